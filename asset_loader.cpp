@@ -0,0 +1,222 @@
+#include "asset_loader.h"
+#include "log.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+// Function to get a file's size in bytes (-1 if it cannot be opened)
+static long getFileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.good()) return -1;
+    return (long)file.tellg();
+}
+
+// Function to get milliseconds elapsed since start
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Function to find a queued asset by name (-1 if not queued)
+static int findAsset(const AssetLoader* loader, const std::string& name) {
+    for (size_t i = 0; i < loader->assets.size(); i++) {
+        if (loader->assets[i].name == name) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// Function to find the directory a file lives in
+bool findAssetRoot(const std::string& probeName, std::string* root) {
+    std::vector<std::string> candidates = {"", "../"};
+    char* basePath = SDL_GetBasePath();
+    if (basePath) {
+        candidates.push_back(basePath);
+        candidates.push_back(std::string(basePath) + "../");
+        SDL_free(basePath);
+    }
+
+    for (const std::string& candidate : candidates) {
+        if (getFileSize(candidate + probeName) >= 0) {
+            *root = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to start an empty loader
+void initializeAssetLoader(AssetLoader* loader) {
+    loader->root.clear();
+    loader->pack.file.data = nullptr;
+    loader->assets.clear();
+    loader->threadCount = 0;
+    loader->decodeWallMs = 0.0;
+}
+
+// Function to queue an image for decoding and get its handle
+int queueAsset(AssetLoader* loader, const std::string& name) {
+    int existing = findAsset(loader, name);
+    if (existing != -1) return existing;
+
+    Asset asset;
+    asset.name = name;
+    asset.fileSize = -1;
+    asset.packEntry = nullptr;
+    asset.surface = nullptr;
+    asset.decodeMs = 0.0;
+    asset.uploadMs = 0.0;
+    loader->assets.push_back(asset);
+    return (int)loader->assets.size() - 1;
+}
+
+// Function to decode every queued image in parallel
+void decodeAssets(AssetLoader* loader, int threadCount) {
+    auto start = std::chrono::steady_clock::now();
+    if (loader->assets.empty()) return;
+
+    // Prefer the pre-decoded pack when one ships with the game
+    std::string packRoot;
+    if (!loader->pack.file.data && findAssetRoot(ASSET_PACK_FILE, &packRoot)) {
+        openAssetPack(&loader->pack, packRoot + ASSET_PACK_FILE);
+    }
+
+    bool needsFiles = false;
+    for (Asset& asset : loader->assets) {
+        asset.packEntry = findPackEntry(&loader->pack, asset.name);
+        if (asset.packEntry) {
+            asset.fileSize = (long)asset.packEntry->storedSize;
+        } else {
+            needsFiles = true;
+        }
+    }
+
+    if (needsFiles) {
+        findAssetRoot(loader->assets[0].name, &loader->root);
+        LOG_INFO("[ASSETS] Asset root: '%s'", loader->root.c_str());
+    }
+
+    // Biggest files first so a large background never starts last
+    std::vector<int> order;
+    for (size_t i = 0; i < loader->assets.size(); i++) {
+        Asset& asset = loader->assets[i];
+        if (asset.packEntry) {
+            order.push_back((int)i);
+            continue;
+        }
+        asset.fileSize = getFileSize(loader->root + asset.name);
+        if (asset.fileSize < 0) {
+            LOG_ERROR("[ERROR] File does not exist: %s%s", loader->root.c_str(), asset.name.c_str());
+            continue;
+        }
+        order.push_back((int)i);
+    }
+    std::sort(order.begin(), order.end(), [loader](int a, int b) {
+        return loader->assets[a].fileSize > loader->assets[b].fileSize;
+    });
+
+    if (threadCount <= 0) {
+        threadCount = (int)std::thread::hardware_concurrency();
+    }
+    threadCount = std::max(1, std::min(threadCount, (int)order.size()));
+
+    // Workers take the next file off a shared counter until none are left
+    std::atomic<int> next(0);
+    auto worker = [loader, &order, &next]() {
+        for (int slot = next++; slot < (int)order.size(); slot = next++) {
+            Asset& asset = loader->assets[order[slot]];
+            auto decodeStart = std::chrono::steady_clock::now();
+            if (asset.packEntry) {
+                asset.surface = getPackSurface(&loader->pack, asset.packEntry);
+                asset.decodeMs = millisecondsSince(decodeStart);
+                continue;
+            }
+
+            std::string path = loader->root + asset.name;
+            asset.surface = IMG_Load(path.c_str());
+            asset.decodeMs = millisecondsSince(decodeStart);
+            if (!asset.surface) {
+                LOG_ERROR("[ERROR] Unable to load image %s! SDL_image Error: %s", path.c_str(), IMG_GetError());
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker(); // The calling thread decodes too
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    loader->threadCount = threadCount;
+    loader->decodeWallMs = millisecondsSince(start);
+}
+
+// Function to get a decoded surface by name
+SDL_Surface* getAssetSurface(const AssetLoader* loader, const std::string& name) {
+    int index = findAsset(loader, name);
+    if (index == -1) {
+        LOG_ERROR("[ERROR] Asset was never queued: %s", name.c_str());
+        return nullptr;
+    }
+    return loader->assets[index].surface;
+}
+
+// Function to upload a decoded image as its own texture
+SDL_Texture* createAssetTexture(AssetLoader* loader, const std::string& name, SDL_Renderer* renderer) {
+    SDL_Surface* surface = getAssetSurface(loader, name);
+    if (!surface) return nullptr;
+
+    auto start = std::chrono::steady_clock::now();
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    loader->assets[findAsset(loader, name)].uploadMs = millisecondsSince(start);
+
+    if (!texture) {
+        LOG_ERROR("[ERROR] Unable to create texture from %s! SDL Error: %s", name.c_str(), SDL_GetError());
+    }
+    return texture;
+}
+
+// Function to log decode and upload times per asset plus totals
+void logAssetReport(const AssetLoader* loader) {
+    // Slowest first
+    std::vector<int> order;
+    for (size_t i = 0; i < loader->assets.size(); i++) {
+        order.push_back((int)i);
+    }
+    std::sort(order.begin(), order.end(), [loader](int a, int b) {
+        const Asset& assetA = loader->assets[a];
+        const Asset& assetB = loader->assets[b];
+        return assetA.decodeMs + assetA.uploadMs > assetB.decodeMs + assetB.uploadMs;
+    });
+
+    double decodeTotal = 0.0;
+    double uploadTotal = 0.0;
+    LOG_INFO("[ASSETS] %-32s %10s %10s %10s", "file", "KB", "decode ms", "upload ms");
+    for (int index : order) {
+        const Asset& asset = loader->assets[index];
+        LOG_INFO("[ASSETS] %-32s %10.1f %10.2f %10.2f%s", asset.name.c_str(), asset.fileSize > 0 ? asset.fileSize / 1024.0 : 0.0,
+                 asset.decodeMs, asset.uploadMs, !asset.surface ? "  (failed)" : asset.packEntry ? "  (pack)" : "");
+        decodeTotal += asset.decodeMs;
+        uploadTotal += asset.uploadMs;
+    }
+    LOG_INFO("[ASSETS] %d files: %.2f ms of decoding in %.2f ms on %d threads, %.2f ms of uploads",
+             (int)loader->assets.size(), decodeTotal, loader->decodeWallMs, loader->threadCount, uploadTotal);
+}
+
+// Function to free every decoded surface and unmap the pack
+void releaseAssetSurfaces(AssetLoader* loader) {
+    for (Asset& asset : loader->assets) {
+        if (asset.surface) {
+            SDL_FreeSurface(asset.surface);
+            asset.surface = nullptr;
+        }
+        asset.packEntry = nullptr;
+    }
+    closeAssetPack(&loader->pack);
+}
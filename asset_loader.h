@@ -0,0 +1,58 @@
+#pragma once
+
+// Startup image loading. Every file is queued up front, the asset root is
+// resolved once, and the files are decoded to surfaces on a pool of
+// worker threads. Only texture creation (the GPU upload) is left for the
+// main thread. logAssetReport() prints how long each file took.
+//
+// When an asset pack (asset_pack.h) is found, images in it are taken
+// from the mapped archive instead of being decoded from PNG.
+
+#include "asset_pack.h"
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+// Structure for one image file and its load timings
+struct Asset {
+    std::string name; // Path relative to the asset root, e.g. "resource/grass.png"
+    long fileSize; // Bytes on disk or in the pack (-1 if missing), larger files are decoded first
+    const AssetPackEntry* packEntry; // Where the pixels are in the pack (null = decode the PNG)
+    SDL_Surface* surface; // Decoded pixels (null if loading failed or after release)
+    double decodeMs; // Time spent in IMG_Load (or unpacking) on a worker thread
+    double uploadMs; // Time spent creating the texture on the main thread
+};
+
+// Structure for the queued assets
+struct AssetLoader {
+    std::string root; // Prefix every PNG name is resolved against ("", "../", ...)
+    AssetPack pack; // Mapped ASSET_PACK_FILE (pack.data is null when there is none)
+    std::vector<Asset> assets;
+    int threadCount; // Workers used by the last decodeAssets
+    double decodeWallMs; // Wall-clock time of the last decodeAssets
+};
+
+// Function to find the directory a file lives in (false if it is nowhere).
+// Tries the working directory, its parent, then the executable's directory.
+bool findAssetRoot(const std::string& probeName, std::string* root);
+
+// Function to start an empty loader
+void initializeAssetLoader(AssetLoader* loader);
+
+// Function to queue an image for decoding and get its handle (queuing the same name twice returns the same handle)
+int queueAsset(AssetLoader* loader, const std::string& name);
+
+// Function to decode every queued image in parallel (threadCount 0 = one per core)
+void decodeAssets(AssetLoader* loader, int threadCount = 0);
+
+// Function to get a decoded surface by name (null if missing or failed)
+SDL_Surface* getAssetSurface(const AssetLoader* loader, const std::string& name);
+
+// Function to upload a decoded image as its own texture (records the upload time)
+SDL_Texture* createAssetTexture(AssetLoader* loader, const std::string& name, SDL_Renderer* renderer);
+
+// Function to log decode and upload times per asset plus totals
+void logAssetReport(const AssetLoader* loader);
+
+// Function to free every decoded surface and unmap the pack (call once the textures exist)
+void releaseAssetSurfaces(AssetLoader* loader);
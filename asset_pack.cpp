@@ -0,0 +1,106 @@
+#include "asset_pack.h"
+#include "log.h"
+#include <cstring>
+
+#ifdef ASSET_PACK_LZ4
+#include <lz4.h>
+#endif
+
+static_assert(sizeof(AssetPackHeader) == 16, "AssetPackHeader layout is part of the file format");
+static_assert(sizeof(AssetPackEntry) == 96, "AssetPackEntry layout is part of the file format");
+
+// Function to map an archive and check its header and index
+bool openAssetPack(AssetPack* pack, const std::string& path) {
+    memset(pack, 0, sizeof(*pack));
+    if (!mapFile(&pack->file, path)) return false;
+
+    // Validate everything up front so lookups can trust the index
+    const char* error = nullptr;
+    pack->header = (const AssetPackHeader*)pack->file.data;
+    if (pack->file.size < sizeof(AssetPackHeader) || memcmp(pack->header->magic, ASSET_PACK_MAGIC, 4) != 0) {
+        error = "not an asset pack";
+    } else if (pack->header->version != ASSET_PACK_VERSION) {
+        error = "unsupported version";
+    } else if ((pack->file.size - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry) < pack->header->entryCount) {
+        error = "truncated index";
+    } else {
+        pack->entries = (const AssetPackEntry*)(pack->file.data + sizeof(AssetPackHeader));
+        for (uint32_t i = 0; i < pack->header->entryCount && !error; i++) {
+            const AssetPackEntry& entry = pack->entries[i];
+            if (entry.offset > pack->file.size || entry.storedSize > pack->file.size - entry.offset) {
+                error = "entry outside the file";
+            } else if (entry.rawSize != (uint64_t)entry.width * entry.height * 4 ||
+                       (!(entry.flags & ASSET_PACK_COMPRESSED) && entry.storedSize != entry.rawSize)) {
+                error = "entry size mismatch";
+            } else if (entry.name[ASSET_PACK_NAME_SIZE - 1] != '\0') {
+                error = "entry name not terminated";
+            }
+        }
+    }
+
+    if (error) {
+        LOG_ERROR("[ERROR] Asset pack %s is invalid: %s", path.c_str(), error);
+        closeAssetPack(pack);
+        return false;
+    }
+
+    LOG_INFO("[ASSETS] Mapped %s: %u images, %.1f KB", path.c_str(), pack->header->entryCount, pack->file.size / 1024.0);
+    return true;
+}
+
+// Function to unmap the archive
+void closeAssetPack(AssetPack* pack) {
+    unmapFile(&pack->file);
+    pack->header = nullptr;
+    pack->entries = nullptr;
+}
+
+// Function to find an image in the index
+const AssetPackEntry* findPackEntry(const AssetPack* pack, const std::string& name) {
+    if (!pack->file.data) return nullptr;
+
+    for (uint32_t i = 0; i < pack->header->entryCount; i++) {
+        if (name == pack->entries[i].name) {
+            return &pack->entries[i];
+        }
+    }
+    return nullptr;
+}
+
+// Function to get an image as a surface
+SDL_Surface* getPackSurface(const AssetPack* pack, const AssetPackEntry* entry) {
+    const uint8_t* block = pack->file.data + entry->offset;
+    int width = (int)entry->width;
+    int height = (int)entry->height;
+
+    if (!(entry->flags & ASSET_PACK_COMPRESSED)) {
+        // SDL never writes through this surface, it is only read for uploads and blits
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom((void*)block, width, height, 32, width * 4,
+                                                                 SDL_PIXELFORMAT_RGBA32);
+        if (!surface) {
+            LOG_ERROR("[ERROR] Unable to wrap packed image %s! SDL Error: %s", entry->name, SDL_GetError());
+        }
+        return surface;
+    }
+
+#ifdef ASSET_PACK_LZ4
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) {
+        LOG_ERROR("[ERROR] Unable to allocate packed image %s! SDL Error: %s", entry->name, SDL_GetError());
+        return nullptr;
+    }
+
+    // Freshly created RGBA32 surfaces have no row padding, so the pixels are one contiguous block
+    int written = LZ4_decompress_safe((const char*)block, (char*)surface->pixels, (int)entry->storedSize,
+                                      (int)entry->rawSize);
+    if (written != (int)entry->rawSize) {
+        LOG_ERROR("[ERROR] Packed image %s is corrupt (LZ4 returned %d)", entry->name, written);
+        SDL_FreeSurface(surface);
+        return nullptr;
+    }
+    return surface;
+#else
+    LOG_ERROR("[ERROR] Packed image %s is LZ4-compressed but this build has no LZ4 support", entry->name);
+    return nullptr;
+#endif
+}
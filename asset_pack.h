@@ -0,0 +1,73 @@
+#pragma once
+
+// Packed asset archive: every image from resource/ stored as ready-to-use
+// RGBA pixels in one file, so startup skips PNG decoding and per-file
+// filesystem probes. The archive is memory-mapped and surfaces point
+// straight into the mapping.
+//
+// Layout (little-endian):
+//   AssetPackHeader
+//   AssetPackEntry[entryCount]
+//   pixel blocks, each aligned to ASSET_PACK_ALIGNMENT
+//
+// Pixels are SDL_PIXELFORMAT_RGBA32 rows with pitch width * 4. A block
+// may be LZ4-compressed (ASSET_PACK_COMPRESSED), which needs a build with
+// ASSET_PACK_LZ4 to read.
+//
+// The archive is written by the pack_assets tool (asset_pack_tool.cpp).
+
+#include "mapped_file.h"
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <string>
+
+// File the game looks for next to resource/ or the executable
+const char* const ASSET_PACK_FILE = "assets.pak";
+
+const char ASSET_PACK_MAGIC[4] = {'T', 'P', 'A', 'K'};
+const uint32_t ASSET_PACK_VERSION = 1;
+const uint32_t ASSET_PACK_ALIGNMENT = 16;
+const int ASSET_PACK_NAME_SIZE = 64;
+
+// Entry flags
+const uint32_t ASSET_PACK_COMPRESSED = 1; // Block is LZ4, rawSize bytes once decompressed
+
+// Structure at the start of the archive
+struct AssetPackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+// Structure for one image in the index
+struct AssetPackEntry {
+    char name[ASSET_PACK_NAME_SIZE]; // e.g. "resource/grass.png", zero padded
+    uint32_t width;
+    uint32_t height;
+    uint32_t flags;
+    uint32_t storedSize; // Bytes in the file
+    uint64_t offset; // From the start of the archive
+    uint64_t rawSize; // width * height * 4
+};
+
+// Structure for an open, memory-mapped archive
+struct AssetPack {
+    MappedFile file; // file.data is null when no archive is open
+    const AssetPackHeader* header;
+    const AssetPackEntry* entries;
+};
+
+// Function to map an archive and check its header and index (false if missing or invalid)
+bool openAssetPack(AssetPack* pack, const std::string& path);
+
+// Function to unmap the archive (surfaces from getPackSurface must be freed first)
+void closeAssetPack(AssetPack* pack);
+
+// Function to find an image in the index (null if it is not packed)
+const AssetPackEntry* findPackEntry(const AssetPack* pack, const std::string& name);
+
+// Function to get an image as a surface. Uncompressed images point into the
+// mapping without copying; compressed ones are decompressed into a new surface.
+// Free with SDL_FreeSurface either way.
+SDL_Surface* getPackSurface(const AssetPack* pack, const AssetPackEntry* entry);
@@ -0,0 +1,177 @@
+// pack_assets: decodes every PNG in a directory and writes them to one
+// asset pack (see asset_pack.h).
+//
+//   pack_assets <resource dir> <output file> [--lz4]
+//
+// Entries are named "<dir name>/<file name>", e.g. "resource/grass.png",
+// which is the same name the game loads them by.
+
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include "asset_pack.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef ASSET_PACK_LZ4
+#include <lz4.h>
+#endif
+
+// Structure for one image ready to be written
+struct PackedImage {
+    AssetPackEntry entry;
+    std::vector<uint8_t> block;
+};
+
+// Function to decode a PNG into tightly packed RGBA rows
+static bool decodeImage(const std::string& path, PackedImage* image) {
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) {
+        fprintf(stderr, "Unable to load %s: %s\n", path.c_str(), IMG_GetError());
+        return false;
+    }
+
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!rgba) {
+        fprintf(stderr, "Unable to convert %s: %s\n", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    int rowBytes = rgba->w * 4;
+    image->entry.width = (uint32_t)rgba->w;
+    image->entry.height = (uint32_t)rgba->h;
+    image->entry.rawSize = (uint64_t)rowBytes * rgba->h;
+    image->block.resize((size_t)image->entry.rawSize);
+    for (int y = 0; y < rgba->h; y++) {
+        memcpy(image->block.data() + (size_t)y * rowBytes, (const uint8_t*)rgba->pixels + (size_t)y * rgba->pitch, rowBytes);
+    }
+    SDL_FreeSurface(rgba);
+    return true;
+}
+
+#ifdef ASSET_PACK_LZ4
+// Function to LZ4-compress a block in place (kept raw if that is not smaller)
+static void compressImage(PackedImage* image) {
+    int rawSize = (int)image->block.size();
+    std::vector<uint8_t> compressed(LZ4_compressBound(rawSize));
+    int size = LZ4_compress_default((const char*)image->block.data(), (char*)compressed.data(), rawSize,
+                                    (int)compressed.size());
+    if (size > 0 && size < rawSize) {
+        compressed.resize(size);
+        image->block.swap(compressed);
+        image->entry.flags |= ASSET_PACK_COMPRESSED;
+    }
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <resource dir> <output file> [--lz4]\n", argv[0]);
+        return 1;
+    }
+
+    std::filesystem::path directory = argv[1];
+    std::string outputPath = argv[2];
+    bool useLz4 = argc > 3 && strcmp(argv[3], "--lz4") == 0;
+#ifndef ASSET_PACK_LZ4
+    if (useLz4) {
+        fprintf(stderr, "This build of pack_assets has no LZ4 support (configure with -DASSET_PACK_LZ4=ON)\n");
+        return 1;
+    }
+#endif
+
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        fprintf(stderr, "SDL_image could not initialize: %s\n", IMG_GetError());
+        return 1;
+    }
+
+    // Sorted so the archive is identical between runs
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (const auto& item : std::filesystem::directory_iterator(directory, error)) {
+        if (item.is_regular_file() && item.path().extension() == ".png") {
+            files.push_back(item.path());
+        }
+    }
+    if (error) {
+        fprintf(stderr, "Unable to read %s: %s\n", directory.string().c_str(), error.message().c_str());
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+
+    std::string prefix = directory.lexically_normal().filename().string();
+    if (prefix.empty()) {
+        prefix = directory.lexically_normal().parent_path().filename().string(); // "resource/" style input
+    }
+
+    std::vector<PackedImage> images;
+    for (const std::filesystem::path& file : files) {
+        PackedImage image = {};
+        std::string name = prefix + "/" + file.filename().string();
+        if (name.size() >= (size_t)ASSET_PACK_NAME_SIZE) {
+            fprintf(stderr, "Skipping %s: name longer than %d characters\n", name.c_str(), ASSET_PACK_NAME_SIZE - 1);
+            continue;
+        }
+        if (!decodeImage(file.string(), &image)) {
+            return 1;
+        }
+        strncpy(image.entry.name, name.c_str(), ASSET_PACK_NAME_SIZE - 1);
+#ifdef ASSET_PACK_LZ4
+        if (useLz4) {
+            compressImage(&image);
+        }
+#endif
+        image.entry.storedSize = (uint32_t)image.block.size();
+        images.push_back(std::move(image));
+    }
+
+    // Lay out the blocks after the index
+    AssetPackHeader header = {};
+    memcpy(header.magic, ASSET_PACK_MAGIC, 4);
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = (uint32_t)images.size();
+
+    uint64_t offset = sizeof(AssetPackHeader) + images.size() * sizeof(AssetPackEntry);
+    for (PackedImage& image : images) {
+        offset = (offset + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+        image.entry.offset = offset;
+        offset += image.block.size();
+    }
+
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        fprintf(stderr, "Unable to write %s\n", outputPath.c_str());
+        return 1;
+    }
+    output.write((const char*)&header, sizeof(header));
+    for (const PackedImage& image : images) {
+        output.write((const char*)&image.entry, sizeof(image.entry));
+    }
+
+    uint64_t written = sizeof(AssetPackHeader) + images.size() * sizeof(AssetPackEntry);
+    uint64_t rawTotal = 0;
+    const char padding[ASSET_PACK_ALIGNMENT] = {};
+    for (const PackedImage& image : images) {
+        output.write(padding, (std::streamsize)(image.entry.offset - written));
+        output.write((const char*)image.block.data(), (std::streamsize)image.block.size());
+        written = image.entry.offset + image.block.size();
+        rawTotal += image.entry.rawSize;
+        printf("%-32s %5ux%-5u %10llu bytes%s\n", image.entry.name, image.entry.width, image.entry.height,
+               (unsigned long long)image.entry.storedSize, (image.entry.flags & ASSET_PACK_COMPRESSED) ? " (lz4)" : "");
+    }
+    if (!output) {
+        fprintf(stderr, "Failed while writing %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    printf("Packed %d images into %s: %llu bytes (%llu bytes of pixels)\n", (int)images.size(), outputPath.c_str(),
+           (unsigned long long)written, (unsigned long long)rawTotal);
+    IMG_Quit();
+    return 0;
+}
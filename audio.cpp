@@ -0,0 +1,369 @@
+#include "audio.h"
+#include "log.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+// Used for the synthetic test sounds
+const double AUDIO_PI = 3.14159265358979323846;
+
+// Volumes of the event sounds
+const int EVENT_HIT_VOLUME = 96;
+const int EVENT_OBSTACLE_VOLUME = 48;
+
+// Function to mix the device buffer on the audio thread
+static void audioCallback(void* userdata, Uint8* stream, int len) {
+    mixAudioEngine((AudioEngine*)userdata, (int16_t*)stream, len / (int)sizeof(int16_t));
+}
+
+// Function to open the sound device, paused
+bool openAudioEngine(AudioEngine* engine) {
+    engine->device = 0;
+    memset(&engine->spec, 0, sizeof(engine->spec));
+    for (AudioSample& sample : engine->samples) {
+        sample.pcm.clear();
+        sample.frames = 0;
+    }
+    engine->queue.head = 0;
+    engine->queue.tail = 0;
+    for (AudioVoice& voice : engine->voices) {
+        voice.active = false;
+        voice.sound = -1;
+    }
+    engine->nextOrder = 0;
+    engine->stats.callbacks = 0;
+    engine->stats.frames = 0;
+    engine->stats.started = 0;
+    engine->stats.stolen = 0;
+    engine->stats.mixMicroseconds = 0;
+    engine->stats.peakVoices = 0;
+    engine->droppedCommands = 0;
+
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        LOG_WARN("[AUDIO] No audio, playing silent: %s", SDL_GetError());
+        return false;
+    }
+
+    SDL_AudioSpec want;
+    memset(&want, 0, sizeof(want));
+    want.freq = AUDIO_FREQUENCY;
+    want.format = AUDIO_S16SYS;
+    want.channels = AUDIO_CHANNELS;
+    want.samples = AUDIO_BUFFER_FRAMES;
+    want.callback = audioCallback;
+    want.userdata = engine;
+    engine->device = SDL_OpenAudioDevice(NULL, 0, &want, &engine->spec,
+                                         SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_CHANNELS_CHANGE |
+                                             SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+    if (engine->device == 0) {
+        LOG_WARN("[AUDIO] No sound device, playing silent: %s", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+
+    // The mixer never allocates: its accumulator covers a whole device buffer
+    engine->mix.assign((size_t)engine->spec.samples * engine->spec.channels, 0);
+    LOG_INFO("[AUDIO] %s driver: %d Hz, %d channels, %d frames per buffer", SDL_GetCurrentAudioDriver(),
+             engine->spec.freq, engine->spec.channels, engine->spec.samples);
+    return true;
+}
+
+// Function to decode a WAV file into a sound
+bool loadAudioSample(AudioEngine* engine, int sound, const std::string& path) {
+    if (engine->device == 0) return false;
+
+    SDL_AudioSpec wav;
+    Uint8* data;
+    Uint32 length;
+    if (!SDL_LoadWAV(path.c_str(), &wav, &data, &length)) {
+        LOG_WARN("[AUDIO] Could not load %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    // Convert once to the device's rate and channels, so mixing is a plain add
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, wav.format, wav.channels, wav.freq, AUDIO_S16SYS, engine->spec.channels,
+                          engine->spec.freq) < 0) {
+        LOG_WARN("[AUDIO] Cannot convert %s: %s", path.c_str(), SDL_GetError());
+        SDL_FreeWAV(data);
+        return false;
+    }
+    std::vector<Uint8> buffer((size_t)length * std::max(1, cvt.len_mult));
+    memcpy(buffer.data(), data, length);
+    SDL_FreeWAV(data);
+    int bytes = (int)length;
+    if (cvt.needed) {
+        cvt.buf = buffer.data();
+        cvt.len = (int)length;
+        if (SDL_ConvertAudio(&cvt) < 0) {
+            LOG_WARN("[AUDIO] Cannot convert %s: %s", path.c_str(), SDL_GetError());
+            return false;
+        }
+        bytes = cvt.len_cvt;
+    }
+
+    int frames = bytes / (int)(sizeof(int16_t) * engine->spec.channels);
+    setAudioSample(engine, sound, (const int16_t*)buffer.data(), frames);
+    LOG_INFO("[AUDIO] Loaded %s: %.2f s", path.c_str(), (double)frames / engine->spec.freq);
+    return true;
+}
+
+// Function to use PCM that is already in the device format as a sound
+void setAudioSample(AudioEngine* engine, int sound, const int16_t* pcm, int frames) {
+    AudioSample* sample = &engine->samples[sound];
+    sample->pcm.assign(pcm, pcm + (size_t)frames * engine->spec.channels);
+    sample->frames = frames;
+}
+
+// Function to start mixing
+void startAudioEngine(AudioEngine* engine) {
+    if (engine->device != 0) {
+        SDL_PauseAudioDevice(engine->device, 0);
+    }
+}
+
+// Function to hand a command to the mixer (drops it if the ring is full)
+static void pushAudioCommand(AudioEngine* engine, AudioCommand command) {
+    if (engine->device == 0) return;
+    AudioQueue* queue = &engine->queue;
+    uint32_t tail = queue->tail.load(std::memory_order_relaxed);
+    if (tail - queue->head.load(std::memory_order_acquire) >= (uint32_t)AUDIO_QUEUE_SIZE) {
+        engine->droppedCommands++;
+        return;
+    }
+    queue->commands[tail & (AUDIO_QUEUE_SIZE - 1)] = command;
+    queue->tail.store(tail + 1, std::memory_order_release);
+}
+
+// Function to play a sound
+void playSound(AudioEngine* engine, int sound, int volume, bool loop) {
+    AudioCommand command;
+    command.type = AUDIO_PLAY;
+    command.sound = (uint8_t)sound;
+    command.volume = (uint8_t)std::max(0, std::min(AUDIO_MAX_VOLUME, volume));
+    command.loop = loop ? 1 : 0;
+    pushAudioCommand(engine, command);
+}
+
+// Function to stop every voice of a sound
+void stopSound(AudioEngine* engine, int sound) {
+    AudioCommand command;
+    command.type = AUDIO_STOP;
+    command.sound = (uint8_t)sound;
+    command.volume = 0;
+    command.loop = 0;
+    pushAudioCommand(engine, command);
+}
+
+// Function to play the sounds of a tick's gameplay events
+void playEventSounds(AudioEngine* engine, const GameEvent* events, int count) {
+    for (int i = 0; i < count; i++) {
+        const GameEvent& event = events[i];
+        if (event.type == GAME_EVENT_HIT) {
+            bool explosive = (event.flags & GAME_EVENT_EXPLOSIVE) != 0;
+            playSound(engine, SOUND_EXPLOSION, explosive ? AUDIO_MAX_VOLUME : EVENT_HIT_VOLUME);
+        } else if (event.type == GAME_EVENT_DESTROYED) {
+            playSound(engine, SOUND_EXPLOSION);
+        } else if (event.type == GAME_EVENT_OBSTACLE_DESTROYED) {
+            playSound(engine, SOUND_EXPLOSION, EVENT_OBSTACLE_VOLUME);
+        }
+    }
+}
+
+// Function to give a play command a voice, taking the oldest one-shot (else the oldest) when all are busy
+static void startVoice(AudioEngine* engine, const AudioCommand& command) {
+    if (command.sound >= SOUND_COUNT || engine->samples[command.sound].frames == 0) return;
+
+    int chosen = -1;
+    for (int i = 0; i < AUDIO_MAX_VOICES && chosen == -1; i++) {
+        if (!engine->voices[i].active) chosen = i;
+    }
+    if (chosen == -1) {
+        for (int pass = 0; pass < 2 && chosen == -1; pass++) {
+            for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+                const AudioVoice& voice = engine->voices[i];
+                if ((pass == 1 || !voice.loop) && (chosen == -1 || voice.order < engine->voices[chosen].order)) {
+                    chosen = i;
+                }
+            }
+        }
+        engine->stats.stolen++;
+    }
+
+    AudioVoice* voice = &engine->voices[chosen];
+    voice->active = true;
+    voice->loop = command.loop != 0;
+    voice->sound = command.sound;
+    voice->volume = command.volume;
+    voice->position = 0;
+    voice->order = engine->nextOrder++;
+    engine->stats.started++;
+}
+
+// Function to add frames of a voice to the accumulator
+static void mixVoice(AudioEngine* engine, AudioVoice* voice, int32_t* mix, int frames) {
+    const AudioSample& sample = engine->samples[voice->sound];
+    int channels = engine->spec.channels;
+    int done = 0;
+    while (done < frames && voice->active) {
+        int count = std::min(frames - done, sample.frames - voice->position);
+        const int16_t* in = sample.pcm.data() + (size_t)voice->position * channels;
+        int32_t* out = mix + (size_t)done * channels;
+        for (int i = 0; i < count * channels; i++) {
+            out[i] += in[i] * voice->volume / AUDIO_MAX_VOLUME;
+        }
+        done += count;
+        voice->position += count;
+        if (voice->position >= sample.frames) {
+            voice->position = 0;
+            voice->active = voice->loop;
+        }
+    }
+}
+
+// Function to mix one device buffer of S16 samples
+void mixAudioEngine(AudioEngine* engine, int16_t* out, int sampleCount) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Take what the game thread asked for since the last buffer
+    AudioQueue* queue = &engine->queue;
+    uint32_t head = queue->head.load(std::memory_order_relaxed);
+    uint32_t tail = queue->tail.load(std::memory_order_acquire);
+    for (; head != tail; head++) {
+        const AudioCommand& command = queue->commands[head & (AUDIO_QUEUE_SIZE - 1)];
+        if (command.type == AUDIO_PLAY) {
+            startVoice(engine, command);
+        } else if (command.type == AUDIO_STOP) {
+            for (AudioVoice& voice : engine->voices) {
+                if (voice.sound == command.sound) voice.active = false;
+            }
+        }
+    }
+    queue->head.store(head, std::memory_order_release);
+
+    int active = 0;
+    for (const AudioVoice& voice : engine->voices) {
+        active += voice.active ? 1 : 0;
+    }
+    if (active > engine->stats.peakVoices.load(std::memory_order_relaxed)) {
+        engine->stats.peakVoices.store(active, std::memory_order_relaxed);
+    }
+
+    // Sum in 32 bits, then clip once
+    int channels = std::max(1, (int)engine->spec.channels);
+    int capacity = (int)engine->mix.size();
+    int done = 0;
+    while (done < sampleCount) {
+        int count = std::min(sampleCount - done, capacity);
+        if (count <= 0) {
+            std::fill(out + done, out + sampleCount, (int16_t)0);
+            break;
+        }
+        int32_t* mix = engine->mix.data();
+        std::fill(mix, mix + count, 0);
+        for (AudioVoice& voice : engine->voices) {
+            if (voice.active) mixVoice(engine, &voice, mix, count / channels);
+        }
+        for (int i = 0; i < count; i++) {
+            out[done + i] = (int16_t)std::max(-32768, std::min(32767, mix[i]));
+        }
+        done += count;
+    }
+
+    engine->stats.callbacks++;
+    engine->stats.frames += sampleCount / channels;
+    engine->stats.mixMicroseconds += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                                         std::chrono::steady_clock::now() - start).count();
+}
+
+// Function to log the mixer's figures and close the device
+void closeAudioEngine(AudioEngine* engine) {
+    if (engine->device == 0) return;
+    SDL_CloseAudioDevice(engine->device); // Waits for the callback to return
+    engine->device = 0;
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+
+    const AudioStats& stats = engine->stats;
+    uint64_t callbacks = std::max<uint64_t>(1, stats.callbacks.load());
+    LOG_INFO("[AUDIO] %llu buffers mixed (%.1f us each), %llu voices started, %llu stolen, %d at most, "
+             "%llu commands dropped",
+             (unsigned long long)stats.callbacks.load(), (double)stats.mixMicroseconds.load() / callbacks,
+             (unsigned long long)stats.started.load(), (unsigned long long)stats.stolen.load(),
+             stats.peakVoices.load(), (unsigned long long)engine->droppedCommands);
+}
+
+// Function to make a synthetic sound: a fading tone with some noise, in the device format
+static std::vector<int16_t> makeTestSound(const SDL_AudioSpec& spec, double seconds, double pitch, GameRng* rng) {
+    int frames = (int)(seconds * spec.freq);
+    std::vector<int16_t> pcm((size_t)frames * spec.channels);
+    for (int i = 0; i < frames; i++) {
+        double fade = 1.0 - (double)i / frames;
+        double tone = std::sin(2.0 * AUDIO_PI * pitch * i / spec.freq);
+        double noise = random(rng, -1000, 1000) / 1000.0;
+        int16_t value = (int16_t)(8000.0 * fade * (0.7 * tone + 0.3 * noise));
+        for (int c = 0; c < spec.channels; c++) {
+            pcm[(size_t)i * spec.channels + c] = value;
+        }
+    }
+    return pcm;
+}
+
+// Function to play bursts of synthetic sounds from a game loop and report the mixer's figures
+AudioTestResult runAudioStress(double seconds) {
+    AudioTestResult result = {};
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0); // Keeps a driver picked by the caller (e.g. "disk")
+
+    AudioEngine engine;
+    result.opened = openAudioEngine(&engine);
+    if (!result.opened) return result;
+    result.driver = SDL_GetCurrentAudioDriver();
+    result.frequency = engine.spec.freq;
+    result.channels = engine.spec.channels;
+    result.bufferFrames = engine.spec.samples;
+
+    GameRng rng;
+    seedRng(&rng, 1);
+    const double lengths[SOUND_COUNT] = {2.0, 0.6, 1.5};
+    const double pitches[SOUND_COUNT] = {110.0, 70.0, 440.0};
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        std::vector<int16_t> pcm = makeTestSound(engine.spec, lengths[i], pitches[i], &rng);
+        setAudioSample(&engine, i, pcm.data(), (int)(pcm.size() / engine.spec.channels));
+    }
+    startAudioEngine(&engine);
+
+    // A busy match: music throughout, a few explosions most ticks, a fanfare now and then
+    auto timedPlay = [&](int sound, int volume, bool loop) {
+        auto start = std::chrono::steady_clock::now();
+        playSound(&engine, sound, volume, loop);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        result.maxPlayMicroseconds = std::max(result.maxPlayMicroseconds, us);
+        result.commands++;
+    };
+    timedPlay(SOUND_MUSIC, AUDIO_MAX_VOLUME / 2, true);
+    int ticks = (int)(seconds * SIMULATION_TICK_RATE);
+    auto nextTick = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        int explosions = random(&rng, 0, 3);
+        for (int i = 0; i < explosions; i++) {
+            timedPlay(SOUND_EXPLOSION, random(&rng, 32, AUDIO_MAX_VOLUME), false);
+        }
+        if (tick % (2 * SIMULATION_TICK_RATE) == 0) {
+            timedPlay(SOUND_WINNER, AUDIO_MAX_VOLUME, false);
+        }
+        nextTick += std::chrono::microseconds(1000000 / SIMULATION_TICK_RATE);
+        std::this_thread::sleep_until(nextTick);
+    }
+    stopSound(&engine, SOUND_MUSIC);
+
+    closeAudioEngine(&engine);
+    result.droppedCommands = engine.droppedCommands;
+    result.callbacks = engine.stats.callbacks;
+    result.started = engine.stats.started;
+    result.stolen = engine.stats.stolen;
+    result.peakVoices = engine.stats.peakVoices;
+    result.mixMicroseconds =
+        result.callbacks > 0 ? (double)engine.stats.mixMicroseconds / result.callbacks : 0.0;
+    return result;
+}
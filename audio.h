@@ -0,0 +1,148 @@
+#pragma once
+
+// Sound effects and music on SDL's core audio API. Every sample is
+// decoded and converted to the device format once, when it is loaded,
+// so playing it is only a copy into the mix. The game thread never
+// touches the voices: playSound() writes a command into a fixed-size
+// single-producer/single-consumer ring, and the mixing callback on the
+// audio thread drains the ring at the start of each buffer. Nothing on
+// the game thread locks, blocks or allocates.
+//
+// At most AUDIO_MAX_VOICES sounds play at once; a new one takes the
+// place of the oldest one-shot sound (looping music is kept while any
+// one-shot can go). Without a sound device, or under SDL's "dummy" or
+// "disk" drivers, everything runs the same.
+
+#include "game_events.h"
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sounds the game plays
+const int SOUND_MUSIC = 0;
+const int SOUND_EXPLOSION = 1;
+const int SOUND_WINNER = 2;
+const int SOUND_COUNT = 3;
+
+// Files of the sounds, relative to the asset root (WAV, any rate and channel count)
+const char* const SOUND_FILES[SOUND_COUNT] = {"resource/background.wav", "resource/explosion.wav",
+                                              "resource/winner.wav"};
+
+// Mixer limits
+const int AUDIO_MAX_VOICES = 16;
+const int AUDIO_QUEUE_SIZE = 256; // Commands in flight (a power of two)
+const int AUDIO_MAX_VOLUME = SDL_MIX_MAXVOLUME;
+
+// Device format asked for (SDL converts if the device wants something else)
+const int AUDIO_FREQUENCY = 48000;
+const int AUDIO_CHANNELS = 2;
+const int AUDIO_BUFFER_FRAMES = 512; // About 11 ms at 48 kHz
+
+// Command types
+const uint8_t AUDIO_PLAY = 1;
+const uint8_t AUDIO_STOP = 2; // Stops every voice of the sound
+
+// Structure for one command from the game thread to the mixer
+struct AudioCommand {
+    uint8_t type; // AUDIO_PLAY, AUDIO_STOP
+    uint8_t sound; // SOUND_*
+    uint8_t volume; // 0 to AUDIO_MAX_VOLUME
+    uint8_t loop; // 1 = play until stopped
+};
+
+// Structure for the command ring (one writer: the game thread; one reader: the mixer)
+struct AudioQueue {
+    AudioCommand commands[AUDIO_QUEUE_SIZE];
+    alignas(64) std::atomic<uint32_t> head; // Next slot the mixer reads (own cache line: each side writes one)
+    alignas(64) std::atomic<uint32_t> tail; // Next slot the game thread writes
+};
+
+// Structure for a decoded sound in the device format
+struct AudioSample {
+    std::vector<int16_t> pcm; // Interleaved, AudioEngine::spec.channels per frame
+    int frames;
+};
+
+// Structure for a sound being played
+struct AudioVoice {
+    bool active;
+    bool loop;
+    int sound;
+    int volume;
+    int position; // Next frame
+    uint32_t order; // When it started (higher = newer)
+};
+
+// Structure for the mixer's figures (written by the audio thread, read by anyone)
+struct AudioStats {
+    std::atomic<uint64_t> callbacks;
+    std::atomic<uint64_t> frames; // Mixed
+    std::atomic<uint64_t> started; // Voices started
+    std::atomic<uint64_t> stolen; // Voices cut off for a newer sound
+    std::atomic<uint64_t> mixMicroseconds; // Total time in the callback
+    std::atomic<int> peakVoices;
+};
+
+// Structure for the audio engine
+struct AudioEngine {
+    SDL_AudioDeviceID device; // 0 when there is no sound
+    SDL_AudioSpec spec; // What the device gave us (always AUDIO_S16SYS)
+    AudioSample samples[SOUND_COUNT]; // Written only before startAudioEngine
+    AudioQueue queue;
+    AudioVoice voices[AUDIO_MAX_VOICES]; // Owned by the mixer
+    uint32_t nextOrder;
+    std::vector<int32_t> mix; // Accumulator, sized for one device buffer when opened
+    AudioStats stats;
+    uint64_t droppedCommands; // Ring full (game thread only)
+};
+
+// Function to open the sound device, paused (false if there is no sound; the game then runs silent)
+bool openAudioEngine(AudioEngine* engine);
+
+// Function to decode a WAV file into a sound (before startAudioEngine)
+bool loadAudioSample(AudioEngine* engine, int sound, const std::string& path);
+
+// Function to use PCM that is already in the device format as a sound (before startAudioEngine)
+void setAudioSample(AudioEngine* engine, int sound, const int16_t* pcm, int frames);
+
+// Function to start mixing
+void startAudioEngine(AudioEngine* engine);
+
+// Function to play a sound (game thread; never blocks, drops the command if the ring is full)
+void playSound(AudioEngine* engine, int sound, int volume = AUDIO_MAX_VOLUME, bool loop = false);
+
+// Function to stop every voice of a sound (game thread)
+void stopSound(AudioEngine* engine, int sound);
+
+// Function to play the sounds of a tick's gameplay events (game thread)
+void playEventSounds(AudioEngine* engine, const GameEvent* events, int count);
+
+// Function to mix one device buffer of S16 samples (the device callback; callable directly for tests)
+void mixAudioEngine(AudioEngine* engine, int16_t* out, int sampleCount);
+
+// Function to log the mixer's figures and close the device
+void closeAudioEngine(AudioEngine* engine);
+
+// Structure for the outcome of runAudioStress
+struct AudioTestResult {
+    bool opened;
+    std::string driver;
+    int frequency;
+    int channels;
+    int bufferFrames;
+    uint64_t commands; // playSound calls
+    uint64_t droppedCommands;
+    double maxPlayMicroseconds; // Slowest playSound call
+    uint64_t callbacks;
+    uint64_t started;
+    uint64_t stolen;
+    int peakVoices;
+    double mixMicroseconds; // Per callback
+};
+
+// Function to open the device (SDL_AUDIODRIVER picks the driver, "dummy"
+// when unset), play bursts of synthetic sounds from a game loop running
+// at SIMULATION_TICK_RATE for the given seconds and report the figures
+AudioTestResult runAudioStress(double seconds);
@@ -0,0 +1,124 @@
+#include "bit_stream.h"
+
+// Bits per variable-length group
+const int VAR_GROUP_BITS = 4;
+
+// Function to start writing into data
+void beginBitWriter(BitWriter* writer, uint8_t* data, int capacity) {
+    writer->data = data;
+    writer->capacity = capacity;
+    writer->bitCount = 0;
+    writer->scratch = 0;
+    writer->scratchBits = 0;
+    writer->overflow = false;
+}
+
+// Function to write the low bits (1 to 32) of value
+void writeBits(BitWriter* writer, uint32_t value, int bits) {
+    if (bits < 32) value &= (1u << bits) - 1;
+    writer->scratch |= (uint64_t)value << writer->scratchBits;
+    writer->scratchBits += bits;
+    writer->bitCount += bits;
+
+    // Move whole bytes out of the scratch
+    while (writer->scratchBits >= 8) {
+        int byte = (writer->bitCount - writer->scratchBits) / 8;
+        if (byte < writer->capacity) {
+            writer->data[byte] = (uint8_t)writer->scratch;
+        } else {
+            writer->overflow = true;
+        }
+        writer->scratch >>= 8;
+        writer->scratchBits -= 8;
+    }
+}
+
+// Function to store the last partial byte
+int finishBitWriter(BitWriter* writer) {
+    if (writer->scratchBits > 0) {
+        int byte = writer->bitCount / 8;
+        if (byte < writer->capacity) {
+            writer->data[byte] = (uint8_t)writer->scratch;
+        } else {
+            writer->overflow = true;
+        }
+    }
+    return (writer->bitCount + 7) / 8;
+}
+
+// Function to write an unsigned number in 4-bit groups
+void writeVarUint(BitWriter* writer, uint32_t value) {
+    for (;;) {
+        writeBits(writer, value, VAR_GROUP_BITS);
+        value >>= VAR_GROUP_BITS;
+        writeBits(writer, value != 0 ? 1 : 0, 1);
+        if (value == 0) break;
+    }
+}
+
+// Function to write a signed number (zigzag)
+void writeVarInt(BitWriter* writer, int32_t value) {
+    writeVarUint(writer, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+// Function to write a value as a change from base
+void writeDelta(BitWriter* writer, int32_t base, int32_t value) {
+    if (value == base) {
+        writeBits(writer, 0, 1);
+        return;
+    }
+    writeBits(writer, 1, 1);
+    writeVarInt(writer, (int32_t)((uint32_t)value - (uint32_t)base));
+}
+
+// Function to start reading size bytes of data
+void beginBitReader(BitReader* reader, const uint8_t* data, int size) {
+    reader->data = data;
+    reader->size = size;
+    reader->bitCount = 0;
+    reader->overflow = false;
+}
+
+// Function to read bits (1 to 32)
+uint32_t readBits(BitReader* reader, int bits) {
+    if (reader->bitCount + bits > reader->size * 8) {
+        reader->overflow = true;
+        reader->bitCount = reader->size * 8;
+        return 0;
+    }
+
+    // Gather the (at most five) bytes the bits span
+    int byte = reader->bitCount / 8;
+    int shift = reader->bitCount % 8;
+    uint64_t scratch = 0;
+    int end = (reader->bitCount + bits + 7) / 8;
+    for (int i = byte; i < end; i++) {
+        scratch |= (uint64_t)reader->data[i] << ((i - byte) * 8);
+    }
+    reader->bitCount += bits;
+    scratch >>= shift;
+    return bits < 32 ? (uint32_t)scratch & ((1u << bits) - 1) : (uint32_t)scratch;
+}
+
+// Function to read an unsigned number in 4-bit groups
+uint32_t readVarUint(BitReader* reader) {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += VAR_GROUP_BITS) {
+        value |= readBits(reader, VAR_GROUP_BITS) << shift;
+        if (readBits(reader, 1) == 0) return value;
+    }
+    reader->overflow = true; // Longer than any value we write
+    return value;
+}
+
+// Function to read a signed number (zigzag)
+int32_t readVarInt(BitReader* reader) {
+    uint32_t value = readVarUint(reader);
+    return (int32_t)((value >> 1) ^ (0u - (value & 1)));
+}
+
+// Function to read a value written as a change from base
+int32_t readDelta(BitReader* reader, int32_t base) {
+    if (readBits(reader, 1) == 0) return base;
+    return (int32_t)((uint32_t)base + (uint32_t)readVarInt(reader));
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// Bit-level packing for network snapshots. Values take only the bits they
+// need: small numbers go out as variable-length integers (4 bits at a
+// time, each group followed by a bit saying whether more follow), and a
+// field that did not change since the base state costs a single bit.
+//
+// Writing past the buffer or reading past the data sets the overflow flag
+// instead of touching memory; the caller checks it once at the end.
+
+#include <cstdint>
+
+// Structure for writing bits into a caller's buffer
+struct BitWriter {
+    uint8_t* data;
+    int capacity; // Bytes
+    int bitCount; // Bits written so far
+    uint64_t scratch; // Bits not yet stored in data (low bits first)
+    int scratchBits;
+    bool overflow;
+};
+
+// Structure for reading bits from a received buffer
+struct BitReader {
+    const uint8_t* data;
+    int size; // Bytes
+    int bitCount; // Bits read so far
+    bool overflow;
+};
+
+// Function to start writing into data
+void beginBitWriter(BitWriter* writer, uint8_t* data, int capacity);
+
+// Function to write the low bits (1 to 32) of value
+void writeBits(BitWriter* writer, uint32_t value, int bits);
+
+// Function to store the last partial byte (returns the bytes used)
+int finishBitWriter(BitWriter* writer);
+
+// Function to write an unsigned number in 4-bit groups (4 bits for 0-15, 9 for 16-255...)
+void writeVarUint(BitWriter* writer, uint32_t value);
+
+// Function to write a signed number (zigzag, so small negatives stay short)
+void writeVarInt(BitWriter* writer, int32_t value);
+
+// Function to write a value as a change from base (one bit if unchanged)
+void writeDelta(BitWriter* writer, int32_t base, int32_t value);
+
+// Function to start reading size bytes of data
+void beginBitReader(BitReader* reader, const uint8_t* data, int size);
+
+// Functions to read back what the matching write functions wrote
+uint32_t readBits(BitReader* reader, int bits);
+uint32_t readVarUint(BitReader* reader);
+int32_t readVarInt(BitReader* reader);
+int32_t readDelta(BitReader* reader, int32_t base);
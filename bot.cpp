@@ -0,0 +1,249 @@
+#include "bot.h"
+#include "job_system.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Function to get the direction from one point to another in degrees (0 = up, clockwise)
+static float getBearing(float dx, float dy) {
+    float degrees = atan2f(dx, -dy) * 180.0f / (float)M_PI;
+    return degrees < 0.0f ? degrees + 360.0f : degrees;
+}
+
+// Function to get the signed difference between two directions (-180 to 180 degrees)
+static float getAngleDifference(float a, float b) {
+    float difference = fmodf(a - b, 360.0f);
+    if (difference > 180.0f) difference -= 360.0f;
+    if (difference < -180.0f) difference += 360.0f;
+    return difference;
+}
+
+// Function to press the key for one of the four facings (0 = up, 1 = right, 2 = down, 3 = left)
+static void pressDirection(TankInput* input, int facing) {
+    input->up = facing == 0;
+    input->right = facing == 1;
+    input->down = facing == 2;
+    input->left = facing == 3;
+}
+
+// Function to check if a move key is held
+static bool isMoveHeld(const TankInput& input) {
+    return input.up || input.down || input.left || input.right;
+}
+
+// Function to steer along a flow field, keeping the tank on the middle of
+// its cell across the direction of travel so its corners clear the
+// obstacles beside the path (false if the field has no step from here)
+static bool steerAlongFlow(const FlowField* field, const NavGrid* grid, SDL_Rect rect, float speed,
+                           TankInput* input) {
+    float x = rect.x + rect.w / 2.0f;
+    float y = rect.y + rect.h / 2.0f;
+    int cell = getNavCell(grid, x, y);
+    int step = getFlowDirection(field, grid, cell);
+    if (step == -1) return false;
+
+    // Off a passable cell (squeezed past a corner) just head for the neighbour
+    float centerX = (cell % grid->columns) * grid->cellSize + grid->cellSize / 2.0f;
+    float centerY = (cell / grid->columns) * grid->cellSize + grid->cellSize / 2.0f;
+    bool blocked = grid->blockers[cell] != 0;
+    if (!blocked && (step == 1 || step == 3) && fabsf(y - centerY) > speed) {
+        pressDirection(input, y > centerY ? 0 : 2);
+    } else if (!blocked && (step == 0 || step == 2) && fabsf(x - centerX) > speed) {
+        pressDirection(input, x > centerX ? 3 : 1);
+    } else {
+        pressDirection(input, step);
+    }
+    return true;
+}
+
+// Function to pick the nearest live tank other than the bot's own (-1 if none)
+static int findNearestEnemy(const TankStore* tanks, int self, float x, float y) {
+    int nearest = -1;
+    float nearestDistance = 0.0f;
+    for (int i = 0; i < tanks->count; i++) {
+        if (i == self || !isTankAlive(tanks, i)) continue;
+        float dx = tanks->rect[i].x + tanks->rect[i].w / 2.0f - x;
+        float dy = tanks->rect[i].y + tanks->rect[i].h / 2.0f - y;
+        float distance = dx * dx + dy * dy;
+        if (nearest == -1 || distance < nearestDistance) {
+            nearest = i;
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
+}
+
+// Function to decide what one bot does until its next think
+static void thinkBot(Bot* bot, const World* world, FlowFieldCache* flowFields) {
+    const TankStore* tanks = &world->tanks;
+    const NavGrid* grid = &world->navGrid;
+    int self = bot->tank;
+    bot->pathCell = -1;
+    bot->nextThinkTick = world->tick + BOT_THINK_INTERVAL + nextRandom(&bot->rng) % 4; // Jitter spreads bots over frames
+
+    TankInput input = {};
+    SDL_Rect rect = tanks->rect[self];
+    float x = rect.x + rect.w / 2.0f;
+    float y = rect.y + rect.h / 2.0f;
+    bot->target = isTankAlive(tanks, self) ? findNearestEnemy(tanks, self, x, y) : -1;
+    if (bot->target == -1) {
+        bot->input = input;
+        return;
+    }
+
+    SDL_Rect targetRect = tanks->rect[bot->target];
+    float dx = targetRect.x + targetRect.w / 2.0f - x;
+    float dy = targetRect.y + targetRect.h / 2.0f - y;
+    float bearing = getBearing(dx, dy);
+    int facing = (int)((bearing + 45.0f) / 90.0f) % 4; // Closest of the four directions a tank can face
+
+    // A bullet from here would reach the target without hitting an obstacle
+    Fixed hitTime;
+    bool clearShot = sweepObstacleGrid(&world->obstacleGrid, fixedFromFloat(x - BULLET_WIDTH / 2.0f),
+                                       fixedFromFloat(y - BULLET_HEIGHT / 2.0f), BULLET_WIDTH, BULLET_HEIGHT,
+                                       fixedFromFloat(dx), fixedFromFloat(dy), &hitTime) == -1;
+
+    // Out of range or behind cover: look up the shared flow field towards
+    // the target's cell. No way there means the target is walled off.
+    int targetCell = -1;
+    const FlowField* field = NULL;
+    bool walledOff = false;
+    if (dx * dx + dy * dy > BOT_ATTACK_RANGE * BOT_ATTACK_RANGE || !clearShot) {
+        targetCell = getNavCell(grid, x + dx, y + dy);
+        field = getFlowField(flowFields, grid, targetCell);
+        int cell = getNavCell(grid, x, y);
+        walledOff = cell != targetCell && getFlowDirection(field, grid, cell) == -1;
+    }
+
+    // Held a move key since the last think without getting anywhere: try
+    // going sideways for a while to get around whatever is in the way
+    bool stuck = isMoveHeld(bot->input) && rect.x == bot->lastRect.x && rect.y == bot->lastRect.y;
+    bot->lastRect = rect;
+    if (stuck && !walledOff && world->tick >= bot->wanderUntilTick) {
+        int side = (nextRandom(&bot->rng) & 1) ? 1 : 3;
+        pressDirection(&bot->wanderInput, (facing + side) % 4);
+        bot->wanderUntilTick = world->tick + 30 + nextRandom(&bot->rng) % 60;
+    }
+
+    if (walledOff) {
+        // Every obstacle can be shot away: face the target and fire through
+        // whatever is in between until the nav grid opens a way
+        if (tanks->rotation[self] != fixedFromInt(facing * 90)) pressDirection(&input, facing);
+    } else if (world->tick < bot->wanderUntilTick) {
+        input = bot->wanderInput;
+    } else if (field != NULL && steerAlongFlow(field, grid, rect, fixedToFloat(tanks->speed[self]), &input)) {
+        bot->pathCell = targetCell; // Close in around the obstacles
+    } else if (field != NULL || tanks->rotation[self] != fixedFromInt(facing * 90)) {
+        // Head straight for a target in the same cell, or turn to face it (a tank turns by moving)
+        pressDirection(&input, facing);
+    }
+
+    // Fire when the sweeping gun points at the target
+    float aim = fixedToFloat(tanks->rotation[self] + tanks->gunRotation[self]);
+    if (fabsf(getAngleDifference(bearing, aim)) <= BOT_AIM_TOLERANCE) {
+        input.fire = tanks->ammo[self] > 0;
+
+        // Save explosion shots for a clear line to a target they would finish
+        input.fireExplosion = clearShot && tanks->info[self].explosionItemCount > 0 && tanks->hp[bot->target] <= 75;
+    }
+    bot->input = input;
+}
+
+// Function to give every tank from firstTank on to a bot
+void initializeBots(BotController* controller, const World* world, int firstTank) {
+    controller->bots.clear();
+    controller->cursor = 0;
+    controller->thinksLastFrame = 0;
+    controller->skippedLastFrame = 0;
+    controller->thinkSecondsLastFrame = 0.0;
+    clearFlowFieldCache(&controller->flowFields); // The world's nav grid was rebuilt
+
+    for (int tank = firstTank; tank < world->tanks.count; tank++) {
+        Bot bot = {};
+        bot.tank = tank;
+        bot.target = -1;
+        bot.pathCell = -1;
+        bot.nextThinkTick = world->tick + tank % BOT_THINK_INTERVAL; // Stagger the first thinks
+        bot.lastRect = world->tanks.rect[tank];
+        seedRng(&bot.rng, world->seed ^ ((uint64_t)(tank + 1) * 0x9E3779B97F4A7C15ull));
+        controller->bots.push_back(bot);
+    }
+}
+
+// Function to let due bots think within the budget and write their inputs
+void updateBots(BotController* controller, const World* world, TankInput* inputs, double budget, JobSystem* jobs) {
+    auto start = std::chrono::steady_clock::now();
+    int count = (int)controller->bots.size();
+
+    // Due bots in round-robin order from where the last frame stopped
+    std::vector<int>& due = controller->due;
+    due.clear();
+    for (int n = 0; n < count; n++) {
+        int index = (controller->cursor + n) % count;
+        if (world->tick >= controller->bots[index].nextThinkTick) due.push_back(index);
+    }
+    int dueCount = (int)due.size();
+    controller->thought.assign(dueCount, 0);
+
+    // Every thread takes the next due bot in order until the budget is
+    // spent. At least one bot thinks every frame so nobody starves on a
+    // slow machine. Bots only read the world, write their own Bot and
+    // share the flow field cache, which locks itself.
+    std::atomic<int> next(0);
+    parallelFor(jobs, std::min(dueCount, getJobThreadCount(jobs)), 1, [&](int, int) {
+        for (;;) {
+            int k = next.fetch_add(1);
+            if (k >= dueCount) break;
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (k > 0 && elapsed >= budget) break;
+            thinkBot(&controller->bots[due[k]], world, &controller->flowFields);
+            controller->thought[k] = 1;
+        }
+    });
+    trimFlowFieldCache(&controller->flowFields);
+
+    int thinks = 0;
+    int resumeAt = -1; // First due bot left without a think
+    for (int k = 0; k < dueCount; k++) {
+        if (controller->thought[k]) {
+            thinks++;
+        } else if (resumeAt == -1) {
+            resumeAt = due[k];
+        }
+    }
+    int skipped = dueCount - thinks;
+    if (count > 0) {
+        controller->cursor = resumeAt != -1 ? resumeAt : (controller->cursor + 1) % count;
+    }
+
+    // Moves are held like keys; shots stay pressed until a tick consumes them.
+    // Bots on a path look up their next step every frame, which is only a
+    // few reads of a field that is already there, so turns are not missed
+    // between thinks.
+    for (Bot& bot : controller->bots) {
+        if (bot.pathCell != -1 && world->tick >= bot.wanderUntilTick) {
+            const FlowField* field = findFlowField(&controller->flowFields, bot.pathCell);
+            if (field != NULL) {
+                steerAlongFlow(field, &world->navGrid, world->tanks.rect[bot.tank],
+                               fixedToFloat(world->tanks.speed[bot.tank]), &bot.input);
+            }
+        }
+
+        TankInput* input = &inputs[bot.tank];
+        bool fire = input->fire || bot.input.fire;
+        bool fireExplosion = input->fireExplosion || bot.input.fireExplosion;
+        *input = bot.input;
+        input->fire = fire;
+        input->fireExplosion = fireExplosion;
+        bot.input.fire = false;
+        bot.input.fireExplosion = false;
+    }
+
+    controller->thinksLastFrame = thinks;
+    controller->skippedLastFrame = skipped;
+    controller->thinkSecondsLastFrame = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+// Computer-controlled tanks. A bot drives its tank through the same
+// TankInput a player's keys fill in: it holds a move direction and presses
+// fire when its gun lines up with a target. A bot without a clear shot
+// finds its way around obstacles with a flow field towards the target's
+// cell, shared by every bot hunting there. Bots only re-decide ("think")
+// every so often, and a frame gives all of them together a fixed time
+// budget: thinking goes round-robin from where the last frame stopped and
+// halts when the budget is spent, so dozens of bots cost a bounded slice
+// of every frame and simply react a little later under load.
+//
+// Bots read the World but never change it, and use their own random
+// numbers, so a match with bots still replays from its recorded inputs.
+
+#include "world.h"
+#include <vector>
+
+// Time all bots together may spend thinking per frame (seconds)
+const double BOT_THINK_BUDGET = 0.0005;
+
+// A bot re-decides at most this often (ticks), like a player's reaction time
+const int BOT_THINK_INTERVAL = 12;
+
+// Bots close in until their target is this near (pixels between centers)
+const float BOT_ATTACK_RANGE = 320.0f;
+
+// Gun must point this close to the target before the bot fires (degrees)
+const float BOT_AIM_TOLERANCE = 6.0f;
+
+// Structure for one bot's memory between thinks
+struct Bot {
+    int tank; // Tank the bot drives
+    int target; // Tank it is hunting (-1 = none)
+    TankInput input; // Held until the next think
+    int pathCell; // Nav cell the bot follows the flow field to (-1 = none)
+    uint32_t nextThinkTick; // World tick of the next think
+    uint32_t wanderUntilTick; // Keeps the wander direction until this tick
+    TankInput wanderInput; // Direction tried to get around an obstacle
+    SDL_Rect lastRect; // Tank position at the previous think (stuck detection)
+    GameRng rng;
+};
+
+// Structure for every bot of a match and the think scheduler
+struct BotController {
+    std::vector<Bot> bots;
+    FlowFieldCache flowFields; // Shared by every bot heading to the same cell
+    std::vector<int> due; // Bots due to think this frame, in round-robin order (scratch)
+    std::vector<uint8_t> thought; // Whether each due bot got to think (scratch)
+    int cursor; // Bot that thinks first next frame
+    int thinksLastFrame; // Bots that thought in the last updateBots call
+    int skippedLastFrame; // Bots that were due but ran out of budget
+    double thinkSecondsLastFrame; // Time spent thinking in the last call
+};
+
+// Function to give every tank from firstTank on to a bot (seeded from the match seed)
+void initializeBots(BotController* controller, const World* world, int firstTank);
+
+// Function to let due bots think within budget seconds and write every
+// bot's held input into inputs (one per tank, as passed to stepWorld).
+// Shots a bot decides on stay set in inputs until the caller clears them
+// after a tick, the same as a player's key presses. With a job system
+// bots think on every thread, so more of them fit in the same budget.
+void updateBots(BotController* controller, const World* world, TankInput* inputs, double budget = BOT_THINK_BUDGET,
+                JobSystem* jobs = NULL);
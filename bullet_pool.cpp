@@ -0,0 +1,224 @@
+#include "bullet_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BULLET_POOL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define BULLET_POOL_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Function to empty the pool and reserve capacity
+void initializeBulletPool(BulletPool* pool, int capacity) {
+    pool->x.clear();
+    pool->y.clear();
+    pool->prevX.clear();
+    pool->prevY.clear();
+    pool->velocityX.clear();
+    pool->velocityY.clear();
+    pool->rotation.clear();
+    pool->owner.clear();
+    pool->flags.clear();
+    pool->freeList.clear();
+    pool->liveCount = 0;
+
+    pool->x.reserve(capacity);
+    pool->y.reserve(capacity);
+    pool->prevX.reserve(capacity);
+    pool->prevY.reserve(capacity);
+    pool->velocityX.reserve(capacity);
+    pool->velocityY.reserve(capacity);
+    pool->rotation.reserve(capacity);
+    pool->owner.reserve(capacity);
+    pool->flags.reserve(capacity);
+    pool->freeList.reserve(capacity);
+}
+
+// Function to get a free slot (grows the pool when needed)
+int allocateBullet(BulletPool* pool) {
+    int index;
+    if (!pool->freeList.empty()) {
+        index = pool->freeList.back();
+        pool->freeList.pop_back();
+    } else {
+        index = (int)pool->x.size();
+        pool->x.push_back(fixedFromInt(0));
+        pool->y.push_back(fixedFromInt(0));
+        pool->prevX.push_back(fixedFromInt(0));
+        pool->prevY.push_back(fixedFromInt(0));
+        pool->velocityX.push_back(fixedFromInt(0));
+        pool->velocityY.push_back(fixedFromInt(0));
+        pool->rotation.push_back(fixedFromInt(0));
+        pool->owner.push_back(0);
+        pool->flags.push_back(0);
+    }
+    pool->flags[index] = BULLET_ACTIVE;
+    pool->liveCount++;
+    return index;
+}
+
+// Function to deactivate a bullet and return its slot to the free list
+void releaseBullet(BulletPool* pool, int index) {
+    if (!isBulletActive(pool, index)) return;
+
+    pool->flags[index] = 0;
+    // Parked slots sit still at the origin so the update kernel can run over them harmlessly
+    pool->x[index] = fixedFromInt(0);
+    pool->y[index] = fixedFromInt(0);
+    pool->velocityX[index] = fixedFromInt(0);
+    pool->velocityY[index] = fixedFromInt(0);
+    pool->freeList.push_back(index);
+    pool->liveCount--;
+}
+
+// Function to fire a bullet from the center of a tank body in a direction
+int fireBullet(BulletPool* pool, SDL_Rect body, Fixed direction, int owner, bool isExplosionBullet) {
+    int index = allocateBullet(pool);
+    if (isExplosionBullet) {
+        pool->flags[index] |= BULLET_EXPLOSION;
+    }
+    pool->owner[index] = (uint8_t)owner;
+    pool->rotation[index] = direction;
+
+    // Direction is fixed for the bullet's lifetime, so the table lookups happen once here
+    pool->velocityX[index] = BULLET_SPEED * fixedSin(direction);
+    pool->velocityY[index] = -(BULLET_SPEED * fixedCos(direction));
+
+    // Position bullet at tank center
+    pool->x[index] = fixedFromInt(body.x + body.w/2 - BULLET_WIDTH/2);
+    pool->y[index] = fixedFromInt(body.y + body.h/2 - BULLET_HEIGHT/2);
+    pool->prevX[index] = pool->x[index];
+    pool->prevY[index] = pool->y[index];
+    return index;
+}
+
+// Function to flag the bullets out of bounds in a SIMD lane mask (returns how many)
+static int flagLanes(BulletPool* pool, int base, int mask, int lanes) {
+    int flagged = 0;
+    for (int lane = 0; lane < lanes; lane++) {
+        if ((mask & (1 << lane)) && isBulletActive(pool, base + lane)) {
+            pool->flags[base + lane] |= BULLET_CULLED;
+            flagged++;
+        }
+    }
+    return flagged;
+}
+
+// Function to advance bullets [begin, end) one tick and flag the ones that had already left the area
+int advanceBullets(BulletPool* pool, int begin, int end, Fixed maxX, Fixed maxY) {
+    Fixed* x = pool->x.data();
+    Fixed* y = pool->y.data();
+    Fixed* prevX = pool->prevX.data();
+    Fixed* prevY = pool->prevY.data();
+    const Fixed* velocityX = pool->velocityX.data();
+    const Fixed* velocityY = pool->velocityY.data();
+    int i = begin;
+    int flagged = 0;
+
+    // Inactive slots are updated too (their velocity is zero) and never flagged
+
+#ifdef BULLET_POOL_AVX2
+    const __m256i zero8 = _mm256_setzero_si256();
+    const __m256i maxX8 = _mm256_set1_epi32(maxX.raw);
+    const __m256i maxY8 = _mm256_set1_epi32(maxY.raw);
+    for (; i + 8 <= end; i += 8) {
+        __m256i px = _mm256_loadu_si256((const __m256i*)(x + i));
+        __m256i py = _mm256_loadu_si256((const __m256i*)(y + i));
+        __m256i vx = _mm256_loadu_si256((const __m256i*)(velocityX + i));
+        __m256i vy = _mm256_loadu_si256((const __m256i*)(velocityY + i));
+        _mm256_storeu_si256((__m256i*)(prevX + i), px);
+        _mm256_storeu_si256((__m256i*)(prevY + i), py);
+        _mm256_storeu_si256((__m256i*)(x + i), _mm256_add_epi32(px, vx));
+        _mm256_storeu_si256((__m256i*)(y + i), _mm256_add_epi32(py, vy));
+
+        __m256i outside = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi32(zero8, px), _mm256_cmpgt_epi32(px, maxX8)),
+            _mm256_or_si256(_mm256_cmpgt_epi32(zero8, py), _mm256_cmpgt_epi32(py, maxY8)));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(outside));
+        if (mask) {
+            flagged += flagLanes(pool, i, mask, 8);
+        }
+    }
+#endif
+
+#ifdef BULLET_POOL_SSE2
+    const __m128i zero4 = _mm_setzero_si128();
+    const __m128i maxX4 = _mm_set1_epi32(maxX.raw);
+    const __m128i maxY4 = _mm_set1_epi32(maxY.raw);
+    for (; i + 4 <= end; i += 4) {
+        __m128i px = _mm_loadu_si128((const __m128i*)(x + i));
+        __m128i py = _mm_loadu_si128((const __m128i*)(y + i));
+        __m128i vx = _mm_loadu_si128((const __m128i*)(velocityX + i));
+        __m128i vy = _mm_loadu_si128((const __m128i*)(velocityY + i));
+        _mm_storeu_si128((__m128i*)(prevX + i), px);
+        _mm_storeu_si128((__m128i*)(prevY + i), py);
+        _mm_storeu_si128((__m128i*)(x + i), _mm_add_epi32(px, vx));
+        _mm_storeu_si128((__m128i*)(y + i), _mm_add_epi32(py, vy));
+
+        __m128i outside = _mm_or_si128(
+            _mm_or_si128(_mm_cmplt_epi32(px, zero4), _mm_cmpgt_epi32(px, maxX4)),
+            _mm_or_si128(_mm_cmplt_epi32(py, zero4), _mm_cmpgt_epi32(py, maxY4)));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(outside));
+        if (mask) {
+            flagged += flagLanes(pool, i, mask, 4);
+        }
+    }
+#endif
+
+    // Remaining bullets (or everything without SIMD)
+    for (; i < end; i++) {
+        prevX[i] = x[i];
+        prevY[i] = y[i];
+        x[i] += velocityX[i];
+        y[i] += velocityY[i];
+        if ((prevX[i].raw < 0 || prevX[i] > maxX || prevY[i].raw < 0 || prevY[i] > maxY) && isBulletActive(pool, i)) {
+            pool->flags[i] |= BULLET_CULLED;
+            flagged++;
+        }
+    }
+    return flagged;
+}
+
+// Function to release every flagged bullet, lowest slot first
+void cullBullets(BulletPool* pool) {
+    int count = (int)pool->flags.size();
+    for (int i = 0; i < count; i++) {
+        if (pool->flags[i] & BULLET_CULLED) {
+            releaseBullet(pool, i);
+        }
+    }
+}
+
+// Function to advance every bullet one tick and cull the ones that had already left the area
+void updateBullets(BulletPool* pool, Fixed maxX, Fixed maxY) {
+    if (advanceBullets(pool, 0, (int)pool->x.size(), maxX, maxY) > 0) {
+        cullBullets(pool);
+    }
+}
+
+// Function to get a bullet's collision rect, or its rect blended between ticks
+SDL_Rect getBulletRect(const BulletPool* pool, int index, float alpha) {
+    Fixed blend = fixedFromFloat(alpha);
+    SDL_Rect rect;
+    rect.x = fixedFloor(pool->prevX[index] + (pool->x[index] - pool->prevX[index]) * blend);
+    rect.y = fixedFloor(pool->prevY[index] + (pool->y[index] - pool->prevY[index]) * blend);
+    rect.w = BULLET_WIDTH;
+    rect.h = BULLET_HEIGHT;
+    return rect;
+}
+
+// Function to send a bullet back the way it came and hand it to the tank that reflected it
+void reflectBullet(BulletPool* pool, int index, int newOwner) {
+    // Reverse the bullet direction
+    pool->rotation[index] += fixedFromInt(180);
+    if (pool->rotation[index] >= fixedFromInt(360)) {
+        pool->rotation[index] -= fixedFromInt(360);
+    }
+    pool->velocityX[index] = -pool->velocityX[index];
+    pool->velocityY[index] = -pool->velocityY[index];
+
+    // Change ownership to the shielded tank
+    pool->owner[index] = (uint8_t)newOwner;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+// Structure-of-arrays projectile pool. Each bullet field lives in its
+// own array so the per-tick update streams through memory and runs as a
+// SIMD kernel (integer lanes, as positions are Fixed). Free slots are
+// kept on a free list, so firing and releasing a bullet are O(1), and
+// the pool grows when it runs out.
+
+#include "game.h"
+#include <cstdint>
+#include <vector>
+
+// Bullet size and speed (pixels per tick)
+const int BULLET_WIDTH = 8;
+const int BULLET_HEIGHT = 10;
+const Fixed BULLET_SPEED = fixedFromInt(2);
+
+// Slots reserved up front so normal matches never reallocate
+const int BULLET_POOL_CAPACITY = 64;
+
+// Bullet flags
+const uint8_t BULLET_ACTIVE = 1;
+const uint8_t BULLET_EXPLOSION = 2; // Explosion bullet (3x damage)
+const uint8_t BULLET_CULLED = 4; // Left the area, released by cullBullets()
+
+// Structure for all bullets of a match; index i is one bullet across every array
+struct BulletPool {
+    std::vector<Fixed> x; // Top-left position with sub-pixel precision
+    std::vector<Fixed> y;
+    std::vector<Fixed> prevX; // Position at the previous tick (render interpolation)
+    std::vector<Fixed> prevY;
+    std::vector<Fixed> velocityX; // Movement per tick, computed once when fired
+    std::vector<Fixed> velocityY;
+    std::vector<Fixed> rotation; // Direction in degrees (for drawing)
+    std::vector<uint8_t> owner; // Index of the tank that fired (or last reflected) the bullet
+    std::vector<uint8_t> flags; // BULLET_ACTIVE | BULLET_EXPLOSION | BULLET_CULLED
+    std::vector<int> freeList; // Inactive slots ready for reuse
+    int liveCount;
+};
+
+// Function to empty the pool and reserve capacity
+void initializeBulletPool(BulletPool* pool, int capacity = BULLET_POOL_CAPACITY);
+
+// Function to get a free slot (grows the pool when needed)
+int allocateBullet(BulletPool* pool);
+
+// Function to deactivate a bullet and return its slot to the free list
+void releaseBullet(BulletPool* pool, int index);
+
+// Function to check if a slot holds a bullet in flight
+inline bool isBulletActive(const BulletPool* pool, int index) {
+    return (pool->flags[index] & BULLET_ACTIVE) != 0;
+}
+
+// Function to fire a bullet from the center of a tank body in a direction
+// (degrees, 0 = up); owner is the firing tank's index
+int fireBullet(BulletPool* pool, SDL_Rect body, Fixed direction, int owner, bool isExplosionBullet = false);
+
+// Function to advance every bullet one tick and cull the ones that had
+// already left the (0,0)-(maxX,maxY) area, so a bullet's last move out of
+// the area is still swept for hits
+void updateBullets(BulletPool* pool, Fixed maxX, Fixed maxY);
+
+// The two halves of updateBullets(), for running the advance in parallel
+// chunks: advanceBullets() moves bullets [begin, end) and only flags the
+// ones to cull (returns how many), cullBullets() then releases every
+// flagged bullet in slot order, so the free list ends up the same as
+// with updateBullets()
+int advanceBullets(BulletPool* pool, int begin, int end, Fixed maxX, Fixed maxY);
+void cullBullets(BulletPool* pool);
+
+// Function to get a bullet's collision rect, or the rect blended between
+// the previous and current tick when alpha < 1
+SDL_Rect getBulletRect(const BulletPool* pool, int index, float alpha = 1.0f);
+
+// Function to send a bullet back the way it came and hand it to the tank that reflected it
+void reflectBullet(BulletPool* pool, int index, int newOwner);
@@ -0,0 +1,84 @@
+#include "camera.h"
+#include <algorithm>
+#include <cmath>
+
+// Function to set up a camera for a screen and world size
+void initializeCamera(Camera* camera, int viewWidth, int viewHeight, int worldWidth, int worldHeight) {
+    camera->viewWidth = viewWidth;
+    camera->viewHeight = viewHeight;
+    camera->worldWidth = worldWidth;
+    camera->worldHeight = worldHeight;
+    camera->centerX = worldWidth / 2.0f;
+    camera->centerY = worldHeight / 2.0f;
+    camera->zoom = CAMERA_MAX_ZOOM;
+}
+
+// Function to clamp the center so the view stays inside the world (centered when the world is smaller)
+static float clampCameraAxis(float center, float viewSpan, float worldSpan) {
+    if (viewSpan >= worldSpan) return worldSpan / 2.0f;
+    return std::max(viewSpan / 2.0f, std::min(worldSpan - viewSpan / 2.0f, center));
+}
+
+// Function to find the center and zoom that frame both focus rects
+static void getCameraTarget(const Camera* camera, SDL_Rect focusA, SDL_Rect focusB, float* centerX, float* centerY,
+                            float* zoom) {
+    float left = (float)std::min(focusA.x, focusB.x);
+    float top = (float)std::min(focusA.y, focusB.y);
+    float right = (float)std::max(focusA.x + focusA.w, focusB.x + focusB.w);
+    float bottom = (float)std::max(focusA.y + focusA.h, focusB.y + focusB.h);
+
+    // Zoom out just enough for both rects plus the margin, but never so far
+    // that the view is larger than the world
+    float fitX = (camera->viewWidth - 2.0f * CAMERA_FOCUS_MARGIN) / std::max(1.0f, right - left);
+    float fitY = (camera->viewHeight - 2.0f * CAMERA_FOCUS_MARGIN) / std::max(1.0f, bottom - top);
+    float minZoom = std::max(CAMERA_MIN_ZOOM, std::max((float)camera->viewWidth / camera->worldWidth,
+                                                       (float)camera->viewHeight / camera->worldHeight));
+    *zoom = std::max(std::min(minZoom, CAMERA_MAX_ZOOM), std::min(CAMERA_MAX_ZOOM, std::min(fitX, fitY)));
+
+    *centerX = clampCameraAxis((left + right) / 2.0f, camera->viewWidth / *zoom, (float)camera->worldWidth);
+    *centerY = clampCameraAxis((top + bottom) / 2.0f, camera->viewHeight / *zoom, (float)camera->worldHeight);
+}
+
+// Function to jump straight to the view that frames both focus rects
+void snapCamera(Camera* camera, SDL_Rect focusA, SDL_Rect focusB) {
+    getCameraTarget(camera, focusA, focusB, &camera->centerX, &camera->centerY, &camera->zoom);
+}
+
+// Function to move the camera towards the view that frames both focus rects
+void updateCamera(Camera* camera, SDL_Rect focusA, SDL_Rect focusB, float deltaTime) {
+    float centerX, centerY, zoom;
+    getCameraTarget(camera, focusA, focusB, &centerX, &centerY, &zoom);
+
+    // Exponential approach, the same feel at any frame rate
+    float blend = 1.0f - std::exp(-CAMERA_FOLLOW_RATE * deltaTime);
+    camera->zoom += (zoom - camera->zoom) * blend;
+    camera->centerX += (centerX - camera->centerX) * blend;
+    camera->centerY += (centerY - camera->centerY) * blend;
+
+    // Blending center and zoom separately can leave the edge of the view outside the world
+    camera->centerX = clampCameraAxis(camera->centerX, camera->viewWidth / camera->zoom, (float)camera->worldWidth);
+    camera->centerY = clampCameraAxis(camera->centerY, camera->viewHeight / camera->zoom, (float)camera->worldHeight);
+}
+
+// Function to get the part of the world on screen
+SDL_Rect getCameraView(const Camera* camera) {
+    float width = camera->viewWidth / camera->zoom;
+    float height = camera->viewHeight / camera->zoom;
+    SDL_Rect view = {(int)std::floor(camera->centerX - width / 2.0f), (int)std::floor(camera->centerY - height / 2.0f),
+                     (int)std::ceil(width) + 1, (int)std::ceil(height) + 1};
+    return view;
+}
+
+// Function to convert a world rect to screen pixels
+SDL_Rect worldToScreen(const Camera* camera, SDL_Rect rect) {
+    float originX = camera->centerX - camera->viewWidth / (2.0f * camera->zoom);
+    float originY = camera->centerY - camera->viewHeight / (2.0f * camera->zoom);
+
+    // Round both edges so neighbouring rects stay seamless when zoomed
+    int left = (int)std::lround((rect.x - originX) * camera->zoom);
+    int top = (int)std::lround((rect.y - originY) * camera->zoom);
+    int right = (int)std::lround((rect.x + rect.w - originX) * camera->zoom);
+    int bottom = (int)std::lround((rect.y + rect.h - originY) * camera->zoom);
+    SDL_Rect screen = {left, top, right - left, bottom - top};
+    return screen;
+}
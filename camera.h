@@ -0,0 +1,45 @@
+#pragma once
+
+// Viewport onto the arena. The camera keeps both tanks in view: it
+// centers on the point between them and zooms out (down to
+// CAMERA_MIN_ZOOM) when they are further apart than the screen. It never
+// shows anything outside the world. Everything drawn in world space goes
+// through worldToScreen; the HUD is drawn in screen space as before.
+
+#include <SDL2/SDL.h>
+
+// Zoom limits (1 = one world pixel per screen pixel)
+const float CAMERA_MIN_ZOOM = 0.5f;
+const float CAMERA_MAX_ZOOM = 1.0f;
+
+// Space kept between the tanks and the screen edge (screen pixels)
+const float CAMERA_FOCUS_MARGIN = 160.0f;
+
+// How quickly the camera catches up with its target (per second)
+const float CAMERA_FOLLOW_RATE = 6.0f;
+
+// Structure for the camera
+struct Camera {
+    float centerX; // World point at the center of the screen
+    float centerY;
+    float zoom;
+    int viewWidth; // Screen size in pixels
+    int viewHeight;
+    int worldWidth;
+    int worldHeight;
+};
+
+// Function to set up a camera for a screen and world size, looking at the world's center
+void initializeCamera(Camera* camera, int viewWidth, int viewHeight, int worldWidth, int worldHeight);
+
+// Function to jump straight to the view that frames both focus rects
+void snapCamera(Camera* camera, SDL_Rect focusA, SDL_Rect focusB);
+
+// Function to move the camera towards the view that frames both focus rects
+void updateCamera(Camera* camera, SDL_Rect focusA, SDL_Rect focusB, float deltaTime);
+
+// Function to get the part of the world on screen (world pixels)
+SDL_Rect getCameraView(const Camera* camera);
+
+// Function to convert a world rect to screen pixels
+SDL_Rect worldToScreen(const Camera* camera, SDL_Rect rect);
@@ -0,0 +1,66 @@
+#include "fixed_math.h"
+#include <cmath>
+
+// Structure for sin(0) to sin(90 degrees) in FIXED_SINE_STEPS + 1 entries
+struct SineTable {
+    int32_t values[FIXED_SINE_STEPS + 1];
+};
+
+// Function to fill the sine table with a Taylor series in Q30 integer
+// arithmetic, so the table does not depend on the compiler's or the
+// platform's floating point (terms past x^17 / 17! are below 1/65536)
+static constexpr SineTable buildSineTable() {
+    const int64_t ONE = (int64_t)1 << 30;
+    const int64_t HALF_PI = 1686629713; // pi / 2 in Q30
+    SineTable table = {};
+    for (int i = 0; i <= FIXED_SINE_STEPS; i++) {
+        int64_t x = HALF_PI * i / FIXED_SINE_STEPS;
+        int64_t term = x; // Magnitude of x^(2k+1) / (2k+1)!
+        int64_t sum = x;
+        for (int k = 1; k <= 8; k++) {
+            term = ((term * x) / ONE) * x / ONE / ((2 * k) * (2 * k + 1));
+            sum += (k & 1) ? -term : term;
+        }
+        table.values[i] = (int32_t)((sum + (ONE >> (FIXED_SHIFT + 1))) >> (30 - FIXED_SHIFT));
+    }
+    return table;
+}
+
+static constexpr SineTable SINE_TABLE = buildSineTable();
+
+static_assert(SINE_TABLE.values[0] == 0 && SINE_TABLE.values[FIXED_SINE_STEPS] == FIXED_ONE_RAW,
+              "Sine table must be exact at 0 and 90 degrees");
+
+// Function to convert a float from outside the simulation
+Fixed fixedFromFloat(float value) {
+    return fixedSaturate(std::llround((double)value * FIXED_ONE_RAW));
+}
+
+// Function to get the sine of an angle in degrees
+Fixed fixedSin(Fixed degrees) {
+    // Position on the circle in table steps, with 16 bits of fraction; a
+    // full turn is a power of two, so masking wraps negative angles too
+    const int64_t TURN = (int64_t)FIXED_SINE_STEPS * 4 << FIXED_SHIFT;
+    int64_t position = ((int64_t)degrees.raw * (FIXED_SINE_STEPS * 4) / 360) & (TURN - 1);
+    int step = (int)(position >> FIXED_SHIFT);
+    int32_t fraction = (int32_t)(position & (FIXED_ONE_RAW - 1));
+    int quarter = step / FIXED_SINE_STEPS;
+    int index = step % FIXED_SINE_STEPS;
+
+    // Mirror the first quarter onto the other three
+    int32_t from, to;
+    if (quarter == 0 || quarter == 2) {
+        from = SINE_TABLE.values[index];
+        to = SINE_TABLE.values[index + 1];
+    } else {
+        from = SINE_TABLE.values[FIXED_SINE_STEPS - index];
+        to = SINE_TABLE.values[FIXED_SINE_STEPS - index - 1];
+    }
+    int32_t value = from + (int32_t)(((int64_t)(to - from) * fraction) >> FIXED_SHIFT);
+    return Fixed{quarter >= 2 ? -value : value};
+}
+
+// Function to get the cosine of an angle in degrees
+Fixed fixedCos(Fixed degrees) {
+    return fixedSin(degrees + fixedFromInt(90));
+}
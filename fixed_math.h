@@ -0,0 +1,130 @@
+#pragma once
+
+// Fixed-point numbers for the simulation. Floating-point results can
+// differ between compilers, optimization flags and CPUs (contraction into
+// fused multiply-adds, x87 precision, libm trig), which would make two
+// builds play the same inputs out differently. Fixed values are plain
+// 32-bit integers with 16 fraction bits (Q16.16: -32768 to 32767.99998,
+// steps of 1/65536), so every operation gives the same bits everywhere.
+//
+// Angles are Fixed degrees (0 = up, clockwise, like the rest of the game).
+// fixedSin() and fixedCos() read a table built from integer arithmetic
+// when the program is compiled, so there is no libm call behind them.
+//
+// Floats remain for drawing, timing and bots (whose choices reach the
+// simulation only as inputs): convert with fixedFromFloat() and
+// fixedToFloat() at that boundary, never inside a tick.
+
+#include <cstdint>
+#include <type_traits>
+
+// Fraction bits
+const int FIXED_SHIFT = 16;
+const int32_t FIXED_ONE_RAW = 1 << FIXED_SHIFT;
+
+// Structure for one fixed-point number
+struct Fixed {
+    int32_t raw; // Value times 65536
+};
+
+static_assert(sizeof(Fixed) == 4 && std::is_trivially_copyable<Fixed>::value,
+              "Fixed arrays are copied and run through SIMD kernels as int32");
+
+// Function to make a Fixed from its raw bits
+constexpr Fixed fixedFromRaw(int32_t raw) {
+    return Fixed{raw};
+}
+
+// Function to make a Fixed from a whole number
+constexpr Fixed fixedFromInt(int value) {
+    return Fixed{value * FIXED_ONE_RAW};
+}
+
+// Function to make a Fixed from numerator / denominator, rounded to the nearest step (constants)
+constexpr Fixed fixedFromRatio(int numerator, int denominator) {
+    return Fixed{(int32_t)(((int64_t)numerator * FIXED_ONE_RAW * 2 + denominator) / (2 * (int64_t)denominator))};
+}
+
+// Largest value (bounds that are never reached)
+const Fixed FIXED_MAX = {INT32_MAX};
+
+// Function to convert a float from outside the simulation (map files, bots, drawing)
+Fixed fixedFromFloat(float value);
+
+// Function to convert to float for drawing and logs
+inline float fixedToFloat(Fixed value) {
+    return value.raw * (1.0f / FIXED_ONE_RAW);
+}
+
+// Function to round down to a whole number
+inline int fixedFloor(Fixed value) {
+    return value.raw >> FIXED_SHIFT;
+}
+
+// Function to round up to a whole number
+inline int fixedCeil(Fixed value) {
+    return (int)(((int64_t)value.raw + FIXED_ONE_RAW - 1) >> FIXED_SHIFT);
+}
+
+// Function to clamp a 64-bit intermediate back into range
+inline Fixed fixedSaturate(int64_t raw) {
+    return Fixed{(int32_t)(raw > INT32_MAX ? INT32_MAX : raw < INT32_MIN ? INT32_MIN : raw)};
+}
+
+inline Fixed operator+(Fixed a, Fixed b) {
+    return Fixed{a.raw + b.raw};
+}
+
+inline Fixed operator-(Fixed a, Fixed b) {
+    return Fixed{a.raw - b.raw};
+}
+
+inline Fixed operator-(Fixed a) {
+    return Fixed{-a.raw};
+}
+
+// Products round towards negative infinity
+inline Fixed operator*(Fixed a, Fixed b) {
+    return Fixed{(int32_t)(((int64_t)a.raw * b.raw) >> FIXED_SHIFT)};
+}
+
+inline Fixed operator*(Fixed a, int b) {
+    return Fixed{a.raw * b};
+}
+
+// Quotients round towards zero and saturate (a tiny divisor gives the largest value, not garbage)
+inline Fixed operator/(Fixed a, Fixed b) {
+    if (b.raw == 0) return a.raw < 0 ? Fixed{INT32_MIN} : FIXED_MAX;
+    return fixedSaturate(((int64_t)a.raw * FIXED_ONE_RAW) / b.raw);
+}
+
+inline Fixed& operator+=(Fixed& a, Fixed b) {
+    a.raw += b.raw;
+    return a;
+}
+
+inline Fixed& operator-=(Fixed& a, Fixed b) {
+    a.raw -= b.raw;
+    return a;
+}
+
+inline bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+inline bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+inline bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+inline bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+inline bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+inline bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+// Function to get the absolute value
+inline Fixed fixedAbs(Fixed value) {
+    return Fixed{value.raw < 0 ? -value.raw : value.raw};
+}
+
+// Table steps per quarter turn (about 0.09 degrees; lookups interpolate between steps)
+const int FIXED_SINE_STEPS = 1024;
+
+// Function to get the sine of an angle in degrees (exact at multiples of 90)
+Fixed fixedSin(Fixed degrees);
+
+// Function to get the cosine of an angle in degrees
+Fixed fixedCos(Fixed degrees);
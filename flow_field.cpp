@@ -0,0 +1,276 @@
+#include "flow_field.h"
+#include "log.h"
+#include <algorithm>
+
+// Neighbour offsets in facing order (up, right, down, left)
+static const int FLOW_STEP_X[4] = {0, 1, 0, -1};
+static const int FLOW_STEP_Y[4] = {-1, 0, 1, 0};
+
+// Function to get the agent box centered on a cell
+static SDL_Rect getNavAgentRect(const NavGrid* grid, int column, int row) {
+    int centerX = column * grid->cellSize + grid->cellSize / 2;
+    int centerY = row * grid->cellSize + grid->cellSize / 2;
+    SDL_Rect rect = {centerX - grid->agentWidth / 2, centerY - grid->agentHeight / 2, grid->agentWidth,
+                     grid->agentHeight};
+    return rect;
+}
+
+// Function to check if two rects overlap (touching edges do not count, like tank collisions)
+static bool rectsOverlap(SDL_Rect a, SDL_Rect b) {
+    return a.x < b.x + b.w && a.x + a.w > b.x && a.y < b.y + b.h && a.y + a.h > b.y;
+}
+
+// Function to add delta to the blocker count of every cell whose agent box overlaps rect
+static void countNavObstacle(NavGrid* grid, SDL_Rect rect, int delta) {
+    // Agent boxes reach at most half an agent past their cell, so a margin of one agent is enough
+    int firstColumn = std::max(0, (rect.x - grid->agentWidth) / grid->cellSize);
+    int lastColumn = std::min(grid->columns - 1, (rect.x + rect.w + grid->agentWidth) / grid->cellSize);
+    int firstRow = std::max(0, (rect.y - grid->agentHeight) / grid->cellSize);
+    int lastRow = std::min(grid->rows - 1, (rect.y + rect.h + grid->agentHeight) / grid->cellSize);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            if (!rectsOverlap(getNavAgentRect(grid, column, row), rect)) continue;
+
+            int cell = row * grid->columns + column;
+            if (delta > 0) {
+                grid->blockers[cell]++;
+            } else if (grid->blockers[cell] > 0 && --grid->blockers[cell] == 0) {
+                grid->openedCells.push_back(cell);
+            }
+        }
+    }
+}
+
+// Function to (re)build the nav grid from the obstacle arrays (skips destroyed objects)
+void buildNavGrid(NavGrid* grid, const GameObject* grassObjects, const GameObject* rockObjects, int grassCount,
+                  int rockCount, int mapWidth, int mapHeight, int agentWidth, int agentHeight) {
+    // A path never has more steps than the grid has cells, so fewer cells
+    // than FLOW_UNREACHABLE keeps every distance in 16 bits
+    int cellSize = NAV_CELL_SIZE;
+    while ((long long)((mapWidth + cellSize - 1) / cellSize) * ((mapHeight + cellSize - 1) / cellSize) >=
+           FLOW_UNREACHABLE) {
+        cellSize *= 2;
+    }
+
+    grid->cellSize = cellSize;
+    grid->columns = std::max(1, (mapWidth + cellSize - 1) / cellSize);
+    grid->rows = std::max(1, (mapHeight + cellSize - 1) / cellSize);
+    grid->agentWidth = agentWidth;
+    grid->agentHeight = agentHeight;
+    grid->blockers.assign((size_t)grid->columns * grid->rows, 0);
+    grid->openedCells.clear();
+    grid->closedCount = 0;
+
+    // Cells too close to the edge for the agent count one blocker that never goes away
+    for (int row = 0; row < grid->rows; row++) {
+        for (int column = 0; column < grid->columns; column++) {
+            SDL_Rect rect = getNavAgentRect(grid, column, row);
+            if (rect.x < 0 || rect.y < 0 || rect.x + rect.w > mapWidth || rect.y + rect.h > mapHeight) {
+                grid->blockers[row * grid->columns + column] = 1;
+            }
+        }
+    }
+
+    for (int i = 0; i < grassCount; i++) {
+        if (!grassObjects[i].isDestroyed) countNavObstacle(grid, grassObjects[i].rect, 1);
+    }
+    for (int i = 0; i < rockCount; i++) {
+        if (!rockObjects[i].isDestroyed) countNavObstacle(grid, rockObjects[i].rect, 1);
+    }
+
+    int passable = (int)std::count(grid->blockers.begin(), grid->blockers.end(), 0);
+    LOG_INFO("[NAV] %dx%d cells of %d px, %d passable", grid->columns, grid->rows, cellSize, passable);
+}
+
+// Function to take a destroyed obstacle off the nav grid, logging the cells it opened
+void openNavObstacle(NavGrid* grid, SDL_Rect obstacle) {
+    countNavObstacle(grid, obstacle, -1);
+}
+
+// Function to put a destroyed obstacle back on the nav grid. Distances
+// can grow again, which a repair cannot follow, so fields are rebuilt.
+void closeNavObstacle(NavGrid* grid, SDL_Rect obstacle) {
+    countNavObstacle(grid, obstacle, 1);
+    grid->closedCount++;
+}
+
+// Function to get the cell under a point (-1 outside the arena)
+int getNavCell(const NavGrid* grid, float x, float y) {
+    if (x < 0.0f || y < 0.0f) return -1;
+    int column = (int)x / grid->cellSize;
+    int row = (int)y / grid->cellSize;
+    if (column >= grid->columns || row >= grid->rows) return -1;
+    return row * grid->columns + column;
+}
+
+// Function to spread distances from the cells queued in the field to
+// every passable cell they shorten the way for
+static void spreadFlowField(FlowField* field, const NavGrid* grid) {
+    uint16_t* distance = field->distance.data();
+    const uint16_t* blockers = grid->blockers.data();
+
+    // From one seed this is a plain breadth-first search. A repair seeds
+    // several cells at different distances, so a cell may be lowered more
+    // than once, but only cells that actually get closer are touched.
+    for (size_t head = 0; head < field->queue.size(); head++) {
+        int cell = field->queue[head];
+        int column = cell % grid->columns;
+        int row = cell / grid->columns;
+        uint16_t next = distance[cell] + 1;
+
+        for (int step = 0; step < 4; step++) {
+            int neighbourColumn = column + FLOW_STEP_X[step];
+            int neighbourRow = row + FLOW_STEP_Y[step];
+            if (neighbourColumn < 0 || neighbourColumn >= grid->columns || neighbourRow < 0 ||
+                neighbourRow >= grid->rows) {
+                continue;
+            }
+
+            int neighbour = neighbourRow * grid->columns + neighbourColumn;
+            if (blockers[neighbour] == 0 && distance[neighbour] > next) {
+                distance[neighbour] = next;
+                field->queue.push_back(neighbour);
+            }
+        }
+    }
+    field->queue.clear();
+}
+
+// Function to compute a flow field towards targetCell from scratch
+void buildFlowField(FlowField* field, const NavGrid* grid, int targetCell) {
+    field->targetCell = targetCell;
+    field->openedSeen = grid->openedCells.size();
+    field->closedSeen = grid->closedCount;
+    field->distance.assign(grid->blockers.size(), FLOW_UNREACHABLE);
+    field->queue.clear();
+    if (targetCell < 0) return;
+
+    // The target itself may be blocked (a tank hugging a rock); the search still starts there
+    field->distance[targetCell] = 0;
+    field->queue.push_back(targetCell);
+    spreadFlowField(field, grid);
+}
+
+// Function to bring a flow field up to date with the cells opened since it was built
+void repairFlowField(FlowField* field, const NavGrid* grid) {
+    if (field->openedSeen >= grid->openedCells.size()) return;
+
+    // Each opened cell takes one more step than its closest neighbour. An
+    // opened cell with no reached neighbour yet is picked up by the spread
+    // once a neighbouring opened cell gets its distance.
+    uint16_t* distance = field->distance.data();
+    for (size_t i = field->openedSeen; i < grid->openedCells.size(); i++) {
+        int cell = grid->openedCells[i];
+        int column = cell % grid->columns;
+        int row = cell / grid->columns;
+
+        uint16_t best = FLOW_UNREACHABLE;
+        for (int step = 0; step < 4; step++) {
+            int neighbourColumn = column + FLOW_STEP_X[step];
+            int neighbourRow = row + FLOW_STEP_Y[step];
+            if (neighbourColumn < 0 || neighbourColumn >= grid->columns || neighbourRow < 0 ||
+                neighbourRow >= grid->rows) {
+                continue;
+            }
+            best = std::min(best, distance[neighbourRow * grid->columns + neighbourColumn]);
+        }
+
+        if (best != FLOW_UNREACHABLE && best + 1 < distance[cell]) {
+            distance[cell] = best + 1;
+            field->queue.push_back(cell);
+        }
+    }
+    field->openedSeen = grid->openedCells.size();
+    spreadFlowField(field, grid);
+}
+
+// Function to drop every cached flow field (call when the nav grid is rebuilt)
+void clearFlowFieldCache(FlowFieldCache* cache) {
+    cache->fields.clear();
+    cache->clock = 0;
+    cache->roundStart = 1;
+    cache->builds = 0;
+    cache->repairs = 0;
+}
+
+// Function to get the cached flow field towards targetCell without building one (NULL if none)
+const FlowField* findFlowField(const FlowFieldCache* cache, int targetCell) {
+    for (const FlowField& field : cache->fields) {
+        if (field.targetCell == targetCell) return &field;
+    }
+    return NULL;
+}
+
+// Function to get an up-to-date flow field towards targetCell, building it if needed
+const FlowField* getFlowField(FlowFieldCache* cache, const NavGrid* grid, int targetCell) {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->clock++;
+    FlowField* field = const_cast<FlowField*>(findFlowField(cache, targetCell));
+
+    if (field != NULL && field->distance.size() == grid->blockers.size() &&
+        field->openedSeen <= grid->openedCells.size() && field->closedSeen == grid->closedCount) {
+        if (field->openedSeen < grid->openedCells.size()) {
+            repairFlowField(field, grid);
+            cache->repairs++;
+        }
+    } else {
+        if (field == NULL && (int)cache->fields.size() >= FLOW_FIELD_CACHE_SIZE) {
+            // Replace the field that went unused the longest, unless every
+            // field is in use this round
+            for (FlowField& candidate : cache->fields) {
+                if (candidate.lastUsed < cache->roundStart && (field == NULL || candidate.lastUsed < field->lastUsed)) {
+                    field = &candidate;
+                }
+            }
+        }
+        if (field == NULL) {
+            cache->fields.emplace_back();
+            field = &cache->fields.back();
+        }
+        buildFlowField(field, grid, targetCell);
+        cache->builds++;
+    }
+
+    field->lastUsed = cache->clock;
+    return field;
+}
+
+// Function to end a round and drop the least recently used fields beyond the cache size
+void trimFlowFieldCache(FlowFieldCache* cache) {
+    while ((int)cache->fields.size() > FLOW_FIELD_CACHE_SIZE) {
+        auto oldest = cache->fields.begin();
+        for (auto it = cache->fields.begin(); it != cache->fields.end(); ++it) {
+            if (it->lastUsed < oldest->lastUsed) oldest = it;
+        }
+        cache->fields.erase(oldest);
+    }
+    cache->roundStart = cache->clock + 1;
+}
+
+// Function to get the step to take from a cell (-1 at the target or when it cannot be reached)
+int getFlowDirection(const FlowField* field, const NavGrid* grid, int cell) {
+    if (cell < 0 || cell == field->targetCell) return -1;
+
+    // Downhill to the closest neighbour; from a blocked cell (its distance
+    // is unknown) any reachable neighbour leads back onto the field
+    int column = cell % grid->columns;
+    int row = cell / grid->columns;
+    int bestStep = -1;
+    uint16_t bestDistance = field->distance[cell];
+    for (int step = 0; step < 4; step++) {
+        int neighbourColumn = column + FLOW_STEP_X[step];
+        int neighbourRow = row + FLOW_STEP_Y[step];
+        if (neighbourColumn < 0 || neighbourColumn >= grid->columns || neighbourRow < 0 ||
+            neighbourRow >= grid->rows) {
+            continue;
+        }
+
+        uint16_t distance = field->distance[neighbourRow * grid->columns + neighbourColumn];
+        if (distance < bestDistance) {
+            bestStep = step;
+            bestDistance = distance;
+        }
+    }
+    return bestStep;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+// Navigation over the obstacle map. The NavGrid splits the arena into
+// cells and marks a cell passable when a tank centered on it would touch
+// no obstacle. A FlowField holds, for every cell, the number of steps
+// (up, down, left or right, the moves a tank has) to one target cell, so
+// any number of agents heading to the same target share one field and
+// each only looks up its next step.
+//
+// Obstacles never appear during a match, they only get destroyed. When
+// one goes, the NavGrid logs the cells it opened and every flow field
+// repairs itself from that log the next time it is used: distances can
+// only shrink, so only the cells that got closer are visited again. The
+// one exception, a rollback putting an obstacle back, makes every field
+// rebuild.
+
+#include "game.h"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Default cell size in pixels (grown on huge maps to keep distances in 16 bits)
+const int NAV_CELL_SIZE = 32;
+
+// Distance of a cell the target cannot be reached from
+const uint16_t FLOW_UNREACHABLE = 0xFFFF;
+
+// Flow fields kept at once (least recently used is rebuilt for a new target)
+const int FLOW_FIELD_CACHE_SIZE = 8;
+
+// Structure for which cells of the arena an agent can stand on
+struct NavGrid {
+    int cellSize;
+    int columns;
+    int rows;
+    int agentWidth; // Box that must fit centered on a passable cell
+    int agentHeight;
+    std::vector<uint16_t> blockers; // Obstacles (and the arena edge) a centered agent would touch, 0 = passable
+    std::vector<int> openedCells; // Cells that became passable this match, in order
+    int closedCount; // Obstacles put back (rollback), fields built before a change are rebuilt
+};
+
+// Structure for the step count from every cell to one target cell
+struct FlowField {
+    int targetCell;
+    size_t openedSeen; // Entries of the nav grid's openedCells already applied
+    int closedSeen; // Nav grid's closedCount when the field was built
+    uint32_t lastUsed; // Cache clock at the last lookup
+    std::vector<uint16_t> distance; // Steps to the target per cell (FLOW_UNREACHABLE if none)
+    std::vector<int> queue; // Frontier scratch, kept to avoid reallocating
+};
+
+// Structure for the flow fields shared by every agent. Agents thinking
+// on several threads may call getFlowField at once; a field handed out
+// in the current round is never rebuilt for another target, so the cache
+// can grow past FLOW_FIELD_CACHE_SIZE until trimFlowFieldCache.
+struct FlowFieldCache {
+    std::mutex mutex; // Held while looking up, repairing or building a field
+    std::deque<FlowField> fields; // Fields stay put while others are added
+    uint32_t clock;
+    uint32_t roundStart; // Fields used at or after this clock value are in use this round
+    int builds; // Fields computed from scratch since the cache was cleared
+    int repairs; // Incremental repairs since the cache was cleared
+};
+
+// Function to (re)build the nav grid from the obstacle arrays (skips destroyed objects)
+void buildNavGrid(NavGrid* grid, const GameObject* grassObjects, const GameObject* rockObjects, int grassCount,
+                  int rockCount, int mapWidth, int mapHeight, int agentWidth, int agentHeight);
+
+// Function to take a destroyed obstacle off the nav grid, logging the cells it opened
+void openNavObstacle(NavGrid* grid, SDL_Rect obstacle);
+
+// Function to put a destroyed obstacle back on the nav grid (rollback)
+void closeNavObstacle(NavGrid* grid, SDL_Rect obstacle);
+
+// Function to get the cell under a point (-1 outside the arena)
+int getNavCell(const NavGrid* grid, float x, float y);
+
+// Function to compute a flow field towards targetCell from scratch
+void buildFlowField(FlowField* field, const NavGrid* grid, int targetCell);
+
+// Function to bring a flow field up to date with the cells opened since it was built
+void repairFlowField(FlowField* field, const NavGrid* grid);
+
+// Function to drop every cached flow field (call when the nav grid is rebuilt)
+void clearFlowFieldCache(FlowFieldCache* cache);
+
+// Function to get an up-to-date flow field towards targetCell, building
+// it if no cached field has that target (thread-safe)
+const FlowField* getFlowField(FlowFieldCache* cache, const NavGrid* grid, int targetCell);
+
+// Function to get the cached flow field towards targetCell without
+// building one (NULL if none). Not while other threads call getFlowField.
+const FlowField* findFlowField(const FlowFieldCache* cache, int targetCell);
+
+// Function to end a round: drop the least recently used fields beyond
+// FLOW_FIELD_CACHE_SIZE. Not while other threads use the cache.
+void trimFlowFieldCache(FlowFieldCache* cache);
+
+// Function to get the step to take from a cell: 0 = up, 1 = right,
+// 2 = down, 3 = left, -1 at the target or when it cannot be reached
+int getFlowDirection(const FlowField* field, const NavGrid* grid, int cell);
@@ -0,0 +1,329 @@
+#include "game.h"
+#include "flow_field.h"
+#include "log.h"
+#include "obstacle_grid.h"
+#include "tank_store.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Function to seed the match's random number generator
+void seedRng(GameRng* rng, uint64_t seed) {
+    rng->state = seed;
+}
+
+// Function to get the next 32 random bits (SplitMix64, same sequence on every platform)
+uint32_t nextRandom(GameRng* rng) {
+    rng->state += 0x9E3779B97F4A7C15ull;
+    uint64_t z = rng->state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+// Function to generate random number between min and max
+int random(GameRng* rng, int min, int max) {
+    return min + (int)(nextRandom(rng) % (uint32_t)(max - min + 1));
+}
+
+// Function to check if two rectangles overlap with minimum distance
+bool checkCollision(SDL_Rect a, SDL_Rect b, int minDistance) {
+    // Expand rectangles by minDistance to ensure minimum spacing
+    SDL_Rect expandedA = {a.x - minDistance, a.y - minDistance, a.w + 2*minDistance, a.h + 2*minDistance};
+    SDL_Rect expandedB = {b.x - minDistance, b.y - minDistance, b.w + 2*minDistance, b.h + 2*minDistance};
+    
+    return (expandedA.x < expandedB.x + expandedB.w && expandedA.x + expandedA.w > expandedB.x && 
+            expandedA.y < expandedB.y + expandedB.h && expandedA.y + expandedA.h > expandedB.y);
+}
+
+// Function to check if object collides with any existing objects
+bool checkObjectCollision(SDL_Rect newRect, SDL_Rect* existingRects, int count, int minDistance) {
+    for (int i = 0; i < count; i++) {
+        if (checkCollision(newRect, existingRects[i], minDistance)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to check if tank collides with any game objects (grass or rocks)
+bool checkTankCollisionWithObjects(SDL_Rect tankRect, GameObject* grassObjects, GameObject* rockObjects, int grassCount, int rockCount) {
+    // Check collision with grass objects (ignore destroyed ones)
+    for (int i = 0; i < grassCount; i++) {
+        if (grassObjects[i].isDestroyed) continue; // Skip destroyed objects
+        
+        // Direct collision check without minDistance
+        bool collisionX = tankRect.x < grassObjects[i].rect.x + grassObjects[i].rect.w && 
+                         tankRect.x + tankRect.w > grassObjects[i].rect.x;
+        bool collisionY = tankRect.y < grassObjects[i].rect.y + grassObjects[i].rect.h && 
+                         tankRect.y + tankRect.h > grassObjects[i].rect.y;
+        
+        if (collisionX && collisionY) {
+            LOG_DEBUG("[DEBUG] Tank collision with grass[%d] at (%d,%d) size %dx%d", i,
+                      grassObjects[i].rect.x, grassObjects[i].rect.y, grassObjects[i].rect.w, grassObjects[i].rect.h);
+            LOG_DEBUG("[DEBUG] Collision details - Tank: (%d,%d) %dx%d Grass: (%d,%d) %dx%d",
+                      tankRect.x, tankRect.y, tankRect.w, tankRect.h,
+                      grassObjects[i].rect.x, grassObjects[i].rect.y, grassObjects[i].rect.w, grassObjects[i].rect.h);
+            LOG_DEBUG("[DEBUG] CollisionX: %d CollisionY: %d", collisionX, collisionY);
+            return true;
+        }
+    }
+    
+    // Check collision with rock objects (ignore destroyed ones)
+    for (int i = 0; i < rockCount; i++) {
+        if (rockObjects[i].isDestroyed) continue; // Skip destroyed objects
+        
+        // Direct collision check without minDistance
+        if (tankRect.x < rockObjects[i].rect.x + rockObjects[i].rect.w && 
+            tankRect.x + tankRect.w > rockObjects[i].rect.x && 
+            tankRect.y < rockObjects[i].rect.y + rockObjects[i].rect.h && 
+            tankRect.y + tankRect.h > rockObjects[i].rect.y) {
+            LOG_DEBUG("[DEBUG] Tank collision with rock[%d] at (%d,%d) size %dx%d", i,
+                      rockObjects[i].rect.x, rockObjects[i].rect.y, rockObjects[i].rect.w, rockObjects[i].rect.h);
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// Function to check if a rect collides with any obstacle using the grid
+bool checkTankCollisionWithGrid(SDL_Rect tankRect, const ObstacleGrid* grid) {
+    int id = findObstacleOverlap(grid, tankRect);
+    if (id == -1) return false;
+
+    LOG_DEBUG("[DEBUG] Tank collision with %s[%d] at (%d,%d) size %dx%d",
+              id < grid->grassCount ? "grass" : "rock", id < grid->grassCount ? id : id - grid->grassCount,
+              grid->bounds[id].x, grid->bounds[id].y, grid->bounds[id].w, grid->bounds[id].h);
+    return true;
+}
+
+// Function to check collision between two tanks
+bool checkTankCollision(SDL_Rect tank1, SDL_Rect tank2) {
+    return (tank1.x < tank2.x + tank2.w && tank1.x + tank1.w > tank2.x && 
+            tank1.y < tank2.y + tank2.h && tank1.y + tank1.h > tank2.y);
+}
+
+// Function to check if bullet collides with tank
+bool checkBulletTankCollision(SDL_Rect bullet, SDL_Rect tank) {
+    return (bullet.x < tank.x + tank.w && bullet.x + bullet.w > tank.x && 
+            bullet.y < tank.y + tank.h && bullet.y + bullet.h > tank.y);
+}
+
+// Function to check if bullet collides with game object
+bool checkBulletObjectCollision(SDL_Rect bullet, GameObject obj) {
+    if (obj.isDestroyed) return false; // Don't collide with destroyed objects
+    return (bullet.x < obj.rect.x + obj.rect.w && bullet.x + bullet.w > obj.rect.x && 
+            bullet.y < obj.rect.y + obj.rect.h && bullet.y + bullet.h > obj.rect.y);
+}
+
+// Function to narrow the times a box moving along one axis overlaps a target span (false if never)
+static bool sweepAxis(Fixed position, int size, Fixed delta, int targetPosition, int targetSize, Fixed* enter,
+                      Fixed* exit) {
+    // The box overlaps while position is strictly between these (touching edges do not count)
+    Fixed low = fixedFromInt(targetPosition - size);
+    Fixed high = fixedFromInt(targetPosition + targetSize);
+    if (delta.raw == 0) return position > low && position < high;
+
+    Fixed t0 = (low - position) / delta;
+    Fixed t1 = (high - position) / delta;
+    if (t0 > t1) std::swap(t0, t1);
+    *enter = std::max(*enter, t0);
+    *exit = std::min(*exit, t1);
+    return true;
+}
+
+// Function to find when a box at (x, y) moving by (dx, dy) first overlaps
+// a rect, as a fraction of the move (ray against the rect grown by the box)
+bool sweepBox(Fixed x, Fixed y, int w, int h, Fixed dx, Fixed dy, SDL_Rect target, Fixed* hitTime) {
+    Fixed enter = fixedFromInt(0);
+    Fixed exit = fixedFromInt(1);
+    if (!sweepAxis(x, w, dx, target.x, target.w, &enter, &exit)) return false;
+    if (!sweepAxis(y, h, dy, target.y, target.h, &enter, &exit)) return false;
+    if (enter >= exit) return false;
+
+    *hitTime = enter;
+    return true;
+}
+
+// Function to destroy game object, create shadow and drop it from the grids
+void destroyGameObject(GameObject* obj, ObstacleGrid* grid, NavGrid* nav, int id) {
+    if (!obj->isDestroyed) {
+        obj->isDestroyed = true;
+        obj->hasShadow = true;
+        removeFromObstacleGrid(grid, id);
+        openNavObstacle(nav, obj->rect); // Flow fields repair from the opened cells
+    }
+}
+
+// Function to undo destroyGameObject (rollback to a tick before the object was hit)
+void restoreGameObject(GameObject* obj, ObstacleGrid* grid, NavGrid* nav, int id) {
+    if (obj->isDestroyed) {
+        obj->isDestroyed = false;
+        obj->hasShadow = false;
+        insertIntoObstacleGrid(grid, id);
+        closeNavObstacle(nav, obj->rect);
+    }
+}
+
+// Function to create explosion effect
+void createExplosion(Explosion* explosion, SDL_Rect position) {
+    explosion->active = true;
+    explosion->timer = 0;
+    explosion->duration = SIMULATION_TICK_RATE; // 1 second duration
+    explosion->rect.x = position.x + position.w/2 - 32; // Center explosion
+    explosion->rect.y = position.y + position.h/2 - 32;
+    explosion->rect.w = 64;
+    explosion->rect.h = 64;
+}
+
+// Function to update explosion effect
+void updateExplosion(Explosion* explosion) {
+    if (!explosion->active) return;
+    
+    explosion->timer++;
+    if (explosion->timer >= explosion->duration) {
+        explosion->active = false;
+    }
+}
+
+// Function to check if a rect overlaps any tank
+static bool isRectOnTank(const TankStore* tanks, SDL_Rect rect) {
+    for (int i = 0; i < tanks->count; i++) {
+        if (checkTankCollision(rect, tanks->rect[i])) return true;
+    }
+    return false;
+}
+
+// Function to spawn power box at random location
+void spawnPowerBox(PowerBox* powerBox, const GameMap* map, const ObstacleGrid* grid, const TankStore* tanks, GameRng* rng) {
+    const int BOX_SIZE = 20;
+    
+    if (powerBox->active) return; // Don't spawn if already active
+    
+    // Increment spawn count
+    powerBox->spawnCount++;
+    
+    // Determine box type: 0=shield, 1=power-up, 2=explosion (every 3rd box)
+    powerBox->boxType = powerBox->spawnCount % 2;
+    
+    // Find a random position in one of the map's zones (anywhere on a map
+    // without zones) that doesn't collide with objects or tanks
+    int zoneCount = (int)map->header->zoneCount;
+    MapZone wholeMap = {0, 0, map->header->width, map->header->height};
+    int attempts = 0;
+    do {
+        const MapZone& zone = zoneCount > 0 ? map->zones[random(rng, 0, zoneCount - 1)] : wholeMap;
+        powerBox->rect.x = random(rng, zone.x, zone.x + std::max(0, zone.w - BOX_SIZE));
+        powerBox->rect.y = random(rng, zone.y, zone.y + std::max(0, zone.h - BOX_SIZE));
+        powerBox->rect.w = BOX_SIZE;
+        powerBox->rect.h = BOX_SIZE;
+        attempts++;
+    } while ((findObstacleOverlap(grid, powerBox->rect) != -1 || isRectOnTank(tanks, powerBox->rect)) &&
+             attempts < 50);
+    
+    powerBox->active = true;
+    powerBox->disappearTimer = 5 * SIMULATION_TICK_RATE; // 5 seconds to disappear
+    
+    if (powerBox->boxType == 0) {
+        LOG_INFO("[POWERBOX] Shield box spawned at (%d,%d) - Defensive shield!", powerBox->rect.x, powerBox->rect.y);
+    } else {
+        LOG_INFO("[POWERBOX] Power-up box spawned at (%d,%d) - Size reduction + Speed boost!", powerBox->rect.x, powerBox->rect.y);
+    }
+}
+// Function to update power box spawning
+void updatePowerBoxSpawning(PowerBox* powerBox, const GameMap* map, const ObstacleGrid* grid, const TankStore* tanks, GameRng* rng) {
+    const int SPAWN_INTERVAL = 3 * SIMULATION_TICK_RATE; // 3 seconds
+    
+    if (powerBox->active) {
+        // Update disappear timer
+        powerBox->disappearTimer--;
+        if (powerBox->disappearTimer <= 0) {
+            powerBox->active = false;
+            LOG_INFO("[POWERBOX] Power box disappeared after 5 seconds!");
+        }
+    } else {
+        powerBox->spawnTimer++;
+        if (powerBox->spawnTimer >= SPAWN_INTERVAL) {
+            spawnPowerBox(powerBox, map, grid, tanks, rng);
+            powerBox->spawnTimer = 0;
+        }
+    }
+}
+
+// Function to let the first tank touching the power box collect it (returns the tank, -1 if none)
+int checkPowerBoxCollection(PowerBox* powerBox, TankStore* tanks, Shield* shield) {
+    if (!powerBox->active) return -1;
+    
+    for (int i = 0; i < tanks->count; i++) {
+        if (!isTankAlive(tanks, i) || !checkTankCollision(tanks->rect[i], powerBox->rect)) continue;
+        
+        powerBox->active = false;
+        
+        if (powerBox->boxType == 0) {
+            // Shield box
+            activateShield(shield, i);
+        } else {
+            // Power-up box (size reduction + speed boost)
+            activatePowerUp(tanks, i);
+        } 
+        return i;
+    }
+    return -1;
+}
+
+// Function to activate shield
+void activateShield(Shield* shield, int owner) {
+    shield->active = true;
+    shield->timer = 0;
+    shield->duration = 30 * SIMULATION_TICK_RATE; // 30 seconds
+    shield->owner = owner;
+    LOG_INFO("[SHIELD] Shield activated for tank %d", owner);
+}
+
+// Function to update shield
+void updateShield(Shield* shield) {
+    if (!shield->active) return;
+    
+    shield->timer++;
+    if (shield->timer >= shield->duration) {
+        shield->active = false;
+        LOG_INFO("[SHIELD] Shield expired");
+    }
+}
+
+// Function to check if tank has active shield
+bool hasActiveShield(const Shield* shield, int owner) {
+    return shield->active && shield->owner == owner;
+}
+
+// Function to create the grass and rock objects from a map
+void initializeGameObjects(std::vector<GameObject>* grassObjects, std::vector<GameObject>* rockObjects, const GameMap* map, ObstacleGrid* grid) {
+    grassObjects->clear();
+    rockObjects->clear();
+    
+    for (uint32_t i = 0; i < map->header->obstacleCount; i++) {
+        const MapObstacle& obstacle = map->obstacles[i];
+        GameObject object;
+        object.rect = {obstacle.x, obstacle.y, obstacle.w, obstacle.h};
+        object.size = obstacle.w;
+        object.rotation = obstacle.rotation;
+        object.rotationSpeed = 0.0f;
+        object.isDestroyed = false;
+        object.hasShadow = false;
+        
+        if (obstacle.type == MAP_GRASS) {
+            grassObjects->push_back(object);
+        } else {
+            rockObjects->push_back(object);
+        }
+    }
+    
+    // Index obstacles for collision queries
+    buildObstacleGrid(grid, grassObjects->data(), rockObjects->data(), (int)grassObjects->size(), (int)rockObjects->size());
+}
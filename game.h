@@ -0,0 +1,95 @@
+#pragma once
+
+// Gameplay types and update functions shared by the windowed game and
+// headless simulation. Only SDL's plain data types are used here, never
+// the renderer.
+
+#include "fixed_math.h"
+#include "map.h"
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+struct ObstacleGrid;
+struct NavGrid;
+struct TankStore;
+
+// Fixed simulation rate. Every timer counts ticks and every speed is in
+// pixels per tick, so a match does not depend on the render frame rate.
+const int SIMULATION_TICK_RATE = 120;
+
+// Structure for game objects
+struct GameObject {
+    SDL_Rect rect;
+    float rotation; // Degrees, only used for drawing
+    float rotationSpeed;
+    int size;
+    bool isDestroyed; // Whether the object has been destroyed
+    bool hasShadow; // Whether there's a shadow at this position
+};
+
+// Structure for explosion effects
+struct Explosion {
+    SDL_Rect rect;
+    int timer; // Ticks
+    int duration;
+    bool active;
+};
+
+// Structure for power boxes
+struct PowerBox {
+    SDL_Rect rect;
+    bool active;
+    int spawnTimer; // Ticks
+    int disappearTimer; // Ticks left before auto-disappear
+    int spawnCount; // Track spawn count to determine type
+    int boxType; // 0=shield, 1=power-up
+};
+
+// Structure for defensive shields
+struct Shield {
+    bool active;
+    int timer; // Ticks
+    int duration;
+    int owner; // Index of the shielded tank
+};
+
+// Structure for the match's random number generator (SplitMix64).
+// Seeded per match so a replay of the same inputs reproduces it exactly.
+struct GameRng {
+    uint64_t state;
+};
+
+// Random number helpers
+void seedRng(GameRng* rng, uint64_t seed);
+uint32_t nextRandom(GameRng* rng);
+int random(GameRng* rng, int min, int max);
+
+// Collision checks
+bool checkCollision(SDL_Rect a, SDL_Rect b, int minDistance = 15);
+bool checkObjectCollision(SDL_Rect newRect, SDL_Rect* existingRects, int count, int minDistance = 15);
+bool checkTankCollisionWithObjects(SDL_Rect tankRect, GameObject* grassObjects, GameObject* rockObjects, int grassCount, int rockCount);
+bool checkTankCollisionWithGrid(SDL_Rect tankRect, const ObstacleGrid* grid);
+bool checkTankCollision(SDL_Rect tank1, SDL_Rect tank2);
+bool checkBulletTankCollision(SDL_Rect bullet, SDL_Rect tank);
+bool checkBulletObjectCollision(SDL_Rect bullet, GameObject obj);
+bool sweepBox(Fixed x, Fixed y, int w, int h, Fixed dx, Fixed dy, SDL_Rect target, Fixed* hitTime);
+
+// Game objects
+void destroyGameObject(GameObject* obj, ObstacleGrid* grid, NavGrid* nav, int id);
+void restoreGameObject(GameObject* obj, ObstacleGrid* grid, NavGrid* nav, int id);
+void initializeGameObjects(std::vector<GameObject>* grassObjects, std::vector<GameObject>* rockObjects, const GameMap* map, ObstacleGrid* grid);
+
+// Tanks live in tank_store.h, bullets in bullet_pool.h
+
+// Explosions
+void createExplosion(Explosion* explosion, SDL_Rect position);
+void updateExplosion(Explosion* explosion);
+
+// Power boxes and shields
+void spawnPowerBox(PowerBox* powerBox, const GameMap* map, const ObstacleGrid* grid, const TankStore* tanks, GameRng* rng);
+void updatePowerBoxSpawning(PowerBox* powerBox, const GameMap* map, const ObstacleGrid* grid, const TankStore* tanks, GameRng* rng);
+int checkPowerBoxCollection(PowerBox* powerBox, TankStore* tanks, Shield* shield);
+void activateShield(Shield* shield, int owner);
+void updateShield(Shield* shield);
+bool hasActiveShield(const Shield* shield, int owner);
@@ -0,0 +1,76 @@
+#include "game_events.h"
+#include "log.h"
+#include "tank_store.h"
+
+// Function to get display name of a team
+static const char* teamName(int team) {
+    return team == 0 ? "Blue" : "Red";
+}
+
+// Function to give the shooters their points
+void applyEventScores(const GameEvent* events, int count, TankStore* tanks) {
+    for (int i = 0; i < count; i++) {
+        const GameEvent& event = events[i];
+        if (event.type == GAME_EVENT_HIT) {
+            tanks->info[event.tank].score += (event.flags & GAME_EVENT_EXPLOSIVE) ? SCORE_EXPLOSION_HIT : SCORE_HIT;
+        } else if (event.type == GAME_EVENT_OBSTACLE_DESTROYED) {
+            tanks->info[event.tank].score += SCORE_OBSTACLE;
+        }
+    }
+}
+
+// Function to start an explosion effect on every tank hit (while a slot is free)
+void applyEventEffects(const GameEvent* events, int count, Explosion* explosions, int explosionCount) {
+    for (int i = 0; i < count; i++) {
+        if (events[i].type != GAME_EVENT_HIT) continue;
+        for (int j = 0; j < explosionCount; j++) {
+            if (!explosions[j].active) {
+                createExplosion(&explosions[j], events[i].rect);
+                break;
+            }
+        }
+    }
+}
+
+// Function to log the events
+void logGameEvents(const GameEvent* events, int count, const TankStore* tanks) {
+    for (int i = 0; i < count; i++) {
+        const GameEvent& event = events[i];
+        switch (event.type) {
+        case GAME_EVENT_HIT:
+            if (event.flags & GAME_EVENT_EXPLOSIVE) {
+                LOG_INFO("%s tank %d hit %s tank %d with explosion bullet! 3x damage!",
+                         teamName(tanks->info[event.tank].team), event.tank, teamName(tanks->info[event.target].team),
+                         event.target);
+            } else {
+                LOG_INFO("%s tank %d hit %s tank %d!", teamName(tanks->info[event.tank].team), event.tank,
+                         teamName(tanks->info[event.target].team), event.target);
+            }
+            break;
+        case GAME_EVENT_DESTROYED:
+            LOG_INFO("[DESTROY] Tank %d destroyed by tank %d!", event.target, event.tank);
+            break;
+        case GAME_EVENT_REFLECTED:
+            LOG_INFO("[REFLECT] Tank %d's shield reflected a bullet from tank %d!", event.tank, event.target);
+            break;
+        case GAME_EVENT_PICKED_UP:
+            if (event.target == 0) {
+                LOG_INFO("[POWERBOX] Tank %d collected shield box! Defensive shield activated!", event.tank);
+            } else {
+                LOG_INFO("[POWERBOX] Tank %d collected power-up box! Size reduced, speed doubled!", event.tank);
+            }
+            break;
+        case GAME_EVENT_OBSTACLE_DESTROYED:
+            LOG_INFO("[DESTROY] Tank %d destroyed %s object at (%d,%d)", event.tank,
+                     (event.flags & GAME_EVENT_GRASS) ? "grass" : "rock", event.rect.x, event.rect.y);
+            break;
+        }
+    }
+}
+
+// Function to add the events to per-type counts
+void countGameEvents(const GameEvent* events, int count, GameEventTotals* totals) {
+    for (int i = 0; i < count; i++) {
+        totals->counts[events[i].type]++;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+// Gameplay events of one tick. The bullet and pickup code only records
+// what happened (a hit, a destroyed tank, a reflection, a pickup, a
+// destroyed obstacle) into World::events, one contiguous array in the
+// order things happened. Consumers then go over the whole array once,
+// after the simulation phases: stepWorld applies scoring and effects,
+// and the caller of stepWorld does logging and telemetry.
+//
+// Events are plain data, so a consumer that should run off the
+// simulation thread can copy the array and be handed the copy.
+
+#include "game.h"
+#include <cstdint>
+#include <vector>
+
+struct TankStore;
+
+// Event types
+const uint8_t GAME_EVENT_HIT = 0; // A bullet took HP from a tank
+const uint8_t GAME_EVENT_DESTROYED = 1; // A tank's HP ran out
+const uint8_t GAME_EVENT_REFLECTED = 2; // A shielded tank sent a bullet back
+const uint8_t GAME_EVENT_PICKED_UP = 3; // A tank collected the power box
+const uint8_t GAME_EVENT_OBSTACLE_DESTROYED = 4; // A bullet destroyed grass or a rock
+const int GAME_EVENT_TYPE_COUNT = 5;
+
+// Bits of GameEvent::flags
+const uint8_t GAME_EVENT_EXPLOSIVE = 1; // Caused by an explosion bullet
+const uint8_t GAME_EVENT_GRASS = 2; // The obstacle was grass (otherwise a rock)
+
+// Points for the shooter
+const int SCORE_HIT = 100;
+const int SCORE_EXPLOSION_HIT = 300;
+const int SCORE_OBSTACLE = 10;
+
+// Structure for one gameplay event
+struct GameEvent {
+    uint8_t type; // GAME_EVENT_*
+    uint8_t flags; // GAME_EVENT_EXPLOSIVE, GAME_EVENT_GRASS
+    int16_t tank; // Tank that caused it: the shooter, the collector, or the shielded tank
+    int32_t target; // Tank hit, destroyed or whose bullet was reflected; obstacle id; box type of a pickup
+    int32_t amount; // HP taken by a hit
+    SDL_Rect rect; // Where it happened: the target's body, the obstacle, the box
+};
+
+static_assert(sizeof(GameEvent) == 28, "GameEvent is kept small so a tick's events stay in a few cache lines");
+
+// Structure for event counts per type (telemetry)
+struct GameEventTotals {
+    int counts[GAME_EVENT_TYPE_COUNT];
+};
+
+// Function to record an event
+inline void pushGameEvent(std::vector<GameEvent>* events, uint8_t type, uint8_t flags, int tank, int target,
+                          int amount, SDL_Rect rect) {
+    GameEvent event;
+    event.type = type;
+    event.flags = flags;
+    event.tank = (int16_t)tank;
+    event.target = target;
+    event.amount = amount;
+    event.rect = rect;
+    events->push_back(event);
+}
+
+// Function to give the shooters their points
+void applyEventScores(const GameEvent* events, int count, TankStore* tanks);
+
+// Function to start an explosion effect on every tank hit (while a slot is free)
+void applyEventEffects(const GameEvent* events, int count, Explosion* explosions, int explosionCount);
+
+// Function to log the events
+void logGameEvents(const GameEvent* events, int count, const TankStore* tanks);
+
+// Function to add the events to per-type counts
+void countGameEvents(const GameEvent* events, int count, GameEventTotals* totals);
@@ -0,0 +1,235 @@
+#include "job_system.h"
+#include "log.h"
+#include <algorithm>
+
+// Failed attempts to find a job before a worker goes to sleep. Phases
+// inside one frame follow each other closely, so a short spin keeps the
+// workers awake between them instead of paying a wake-up per phase.
+const int JOB_SPIN_COUNT = 256;
+
+// Index of the calling thread's queue (workers are 1..n-1, every other thread uses 0)
+static thread_local int jobThreadIndex = 0;
+
+// Function to queue a ready job on the calling thread's queue
+static void pushJob(JobSystem* system, Job* job) {
+    JobQueue* queue = &system->queues[jobThreadIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs.push_back(job);
+    }
+    system->queuedJobs.fetch_add(1);
+
+    // Workers count themselves as sleepers before checking queuedJobs, so
+    // one of the two always sees the other
+    if (system->sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(system->wakeMutex);
+        system->wake.notify_one();
+    }
+}
+
+// Function to take a job: the newest of our own, else the oldest of someone else's
+static Job* takeJob(JobSystem* system) {
+    int self = jobThreadIndex;
+    {
+        JobQueue* queue = &system->queues[self];
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->jobs.empty()) {
+            Job* job = queue->jobs.back();
+            queue->jobs.pop_back();
+            system->queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+
+    for (int i = 1; i < system->threadCount; i++) {
+        JobQueue* victim = &system->queues[(self + i) % system->threadCount];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->jobs.empty()) {
+            Job* job = victim->jobs.front();
+            victim->jobs.pop_front();
+            system->queuedJobs.fetch_sub(1);
+            system->jobsStolen.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    return NULL;
+}
+
+// Function to run a job and release the jobs that were waiting for it
+static void runJob(JobSystem* system, Job* job) {
+    job->run();
+    system->jobsRun.fetch_add(1, std::memory_order_relaxed);
+
+    for (Job* dependent : job->dependents) {
+        if (dependent->waitingFor.fetch_sub(1) == 1) {
+            pushJob(system, dependent);
+        }
+    }
+
+    // Last, so the submitter cannot return while a dependent is being queued
+    job->pending->fetch_sub(1, std::memory_order_release);
+}
+
+// Function to run jobs on the calling thread until a submission has finished
+static void helpUntilDone(JobSystem* system, const std::atomic<int>* pending) {
+    while (pending->load(std::memory_order_acquire) > 0) {
+        Job* job = takeJob(system);
+        if (job != NULL) {
+            runJob(system, job);
+        } else {
+            std::this_thread::yield(); // The last jobs are running on other threads
+        }
+    }
+}
+
+// Function run by each worker thread
+static void workerLoop(JobSystem* system, int index) {
+    jobThreadIndex = index;
+    int misses = 0;
+    while (!system->stopping.load()) {
+        Job* job = takeJob(system);
+        if (job != NULL) {
+            runJob(system, job);
+            misses = 0;
+            continue;
+        }
+
+        if (++misses < JOB_SPIN_COUNT) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(system->wakeMutex);
+        system->sleepers.fetch_add(1);
+        system->wake.wait(lock, [system] { return system->stopping.load() || system->queuedJobs.load() > 0; });
+        system->sleepers.fetch_sub(1);
+        misses = 0;
+    }
+}
+
+// Function to start threadCount - 1 worker threads (0 = one per hardware thread)
+void startJobSystem(JobSystem* system, int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = (int)std::thread::hardware_concurrency();
+    }
+    threadCount = std::max(1, threadCount);
+
+    system->threadCount = threadCount;
+    system->queues.clear();
+    for (int i = 0; i < threadCount; i++) {
+        system->queues.emplace_back();
+    }
+    system->queuedJobs = 0;
+    system->sleepers = 0;
+    system->stopping = false;
+    system->jobsRun = 0;
+    system->jobsStolen = 0;
+
+    for (int i = 1; i < threadCount; i++) {
+        system->workers.emplace_back(workerLoop, system, i);
+    }
+    LOG_INFO("[JOBS] Started %d worker threads (%d threads run jobs)", threadCount - 1, threadCount);
+}
+
+// Function to finish the workers (no job may be running)
+void stopJobSystem(JobSystem* system) {
+    {
+        std::lock_guard<std::mutex> lock(system->wakeMutex);
+        system->stopping = true;
+    }
+    system->wake.notify_all();
+    for (std::thread& worker : system->workers) {
+        worker.join();
+    }
+    system->workers.clear();
+    LOG_INFO("[JOBS] Stopped after %llu jobs (%llu stolen)", (unsigned long long)system->jobsRun.load(),
+             (unsigned long long)system->jobsStolen.load());
+}
+
+// Function to get how many threads run jobs (1 without a system)
+int getJobThreadCount(const JobSystem* system) {
+    return system != NULL ? system->threadCount : 1;
+}
+
+// Function to run body over [0, count) in chunks, in parallel when there is more than one chunk
+void parallelFor(JobSystem* system, int count, int grain, const std::function<void(int begin, int end)>& body) {
+    if (count <= 0) return;
+    grain = std::max(1, grain);
+    int chunks = (count + grain - 1) / grain;
+    if (system == NULL || system->threadCount == 1 || chunks == 1) {
+        body(0, count);
+        return;
+    }
+
+    // A few chunks per thread: each still big enough to be worth a job,
+    // and enough left over for threads that finish early to steal
+    chunks = std::min(chunks, system->threadCount * 4);
+    std::atomic<int> pending(chunks);
+    std::deque<Job> jobs(chunks);
+    for (int i = 0; i < chunks; i++) {
+        int begin = (int)((long long)count * i / chunks);
+        int end = (int)((long long)count * (i + 1) / chunks);
+        Job* job = &jobs[i];
+        job->run = [&body, begin, end] { body(begin, end); };
+        job->dependencyCount = 0;
+        job->waitingFor = 0;
+        job->pending = &pending;
+    }
+
+    // Queued in reverse, so the caller takes the first chunk and thieves the last
+    for (int i = chunks - 1; i >= 0; i--) {
+        pushJob(system, &jobs[i]);
+    }
+    helpUntilDone(system, &pending);
+}
+
+// Function to add a job to a graph (returns its index in the graph)
+int addJob(JobGraph* graph, const std::function<void()>& run) {
+    graph->jobs.emplace_back();
+    Job* job = &graph->jobs.back();
+    job->run = run;
+    job->dependencyCount = 0;
+    job->waitingFor = 0;
+    job->pending = NULL;
+    return (int)graph->jobs.size() - 1;
+}
+
+// Function to make job wait until dependsOn has finished
+void addJobDependency(JobGraph* graph, int job, int dependsOn) {
+    graph->jobs[dependsOn].dependents.push_back(&graph->jobs[job]);
+    graph->jobs[job].dependencyCount++;
+}
+
+// Function to run every job of a graph after its dependencies and wait for all of them
+void runJobGraph(JobSystem* system, JobGraph* graph) {
+    int count = (int)graph->jobs.size();
+    std::atomic<int> pending(count);
+    for (Job& job : graph->jobs) {
+        job.waitingFor = job.dependencyCount;
+        job.pending = &pending;
+    }
+
+    if (system == NULL || system->threadCount == 1) {
+        // Inline: run whatever is ready, in the order the jobs were added
+        std::vector<Job*> ready;
+        for (Job& job : graph->jobs) {
+            if (job.dependencyCount == 0) ready.push_back(&job);
+        }
+        for (size_t i = 0; i < ready.size(); i++) {
+            Job* job = ready[i];
+            job->run();
+            for (Job* dependent : job->dependents) {
+                if (dependent->waitingFor.fetch_sub(1) == 1) ready.push_back(dependent);
+            }
+        }
+        if ((int)ready.size() != count) {
+            LOG_ERROR("[JOBS] Job graph has a cycle: %d of %d jobs ran", (int)ready.size(), count);
+        }
+        return;
+    }
+
+    for (Job& job : graph->jobs) {
+        if (job.dependencyCount == 0) pushJob(system, &job);
+    }
+    helpUntilDone(system, &pending);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+// Work-stealing job scheduler. Every thread owns a queue of ready jobs:
+// it runs the newest job from the back of its own queue (its data is
+// still in cache) and, when that runs dry, steals the oldest job from
+// the front of another thread's queue. A thread that submits work runs
+// jobs too while it waits, so nested submissions cannot deadlock and a
+// JobSystem with one thread simply runs everything on the caller.
+//
+// Two ways to submit work, both returning once all of it has finished:
+//  - parallelFor splits an index range into chunks run as jobs
+//  - a JobGraph holds jobs with dependencies; a job is queued once every
+//    job it depends on has finished
+//
+// Jobs run in no particular order. Work whose result must not depend on
+// timing (the simulation) writes only per-item outputs in parallel and
+// combines them on the calling thread in index order.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Structure for one unit of work
+struct Job {
+    std::function<void()> run;
+    int dependencyCount; // Jobs this one waits for (graph jobs)
+    std::atomic<int> waitingFor; // Dependencies not finished yet in the current run
+    std::vector<Job*> dependents; // Jobs waiting for this one
+    std::atomic<int>* pending; // Unfinished jobs of the submission this job belongs to
+};
+
+// Structure for the ready jobs of one thread
+struct JobQueue {
+    std::mutex mutex;
+    std::deque<Job*> jobs; // Owner takes from the back, thieves from the front
+};
+
+// Structure for the worker threads and their queues
+struct JobSystem {
+    int threadCount; // Worker threads plus the thread that started the system
+    std::vector<std::thread> workers;
+    std::deque<JobQueue> queues; // One per thread, 0 = the starting thread
+    std::atomic<int> queuedJobs; // Jobs sitting in any queue
+    std::atomic<int> sleepers; // Workers waiting for work
+    std::atomic<bool> stopping;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<uint64_t> jobsRun; // Totals since the system started (statistics)
+    std::atomic<uint64_t> jobsStolen;
+};
+
+// Structure for jobs with dependencies, run together with runJobGraph
+struct JobGraph {
+    std::deque<Job> jobs; // Stable addresses while jobs are added
+};
+
+// Function to start threadCount - 1 worker threads (0 = one per hardware thread)
+void startJobSystem(JobSystem* system, int threadCount = 0);
+
+// Function to finish the workers (no job may be running)
+void stopJobSystem(JobSystem* system);
+
+// Function to get how many threads run jobs (1 without a system)
+int getJobThreadCount(const JobSystem* system);
+
+// Function to run body over [0, count) in chunks of at least grain
+// indices, in parallel when there is more than one chunk. body gets the
+// chunk's [begin, end). system may be NULL to run inline.
+void parallelFor(JobSystem* system, int count, int grain, const std::function<void(int begin, int end)>& body);
+
+// Function to add a job to a graph (returns its index in the graph)
+int addJob(JobGraph* graph, const std::function<void()>& run);
+
+// Function to make job wait until dependsOn has finished (the graph must not have cycles)
+void addJobDependency(JobGraph* graph, int job, int dependsOn);
+
+// Function to run every job of a graph, each after its dependencies, and
+// wait for all of them. system may be NULL to run them in order inline.
+void runJobGraph(JobSystem* system, JobGraph* graph);
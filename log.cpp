@@ -0,0 +1,175 @@
+#include "log.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Ring buffer sizing (per thread)
+const int LOG_RING_SIZE = 512; // Must be a power of two
+const int LOG_MESSAGE_SIZE = 256; // Longer messages are truncated
+
+// Structure for one queued message
+struct LogEntry {
+    int level;
+    char text[LOG_MESSAGE_SIZE];
+};
+
+// Single-producer/single-consumer ring owned by one logging thread.
+// The producer only writes head, the flusher only writes tail.
+struct LogRing {
+    LogEntry entries[LOG_RING_SIZE];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+    std::atomic<uint32_t> dropped{0}; // Messages lost because the ring was full
+    std::atomic<bool> inUse{true}; // False once the owning thread has exited
+};
+
+// Structure that hands a thread's ring back when the thread exits
+struct LogRingOwner {
+    LogRing* ring;
+    ~LogRingOwner() {
+        ring->inUse.store(false, std::memory_order_release);
+    }
+};
+
+// Structure for the flusher thread and the list of per-thread rings
+struct Logger {
+    std::mutex ringsMutex; // Only taken when a thread logs for the first time
+    std::vector<LogRing*> rings;
+    std::atomic<int> level{LOG_COMPILE_LEVEL};
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::atomic<bool> stopping{false};
+    uint64_t drainCount = 0; // Completed drain passes (guarded by wakeMutex)
+    std::thread flusher;
+
+    Logger() {
+        flusher = std::thread([this] { run(); });
+    }
+
+    // Flush everything on exit so messages logged right before
+    // returning from main() are not lost
+    ~Logger() {
+        stopping.store(true);
+        wake.notify_one();
+        flusher.join();
+        drainAll();
+        for (LogRing* ring : rings) {
+            delete ring;
+        }
+    }
+
+    // Function to give a thread a ring: one left by an exited thread once
+    // the flusher has written it out, otherwise a new one (so short-lived
+    // threads do not grow the list)
+    LogRing* registerThread() {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (LogRing* ring : rings) {
+            if (!ring->inUse.load(std::memory_order_acquire) &&
+                ring->tail.load(std::memory_order_acquire) == ring->head.load(std::memory_order_relaxed)) {
+                ring->inUse.store(true, std::memory_order_relaxed);
+                return ring;
+            }
+        }
+        LogRing* ring = new LogRing();
+        rings.push_back(ring);
+        return ring;
+    }
+
+    // Function to write out everything currently queued in every ring
+    void drainAll() {
+        std::string output;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            for (LogRing* ring : rings) {
+                uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+                uint32_t head = ring->head.load(std::memory_order_acquire);
+                for (; tail != head; tail++) {
+                    output += ring->entries[tail & (LOG_RING_SIZE - 1)].text;
+                    output += '\n';
+                }
+                ring->tail.store(tail, std::memory_order_release);
+
+                uint32_t dropped = ring->dropped.exchange(0);
+                if (dropped > 0) {
+                    output += "[LOG] " + std::to_string(dropped) + " messages dropped (ring full)\n";
+                }
+            }
+        }
+
+        if (!output.empty()) {
+            fwrite(output.data(), 1, output.size(), stdout);
+            fflush(stdout);
+        }
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        while (!stopping.load()) {
+            wake.wait_for(lock, std::chrono::milliseconds(10));
+            lock.unlock();
+            drainAll();
+            lock.lock();
+            drainCount++;
+            drained.notify_all();
+        }
+    }
+};
+
+// Function to get the process-wide logger (started on first use)
+static Logger& getLogger() {
+    static Logger logger;
+    return logger;
+}
+
+// Function to queue a message for the flusher thread (never blocks)
+void logMessage(int level, const char* format, ...) {
+    Logger& logger = getLogger();
+    if (level < logger.level.load(std::memory_order_relaxed)) return;
+
+    thread_local LogRingOwner owner = {logger.registerThread()};
+    LogRing* ring = owner.ring;
+
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    uint32_t tail = ring->tail.load(std::memory_order_acquire);
+    if (head - tail >= (uint32_t)LOG_RING_SIZE) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    LogEntry& entry = ring->entries[head & (LOG_RING_SIZE - 1)];
+    entry.level = level;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(entry.text, sizeof(entry.text), format, args);
+    va_end(args);
+    ring->head.store(head + 1, std::memory_order_release);
+
+    // Errors and nearly full rings are written out right away
+    if (level >= LOG_LEVEL_ERROR || head - tail >= (uint32_t)(LOG_RING_SIZE * 3 / 4)) {
+        logger.wake.notify_one();
+    }
+}
+
+// Function to change the runtime filter (cannot go below LOG_COMPILE_LEVEL)
+void setLogLevel(int level) {
+    getLogger().level.store(level < LOG_COMPILE_LEVEL ? LOG_COMPILE_LEVEL : level);
+}
+
+// Function to wait until every message queued so far has been written
+void flushLog() {
+    Logger& logger = getLogger();
+    std::unique_lock<std::mutex> lock(logger.wakeMutex);
+    // A pass that starts after this point sees everything queued before it
+    uint64_t target = logger.drainCount + 2;
+    logger.wake.notify_one();
+    logger.drained.wait(lock, [&] { return logger.drainCount >= target || logger.stopping.load(); });
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+// Asynchronous leveled logging. Messages are formatted on the calling
+// thread into that thread's lock-free ring buffer and written to stdout by
+// a background flusher thread, so game code never waits on terminal I/O.
+//
+// Usage (printf-style):
+//   LOG_DEBUG("[AMMO] Tank reloaded! Current ammo: %d/%d", ammo, MAX_AMMO);
+//   LOG_ERROR("[ERROR] Unable to load image %s", path.c_str());
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_OFF 4
+
+// Messages below LOG_COMPILE_LEVEL are stripped at compile time (their
+// arguments are not even evaluated). Debug builds keep everything.
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_PRINTF_FORMAT __attribute__((format(printf, 2, 3)))
+#else
+#define LOG_PRINTF_FORMAT
+#endif
+
+// Function to queue a message for the flusher thread (never blocks)
+void logMessage(int level, const char* format, ...) LOG_PRINTF_FORMAT;
+
+// Function to change the runtime filter (cannot go below LOG_COMPILE_LEVEL)
+void setLogLevel(int level);
+
+// Function to wait until every message queued so far has been written
+void flushLog();
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logMessage(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) logMessage(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) logMessage(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logMessage(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
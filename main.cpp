@@ -1,12 +1,29 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <ctime>
 #include <cstdlib>
-#include <cmath>
+#include <cstring>
 #include <string>
-#define M_PI 3.14159265358979323846
+#include <thread>
+#include <vector>
+#include "asset_loader.h"
+#include "audio.h"
+#include "bot.h"
+#include "camera.h"
+#include "job_system.h"
+#include "log.h"
+#include "map.h"
+#include "net_client.h"
+#include "particle_system.h"
+#include "profiler.h"
+#include "profiler_overlay.h"
+#include "replay.h"
+#include "rollback.h"
+#include "sprite_batch.h"
+#include "world.h"
 using namespace std;
 
 // Game states
@@ -17,141 +34,44 @@ enum GameState {
     WINNER_SCREEN
 };
 
-// Structure for game objects
-struct GameObject {
-    SDL_Rect rect;
-    float rotation;
-    float rotationSpeed;
-    int size;
-    bool isDestroyed; // Whether the object has been destroyed
-    bool hasShadow; // Whether there's a shadow at this position
+// Every image the game uses, decoded in parallel before any texture is created
+const char* const ASSET_FILES[] = {
+    "resource/welcome_screen.png", "resource/gamemode_bg.png", "resource/background.png",
+    "resource/start_button.png", "resource/singleplayer.png", "resource/singleplayer_hover.png",
+    "resource/multiplayer.png", "resource/multiplayer_hover.png",
+    "resource/blue-body.png", "resource/blue-gun.png", "resource/red-body.png", "resource/red-gun.png",
+    "resource/grass.png", "resource/rock.png", "resource/blue-bullet.png", "resource/red-bullet.png",
+    "resource/shadow.png", "resource/explosion.png", "resource/blue-shield.png", "resource/red-shield.png",
+    "resource/blue-win.png", "resource/red-win.png", "resource/play-again.png", "resource/home-button.png",
+    "resource/0.png", "resource/1.png", "resource/2.png", "resource/3.png", "resource/4.png",
+    "resource/5.png", "resource/6.png", "resource/7.png", "resource/8.png", "resource/9.png",
+    "resource/bomb.png", "resource/box.png"
 };
 
-// Structure for tanks
-struct Tank {
-    SDL_Rect rect;
-    bool isMoving;
-    float speed;
-    float rotation; // Rotation angle in degrees (body rotation)
-    float gunRotation; // Gun rotation relative to body (-45 to +45)
-    float gunRotationSpeed; // Speed of gun rotation
-    bool gunRotatingRight; // Direction of gun rotation
-    SDL_Rect gunRect; // Gun rectangle for rendering
-    float gunScale; // Scale factor for gun size
-    int currentAmmo; // Current ammo count (0-5)
-    float reloadTimer; // Timer for reloading
-    bool canShoot; // Whether tank can shoot
-    int hp; // Health points
-    bool isDestroyed; // Whether tank is destroyed
-    bool hasShadow; // Whether tank has shadow
-    int score; // Player score
-    bool hasPower; // Whether tank has power-up (size reduction + speed boost)
-    float powerTimer; // Timer for power-up duration
-    float originalSpeed; // Original speed before power-up
-    int originalWidth; // Original width before power-up
-    int originalHeight; // Original height before power-up
-    int explosionItemCount; // Number of explosion items the tank has
-};
-
-// Structure for bullets
-struct Bullet {
-    SDL_Rect rect;
-    float speed;
-    float rotation; // Direction of bullet
-    bool active;
-    int owner; // 0 for blue tank, 1 for red tank
-    bool isExplosionBullet; // True for explosion bullets (instant kill)
-};
-
-// Structure for explosion effects
-struct Explosion {
-    SDL_Rect rect;
-    float timer;
-    float duration;
-    bool active;
-};
-
-// Structure for power boxes
-struct PowerBox {
-    SDL_Rect rect;
-    bool active;
-    float spawnTimer;
-    float disappearTimer; // Timer for auto-disappear
-    int spawnCount; // Track spawn count to determine type
-    int boxType; // 0=shield, 1=power-up
-};
-
-// Structure for bomb items
-struct BombItem {
-    bool active;
-    int owner; // 0 for blue tank, 1 for red tank
-    SDL_Rect rect;
-    float scale; // Scale factor for bomb size
-};
-
-// Structure for defensive shields
-struct Shield {
-    bool active;
-    float timer;
-    float duration;
-    int owner; // 0 for blue tank, 1 for red tank
-};
-
-// Forward declarations
-void activatePowerUp(Tank* tank);
-void activateShield(Shield* shield, int owner);
-
-// Helper function to check if file exists
-bool fileExists(const std::string& path) {
-    std::ifstream file(path);
-    return file.good();
+// Helper function to queue a decoded image for the sprite atlas (-1 if it failed to load)
+int loadAtlasImage(const std::string& path, AssetLoader* assets, TextureAtlas* atlas) {
+    return addAtlasImage(atlas, getAssetSurface(assets, path));
 }
 
-// Helper function to load texture from file
-SDL_Texture* loadTexture(const std::string& path, SDL_Renderer* renderer) {
-    std::cout << "[DEBUG] Attempting to load: " << path << std::endl;
-    
-    // Get current working directory
-    char* basePath = SDL_GetBasePath();
-    if (basePath) {
-        std::cout << "[DEBUG] SDL Base Path: " << basePath << std::endl;
-        SDL_free(basePath);
-    }
-    
-    // Check if file exists
-    if (!fileExists(path)) {
-        std::cout << "[ERROR] File does not exist: " << path << std::endl;
-        
-        // Try alternate path
-        std::string altPath = "../" + path;
-        std::cout << "[DEBUG] Trying alternate path: " << altPath << std::endl;
-        if (fileExists(altPath)) {
-            std::cout << "[DEBUG] Found at alternate path!" << std::endl;
-            return loadTexture(altPath, renderer);
+// Helper function to draw the game background repeated across the visible part of the world
+// (one copy per screen-sized area, so the default arena shows it exactly once)
+void drawTiledBackground(SDL_Renderer* renderer, SDL_Texture* background, const Camera* camera) {
+    SDL_Rect view = getCameraView(camera);
+    int tileWidth = camera->viewWidth;
+    int tileHeight = camera->viewHeight;
+    int right = std::min(view.x + view.w, camera->worldWidth);
+    int bottom = std::min(view.y + view.h, camera->worldHeight);
+    for (int tileY = std::max(0, view.y) / tileHeight * tileHeight; tileY < bottom; tileY += tileHeight) {
+        for (int tileX = std::max(0, view.x) / tileWidth * tileWidth; tileX < right; tileX += tileWidth) {
+            SDL_Rect tile = worldToScreen(camera, SDL_Rect{tileX, tileY, tileWidth, tileHeight});
+            SDL_RenderCopy(renderer, background, NULL, &tile);
         }
-        return nullptr;
     }
-    
-    std::cout << "[DEBUG] File exists, loading..." << std::endl;
-    
-    SDL_Surface* loadedSurface = IMG_Load(path.c_str());
-    if (!loadedSurface) {
-        std::cout << "[ERROR] Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
-        return nullptr;
-    }
-    
-    std::cout << "[DEBUG] Surface loaded successfully, creating texture..." << std::endl;
-    
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-    SDL_FreeSurface(loadedSurface);
-    
-    if (!texture) {
-        std::cout << "[ERROR] Unable to create texture from " << path << "! SDL Error: " << SDL_GetError() << std::endl;
-    } else {
-        std::cout << "[SUCCESS] Texture created successfully from " << path << std::endl;
-    }
-    
-    return texture;
+}
+
+// Check if two rectangles overlap
+bool rectsIntersect(SDL_Rect a, SDL_Rect b) {
+    return a.x < b.x + b.w && a.x + a.w > b.x && a.y < b.y + b.h && a.y + a.h > b.y;
 }
 
 // Check if point is inside rectangle
@@ -166,319 +86,83 @@ void renderText(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Colo
     // You can replace this with proper text rendering later
 }
 
-// Function to generate random number between min and max
-int random(int min, int max) {
-    return min + rand() % (max - min + 1);
-}
-
-// Function to check if two rectangles overlap with minimum distance
-bool checkCollision(SDL_Rect a, SDL_Rect b, int minDistance = 15) {
-    // Expand rectangles by minDistance to ensure minimum spacing
-    SDL_Rect expandedA = {a.x - minDistance, a.y - minDistance, a.w + 2*minDistance, a.h + 2*minDistance};
-    SDL_Rect expandedB = {b.x - minDistance, b.y - minDistance, b.w + 2*minDistance, b.h + 2*minDistance};
-    
-    return (expandedA.x < expandedB.x + expandedB.w && expandedA.x + expandedA.w > expandedB.x && 
-            expandedA.y < expandedB.y + expandedB.h && expandedA.y + expandedA.h > expandedB.y);
-}
-
-// Function to check if object collides with any existing objects
-bool checkObjectCollision(SDL_Rect newRect, SDL_Rect* existingRects, int count, int minDistance = 15) {
-    for (int i = 0; i < count; i++) {
-        if (checkCollision(newRect, existingRects[i], minDistance)) {
-            return true;
-        }
-    }
-    return false;
-}
-
-// Function to check if tank collides with any game objects (grass or rocks)
-bool checkTankCollisionWithObjects(SDL_Rect tankRect, GameObject* grassObjects, GameObject* rockObjects, int grassCount, int rockCount) {
-    // Check collision with grass objects (ignore destroyed ones)
-    for (int i = 0; i < grassCount; i++) {
-        if (grassObjects[i].isDestroyed) continue; // Skip destroyed objects
-        
-        // Direct collision check without minDistance
-        bool collisionX = tankRect.x < grassObjects[i].rect.x + grassObjects[i].rect.w && 
-                         tankRect.x + tankRect.w > grassObjects[i].rect.x;
-        bool collisionY = tankRect.y < grassObjects[i].rect.y + grassObjects[i].rect.h && 
-                         tankRect.y + tankRect.h > grassObjects[i].rect.y;
-        
-        if (collisionX && collisionY) {
-            std::cout << "[DEBUG] Tank collision with grass[" << i << "] at (" 
-                     << grassObjects[i].rect.x << "," << grassObjects[i].rect.y 
-                     << ") size " << grassObjects[i].rect.w << "x" << grassObjects[i].rect.h << std::endl;
-            std::cout << "[DEBUG] Collision details - Tank: (" << tankRect.x << "," << tankRect.y 
-                     << ") " << tankRect.w << "x" << tankRect.h << " Grass: (" 
-                     << grassObjects[i].rect.x << "," << grassObjects[i].rect.y 
-                     << ") " << grassObjects[i].rect.w << "x" << grassObjects[i].rect.h << std::endl;
-            std::cout << "[DEBUG] CollisionX: " << collisionX << " CollisionY: " << collisionY << std::endl;
-            return true;
-        }
-    }
-    
-    // Check collision with rock objects (ignore destroyed ones)
-    for (int i = 0; i < rockCount; i++) {
-        if (rockObjects[i].isDestroyed) continue; // Skip destroyed objects
-        
-        // Direct collision check without minDistance
-        if (tankRect.x < rockObjects[i].rect.x + rockObjects[i].rect.w && 
-            tankRect.x + tankRect.w > rockObjects[i].rect.x && 
-            tankRect.y < rockObjects[i].rect.y + rockObjects[i].rect.h && 
-            tankRect.y + tankRect.h > rockObjects[i].rect.y) {
-            std::cout << "[DEBUG] Tank collision with rock[" << i << "] at (" 
-                     << rockObjects[i].rect.x << "," << rockObjects[i].rect.y 
-                     << ") size " << rockObjects[i].rect.w << "x" << rockObjects[i].rect.h << std::endl;
-            return true;
-        }
-    }
-    
-    return false;
-}
-
-// Function to check collision between two tanks
-bool checkTankCollision(SDL_Rect tank1, SDL_Rect tank2) {
-    return (tank1.x < tank2.x + tank2.w && tank1.x + tank1.w > tank2.x && 
-            tank1.y < tank2.y + tank2.h && tank1.y + tank1.h > tank2.y);
-}
-
-// Function to check if bullet collides with tank
-bool checkBulletTankCollision(SDL_Rect bullet, SDL_Rect tank) {
-    return (bullet.x < tank.x + tank.w && bullet.x + bullet.w > tank.x && 
-            bullet.y < tank.y + tank.h && bullet.y + bullet.h > tank.y);
-}
-
-// Function to check if bullet collides with game object
-bool checkBulletObjectCollision(SDL_Rect bullet, GameObject obj) {
-    if (obj.isDestroyed) return false; // Don't collide with destroyed objects
-    return (bullet.x < obj.rect.x + obj.rect.w && bullet.x + bullet.w > obj.rect.x && 
-            bullet.y < obj.rect.y + obj.rect.h && bullet.y + bullet.h > obj.rect.y);
-}
-
-// Function to destroy game object and create shadow
-void destroyGameObject(GameObject* obj) {
-    if (!obj->isDestroyed) {
-        obj->isDestroyed = true;
-        obj->hasShadow = true;
-        std::cout << "[DESTROY] Object destroyed at (" << obj->rect.x << "," << obj->rect.y << ")" << std::endl;
-    }
-}
-
-// Function to update gun rotation
-void updateGunRotation(Tank* tank, float deltaTime) {
-    const float MIN_GUN_ROTATION = -45.0f;
-    const float MAX_GUN_ROTATION = 45.0f;
-    
-    // Update gun rotation
-    if (tank->gunRotatingRight) {
-        tank->gunRotation += tank->gunRotationSpeed * deltaTime;
-        if (tank->gunRotation >= MAX_GUN_ROTATION) {
-            tank->gunRotation = MAX_GUN_ROTATION;
-            tank->gunRotatingRight = false;
-        }
-    } else {
-        tank->gunRotation -= tank->gunRotationSpeed * deltaTime;
-        if (tank->gunRotation <= MIN_GUN_ROTATION) {
-            tank->gunRotation = MIN_GUN_ROTATION;
-            tank->gunRotatingRight = true;
-        }
-    }
-}
-
-// Function to update gun rectangle and scale
-void updateGunRect(Tank* tank) {
-    // Set gun scale (smaller than body)
-    tank->gunScale = 0.5f; // 50% of original size
-    
-    // Calculate gun dimensions
-    int gunWidth = (int)(tank->rect.w * tank->gunScale);
-    int gunHeight = (int)(tank->rect.h * (tank->gunScale + 0.2f));
-    
-    // Set specific offsets for each direction
-    int offsetX = 0;
-    int offsetY = 0;
-    
-    // Set position based on tank rotation
-    if (tank->rotation == 0.0f) {
-        // Facing up - gun above center
-        offsetX = 0;
-        offsetY = -20;
-    } else if (tank->rotation == 90.0f) {
-        // Facing right - gun to the right
-        offsetX = 25;
-        offsetY =5;
-    } else if (tank->rotation == 180.0f) {
-        // Facing down - gun below center
-        offsetX = 0;
-        offsetY = tank->rect.h/2 -18;
-    } else if (tank->rotation == 270.0f) {
-        // Facing left - gun to the left
-        offsetX = -12;
-        offsetY =6;
-    }
-    
-    // Position gun at center of tank body with specific offset
-    tank->gunRect.x = tank->rect.x + (tank->rect.w - gunWidth) / 2 + offsetX;
-    tank->gunRect.y = tank->rect.y + (tank->rect.h - gunHeight) / 2 + offsetY;
-    tank->gunRect.w = gunWidth;
-    tank->gunRect.h = gunHeight;
-}
-
-// Function to fire bullet from tank
-void fireBullet(Bullet* bullet, Tank tank, int owner, bool isExplosionBullet = false) {
-    bullet->active = true;
-    bullet->owner = owner;
-    bullet->rotation = tank.rotation + tank.gunRotation; // Combine body and gun rotation
-    bullet->speed = 2.0f;
-    bullet->isExplosionBullet = isExplosionBullet;
-    
-    // Position bullet at tank center
-    bullet->rect.w = 8;
-    bullet->rect.h = 10;
-    bullet->rect.x = tank.rect.x + tank.rect.w/2 - bullet->rect.w/2;
-    bullet->rect.y = tank.rect.y + tank.rect.h/2 - bullet->rect.h/2;
-}
-
-// Function to update bullet position
-void updateBullet(Bullet* bullet) {
-    if (!bullet->active) return;
-    
-    // Convert rotation to radians and calculate movement
-    float radians = bullet->rotation * M_PI / 180.0f;
-    bullet->rect.x += bullet->speed * sin(radians);
-    bullet->rect.y -= bullet->speed * cos(radians);
-    
-    // Deactivate bullet if it goes off screen
-    if (bullet->rect.x < 0 || bullet->rect.x > 960 || 
-        bullet->rect.y < 0 || bullet->rect.y > 540) {
-        bullet->active = false;
-    }
-}
-
-// Function to update tank ammo system
-void updateTankAmmo(Tank* tank, float deltaTime) {
-    const float RELOAD_TIME = 0.5f; // 0.5 seconds
-    const int MAX_AMMO = 5;
-    
-    // Update reload timer
-    if (tank->currentAmmo < MAX_AMMO) {
-        tank->reloadTimer += deltaTime;
-        
-        // If reload time is reached, add one ammo
-        if (tank->reloadTimer >= RELOAD_TIME) {
-            tank->currentAmmo++;
-            tank->reloadTimer = 0.0f;
-            std::cout << "[AMMO] Tank reloaded! Current ammo: " << tank->currentAmmo << "/" << MAX_AMMO << std::endl;
-        }
-    }
-    
-    // Tank can shoot if it has ammo
-    tank->canShoot = (tank->currentAmmo > 0);
-}
-
-// Function to try to fire bullet (returns true if successful)
-bool tryFireBullet(Bullet* bullet, Tank* tank, int owner) {
-    if (!tank->canShoot || tank->currentAmmo <= 0) {
-        return false;
-    }
-    
-    // Consume ammo
-    tank->currentAmmo--;
-    tank->reloadTimer = 0.0f; // Reset reload timer
-    
-    // Fire the bullet
-    fireBullet(bullet, *tank, owner);
-    std::cout << "[AMMO] Tank fired! Remaining ammo: " << tank->currentAmmo << "/5" << std::endl;
-    
-    return true;
-}
-
 // Function to draw ammo bar
-void drawAmmoBar(SDL_Renderer* renderer, Tank tank, int x, int y, int width, int height, SDL_Color color) {
-    const int MAX_AMMO = 5;
-    const float RELOAD_TIME = 0.5f;
+void drawAmmoBar(SpriteBatch* batch, const TankStore* tanks, int tank, int x, int y, int width, int height, SDL_Color color) {
+    const int MAX_AMMO = TANK_MAX_AMMO;
+    const float RELOAD_TIME = (float)TANK_RELOAD_TICKS;
+    int currentAmmo = tanks->ammo[tank];
+    float reloadTimer = (float)tanks->reloadTimer[tank];
     
     // Draw background bar
     SDL_Rect bgRect = {x, y, width, height};
-    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-    SDL_RenderFillRect(renderer, &bgRect);
+    drawBatchRect(batch, bgRect, SDL_Color{50, 50, 50, 255});
     
     // Draw ammo segments
     int segmentWidth = width / MAX_AMMO;
-    for (int i = 0; i < tank.currentAmmo; i++) {
+    for (int i = 0; i < currentAmmo; i++) {
         SDL_Rect ammoRect = {x + i * segmentWidth, y, segmentWidth - 2, height};
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
-        SDL_RenderFillRect(renderer, &ammoRect);
+        drawBatchRect(batch, ammoRect, SDL_Color{color.r, color.g, color.b, 255});
     }
     
     // Draw reloading segment if applicable
-    if (tank.currentAmmo < MAX_AMMO && tank.reloadTimer > 0) {
-        float reloadProgress = tank.reloadTimer / RELOAD_TIME;
+    if (currentAmmo < MAX_AMMO && reloadTimer > 0) {
+        float reloadProgress = reloadTimer / RELOAD_TIME;
         int reloadWidth = (int)(segmentWidth * reloadProgress);
-        SDL_Rect reloadRect = {x + tank.currentAmmo * segmentWidth, y, reloadWidth, height};
-        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255); // Yellow for reloading
-        SDL_RenderFillRect(renderer, &reloadRect);
+        SDL_Rect reloadRect = {x + currentAmmo * segmentWidth, y, reloadWidth, height};
+        drawBatchRect(batch, reloadRect, SDL_Color{255, 255, 0, 255}); // Yellow for reloading
     }
     
     // Draw border
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &bgRect);
+    drawBatchRectOutline(batch, bgRect, SDL_Color{255, 255, 255, 255});
 }
 
 // Function to draw HP bar
-void drawHPBar(SDL_Renderer* renderer, Tank tank, int x, int y, int width, int height, SDL_Color color) {
-    const int MAX_HP = 100;
+void drawHPBar(SpriteBatch* batch, const TankStore* tanks, int tank, int x, int y, int width, int height, SDL_Color color) {
+    const int MAX_HP = TANK_MAX_HP;
     
     // Draw background bar
     SDL_Rect bgRect = {x, y, width, height};
-    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-    SDL_RenderFillRect(renderer, &bgRect);
+    drawBatchRect(batch, bgRect, SDL_Color{50, 50, 50, 255});
     
     // Draw HP bar
-    int hpWidth = (int)((float)tank.hp / MAX_HP * width);
+    int hpWidth = (int)((float)tanks->hp[tank] / MAX_HP * width);
     if (hpWidth > 0) {
         SDL_Rect hpRect = {x, y, hpWidth, height};
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
-        SDL_RenderFillRect(renderer, &hpRect);
+        drawBatchRect(batch, hpRect, SDL_Color{color.r, color.g, color.b, 255});
     }
     
     // Draw border
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &bgRect);
-}
-
-// Function to create explosion effect
-void createExplosion(Explosion* explosion, SDL_Rect position) {
-    explosion->active = true;
-    explosion->timer = 0.0f;
-    explosion->duration = 1.0f; // 1 second duration
-    explosion->rect.x = position.x + position.w/2 - 32; // Center explosion
-    explosion->rect.y = position.y + position.h/2 - 32;
-    explosion->rect.w = 64;
-    explosion->rect.h = 64;
-}
-
-// Function to update explosion effect
-void updateExplosion(Explosion* explosion, float deltaTime) {
-    if (!explosion->active) return;
-    
-    explosion->timer += deltaTime;
-    if (explosion->timer >= explosion->duration) {
-        explosion->active = false;
-    }
+    drawBatchRectOutline(batch, bgRect, SDL_Color{255, 255, 255, 255});
 }
 
-// Function to destroy tank
-void destroyTank(Tank* tank) {
-    if (!tank->isDestroyed) {
-        tank->isDestroyed = true;
-        tank->hasShadow = true;
-        tank->hp = 0;
-        std::cout << "[DESTROY] Tank destroyed!" << std::endl;
+// Function to draw the particles as squares fading out with their life, in one pass per batch run
+void drawParticles(SpriteBatch* batch, const ParticleSystem* particles, const Camera* camera) {
+    float originX = camera->centerX - camera->viewWidth / (2.0f * camera->zoom);
+    float originY = camera->centerY - camera->viewHeight / (2.0f * camera->zoom);
+    float zoom = camera->zoom;
+    int next = 0;
+    while (next < particles->count) {
+        int reserved;
+        SDL_Vertex* vertices = reserveBatchQuads(batch, particles->count - next, &reserved);
+        if (!vertices) return;
+        for (int i = 0; i < reserved; i++, next++) {
+            float half = particles->size[next] * 0.5f * zoom;
+            float x = (particles->x[next] - originX) * zoom;
+            float y = (particles->y[next] - originY) * zoom;
+            SDL_Color color = particles->color[next];
+            color.a = (Uint8)(color.a * std::min(1.0f, particles->life[next] * particles->fade[next]));
+            SDL_Vertex* quad = vertices + i * 4;
+            quad[0].position = SDL_FPoint{x - half, y - half};
+            quad[1].position = SDL_FPoint{x + half, y - half};
+            quad[2].position = SDL_FPoint{x + half, y + half};
+            quad[3].position = SDL_FPoint{x - half, y + half};
+            quad[0].color = quad[1].color = quad[2].color = quad[3].color = color;
+        }
     }
 }
 
 // Function to draw score using number images
-void drawScoreWithNumbers(SDL_Renderer* renderer, SDL_Texture* numberTextures[], int score, int x, int y, int digitWidth, int digitHeight) {
+void drawScoreWithNumbers(SpriteBatch* batch, const int numberSprites[], int score, int x, int y, int digitWidth, int digitHeight) {
     // Convert score to string to get individual digits
     std::string scoreStr = std::to_string(score);
     
@@ -490,505 +174,534 @@ void drawScoreWithNumbers(SDL_Renderer* renderer, SDL_Texture* numberTextures[],
     for (size_t i = 0; i < scoreStr.length(); i++) {
         int digit = scoreStr[i] - '0'; // Convert char to int
         
-        if (digit >= 0 && digit <= 9 && numberTextures[digit]) {
+        if (digit >= 0 && digit <= 9) {
             SDL_Rect digitRect = {
                 startX + i * digitWidth,
                 y,
                 digitWidth,
                 digitHeight
             };
-            SDL_RenderCopy(renderer, numberTextures[digit], NULL, &digitRect);
+            drawSprite(batch, numberSprites[digit], digitRect);
         }
     }
     
-    std::cout << "[SCORE] Displaying score: " << score << std::endl;
+    LOG_DEBUG("[SCORE] Displaying score: %d", score);
 }
 
-// Function to spawn power box at random location
-void spawnPowerBox(PowerBox* powerBox, GameObject* grassObjects, GameObject* rockObjects, int grassCount, int rockCount, Tank* blueTank, Tank* redTank) {
-    if (powerBox->active) return; // Don't spawn if already active
-    
-    // Increment spawn count
-    powerBox->spawnCount++;
-    
-    // Determine box type: 0=shield, 1=power-up, 2=explosion (every 3rd box)
-    powerBox->boxType = powerBox->spawnCount % 2;
-    
-    // Find a random position that doesn't collide with objects or tanks
-    int attempts = 0;
-    do {
-        powerBox->rect.x = random(50, 860);
-        powerBox->rect.y = random(50, 440);
-        powerBox->rect.w = 20;
-        powerBox->rect.h = 20;
-        attempts++;
-    } while ((checkTankCollisionWithObjects(powerBox->rect, grassObjects, rockObjects, grassCount, rockCount) ||
-              checkTankCollision(powerBox->rect, blueTank->rect) ||
-              checkTankCollision(powerBox->rect, redTank->rect)) && attempts < 50);
-    
-    powerBox->active = true;
-    powerBox->disappearTimer = 5.0f; // 5 seconds to disappear
-    
-    if (powerBox->boxType == 0) {
-        std::cout << "[POWERBOX] Shield box spawned at (" << powerBox->rect.x << "," << powerBox->rect.y << ") - Defensive shield!" << std::endl;
-    } else {
-        std::cout << "[POWERBOX] Power-up box spawned at (" << powerBox->rect.x << "," << powerBox->rect.y << ") - Size reduction + Speed boost!" << std::endl;
-    }
-}
-// Function to update power box spawning
-void updatePowerBoxSpawning(PowerBox* powerBox, float deltaTime, GameObject* grassObjects, GameObject* rockObjects, int grassCount, int rockCount, Tank* blueTank, Tank* redTank) {
-    const float SPAWN_INTERVAL = 3.0f; // 3 seconds
-    
-    if (powerBox->active) {
-        // Update disappear timer
-        powerBox->disappearTimer -= deltaTime;
-        if (powerBox->disappearTimer <= 0.0f) {
-            powerBox->active = false;
-            std::cout << "[POWERBOX] Power box disappeared after 5 seconds!" << std::endl;
-        }
-    } else {
-        powerBox->spawnTimer += deltaTime;
-        if (powerBox->spawnTimer >= SPAWN_INTERVAL) {
-            spawnPowerBox(powerBox, grassObjects, rockObjects, grassCount, rockCount, blueTank, redTank);
-            powerBox->spawnTimer = 0.0f;
-        }
+// Helper function to load the map given with --map, or the default arena found next to the resources
+bool loadArenaMap(GameMap* map, const std::string& mapPath) {
+    if (!mapPath.empty()) {
+        return loadMap(map, mapPath);
+    }
+    std::string root;
+    if (!findAssetRoot(DEFAULT_MAP_FILE, &root)) {
+        LOG_ERROR("[ERROR] File does not exist: %s", DEFAULT_MAP_FILE);
+        return false;
     }
+    return loadMap(map, root + DEFAULT_MAP_FILE);
 }
 
-// Function to check if tank collects power box
-bool checkPowerBoxCollection(PowerBox* powerBox, Tank* tank, Shield* shield, int tankOwner) {
-    if (!powerBox->active || tank->isDestroyed) return false;
-    
-    // Check collision between tank and power box
-    if (tank->rect.x < powerBox->rect.x + powerBox->rect.w && 
-        tank->rect.x + tank->rect.w > powerBox->rect.x && 
-        tank->rect.y < powerBox->rect.y + powerBox->rect.h && 
-        tank->rect.y + tank->rect.h > powerBox->rect.y) {
-        
-        powerBox->active = false;
-        
-        if (powerBox->boxType == 0) {
-            // Shield box
-            activateShield(shield, tankOwner);
-            std::cout << "[POWERBOX] Tank " << tankOwner << " collected shield box! Defensive shield activated!" << std::endl;
-        } else {
-            // Power-up box (size reduction + speed boost)
-            activatePowerUp(tank);
-            std::cout << "[POWERBOX] Tank collected power-up box! Size reduced, speed doubled!" << std::endl;
-        } 
-        return true;
+// Function to re-simulate a recorded match headless and report whether it matched
+int runReplay(const std::string& path, const std::string& mapPath) {
+    Replay replay;
+    GameMap map = {};
+    if (!loadReplay(&replay, path) || !loadArenaMap(&map, mapPath)) {
+        return 1;
+    }
+    if (replay.mapHash != map.hash) {
+        LOG_ERROR("[REPLAY] %s was recorded on a different map (pass it with --map)", path.c_str());
+        closeMap(&map);
+        return 1;
     }
-    return false;
-}
 
-// Function to activate shield
-void activateShield(Shield* shield, int owner) {
-    shield->active = true;
-    shield->timer = 0.0f;
-    shield->duration = 30.0f; // 10 seconds
-    shield->owner = owner;
-    std::cout << "[SHIELD] Shield activated for tank " << owner << std::endl;
+    ReplayResult result = playReplay(&replay, &map);
+    closeMap(&map);
+    double ticksPerSecond = result.seconds > 0.0 ? result.ticks / result.seconds : 0.0;
+    LOG_WARN("[REPLAY] %s: %d ticks (%.1f s of play) in %.3f s, %.0f ticks/s, winner %d",
+             path.c_str(), result.ticks, result.ticks * FIXED_TIMESTEP, result.seconds, ticksPerSecond, result.winner);
+    if (result.firstDivergentTick >= 0) {
+        LOG_ERROR("[REPLAY] DIVERGED at tick %d", result.firstDivergentTick);
+        return 1;
+    }
+    LOG_WARN("[REPLAY] Every tick matched the recording");
+    return 0;
 }
 
-// Function to update shield
-void updateShield(Shield* shield, float deltaTime) {
-    if (!shield->active) return;
-    
-    shield->timer += deltaTime;
-    if (shield->timer >= shield->duration) {
-        shield->active = false;
-        std::cout << "[SHIELD] Shield expired" << std::endl;
+// Function to play a network match against ourselves on loopback and report whether both sides agreed
+int runNetplayTest(int ticks, const std::string& mapPath, int latencyMs, int jitterMs, float lossRate) {
+    GameMap map = {};
+    if (!loadArenaMap(&map, mapPath)) {
+        return 1;
     }
-}
-
-// Function to check if tank has active shield
-bool hasActiveShield(Shield* shield, int owner) {
-    return shield->active && shield->owner == owner;
-}
 
-// Function to reflect bullet
-void reflectBullet(Bullet* bullet, Tank* targetTank) {
-    // Reverse the bullet direction
-    bullet->rotation += 180.0f;
-    if (bullet->rotation >= 360.0f) {
-        bullet->rotation -= 360.0f;
+    // Size of the tank body sprite (the test runs without loading any image)
+    const int TEST_TANK_WIDTH = 81;
+    const int TEST_TANK_HEIGHT = 73;
+    NetplayTestResult result =
+        runNetplayLoopback(&map, ticks, TEST_TANK_WIDTH, TEST_TANK_HEIGHT, latencyMs, jitterMs, lossRate);
+    closeMap(&map);
+    if (!result.connected) {
+        LOG_ERROR("[NET] The two sides never connected");
+        return 1;
     }
-    
-    // Change ownership to the shielded tank
-    bullet->owner = (bullet->owner == 0) ? 1 : 0;
-    
-    std::cout << "[REFLECT] Bullet reflected by shielded tank!" << std::endl;
-}
 
-// Function to activate power-up (size reduction + speed boost)
-void activatePowerUp(Tank* tank) {
-    if (!tank->hasPower) {
-        tank->hasPower = true;
-        tank->powerTimer = 15.0f; // 15 seconds duration
-        
-        // Store original values
-        tank->originalSpeed = tank->speed;
-        tank->originalWidth = tank->rect.w;
-        tank->originalHeight = tank->rect.h;
-        
-        // Apply power-up effects
-        tank->speed *= 2.0f; // Double speed
-    
-   
-        std::cout << "[POWERUP] Tank activated power-up! Size reduced, speed doubled!" << std::endl;
-    }
+    const RollbackStats* sides[2] = {&result.host, &result.client};
+    for (int i = 0; i < 2; i++) {
+        const RollbackStats* stats = sides[i];
+        LOG_WARN("[NET] %s: %d rollbacks, %d ticks simulated again (longest %d, worst %.3f ms), %d ticks waiting, "
+                 "%d hash checks, %zu byte snapshots saved in %.2f us",
+                 i == 0 ? "Host" : "Client", stats->rollbacks, stats->resimulatedTicks, stats->longestRollback,
+                 stats->worstRollbackMs, stats->stalls, stats->checks, stats->snapshotBytes,
+                 stats->saves > 0 ? stats->saveMs * 1000.0 / stats->saves : 0.0);
+    }
+    LOG_WARN("[NET] Rolling back %d ticks and simulating them again took %.3f ms", ROLLBACK_MAX_FRAMES,
+             result.forcedRollbackMs);
+    if (!result.matched || result.desyncTick >= 0) {
+        LOG_ERROR("[NET] DIVERGED after %d ticks (first mismatch at tick %d)", result.ticks, result.desyncTick);
+        return 1;
+    }
+    LOG_WARN("[NET] Both sides ended on the same state after %d ticks", result.ticks);
+    return 0;
 }
 
-// Function to update power-up timer
-void updatePowerUp(Tank* tank, float deltaTime) {
-    if (tank->hasPower) {
-        tank->powerTimer -= deltaTime;
-        
-        if (tank->powerTimer <= 0.0f) {
-            // Restore original values
-            tank->speed = tank->originalSpeed;
-            
-            // Restore original size and position
-            tank->rect.x -= tank->originalWidth / 4;
-            tank->rect.y -= tank->originalHeight / 4;
-            tank->rect.w = tank->originalWidth;
-            tank->rect.h = tank->originalHeight;
-            
-            tank->hasPower = false;
-            std::cout << "[POWERUP] Tank power-up expired! Size and speed restored." << std::endl;
-        }
+// Function to serve a match to scripted clients on loopback and report what it cost on the wire
+int runServerTest(int ticks, int clients, const std::string& mapPath, int latencyMs, int jitterMs, float lossRate) {
+    GameMap map = {};
+    if (!loadArenaMap(&map, mapPath)) {
+        return 1;
     }
-}
 
-// Function to fire explosion bullet
-bool fireExplosionBullet(Bullet* bullet, Tank* tank, int owner) {
-    if (tank->explosionItemCount > 0) {
-        tank->explosionItemCount--; // Use one explosion item
-        fireBullet(bullet, *tank, owner, true); // Fire explosion bullet
-        std::cout << "[EXPLOSION] Tank fired explosion bullet! Remaining items: " << tank->explosionItemCount << std::endl;
-        return true;
-    }
-    return false;
-}
-
-// Function to update bomb items position
-void updateBombItems(BombItem* bombItems, int maxItems, Tank* blueTank, Tank* redTank) {
-    // Update blue tank bomb items
-    for (int i = 0; i < blueTank->explosionItemCount && i < maxItems; i++) {
-        bombItems[i].active = true;
-        bombItems[i].owner = 0;
-        bombItems[i].rect.x = blueTank->rect.x + blueTank->rect.w + 5 + (i * 20); // Position to the right
-        bombItems[i].rect.y = blueTank->rect.y + blueTank->rect.h / 2 - 12; // Center vertically
-        bombItems[i].rect.w = 24; // Larger bomb
-        bombItems[i].rect.h = 24;
-        bombItems[i].scale = 0.8f; // Slightly larger scale
-    }
-    
-    // Update red tank bomb items
-    for (int i = 0; i < redTank->explosionItemCount && i < maxItems; i++) {
-        bombItems[i + maxItems/2].active = true;
-        bombItems[i + maxItems/2].owner = 1;
-        bombItems[i + maxItems/2].rect.x = redTank->rect.x + redTank->rect.w + 5 + (i * 20); // Position to the right
-        bombItems[i + maxItems/2].rect.y = redTank->rect.y + redTank->rect.h / 2 - 12; // Center vertically
-        bombItems[i + maxItems/2].rect.w = 24; // Larger bomb
-        bombItems[i + maxItems/2].rect.h = 24;
-        bombItems[i + maxItems/2].scale = 0.8f; // Slightly larger scale
+    // The test runs without loading any image, so with the headless servers' tank size
+    ServerTestResult result =
+        runServerLoopback(&map, ticks, clients, SERVER_TANK_WIDTH, SERVER_TANK_HEIGHT, latencyMs, jitterMs, lossRate);
+    closeMap(&map);
+    if (!result.connected) {
+        LOG_ERROR("[SERVER] The clients never all connected");
+        return 1;
     }
+
+    const ServerStats& server = result.server;
+    double tickClients = (double)std::max(1, result.ticks) * clients;
+    int snapshots = std::max(1, server.snapshots);
+    double bytesPerTick = server.snapshotBytes / tickClients;
+    double wireBytesPerTick = (server.snapshotBytes + (double)server.snapshots * NET_DATAGRAM_OVERHEAD) / tickClients;
+    LOG_WARN("[SERVER] %d ticks to %d clients: %.1f snapshot bytes per tick per client, %.1f with UDP/IP headers "
+             "(%.1f kbit/s)",
+             result.ticks, clients, bytesPerTick, wireBytesPerTick, wireBytesPerTick * SIMULATION_TICK_RATE * 8 / 1000);
+    LOG_WARN("[SERVER] Snapshots: %.1f bytes on average, %d at most, %.1f against the match start instead; "
+             "%d of %d coded against an acknowledged one in %.2f us",
+             (double)server.snapshotBytes / snapshots, server.maxSnapshotBytes, (double)server.fullBytes / snapshots,
+             server.deltaSnapshots, server.snapshots, server.encodeMs * 1000.0 / snapshots);
+    LOG_WARN("[SERVER] Inputs: %.1f bytes per tick per client; simulation %.3f ms per tick",
+             result.inputBytesSent / tickClients, server.simulateMs / std::max(1, result.ticks));
+    LOG_WARN("[SERVER] Clients applied %d snapshots (%d stale, %d without their base, %d bad)",
+             result.client.snapshots, result.client.staleSnapshots, result.client.missingBase,
+             result.client.badSnapshots);
+    if (!result.matched) {
+        LOG_ERROR("[SERVER] A client did not end on the server's final state");
+        return 1;
+    }
+    LOG_WARN("[SERVER] Every client ended on the server's final state");
+    return 0;
 }
 
-// Function to initialize game objects (grass and rocks) with fixed positions
-void initializeGameObjects(GameObject* grassObjects, GameObject* rockObjects, int grassCount, int rockCount, SDL_Rect blueTankRect, SDL_Rect redTankRect) {
-    // Fixed positions for grass objects (20 objects)
-    SDL_Rect grassPositions[20] = {
-        {50, 100, 30, 40}, {150, 200, 20, 40}, {250, 50, 20, 40}, {200, 300, 40, 50}, {350, 150, 20, 40},
-        {400, 400, 30, 30}, {500, 250, 40, 40}, {550, 500, 20, 30}, {650, 100, 30, 30}, {700, 350, 20, 30},
-        {800, 200, 20, 30}, {850, 450, 20, 50}, {900, 50, 20, 50}, {900, 500, 20, 50}, {750, 500, 20, 30},
-        {600, 30, 20, 30}, {450, 500, 20, 30}, {300, 450, 20, 50}, {10, 500, 20, 30}, {940, 500, 20, 30 }
-    };
-    
-    // Fixed positions for rock objects (15 objects)
-    SDL_Rect rockPositions[15] = {
-        {100, 50, 40, 80}, {300, 250, 50, 50}, {450, 100, 30, 50}, {500, 450, 30, 50}, {600, 200, 40, 40},
-        {750, 30, 30, 30}, {800, 300, 30, 50}, {20, 400, 30, 30}, {100, 350, 30, 30}, {250, 150, 30, 45 },
-        {350, 500, 30, 60}, {400, 20, 30, 30}, {650, 400, 30, 30}, {700, 500, 30, 60}, {900, 380, 30, 40}
-    };
-    
-    // Initialize grass objects with fixed positions (keep original aspect ratio)
-    for (int i = 0; i < grassCount; i++) {
-        grassObjects[i].rect.x = grassPositions[i].x;
-        grassObjects[i].rect.y = grassPositions[i].y;
-        grassObjects[i].rect.w = grassPositions[i].w;
-        grassObjects[i].rect.h = grassPositions[i].w; // Keep square aspect ratio
-        grassObjects[i].size = grassObjects[i].rect.w;
-        grassObjects[i].rotation = random(0, 360);
-        grassObjects[i].isDestroyed = false;
-        grassObjects[i].hasShadow = false;
-    }
-    
-    // Initialize rock objects with fixed positions (keep original aspect ratio)
-    for (int i = 0; i < rockCount; i++) {
-        rockObjects[i].rect.x = rockPositions[i].x;
-        rockObjects[i].rect.y = rockPositions[i].y;
-        rockObjects[i].rect.w = rockPositions[i].w;
-        rockObjects[i].rect.h = rockPositions[i].w; // Keep square aspect ratio
-        rockObjects[i].size = rockObjects[i].rect.w;
-        rockObjects[i].rotation = random(0, 360);
-        rockObjects[i].isDestroyed = false;
-        rockObjects[i].hasShadow = false;
+// Function to run the audio engine on a game loop without a sound card and report its figures
+int runAudioTest(double seconds) {
+    AudioTestResult result = runAudioStress(seconds);
+    if (!result.opened) {
+        LOG_ERROR("[AUDIO] Could not open an audio device");
+        return 1;
+    }
+    LOG_WARN("[AUDIO] %s driver at %d Hz, %d channels, %d frames per buffer", result.driver.c_str(), result.frequency,
+             result.channels, result.bufferFrames);
+    LOG_WARN("[AUDIO] %llu play commands (%llu dropped), slowest took %.2f us on the game thread",
+             (unsigned long long)result.commands, (unsigned long long)result.droppedCommands,
+             result.maxPlayMicroseconds);
+    LOG_WARN("[AUDIO] %llu buffers mixed in %.1f us each, %llu voices started, %llu stolen, %d at most",
+             (unsigned long long)result.callbacks, result.mixMicroseconds, (unsigned long long)result.started,
+             (unsigned long long)result.stolen, result.peakVoices);
+    if (result.callbacks == 0) {
+        LOG_ERROR("[AUDIO] The %s driver never asked for audio", result.driver.c_str());
+        return 1;
     }
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
-    std::cout << "========================================" << std::endl;
-    std::cout << "    GAME DEBUG LOG" << std::endl;
-    std::cout << "========================================" << std::endl;
+    // Command line: --map <file> picks the arena, --record <file> saves every
+    // match, --replay <file> verifies a recording and exits, --tanks <n> adds
+    // tanks beyond the players (free-for-all, driven by bots), --threads <n>
+    // sets how many threads run the simulation (default: every hardware thread).
+    // Network play: --host <port> waits for a player, --join <host[:port]>
+    // joins one; --net-latency <ms>, --net-jitter <ms> and --net-loss <percent>
+    // make the connection worse on purpose, and --netplay-test <ticks> plays
+    // both sides on loopback, checks they agree and exits.
+    // Server play: --server <port> runs a server for us and one remote
+    // player, --connect <host[:port]> joins one, and --server-test <ticks>
+    // serves --tanks scripted clients on loopback and reports bytes per tick.
+    // --audio-test <seconds> runs the mixer on SDL_AUDIODRIVER (default
+    // "dummy") under a busy game loop and exits. --rules-test checks the
+    // match rules on scripted duels and exits.
+    std::string mapPath;
+    std::string recordPath;
+    std::string replayPath;
+    std::string joinAddress;
+    std::string connectAddress;
+    int tankCount = 2;
+    int threadCount = 0;
+    int hostPort = 0;
+    int netLatency = 0;
+    int netJitter = 0;
+    float netLoss = 0.0f;
+    int netplayTestTicks = 0;
+    int serverPort = 0;
+    int serverTestTicks = 0;
+    double audioTestSeconds = 0.0;
+    bool rulesTest = false;
+    for (int i = 1; i < argc; i++) {
+        rulesTest |= strcmp(argv[i], "--rules-test") == 0;
+    }
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--map") == 0) {
+            mapPath = argv[++i];
+        } else if (strcmp(argv[i], "--tanks") == 0) {
+            tankCount = std::max(2, std::min(MAX_TANKS, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            threadCount = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--record") == 0) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--host") == 0) {
+            hostPort = std::max(1, std::min(65535, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--join") == 0) {
+            joinAddress = argv[++i];
+        } else if (strcmp(argv[i], "--net-latency") == 0) {
+            netLatency = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--net-jitter") == 0) {
+            netJitter = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--net-loss") == 0) {
+            netLoss = std::max(0.0f, std::min(100.0f, (float)atof(argv[++i]))) / 100.0f;
+        } else if (strcmp(argv[i], "--netplay-test") == 0) {
+            netplayTestTicks = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--server") == 0) {
+            serverPort = std::max(1, std::min(65535, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--connect") == 0) {
+            connectAddress = argv[++i];
+        } else if (strcmp(argv[i], "--server-test") == 0) {
+            serverTestTicks = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--audio-test") == 0) {
+            audioTestSeconds = std::max(0.1, atof(argv[++i]));
+        }
+    }
+    if (!replayPath.empty()) {
+        setLogLevel(LOG_LEVEL_WARN);
+        int status = runReplay(replayPath, mapPath);
+        flushLog();
+        return status;
+    }
+    if (netplayTestTicks > 0) {
+        setLogLevel(LOG_LEVEL_WARN);
+        int status = runNetplayTest(netplayTestTicks, mapPath, netLatency, netJitter, netLoss);
+        flushLog();
+        return status;
+    }
+    if (serverTestTicks > 0) {
+        setLogLevel(LOG_LEVEL_WARN);
+        int status = runServerTest(serverTestTicks, std::min(tankCount, SERVER_MAX_TANKS), mapPath, netLatency,
+                                   netJitter, netLoss);
+        flushLog();
+        return status;
+    }
+    if (rulesTest) {
+        setLogLevel(LOG_LEVEL_WARN);
+        bool passed = runWorldRulesTest();
+        LOG_WARN("[RULES] %s", passed ? "Every rule held" : "A rule was broken");
+        flushLog();
+        return passed ? 0 : 1;
+    }
+    if (audioTestSeconds > 0.0) {
+        setLogLevel(LOG_LEVEL_WARN);
+        int status = runAudioTest(audioTestSeconds);
+        SDL_Quit();
+        flushLog();
+        return status;
+    }
+    
+    LOG_INFO("========================================");
+    LOG_INFO("    GAME DEBUG LOG");
+    LOG_INFO("========================================");
     
     // Print working directory info
     char* basePath = SDL_GetBasePath();
     if (basePath) {
-        std::cout << "[INFO] Executable path: " << basePath << std::endl;
+        LOG_INFO("[INFO] Executable path: %s", basePath);
         SDL_free(basePath);
     }
     
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        std::cout << "[ERROR] SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
+        LOG_ERROR("[ERROR] SDL could not initialize! SDL_Error: %s", SDL_GetError());
         return -1;
     }
-    std::cout << "[SUCCESS] SDL initialized" << std::endl;
+    LOG_INFO("[SUCCESS] SDL initialized");
+    Uint64 startupCounter = SDL_GetPerformanceCounter();
     
     // Initialize SDL_image
     int imgFlags = IMG_INIT_PNG;
     if (!(IMG_Init(imgFlags) & imgFlags)) {
-        std::cout << "[ERROR] SDL_image could not initialize! SDL_image Error: " << IMG_GetError() << std::endl;
+        LOG_ERROR("[ERROR] SDL_image could not initialize! SDL_image Error: %s", IMG_GetError());
         return -1;
     }
-    std::cout << "[SUCCESS] SDL_image initialized" << std::endl;
-    
-    // Audio initialization commented out - SDL_mixer not available
-    // if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
-    //     std::cout << "[ERROR] SDL_mixer could not initialize! SDL_mixer Error: " << Mix_GetError() << std::endl;
-    //     return -1;
-    // }
-    // std::cout << "[SUCCESS] SDL_mixer initialized" << std::endl;
+    LOG_INFO("[SUCCESS] SDL_image initialized");
     
     SDL_Window* window = SDL_CreateWindow("Game", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 
                                          960, 540, SDL_WINDOW_SHOWN);
     if (!window) {
-        std::cout << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        LOG_ERROR("Window could not be created! SDL_Error: %s", SDL_GetError());
         return -1;
     }
     
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     if (!renderer) {
-        std::cout << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        LOG_ERROR("Renderer could not be created! SDL_Error: %s", SDL_GetError());
         return -1;
     }
     
-    // Load welcome screen background
-    SDL_Texture* welcomeBackground = loadTexture("resource/welcome_screen.png", renderer);
-    if (!welcomeBackground) {
-        std::cout << "Failed to load welcome screen background!" << std::endl;
-        return -1;
+    // Decode every image on worker threads, then upload on this thread
+    Uint64 loadStartCounter = SDL_GetPerformanceCounter();
+    AssetLoader assets;
+    initializeAssetLoader(&assets);
+    for (const char* file : ASSET_FILES) {
+        queueAsset(&assets, file);
     }
+    decodeAssets(&assets);
     
-    // Load start button
-    SDL_Texture* startButton = loadTexture("resource/start_button.png", renderer);
-    if (!startButton) {
-        std::cout << "Failed to load start button!" << std::endl;
+    // Load welcome screen background
+    SDL_Texture* welcomeBackground = createAssetTexture(&assets, "resource/welcome_screen.png", renderer);
+    if (!welcomeBackground) {
+        LOG_ERROR("Failed to load welcome screen background!");
         return -1;
     }
     
     // Load game mode background
-    SDL_Texture* gameModeBackground = loadTexture("resource/gamemode_bg.png", renderer);
+    SDL_Texture* gameModeBackground = createAssetTexture(&assets, "resource/gamemode_bg.png", renderer);
     if (!gameModeBackground) {
-        std::cout << "Failed to load game mode background!" << std::endl;
+        LOG_ERROR("Failed to load game mode background!");
         return -1;
     }
     
-    // Load multiplayer buttons
-    SDL_Texture* multiplayerButton = loadTexture("resource/multiplayer.png", renderer);
-    if (!multiplayerButton) {
-        std::cout << "Failed to load multiplayer button!" << std::endl;
+    // Load game background
+    SDL_Texture* gameBackground = createAssetTexture(&assets, "resource/background.png", renderer);
+    if (!gameBackground) {
+        LOG_ERROR("Failed to load game background!");
         return -1;
     }
     
-    SDL_Texture* multiplayerButtonHover = loadTexture("resource/multiplayer_hover.png", renderer);
-    if (!multiplayerButtonHover) {
-        std::cout << "Failed to load multiplayer hover button!" << std::endl;
+    // Everything else is packed into the sprite atlas and drawn through the sprite batch
+    TextureAtlas atlas;
+    initializeTextureAtlas(&atlas);
+    
+    // Load start button
+    int startButton = loadAtlasImage("resource/start_button.png", &assets, &atlas);
+    if (startButton < 0) {
+        LOG_ERROR("Failed to load start button!");
         return -1;
     }
     
-
-    
-    // Load game assets
-    SDL_Texture* gameBackground = loadTexture("resource/background.png", renderer);
-    if (!gameBackground) {
-        std::cout << "Failed to load game background!" << std::endl;
+    // Load singleplayer buttons
+    int singleplayerButton = loadAtlasImage("resource/singleplayer.png", &assets, &atlas);
+    if (singleplayerButton < 0) {
+        LOG_ERROR("Failed to load singleplayer button!");
         return -1;
     }
     
-    // Load tank body and gun textures
-    SDL_Texture* blueBody = loadTexture("resource/blue-body.png", renderer);
-    if (!blueBody) {
-        std::cout << "Failed to load blue body!" << std::endl;
+    int singleplayerButtonHover = loadAtlasImage("resource/singleplayer_hover.png", &assets, &atlas);
+    if (singleplayerButtonHover < 0) {
+        LOG_ERROR("Failed to load singleplayer hover button!");
         return -1;
     }
     
-    SDL_Texture* blueGun = loadTexture("resource/blue-gun.png", renderer);
-    if (!blueGun) {
-        std::cout << "Failed to load blue gun!" << std::endl;
+    // Load multiplayer buttons
+    int multiplayerButton = loadAtlasImage("resource/multiplayer.png", &assets, &atlas);
+    if (multiplayerButton < 0) {
+        LOG_ERROR("Failed to load multiplayer button!");
         return -1;
     }
     
-    SDL_Texture* redBody = loadTexture("resource/red-body.png", renderer);
-    if (!redBody) {
-        std::cout << "Failed to load red body!" << std::endl;
+    int multiplayerButtonHover = loadAtlasImage("resource/multiplayer_hover.png", &assets, &atlas);
+    if (multiplayerButtonHover < 0) {
+        LOG_ERROR("Failed to load multiplayer hover button!");
         return -1;
     }
     
-    SDL_Texture* redGun = loadTexture("resource/red-gun.png", renderer);
-    if (!redGun) {
-        std::cout << "Failed to load red gun!" << std::endl;
+    // Load tank body and gun sprites
+    int blueBody = loadAtlasImage("resource/blue-body.png", &assets, &atlas);
+    if (blueBody < 0) {
+        LOG_ERROR("Failed to load blue body!");
         return -1;
     }
     
-    SDL_Texture* grass = loadTexture("resource/grass.png", renderer);
-    if (!grass) {
-        std::cout << "Failed to load grass!" << std::endl;
+    int blueGun = loadAtlasImage("resource/blue-gun.png", &assets, &atlas);
+    if (blueGun < 0) {
+        LOG_ERROR("Failed to load blue gun!");
         return -1;
     }
     
-    SDL_Texture* rock = loadTexture("resource/rock.png", renderer);
-    if (!rock) {
-        std::cout << "Failed to load rock!" << std::endl;
+    int redBody = loadAtlasImage("resource/red-body.png", &assets, &atlas);
+    if (redBody < 0) {
+        LOG_ERROR("Failed to load red body!");
         return -1;
     }
     
-    // Load bullet textures
-    SDL_Texture* blueBullet = loadTexture("resource/blue-bullet.png", renderer);
-    if (!blueBullet) {
-        std::cout << "Failed to load blue bullet!" << std::endl;
+    int redGun = loadAtlasImage("resource/red-gun.png", &assets, &atlas);
+    if (redGun < 0) {
+        LOG_ERROR("Failed to load red gun!");
         return -1;
     }
     
-    SDL_Texture* redBullet = loadTexture("resource/red-bullet.png", renderer);
-    if (!redBullet) {
-        std::cout << "Failed to load red bullet!" << std::endl;
+    int grass = loadAtlasImage("resource/grass.png", &assets, &atlas);
+    if (grass < 0) {
+        LOG_ERROR("Failed to load grass!");
         return -1;
     }
     
-    // Load shadow textures (optional - use original textures if shadows don't exist)
-    SDL_Texture* grassShadow = loadTexture("resource/shadow.png", renderer);
-    if (!grassShadow) {
-        std::cout << "Warning: Failed to load grass shadow, using original grass texture!" << std::endl;
-        grassShadow = grass; // Use original grass texture as fallback
+    int rock = loadAtlasImage("resource/rock.png", &assets, &atlas);
+    if (rock < 0) {
+        LOG_ERROR("Failed to load rock!");
+        return -1;
     }
     
-    SDL_Texture* rockShadow = loadTexture("resource/shadow.png", renderer);
-    if (!rockShadow) {
-        std::cout << "Warning: Failed to load rock shadow, using original rock texture!" << std::endl;
-        rockShadow = rock; // Use original rock texture as fallback
+    // Load bullet sprites
+    int blueBullet = loadAtlasImage("resource/blue-bullet.png", &assets, &atlas);
+    if (blueBullet < 0) {
+        LOG_ERROR("Failed to load blue bullet!");
+        return -1;
     }
     
-    // Load explosion texture
-    SDL_Texture* explosionTexture = loadTexture("resource/explosion.png", renderer);
-    if (!explosionTexture) {
-        std::cout << "Warning: Failed to load explosion texture!" << std::endl;
-        // Create a simple colored rectangle as fallback
-        explosionTexture = nullptr;
+    int redBullet = loadAtlasImage("resource/red-bullet.png", &assets, &atlas);
+    if (redBullet < 0) {
+        LOG_ERROR("Failed to load red bullet!");
+        return -1;
     }
     
-    // Load tank shadow texture
-    SDL_Texture* tankShadow = loadTexture("resource/shadow.png", renderer);
-    if (!tankShadow) {
-        std::cout << "Warning: Failed to load tank shadow, using blue body as fallback!" << std::endl;
+    // Load the shadow sprite (optional - use original sprites if shadows don't exist)
+    int shadow = loadAtlasImage("resource/shadow.png", &assets, &atlas);
+    int grassShadow = shadow;
+    int rockShadow = shadow;
+    int tankShadow = shadow;
+    if (shadow < 0) {
+        LOG_WARN("Warning: Failed to load shadow, using original grass, rock and blue body sprites!");
+        grassShadow = grass; // Use original grass sprite as fallback
+        rockShadow = rock; // Use original rock sprite as fallback
         tankShadow = blueBody; // Use blue body as fallback
     }
     
-    // Load shield tank textures
-    SDL_Texture* blueShieldTank = loadTexture("resource/blue-shield.png", renderer);
-    if (!blueShieldTank) {
-        std::cout << "Failed to load blue-shield tank!" << std::endl;
+    // Load explosion sprite (optional - explosions are not drawn without it)
+    int explosionSprite = loadAtlasImage("resource/explosion.png", &assets, &atlas);
+    if (explosionSprite < 0) {
+        LOG_WARN("Warning: Failed to load explosion texture!");
+    }
+    
+    // Load shield tank sprites
+    int blueShieldTank = loadAtlasImage("resource/blue-shield.png", &assets, &atlas);
+    if (blueShieldTank < 0) {
+        LOG_ERROR("Failed to load blue-shield tank!");
         return -1;
     }
     
-    SDL_Texture* redShieldTank = loadTexture("resource/red-shield.png", renderer);
-    if (!redShieldTank) {
-        std::cout << "Failed to load red-shield tank!" << std::endl;
+    int redShieldTank = loadAtlasImage("resource/red-shield.png", &assets, &atlas);
+    if (redShieldTank < 0) {
+        LOG_ERROR("Failed to load red-shield tank!");
         return -1;
     }
     
     // Load winner images
-    SDL_Texture* blueWinImage = loadTexture("resource/blue-win.png", renderer);
-    if (!blueWinImage) {
-        std::cout << "Failed to load blue-win image!" << std::endl;
+    int blueWinImage = loadAtlasImage("resource/blue-win.png", &assets, &atlas);
+    if (blueWinImage < 0) {
+        LOG_ERROR("Failed to load blue-win image!");
         return -1;
     }
     
-    SDL_Texture* redWinImage = loadTexture("resource/red-win.png", renderer);
-    if (!redWinImage) {
-        std::cout << "Failed to load red-win image!" << std::endl;
+    int redWinImage = loadAtlasImage("resource/red-win.png", &assets, &atlas);
+    if (redWinImage < 0) {
+        LOG_ERROR("Failed to load red-win image!");
         return -1;
     }
     
     // Load winner screen buttons
-    SDL_Texture* playAgainButton = loadTexture("resource/play-again.png", renderer);
-    if (!playAgainButton) {
-        std::cout << "Failed to load play-again button!" << std::endl;
+    int playAgainButton = loadAtlasImage("resource/play-again.png", &assets, &atlas);
+    if (playAgainButton < 0) {
+        LOG_ERROR("Failed to load play-again button!");
         return -1;
     }
     
-    SDL_Texture* homeButton = loadTexture("resource/home-button.png", renderer);
-    if (!homeButton) {
-        std::cout << "Failed to load home button!" << std::endl;
+    int homeButton = loadAtlasImage("resource/home-button.png", &assets, &atlas);
+    if (homeButton < 0) {
+        LOG_ERROR("Failed to load home button!");
         return -1;
     }
     
     // Load number images (0-9)
-    SDL_Texture* numberTextures[10];
+    int numberSprites[10];
     for (int i = 0; i < 10; i++) {
         std::string numberPath = "resource/" + std::to_string(i) + ".png";
-        numberTextures[i] = loadTexture(numberPath, renderer);
-        if (!numberTextures[i]) {
-            std::cout << "Failed to load number " << i << " image!" << std::endl;
+        numberSprites[i] = loadAtlasImage(numberPath, &assets, &atlas);
+        if (numberSprites[i] < 0) {
+            LOG_ERROR("Failed to load number %d image!", i);
             return -1;
         }
     }
     
-    // Load bomb texture
-    SDL_Texture* bombTexture = loadTexture("resource/bomb.png", renderer);
-    if (!bombTexture) {
-        std::cout << "Failed to load bomb texture!" << std::endl;
+    // Load bomb sprite
+    int bombSprite = loadAtlasImage("resource/bomb.png", &assets, &atlas);
+    if (bombSprite < 0) {
+        LOG_ERROR("Failed to load bomb texture!");
+        return -1;
+    }
+    
+    // Decode every sound to the device format now, so playing one is only a copy
+    // (without a device or a file the game runs without that sound)
+    AudioEngine audio;
+    if (openAudioEngine(&audio)) {
+        for (int i = 0; i < SOUND_COUNT; i++) {
+            loadAudioSample(&audio, i, assets.root + SOUND_FILES[i]);
+        }
+        startAudioEngine(&audio);
+    }
+    
+    // Load power box sprite
+    int powerBoxSprite = loadAtlasImage("resource/box.png", &assets, &atlas);
+    if (powerBoxSprite < 0) {
+        LOG_ERROR("Failed to load power box texture!");
         return -1;
     }
     
-    // Audio loading commented out - SDL_mixer not available
-    // Mix_Music* backgroundMusic = Mix_LoadMUS("resource/background.mp3");
-    // if (!backgroundMusic) {
-    //     std::cout << "Warning: Failed to load background music!" << std::endl;
-    // }
-    // 
-    // Mix_Chunk* explosionSound = Mix_LoadWAV("resource/explosion.mp3");
-    // if (!explosionSound) {
-    //     std::cout << "Warning: Failed to load explosion sound!" << std::endl;
-    // }
-    // 
-    // Mix_Chunk* winnerSound = Mix_LoadWAV("resource/winner.mp3");
-    // if (!winnerSound) {
-    //     std::cout << "Warning: Failed to load winner sound!" << std::endl;
-    // }
-    
-    // Load power box texture
-    SDL_Texture* powerBoxTexture = loadTexture("resource/box.png", renderer);
-    if (!powerBoxTexture) {
-        std::cout << "Failed to load power box texture!" << std::endl;
+    // Pack the sprites into atlas pages
+    Uint64 atlasStartCounter = SDL_GetPerformanceCounter();
+    if (!buildTextureAtlas(&atlas, renderer)) {
+        LOG_ERROR("Failed to build sprite atlas!");
         return -1;
     }
+    releaseAssetSurfaces(&assets);
+    
+    // Report where startup time went
+    double counterMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    Uint64 loadEndCounter = SDL_GetPerformanceCounter();
+    logAssetReport(&assets);
+    LOG_INFO("[ASSETS] Atlas build and upload: %.2f ms", (loadEndCounter - atlasStartCounter) * counterMs);
+    LOG_INFO("[ASSETS] Total asset loading: %.2f ms", (loadEndCounter - loadStartCounter) * counterMs);
+    
+    SpriteBatch spriteBatch;
+    initializeSpriteBatch(&spriteBatch, renderer, &atlas);
+    
+    // Hit, explosion and debris particles (drawing side only, fed from the gameplay events)
+    ParticleSystem particles;
+    initializeParticleSystem(&particles);
     
     
     // Get button dimensions
-    int buttonWidth, buttonHeight;
-    SDL_QueryTexture(startButton, NULL, NULL, &buttonWidth, &buttonHeight);
+    int buttonWidth = atlas.sprites[startButton].source.w;
+    int buttonHeight = atlas.sprites[startButton].source.h;
     
     // Position start button at center-bottom of screen
     SDL_Rect startButtonRect;
@@ -996,14 +709,14 @@ int main(int argc, char* argv[]) {
     startButtonRect.h = buttonHeight;
     startButtonRect.x = (960 - buttonWidth)/2 + 200;
     startButtonRect.y = (540 - buttonHeight) / 2;
-    cout<<"startButtonRect.x: "<<startButtonRect.x<<endl;
-    cout<<"startButtonRect.y: "<<startButtonRect.y<<endl;
-    cout<<"startButtonRect.w: "<<startButtonRect.w<<endl;
-    cout<<"startButtonRect.h: "<<startButtonRect.h<<endl;
+    LOG_DEBUG("startButtonRect.x: %d", startButtonRect.x);
+    LOG_DEBUG("startButtonRect.y: %d", startButtonRect.y);
+    LOG_DEBUG("startButtonRect.w: %d", startButtonRect.w);
+    LOG_DEBUG("startButtonRect.h: %d", startButtonRect.h);
     
     // Get multiplayer button dimensions
-    int multiplayerWidth, multiplayerHeight;
-    SDL_QueryTexture(multiplayerButton, NULL, NULL, &multiplayerWidth, &multiplayerHeight);
+    int multiplayerWidth = atlas.sprites[multiplayerButton].source.w;
+    int multiplayerHeight = atlas.sprites[multiplayerButton].source.h;
     
  
     
@@ -1014,13 +727,19 @@ int main(int argc, char* argv[]) {
     multiplayerButtonRect.x = (960 - multiplayerButtonRect.w) / 2;
     multiplayerButtonRect.y = 200;
     
+    SDL_Rect singleplayerButtonRect;
+    singleplayerButtonRect.w = atlas.sprites[singleplayerButton].source.w;
+    singleplayerButtonRect.h = atlas.sprites[singleplayerButton].source.h;
+    singleplayerButtonRect.x = (960 - singleplayerButtonRect.w) / 2;
+    singleplayerButtonRect.y = multiplayerButtonRect.y - singleplayerButtonRect.h - 20; // Above multiplayer
+    
  
     // Get winner screen button dimensions
-    int playAgainWidth, playAgainHeight;
-    SDL_QueryTexture(playAgainButton, NULL, NULL, &playAgainWidth, &playAgainHeight);
+    int playAgainWidth = atlas.sprites[playAgainButton].source.w;
+    int playAgainHeight = atlas.sprites[playAgainButton].source.h;
     
-    int homeWidth, homeHeight;
-    SDL_QueryTexture(homeButton, NULL, NULL, &homeWidth, &homeHeight);
+    int homeWidth = atlas.sprites[homeButton].source.w;
+    int homeHeight = atlas.sprites[homeButton].source.h;
     
     // Create winner screen button rectangles
     SDL_Rect playAgainButtonRect;
@@ -1035,127 +754,120 @@ int main(int argc, char* argv[]) {
     homeButtonRect.x = (960 - homeButtonRect.w) / 2;
     homeButtonRect.y = 450;
     
-    // Initialize tanks
-    Tank blueTankObj, redTankObj;
-    
-    // Get tank dimensions from body texture
-    int tankWidth, tankHeight;
-    SDL_QueryTexture(blueBody, NULL, NULL, &tankWidth, &tankHeight);
-    
-    // Blue tank at bottom-left
-    blueTankObj.rect.x = 50;
-    blueTankObj.rect.y = 540 - tankHeight - 50;
-    blueTankObj.rect.w = tankWidth;
-    blueTankObj.rect.h = tankHeight;
-    blueTankObj.isMoving = false;
-    blueTankObj.speed = 2.0f;
-    blueTankObj.rotation = 0.0f; // Start facing up
-    blueTankObj.gunRotation = 0.0f; // Gun starts at center
-    blueTankObj.gunRotationSpeed = 30.0f; // 30 degrees per second
-    blueTankObj.gunRotatingRight = true; // Start rotating right
-    blueTankObj.gunScale = 0.5f; // 60% of body size
-    blueTankObj.currentAmmo = 5; // Start with full ammo
-    blueTankObj.reloadTimer = 0.0f;
-    blueTankObj.canShoot = true;
-    blueTankObj.hp = 100; // Start with full HP
-    blueTankObj.isDestroyed = false;
-    blueTankObj.hasShadow = false;
-    blueTankObj.score = 0; // Start with 0 score
-    blueTankObj.hasPower = false; // No power-up initially
-    blueTankObj.powerTimer = 0.0f;
-    blueTankObj.originalSpeed = blueTankObj.speed;
-    blueTankObj.originalWidth = tankWidth;
-    blueTankObj.originalHeight = tankHeight;
-    blueTankObj.explosionItemCount = 0; // No explosion items initially
-    
-    // Initialize gun rectangle
-    updateGunRect(&blueTankObj);
-    
-    // Red tank at top-right (moved further from grass[12] at 900,50)
-    redTankObj.rect.x = 960 - tankWidth - 100;
-    redTankObj.rect.y = 50;
-    redTankObj.rect.w = tankWidth;
-    redTankObj.rect.h = tankHeight;
-    redTankObj.isMoving = false;
-    redTankObj.speed = 2.0f;
-    redTankObj.rotation = 180.0f; // Start facing down
-    redTankObj.gunRotation = 0.0f; // Gun starts at center
-    redTankObj.gunRotationSpeed = 30.0f; // 30 degrees per second
-    redTankObj.gunRotatingRight = true; // Start rotating right
-    redTankObj.gunScale = 0.5f; // 50% of body size
-    redTankObj.currentAmmo = 5; // Start with full ammo
-    redTankObj.reloadTimer = 0.0f;
-    redTankObj.canShoot = true;
-    redTankObj.hp = 100; // Start with full HP
-    redTankObj.isDestroyed = false;
-    redTankObj.hasShadow = false;
-    redTankObj.score = 0; // Start with 0 score
-    redTankObj.hasPower = false; // No power-up initially
-    redTankObj.powerTimer = 0.0f;
-    redTankObj.originalSpeed = redTankObj.speed;
-    redTankObj.originalWidth = tankWidth;
-    redTankObj.originalHeight = tankHeight;
-    redTankObj.explosionItemCount = 0; // No explosion items initially
-    
-    // Initialize gun rectangle
-    updateGunRect(&redTankObj);
-    
-    // Initialize game objects
-    const int GRASS_COUNT = 20;
-    const int ROCK_COUNT = 15;
-    GameObject grassObjects[GRASS_COUNT];
-    GameObject rockObjects[ROCK_COUNT];
-    
-    // Initialize bullets
-    const int MAX_BULLETS = 5;
-    Bullet bullets[MAX_BULLETS];
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        bullets[i].active = false;
-    }
-    
-    // Initialize explosions
-    const int MAX_EXPLOSIONS = 3;
-    Explosion explosions[MAX_EXPLOSIONS];
-    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-        explosions[i].active = false;
-    }
-    
-    // Winner tracking
-    int winner = -1; // -1 = no winner, 0 = blue tank wins, 1 = red tank wins
-    
-    // Initialize power box
-    PowerBox powerBox;
-    powerBox.active = false;
-    powerBox.spawnTimer = 0.0f;
-    powerBox.disappearTimer = 0.0f;
-    powerBox.spawnCount = 0;
-    powerBox.boxType = 0;
-    
-    // Initialize bomb items
-    const int MAX_BOMB_ITEMS = 10;
-    BombItem bombItems[MAX_BOMB_ITEMS];
-    for (int i = 0; i < MAX_BOMB_ITEMS; i++) {
-        bombItems[i].active = false;
-        bombItems[i].owner = -1;
-        bombItems[i].scale = 0.8f;
-    }
-    
-    // Initialize shield
-    Shield shield;
-    shield.active = false;
-    shield.timer = 0.0f;
-    shield.duration = 0.0f;
-    shield.owner = -1;
-    
-    // Seed random number generator
-    srand(time(NULL));
-    initializeGameObjects(grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT, blueTankObj.rect, redTankObj.rect);
-    
-    // Background music commented out - SDL_mixer not available
-    // if (backgroundMusic) {
-    //     Mix_PlayMusic(backgroundMusic, -1); // Loop indefinitely
-    //     std::cout << "[AUDIO] Background music started" << std::endl;
-    // }
+    // Get tank dimensions from body sprite
+    int tankWidth = atlas.sprites[blueBody].source.w;
+    int tankHeight = atlas.sprites[blueBody].source.h;
+    
+    // Every match gets a fresh seed; the match itself only draws from world.rng
+    uint64_t matchSeed = (uint64_t)time(NULL) ^ SDL_GetPerformanceCounter();
+    
+    // Load the arena (obstacles, spawn points, power box zones)
+    GameMap map = {};
+    if (!loadArenaMap(&map, mapPath)) {
+        LOG_ERROR("Failed to load map!");
+        return -1;
+    }
+    
+    // Network match (--host or --join): find the other player before anything
+    // else, the host's seed is the one both sides play with
+    RollbackSession netplay;
+    netplay.active = false;
+    bool netplayMatch = false;
+    if (hostPort > 0 || !joinAddress.empty()) {
+        NetMatchInfo match = {matchSeed, map.hash, tankWidth, tankHeight};
+        bool connected = openNetplay(&netplay, hostPort > 0 ? (uint16_t)hostPort : 0);
+        if (connected) {
+            setNetShim(&netplay.socket, netLatency, netJitter, netLoss, matchSeed);
+            if (hostPort > 0) {
+                connected = waitForNetplayPeer(&netplay, &match);
+            } else {
+                NetAddress hostAddress;
+                connected = resolveNetAddress(&hostAddress, joinAddress, NETPLAY_DEFAULT_PORT) &&
+                            connectNetplayPeer(&netplay, &hostAddress, &match);
+            }
+        }
+        if (!connected) {
+            LOG_ERROR("[NET] Could not start the network match");
+            return -1;
+        }
+        tankCount = 2; // Bots think on a time budget, which two machines would not agree on
+        if (!recordPath.empty()) {
+            LOG_WARN("[NET] Network matches are not recorded");
+        }
+    }
+    
+    // Server match (--server or --connect): the server runs the match and
+    // this game only sends its input and draws the snapshots. --server runs
+    // that server here too, on its own thread, until the match is over.
+    GameServer listenServer;
+    std::thread listenThread;
+    std::atomic<bool> stopListenServer(false);
+    GameClient serverClient;
+    serverClient.active = false;
+    bool serverMatch = false;
+    if (serverPort > 0 || !connectAddress.empty()) {
+        NetAddress serverAddress;
+        bool connected;
+        if (serverPort > 0) {
+            connected = openGameServer(&listenServer, &map, (uint16_t)serverPort, 2, tankWidth, tankHeight, matchSeed);
+            if (connected) {
+                setNetShim(&listenServer.socket, netLatency, netJitter, netLoss, matchSeed);
+                listenThread = std::thread([&listenServer, &stopListenServer]() {
+                    while (!listenServer.finished && !stopListenServer.load()) {
+                        updateGameServer(&listenServer);
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                });
+                serverAddress.host = 0x7F000001; // 127.0.0.1
+                serverAddress.port = (uint16_t)serverPort;
+            }
+        } else {
+            connected = resolveNetAddress(&serverAddress, connectAddress, SERVER_DEFAULT_PORT);
+        }
+
+        ServerMatchInfo match = {};
+        match.mapHash = map.hash;
+        match.tankWidth = tankWidth;
+        match.tankHeight = tankHeight;
+        if (connected && openGameClient(&serverClient)) {
+            setNetShim(&serverClient.socket, netLatency, netJitter, netLoss, matchSeed + 1);
+            connected = connectGameServer(&serverClient, &serverAddress, &match);
+        } else {
+            connected = false;
+        }
+        if (!connected) {
+            LOG_ERROR("[NET] Could not join the server match");
+            if (listenThread.joinable()) {
+                stopListenServer = true;
+                listenThread.join();
+                closeGameServer(&listenServer);
+            }
+            return -1;
+        }
+        tankCount = match.tankCount;
+        if (!recordPath.empty()) {
+            LOG_WARN("[NET] Server matches are not recorded");
+        }
+    }
+    
+    // Initialize match state (tanks, obstacles, bullets, pickups)
+    World world;
+    initializeWorld(&world, &map, tankWidth, tankHeight, matchSeed, tankCount);
+    
+    // Camera over the arena (follows both players on maps larger than the screen)
+    Camera camera;
+    initializeCamera(&camera, 960, 540, world.mapWidth, world.mapHeight);
+    snapCamera(&camera, world.tanks.rect[0], world.tanks.rect[1]);
+    std::vector<int> visibleObstacles; // Reused every frame
+    std::vector<TankPose> tankPoses; // Tanks blended between ticks, reused every frame
+    
+    // Match recording (--record): match 1 goes to the given file, later ones to file.2, file.3, ...
+    Replay replay;
+    int recordedMatches = 0;
+    bool replaySaved = false;
+    beginReplay(&replay, &world);
+    
+    playSound(&audio, SOUND_MUSIC, AUDIO_MAX_VOLUME / 2, true); // Loops until the game closes
     
     bool quit = false;
     GameState currentState = WELCOME_SCREEN;
@@ -1163,179 +875,188 @@ int main(int argc, char* argv[]) {
     
     // Track key states for tank movement
     const Uint8* keystate = SDL_GetKeyboardState(NULL);
-    bool blueTankKeysPressed = false;
-    bool redTankKeysPressed = false;
+    
+    // Per-frame tank inputs (index 0 = blue player, 1 = red player or a bot, the rest bots)
+    std::vector<TankInput> tankInputs(world.tanks.count);
     
     // Timing variables
-    Uint32 lastTime = SDL_GetTicks();
-    float deltaTime = 0.0f;
+    const double counterFrequency = (double)SDL_GetPerformanceFrequency();
+    const double MAX_FRAME_TIME = 0.25; // Cap catch-up after a stall (seconds)
+    const double MIN_FRAME_TIME = 1.0 / 144.0; // Frame limiter when vsync is unavailable
+    Uint64 lastCounter = SDL_GetPerformanceCounter();
+    double accumulator = 0.0; // Unsimulated time carried to the next frame
+    bool firstFramePresented = false;
+    
+    // Frame profiler (F3 shows the overlay, F4 exports a trace and CSV)
+    bool showProfiler = false;
+    const int eventsZone = registerProfileZone("Events");
+    
+    // Worker threads for the parallel parts of the simulation and the bots
+    JobSystem jobs;
+    startJobSystem(&jobs, threadCount);
+    
+    // Computer-controlled tanks (single player: every tank but the blue one)
+    bool singlePlayer = false;
+    BotController bots;
+    initializeBots(&bots, &world, 2);
+    
+    // Function to start a fresh match in the current mode
+    auto startMatch = [&]() {
+        currentState = GAME_PLAYING;
+        uint64_t seed = netplay.active ? netplay.match.seed
+                        : serverClient.active ? serverClient.match.seed
+                        : ++matchSeed;
+        initializeWorld(&world, &map, tankWidth, tankHeight, seed, tankCount);
+        clearParticles(&particles);
+        // Bots only take local seats nobody plays; in a network match the remote players
+        // (or the server) drive every other seat
+        int firstBot = (netplay.active || serverClient.active) ? world.tanks.count : singlePlayer ? 1 : 2;
+        initializeBots(&bots, &world, firstBot);
+        if (netplay.active) {
+            beginNetplayMatch(&netplay, &world);
+        }
+        if (serverClient.active) {
+            beginGameClientMatch(&serverClient, &world);
+        }
+        beginReplay(&replay, &world);
+        replaySaved = false;
+        snapCamera(&camera, world.tanks.rect[0], world.tanks.rect[1]);
+        tankInputs.assign(world.tanks.count, TankInput());
+        accumulator = 0.0;
+    };
+    
+    // A network match starts as soon as both players are connected
+    if (netplay.active) {
+        netplayMatch = true;
+        startMatch();
+        LOG_INFO("[NET] Network match started, you drive the %s tank", netplay.localTank == 0 ? "blue" : "red");
+    }
+    
+    // A server match starts as soon as we have a seat (the server waits for the other players)
+    if (serverClient.active) {
+        serverMatch = true;
+        startMatch();
+        LOG_INFO("[NET] Server match started, you drive tank %d", serverClient.match.tank);
+    }
+    
+    // Function to leave a network match (once it is over or the peer is gone)
+    auto endNetplayMatch = [&]() {
+        if (netplayMatch) {
+            closeNetplay(&netplay);
+            netplayMatch = false;
+        }
+        if (serverMatch) {
+            closeGameClient(&serverClient);
+            serverMatch = false;
+        }
+        if (listenThread.joinable()) {
+            stopListenServer = true;
+            listenThread.join();
+            closeGameServer(&listenServer);
+        }
+    };
+    
+    // Function to get the tank the local keys drive (the second key set drives it too when there is no second player)
+    auto getLocalTank = [&]() {
+        return netplayMatch ? netplay.localTank : serverMatch ? (int)serverClient.match.tank : 0;
+    };
     
     while (!quit) {
-        // Calculate delta time
-        Uint32 currentTime = SDL_GetTicks();
-        deltaTime = (currentTime - lastTime) / 1000.0f; // Convert to seconds
-        lastTime = currentTime;
+        // Measure frame time
+        Uint64 frameStartCounter = SDL_GetPerformanceCounter();
+        double frameTime = (frameStartCounter - lastCounter) / counterFrequency;
+        lastCounter = frameStartCounter;
+        if (frameTime > MAX_FRAME_TIME) {
+            frameTime = MAX_FRAME_TIME;
+        }
+        beginProfileFrame();
         
         int mouseX, mouseY;
         SDL_GetMouseState(&mouseX, &mouseY);
         bool showPointer = false;
         
+        beginProfileZone(eventsZone);
         while (SDL_PollEvent(&e)) {
             if (e.type == SDL_QUIT) {
                 quit = true;
             }
+            else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F3) {
+                // Toggle the profiler overlay
+                showProfiler = !showProfiler;
+            }
+            else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F4) {
+                // Export the profiler history to the working directory
+                std::string baseName = "profile_" + std::to_string((long long)time(NULL));
+                exportProfileTrace(baseName + ".json");
+                exportProfileCsv(baseName + ".csv");
+            }
             else if (e.type == SDL_MOUSEBUTTONDOWN) {
                 if (currentState == WELCOME_SCREEN) {
                 // Check if start button was clicked
                     if (isPointInRect(mouseX, mouseY, startButtonRect)) {
                         currentState = GAME_MODE_SELECTION;
-                        std::cout << "Switched to Game Mode Selection!" << std::endl;
+                        LOG_INFO("Switched to Game Mode Selection!");
                     }
                 }
                 else if (currentState == GAME_MODE_SELECTION) {
+                    // Check if singleplayer button was clicked
+                    if (isPointInRect(mouseX, mouseY, singleplayerButtonRect)) {
+                        singlePlayer = true;
+                        startMatch();
+                        LOG_INFO("Singleplayer mode selected!");
+                    }
                     // Check if multiplayer button was clicked
-                    if (isPointInRect(mouseX, mouseY, multiplayerButtonRect)) {
-                        currentState = GAME_PLAYING;
-                        std::cout << "Multiplayer mode selected!" << std::endl;
+                    else if (isPointInRect(mouseX, mouseY, multiplayerButtonRect)) {
+                        singlePlayer = false;
+                        startMatch();
+                        LOG_INFO("Multiplayer mode selected!");
                     }
-                  
                 }
                 else if (currentState == WINNER_SCREEN) {
                     // Check if play again button was clicked
                     if (isPointInRect(mouseX, mouseY, playAgainButtonRect)) {
-                        // Reset game state
-                        currentState = GAME_PLAYING;
-                        winner = -1;
-                        
-                        // Reset tanks
-                            blueTankObj.rect.x = 50;
-                            blueTankObj.rect.y = 540 - tankHeight - 50;
-                            blueTankObj.rect.w = tankWidth;
-                            blueTankObj.rect.h = tankHeight;
-                            blueTankObj.isMoving = false;
-                            blueTankObj.speed = 2.0f;
-                            blueTankObj.rotation = 0.0f; // Start facing up
-                            blueTankObj.gunRotation = 0.0f; // Gun starts at center
-                            blueTankObj.gunRotationSpeed = 30.0f; // 30 degrees per second
-                            blueTankObj.gunRotatingRight = true; // Start rotating right
-                            blueTankObj.gunScale = 0.5f; // 60% of body size
-                            blueTankObj.currentAmmo = 5; // Start with full ammo
-                            blueTankObj.reloadTimer = 0.0f;
-                            blueTankObj.canShoot = true;
-                            blueTankObj.hp = 100; // Start with full HP
-                            blueTankObj.isDestroyed = false;
-                            blueTankObj.hasShadow = false;
-                            blueTankObj.score = 0; // Start with 0 score
-                            updateGunRect(&blueTankObj); // Update gun rectangle
-                                                
-                            redTankObj.rect.x = 960 - tankWidth - 100;
-                            redTankObj.rect.y = 50;
-                            redTankObj.rect.w = tankWidth;
-                            redTankObj.rect.h = tankHeight;
-                            redTankObj.isMoving = false;
-                            redTankObj.speed = 2.0f;
-                            redTankObj.rotation = 180.0f; // Start facing down
-                            redTankObj.gunRotation = 0.0f; // Gun starts at center
-                            redTankObj.gunRotationSpeed = 30.0f; // 30 degrees per second
-                            redTankObj.gunRotatingRight = true; // Start rotating right
-                            redTankObj.gunScale = 0.5f; // 50% of body size
-                            redTankObj.currentAmmo = 5; // Start with full ammo
-                            redTankObj.reloadTimer = 0.0f;
-                            redTankObj.canShoot = true;
-                            redTankObj.hp = 100; // Start with full HP
-                            redTankObj.isDestroyed = false;
-                            redTankObj.hasShadow = false;
-                            redTankObj.score = 0; // Start with 0 score
-                            updateGunRect(&redTankObj); // Update gun rectangle
-                                                
-                        // Reset bullets
-                        for (int i = 0; i < MAX_BULLETS; i++) {
-                            bullets[i].active = false;
-                        }
-                        
-                        // Reset explosions
-                        for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-                            explosions[i].active = false;
-                        }
-                        
-                        // Reset game objects
-                        initializeGameObjects(grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT, blueTankObj.rect, redTankObj.rect);
-                        
-                        std::cout << "Game restarted!" << std::endl;
+                        // Reset game state (a network match is over for good, this one is local)
+                        endNetplayMatch();
+                        startMatch();
+                        LOG_INFO("Game restarted!");
                     }
                     // Check if home button was clicked
                     else if (isPointInRect(mouseX, mouseY, homeButtonRect)) {
+                        endNetplayMatch();
                         currentState = WELCOME_SCREEN;
-                        std::cout << "Returned to welcome screen!" << std::endl;
+                        LOG_INFO("Returned to welcome screen!");
                     }
                 }
             }
             else if (e.type == SDL_KEYDOWN && currentState == GAME_PLAYING) {
-                // Blue tank shooting (F key) - only if not destroyed
-                if (e.key.keysym.sym == SDLK_f && !blueTankObj.isDestroyed) {
-                    // Find inactive bullet slot and try to fire
-                    for (int i = 0; i < MAX_BULLETS; i++) {
-                        if (!bullets[i].active) {
-                            if (tryFireBullet(&bullets[i], &blueTankObj, 0)) {
-                                break; // Successfully fired, exit loop
-                            } else {
-                                std::cout << "Blue tank out of ammo!" << std::endl;
-                                break; // No ammo, exit loop
-                            }
-                        }
-                    }
+                // Shooting keys are edge-triggered and consumed by the next step.
+                // In single player and network matches both key sets drive the local tank.
+                int wasdTank = getLocalTank();
+                int arrowTank = (singlePlayer || netplayMatch || serverMatch) ? wasdTank : 1;
+                if (e.key.keysym.sym == SDLK_f) {
+                    tankInputs[wasdTank].fire = true; // Blue tank shooting
                 }
-                // Red tank shooting (/ key) - only if not destroyed
-                else if (e.key.keysym.sym == SDLK_SLASH && !redTankObj.isDestroyed) {
-                    // Find inactive bullet slot and try to fire
-                    for (int i = 0; i < MAX_BULLETS; i++) {
-                        if (!bullets[i].active) {
-                            if (tryFireBullet(&bullets[i], &redTankObj, 1)) {
-                                break; // Successfully fired, exit loop
-                            } else {
-                                std::cout << "Red tank out of ammo!" << std::endl;
-                                break; // No ammo, exit loop
-                            }
-                        }
-                    }
+                else if (e.key.keysym.sym == SDLK_SLASH) {
+                    tankInputs[arrowTank].fire = true; // Red tank shooting
                 }
-                // Blue tank explosion power (J key)
-                else if (e.key.keysym.sym == SDLK_j && !blueTankObj.isDestroyed) {
-                    // Find inactive bullet slot and try to fire explosion bullet
-                    for (int i = 0; i < MAX_BULLETS; i++) {
-                        if (!bullets[i].active) {
-                            if (fireExplosionBullet(&bullets[i], &blueTankObj, 0)) {
-                                break; // Successfully fired explosion bullet
-                            } else {
-                                std::cout << "Blue tank has no explosion items!" << std::endl;
-                                break;
-                            }
-                        }
-                    }
+                else if (e.key.keysym.sym == SDLK_j) {
+                    tankInputs[wasdTank].fireExplosion = true; // Blue tank explosion power
                 }
-                // Red tank explosion power (. key)
-                else if (e.key.keysym.sym == SDLK_PERIOD && !redTankObj.isDestroyed) {
-                    // Find inactive bullet slot and try to fire explosion bullet
-                    for (int i = 0; i < MAX_BULLETS; i++) {
-                        if (!bullets[i].active) {
-                            if (fireExplosionBullet(&bullets[i], &redTankObj, 1)) {
-                                break; // Successfully fired explosion bullet
-                            } else {
-                                std::cout << "Red tank has no explosion items!" << std::endl;
-                                break;
-                            }
-                        }
-                    }
+                else if (e.key.keysym.sym == SDLK_PERIOD) {
+                    tankInputs[arrowTank].fireExplosion = true; // Red tank explosion power
                 }
             }
         }
         
+        endProfileZone(eventsZone);
+        
         // Check for cursor pointer on buttons
         if (currentState == WELCOME_SCREEN && isPointInRect(mouseX, mouseY, startButtonRect)) {
             showPointer = true;
         }
         else if (currentState == GAME_MODE_SELECTION && 
-                 (isPointInRect(mouseX, mouseY, multiplayerButtonRect) )) {
+                 (isPointInRect(mouseX, mouseY, singleplayerButtonRect) ||
+                  isPointInRect(mouseX, mouseY, multiplayerButtonRect))) {
             showPointer = true;
         }
         else if (currentState == WINNER_SCREEN && 
@@ -1352,579 +1073,402 @@ int main(int argc, char* argv[]) {
         }
         
         SDL_RenderClear(renderer);
+        resetSpriteBatchStats(&spriteBatch);
         
         if (currentState == WELCOME_SCREEN) {
             // Draw welcome screen
             SDL_RenderCopy(renderer, welcomeBackground, NULL, NULL);
-            SDL_RenderCopy(renderer, startButton, NULL, &startButtonRect);
+            drawSprite(&spriteBatch, startButton, startButtonRect);
         }
         else if (currentState == GAME_MODE_SELECTION) {
             // Draw game mode selection screen
             SDL_RenderCopy(renderer, gameModeBackground, NULL, NULL);
             
             // Check if buttons are hovered
+            bool singleplayerHovered = isPointInRect(mouseX, mouseY, singleplayerButtonRect);
             bool multiplayerHovered = isPointInRect(mouseX, mouseY, multiplayerButtonRect);
             
+            // Draw singleplayer button (normal or hover)
+            if (singleplayerHovered) {
+                drawSprite(&spriteBatch, singleplayerButtonHover, singleplayerButtonRect);
+            } else {
+                drawSprite(&spriteBatch, singleplayerButton, singleplayerButtonRect);
+            }
+            
             // Draw multiplayer button (normal or hover)
             if (multiplayerHovered) {
-                SDL_RenderCopy(renderer, multiplayerButtonHover, NULL, &multiplayerButtonRect);
+                drawSprite(&spriteBatch, multiplayerButtonHover, multiplayerButtonRect);
             } else {
-                SDL_RenderCopy(renderer, multiplayerButton, NULL, &multiplayerButtonRect);
+                drawSprite(&spriteBatch, multiplayerButton, multiplayerButtonRect);
             }
             
            
         }
         else if (currentState == GAME_PLAYING) {
-            // Update gun rotation for both tanks
-            updateGunRotation(&blueTankObj, deltaTime);
-            updateGunRotation(&redTankObj, deltaTime);
-            
-            // Update gun rectangles (position and size)
-            updateGunRect(&blueTankObj);
-            updateGunRect(&redTankObj);
-            
-            // Update ammo systems
-            updateTankAmmo(&blueTankObj, deltaTime);
-            updateTankAmmo(&redTankObj, deltaTime);
-            
-            // Update power-ups
-            updatePowerUp(&blueTankObj, deltaTime);
-            updatePowerUp(&redTankObj, deltaTime);
+            // Blue tank movement (WASD keys), or whichever tank is ours in a network match
+            int wasdTank = getLocalTank();
+            tankInputs[wasdTank].up = keystate[SDL_SCANCODE_W];
+            tankInputs[wasdTank].down = keystate[SDL_SCANCODE_S];
+            tankInputs[wasdTank].left = keystate[SDL_SCANCODE_A];
+            tankInputs[wasdTank].right = keystate[SDL_SCANCODE_D];
             
-            // Update bomb items
-            updateBombItems(bombItems, MAX_BOMB_ITEMS, &blueTankObj, &redTankObj);
-            
-            // Update explosions
-            for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-                updateExplosion(&explosions[i], deltaTime);
+            // Red tank movement (Arrow keys), or the local tank's second key set
+            if (singlePlayer || netplayMatch || serverMatch) {
+                tankInputs[wasdTank].up |= keystate[SDL_SCANCODE_UP];
+                tankInputs[wasdTank].down |= keystate[SDL_SCANCODE_DOWN];
+                tankInputs[wasdTank].left |= keystate[SDL_SCANCODE_LEFT];
+                tankInputs[wasdTank].right |= keystate[SDL_SCANCODE_RIGHT];
+            } else {
+                tankInputs[1].up = keystate[SDL_SCANCODE_UP];
+                tankInputs[1].down = keystate[SDL_SCANCODE_DOWN];
+                tankInputs[1].left = keystate[SDL_SCANCODE_LEFT];
+                tankInputs[1].right = keystate[SDL_SCANCODE_RIGHT];
             }
             
-            // Update power box spawning
-            updatePowerBoxSpawning(&powerBox, deltaTime, grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT, &blueTankObj, &redTankObj);
-            
-            // Update shield
-            updateShield(&shield, deltaTime);
-            
-            // Check power box collection
-            checkPowerBoxCollection(&powerBox, &blueTankObj, &shield, 0);
-            checkPowerBoxCollection(&powerBox, &redTankObj, &shield, 1);
-            
-            // Check blue tank movement (WASD keys)
-            blueTankKeysPressed = (keystate[SDL_SCANCODE_W] || keystate[SDL_SCANCODE_S] || 
-                                  keystate[SDL_SCANCODE_A] || keystate[SDL_SCANCODE_D]);
-            
-            // Check red tank movement (Arrow keys)
-            redTankKeysPressed = (keystate[SDL_SCANCODE_UP] || keystate[SDL_SCANCODE_DOWN] || 
-                                 keystate[SDL_SCANCODE_LEFT] || keystate[SDL_SCANCODE_RIGHT]);
+            // Bots think within their frame budget and hold their inputs like keys
+            {
+                PROFILE_ZONE("Bots");
+                updateBots(&bots, &world, tankInputs.data(), BOT_THINK_BUDGET, &jobs);
+            }
             
-            // Update blue tank (only if not destroyed)
-            if (blueTankKeysPressed && !blueTankObj.isDestroyed) {
-                blueTankObj.isMoving = true;
-                std::cout << "[DEBUG] Blue tank keys pressed - W:" << keystate[SDL_SCANCODE_W] 
-                         << " S:" << keystate[SDL_SCANCODE_S] << " A:" << keystate[SDL_SCANCODE_A] 
-                         << " D:" << keystate[SDL_SCANCODE_D] << std::endl;
-                
-                // Try to move blue tank based on WASD keys
-                if (keystate[SDL_SCANCODE_W] && blueTankObj.rect.y > 0) {
-                    blueTankObj.rotation = 0.0f; // Face up
-                    SDL_Rect newBlueTankRect = blueTankObj.rect;
-                    newBlueTankRect.y -= blueTankObj.speed;
-                    // Check collision before applying movement
-                    if (!checkTankCollisionWithObjects(newBlueTankRect, grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT) && 
-                        !checkTankCollision(newBlueTankRect, redTankObj.rect)) {
-                        blueTankObj.rect.y = newBlueTankRect.y;
-                    }
+            // Network match: take in the peer's inputs (which may roll the world back)
+            if (netplayMatch) {
+                PROFILE_ZONE("Netplay");
+                pollNetplay(&netplay, &world, &jobs);
+                if (!netplay.active) {
+                    LOG_WARN("[NET] Lost the other player, back to the welcome screen");
+                    endNetplayMatch();
+                    currentState = WELCOME_SCREEN;
+                    accumulator = 0.0;
                 }
-                if (keystate[SDL_SCANCODE_S] && blueTankObj.rect.y < 540 - blueTankObj.rect.h) {
-                    blueTankObj.rotation = 180.0f; // Face down
-                    SDL_Rect newBlueTankRect = blueTankObj.rect;
-                    newBlueTankRect.y += blueTankObj.speed;
-                    // Check collision before applying movement
-                    if (!checkTankCollisionWithObjects(newBlueTankRect, grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT) && 
-                        !checkTankCollision(newBlueTankRect, redTankObj.rect)) {
-                        blueTankObj.rect.y = newBlueTankRect.y;
-                    }
+            }
+            
+            // Server match: send our input and show the newest snapshot (nothing is simulated here)
+            if (serverMatch) {
+                PROFILE_ZONE("Client");
+                TankInput& input = tankInputs[serverClient.match.tank];
+                updateGameClient(&serverClient, &world, input);
+                playEventSounds(&audio, world.events.data(), (int)world.events.size());
+                emitEventParticles(&particles, world.events.data(), (int)world.events.size());
+                input.fire = false;
+                input.fireExplosion = false;
+                if (!serverClient.active) {
+                    LOG_WARN("[NET] Lost the server, back to the welcome screen");
+                    endNetplayMatch();
+                    currentState = WELCOME_SCREEN;
                 }
-                if (keystate[SDL_SCANCODE_A] && blueTankObj.rect.x > 0) {
-                    blueTankObj.rotation = 270.0f; // Face left
-                    SDL_Rect newBlueTankRect = blueTankObj.rect;
-                    newBlueTankRect.x -= blueTankObj.speed;
-                    // Check collision before applying movement
-                    if (!checkTankCollisionWithObjects(newBlueTankRect, grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT) && 
-                        !checkTankCollision(newBlueTankRect, redTankObj.rect)) {
-                        blueTankObj.rect.x = newBlueTankRect.x;
+            }
+            
+            // Advance the match in fixed ticks
+            accumulator += frameTime;
+            while (currentState == GAME_PLAYING && !serverMatch && accumulator >= FIXED_TIMESTEP &&
+                   world.winner == -1) {
+                PROFILE_ZONE("Simulate");
+                bool stepped = true;
+                if (netplayMatch) {
+                    stepped = advanceNetplay(&netplay, &world, tankInputs[netplay.localTank], &jobs);
+                } else {
+                    stepWorld(&world, tankInputs.data(), &jobs);
+                    if (!recordPath.empty()) {
+                        recordReplayTick(&replay, tankInputs.data(), &world);
                     }
                 }
-                if (keystate[SDL_SCANCODE_D] && blueTankObj.rect.x < 960 - blueTankObj.rect.w) {
-                    blueTankObj.rotation = 90.0f; // Face right
-                    SDL_Rect newBlueTankRect = blueTankObj.rect;
-                    newBlueTankRect.x += blueTankObj.speed;
-                    // Check collision before applying movement
-                    if (!checkTankCollisionWithObjects(newBlueTankRect, grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT) && 
-                        !checkTankCollision(newBlueTankRect, redTankObj.rect)) {
-                        blueTankObj.rect.x = newBlueTankRect.x;
+                accumulator -= FIXED_TIMESTEP;
+                
+                // Shots have been consumed (a tick spent waiting for the peer keeps them)
+                if (stepped) {
+                    logGameEvents(world.events.data(), (int)world.events.size(), &world.tanks);
+                    playEventSounds(&audio, world.events.data(), (int)world.events.size());
+                    emitEventParticles(&particles, world.events.data(), (int)world.events.size());
+                    for (TankInput& input : tankInputs) {
+                        input.fire = false;
+                        input.fireExplosion = false;
                     }
                 }
-            } else {
-                blueTankObj.isMoving = false;
             }
             
-            // Update red tank (only if not destroyed)
-            if (redTankKeysPressed && !redTankObj.isDestroyed) {
-                redTankObj.isMoving = true;
-                std::cout << "[DEBUG] Red tank keys pressed - UP:" << keystate[SDL_SCANCODE_UP] 
-                         << " DOWN:" << keystate[SDL_SCANCODE_DOWN] << " LEFT:" << keystate[SDL_SCANCODE_LEFT] 
-                         << " RIGHT:" << keystate[SDL_SCANCODE_RIGHT] << std::endl;
+            // A predicted win may still be rolled back; only a confirmed one ends the match
+            if (world.winner != -1 && (!netplayMatch || isNetplayStateConfirmed(&netplay, &world))) {
+                currentState = WINNER_SCREEN;
+                accumulator = 0.0;
+                playSound(&audio, SOUND_WINNER);
                 
-                // Try to move red tank based on arrow keys
-                if (keystate[SDL_SCANCODE_UP] && redTankObj.rect.y > 0) {
-                    redTankObj.rotation = 0.0f; // Face up
-                    SDL_Rect newRedTankRect = redTankObj.rect;
-                    newRedTankRect.y -= redTankObj.speed;
-                    // Check collision before applying movement
-                    if (!checkTankCollisionWithObjects(newRedTankRect, grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT) && 
-                        !checkTankCollision(newRedTankRect, blueTankObj.rect)) {
-                        redTankObj.rect.y = newRedTankRect.y;
-                    }
+                if (!recordPath.empty() && !replaySaved && !netplayMatch && !serverMatch) {
+                    recordedMatches++;
+                    std::string path = recordedMatches == 1 ? recordPath : recordPath + "." + std::to_string(recordedMatches);
+                    saveReplay(&replay, path);
+                    replaySaved = true;
                 }
-                if (keystate[SDL_SCANCODE_DOWN] && redTankObj.rect.y < 540 - redTankObj.rect.h) {
-                    redTankObj.rotation = 180.0f; // Face down
-                    SDL_Rect newRedTankRect = redTankObj.rect;
-                    newRedTankRect.y += redTankObj.speed;
-                    // Check collision before applying movement
-                    if (!checkTankCollisionWithObjects(newRedTankRect, grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT) && 
-                        !checkTankCollision(newRedTankRect, blueTankObj.rect)) {
-                        redTankObj.rect.y = newRedTankRect.y;
-                    }
-                }
-                if (keystate[SDL_SCANCODE_LEFT] && redTankObj.rect.x > 0) {
-                    redTankObj.rotation = 270.0f; // Face left
-                    SDL_Rect newRedTankRect = redTankObj.rect;
-                    newRedTankRect.x -= redTankObj.speed;
-                    // Check collision before applying movement
-                    if (!checkTankCollisionWithObjects(newRedTankRect, grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT) && 
-                        !checkTankCollision(newRedTankRect, blueTankObj.rect)) {
-                        redTankObj.rect.x = newRedTankRect.x;
-                    }
-                }
-                if (keystate[SDL_SCANCODE_RIGHT] && redTankObj.rect.x < 960 - redTankObj.rect.w) {
-                    redTankObj.rotation = 90.0f; // Face right
-                    SDL_Rect newRedTankRect = redTankObj.rect;
-                    newRedTankRect.x += redTankObj.speed;
-                    // Check collision before applying movement
-                    if (!checkTankCollisionWithObjects(newRedTankRect, grassObjects, rockObjects, GRASS_COUNT, ROCK_COUNT) && 
-                        !checkTankCollision(newRedTankRect, blueTankObj.rect)) {
-                        redTankObj.rect.x = newRedTankRect.x;
+            }
+            
+            // Blend between the last two ticks when drawing (a server match shows the newest snapshot as is)
+            float alpha = serverMatch ? 1.0f : (float)(accumulator / FIXED_TIMESTEP);
+            tankPoses.resize(world.tanks.count);
+            for (int i = 0; i < world.tanks.count; i++) {
+                tankPoses[i] = interpolateTank(&world.tanks, i, alpha);
+            }
+            
+            // Keep both players in view
+            updateCamera(&camera, tankPoses[0].rect, tankPoses[1].rect, (float)frameTime);
+            SDL_Rect view = getCameraView(&camera);
+            
+            // Draw game background
+            drawTiledBackground(renderer, gameBackground, &camera);
+            
+            // Draw grass and rock objects (or their shadows) in the chunks on screen
+            {
+                PROFILE_ZONE("Obstacles");
+                collectChunkObstacles(&world.chunks, view, &visibleObstacles);
+                int grassCount = (int)world.grassObjects.size();
+                for (int id : visibleObstacles) {
+                    bool isGrass = id < grassCount;
+                    const GameObject& object = isGrass ? world.grassObjects[id] : world.rockObjects[id - grassCount];
+                    SDL_Rect screenRect = worldToScreen(&camera, object.rect);
+                    if (object.isDestroyed && object.hasShadow) {
+                        // Draw shadow
+                        drawSprite(&spriteBatch, isGrass ? grassShadow : rockShadow, screenRect, object.rotation);
+                    } else if (!object.isDestroyed) {
+                        // Draw normal grass or rock
+                        drawSprite(&spriteBatch, isGrass ? grass : rock, screenRect, object.rotation);
                     }
                 }
-            } else {
-                redTankObj.isMoving = false;
             }
             
-            // Update bullets
-            for (int i = 0; i < MAX_BULLETS; i++) {
-                if (bullets[i].active) {
-                    updateBullet(&bullets[i]);
-                    
-                    // Check bullet collision with tanks
-                    if (bullets[i].owner == 0) { // Blue tank bullet
-                        if (checkBulletTankCollision(bullets[i].rect, redTankObj.rect) && !redTankObj.isDestroyed) {
-                            // Check if red tank has active shield
-                            if (hasActiveShield(&shield, 1)) {
-                                // Reflect bullet
-                                reflectBullet(&bullets[i], &redTankObj);
-                            } else {
-                                // Normal hit or explosion bullet
-                                if (bullets[i].isExplosionBullet) {
-                                    // Explosion bullet - 3x damage
-                                    std::cout << "Blue tank hit red tank with explosion bullet! 3x damage!" << std::endl;
-                                    redTankObj.hp -= 75; // 3x damage (25 * 3)
-                                    blueTankObj.score += 300; // +300 points for explosion bullet hit
-                                    
-                                    // Explosion sound would play here
-                                    
-                                    // Check if red tank is destroyed
-                                    if (redTankObj.hp <= 0) {
-                                        destroyTank(&redTankObj);
-                                        winner = 0; // Blue tank wins
-                                        currentState = WINNER_SCREEN;
-                                        
-                                        // Winner sound would play here
-                                    }
-                                } else {
-                                    // Normal bullet
-                                    std::cout << "Blue tank hit red tank!" << std::endl;
-                                    redTankObj.hp -= 25; // Damage
-                                    blueTankObj.score += 100; // +100 points for hitting opponent
-                                    
-                            // Explosion sound would play here
-                                    
-                                    // Check if red tank is destroyed
-                                    if (redTankObj.hp <= 0) {
-                                        destroyTank(&redTankObj);
-                                        winner = 0; // Blue tank wins
-                                        currentState = WINNER_SCREEN;
-                                        
-                                        // Play winner sound
-                                        // Winner sound would play here
-                                    }
-                                }
-                                
-                                // Create explosion effect
-                                for (int j = 0; j < MAX_EXPLOSIONS; j++) {
-                                    if (!explosions[j].active) {
-                                        createExplosion(&explosions[j], redTankObj.rect);
-                                        break;
-                                    }
-                                }
-                                
-                                bullets[i].active = false;
-                            }
-                        }
-                    } else { // Red tank bullet
-                        if (checkBulletTankCollision(bullets[i].rect, blueTankObj.rect) && !blueTankObj.isDestroyed) {
-                            // Check if blue tank has active shield
-                            if (hasActiveShield(&shield, 0)) {
-                                // Reflect bullet
-                                reflectBullet(&bullets[i], &blueTankObj);
-                            } else {
-                                // Normal hit or explosion bullet
-                                if (bullets[i].isExplosionBullet) {
-                                    // Explosion bullet - 3x damage
-                                    std::cout << "Red tank hit blue tank with explosion bullet! 3x damage!" << std::endl;
-                                    blueTankObj.hp -= 75; // 3x damage (25 * 3)
-                                    redTankObj.score += 300; // +300 points for explosion bullet hit
-                                    
-                                    // Explosion sound would play here
-                                    
-                                    // Check if blue tank is destroyed
-                                    if (blueTankObj.hp <= 0) {
-                                        destroyTank(&blueTankObj);
-                                        winner = 1; // Red tank wins
-                                        currentState = WINNER_SCREEN;
-                                        
-                                        // Winner sound would play here
-                                    }
-                                } else {
-                                    // Normal bullet
-                                    std::cout << "Red tank hit blue tank!" << std::endl;
-                                    blueTankObj.hp -= 25; // Damage
-                                    redTankObj.score += 100; // +100 points for hitting opponent
-                                    
-                            // Explosion sound would play here
-                                    
-                                    // Check if blue tank is destroyed
-                                    if (blueTankObj.hp <= 0) {
-                                        destroyTank(&blueTankObj);
-                                        winner = 1; // Red tank wins
-                                        currentState = WINNER_SCREEN;
-                                        
-                                        // Play winner sound
-                                        // Winner sound would play here
-                                    }
-                                }
-                                
-                                // Create explosion effect
-                                for (int j = 0; j < MAX_EXPLOSIONS; j++) {
-                                    if (!explosions[j].active) {
-                                        createExplosion(&explosions[j], blueTankObj.rect);
-                                        break;
-                                    }
-                                }
-                                
-                                bullets[i].active = false;
-                            }
+            // Draw tanks with rotation (or shadows if destroyed), in their team's colors
+            {
+                PROFILE_ZONE("Tanks");
+                const int bodySprites[2] = {blueBody, redBody};
+                const int shieldSprites[2] = {blueShieldTank, redShieldTank};
+                const int gunSprites[2] = {blueGun, redGun};
+                for (int i = 0; i < world.tanks.count; i++) {
+                    const TankPose& pose = tankPoses[i];
+                    int team = world.tanks.info[i].team;
+                    if (!isTankAlive(&world.tanks, i)) {
+                        if (world.tanks.flags[i] & TANK_SHADOW) {
+                            // Draw tank shadow
+                            drawSprite(&spriteBatch, tankShadow, worldToScreen(&camera, pose.rect), pose.rotation);
                         }
+                        continue;
                     }
                     
-                    // Check bullet collision with grass objects
-                    for (int j = 0; j < GRASS_COUNT; j++) {
-                        if (checkBulletObjectCollision(bullets[i].rect, grassObjects[j])) {
-                            std::cout << "Bullet hit grass object at (" << grassObjects[j].rect.x 
-                                     << "," << grassObjects[j].rect.y << ")" << std::endl;
-                            destroyGameObject(&grassObjects[j]);
-                            
-                            // Add score based on bullet owner
-                            if (bullets[i].owner == 0) {
-                                blueTankObj.score += 10; // +10 points for destroying grass
-                            } else {
-                                redTankObj.score += 10; // +10 points for destroying grass
-                            }
-                            
-                            // Play explosion sound
-                            // Explosion sound would play here
-                            
-                            bullets[i].active = false;
-                            break; // Bullet is destroyed, no need to check more objects
-                        }
+                    // Draw tank body (normal or shield)
+                    if (hasActiveShield(&world.shield, i)) {
+                        // Draw shield body with scaled up size
+                        float shieldScale = 1.15f; // 15% larger
+                        SDL_Rect scaledRect = {
+                            pose.rect.x - (int)(pose.rect.w * (shieldScale - 1.0f) / 2),
+                            pose.rect.y - (int)(pose.rect.h * (shieldScale - 1.0f) / 2),
+                            (int)(pose.rect.w * shieldScale),
+                            (int)(pose.rect.h * shieldScale)
+                        };
+                        drawSprite(&spriteBatch, shieldSprites[team], worldToScreen(&camera, scaledRect), pose.rotation);
+                    } else {
+                        // Draw normal body
+                        drawSprite(&spriteBatch, bodySprites[team], worldToScreen(&camera, pose.rect), pose.rotation);
                     }
                     
-                    // Check bullet collision with rock objects
-                    for (int j = 0; j < ROCK_COUNT; j++) {
-                        if (checkBulletObjectCollision(bullets[i].rect, rockObjects[j])) {
-                            std::cout << "Bullet hit rock object at (" << rockObjects[j].rect.x 
-                                     << "," << rockObjects[j].rect.y << ")" << std::endl;
-                            destroyGameObject(&rockObjects[j]);
-                            
-                            // Add score based on bullet owner
-                            if (bullets[i].owner == 0) {
-                                blueTankObj.score += 10; // +10 points for destroying rock
-                            } else {
-                                redTankObj.score += 10; // +10 points for destroying rock
-                            }
-                            
-                            // Play explosion sound
-                            // Explosion sound would play here
-                            
-                            bullets[i].active = false;
-                            break; // Bullet is destroyed, no need to check more objects
-                        }
-                    }
+                    // Draw tank gun (always the same)
+                    drawSprite(&spriteBatch, gunSprites[team], worldToScreen(&camera, pose.gunRect),
+                                   pose.rotation + pose.gunRotation);
                 }
             }
             
-            // Draw game background
-            SDL_RenderCopy(renderer, gameBackground, NULL, NULL);
-            
-            // Draw grass objects and shadows
-            for (int i = 0; i < GRASS_COUNT; i++) {
-                if (grassObjects[i].isDestroyed && grassObjects[i].hasShadow) {
-                    // Draw shadow
-                    SDL_RenderCopyEx(renderer, grassShadow, NULL, &grassObjects[i].rect, 
-                                   grassObjects[i].rotation, NULL, SDL_FLIP_NONE);
-                } else if (!grassObjects[i].isDestroyed) {
-                    // Draw normal grass
-                    SDL_RenderCopyEx(renderer, grass, NULL, &grassObjects[i].rect, 
-                                   grassObjects[i].rotation, NULL, SDL_FLIP_NONE);
+            // Draw bullets
+            {
+                PROFILE_ZONE("Bullet sprites");
+                for (int i = 0; i < (int)world.bullets.flags.size(); i++) {
+                    if (isBulletActive(&world.bullets, i)) {
+                        SDL_Rect bulletRect = getBulletRect(&world.bullets, i, alpha);
+                        if (!rectsIntersect(bulletRect, view)) continue;
+                        bulletRect = worldToScreen(&camera, bulletRect);
+                        if (world.tanks.info[world.bullets.owner[i]].team == 0) { // Blue tank bullet
+                            drawSprite(&spriteBatch, blueBullet, bulletRect, 
+                                           fixedToFloat(world.bullets.rotation[i]));
+                        } else { // Red tank bullet
+                            drawSprite(&spriteBatch, redBullet, bulletRect, 
+                                           fixedToFloat(world.bullets.rotation[i]));
+                        }
+                    }
                 }
             }
             
-            // Draw rock objects and shadows
-            for (int i = 0; i < ROCK_COUNT; i++) {
-                if (rockObjects[i].isDestroyed && rockObjects[i].hasShadow) {
-                    // Draw shadow
-                    SDL_RenderCopyEx(renderer, rockShadow, NULL, &rockObjects[i].rect, 
-                                   rockObjects[i].rotation, NULL, SDL_FLIP_NONE);
-                } else if (!rockObjects[i].isDestroyed) {
-                    // Draw normal rock
-                    SDL_RenderCopyEx(renderer, rock, NULL, &rockObjects[i].rect, 
-                                   rockObjects[i].rotation, NULL, SDL_FLIP_NONE);
+            // Draw power box with different visual for different types
+            {
+                PROFILE_ZONE("Pickups");
+                if (world.powerBox.active) {
+                    if (world.powerBox.boxType == 0) {
+                        // Shield box - normal color
+                        drawSprite(&spriteBatch, powerBoxSprite, worldToScreen(&camera, world.powerBox.rect));
+                    } else {
+                        // Power-up box - yellow tint
+                        drawSprite(&spriteBatch, powerBoxSprite, worldToScreen(&camera, world.powerBox.rect), 0.0, SDL_Color{255, 255, 0, 255});
+                    } 
                 }
-            }
             
-            // Draw tanks with rotation (or shadows if destroyed)
-            if (blueTankObj.isDestroyed && blueTankObj.hasShadow) {
-                // Draw blue tank shadow
-                SDL_RenderCopyEx(renderer, tankShadow, NULL, &blueTankObj.rect, 
-                               blueTankObj.rotation, NULL, SDL_FLIP_NONE);
-            } else if (!blueTankObj.isDestroyed) {
-                // Draw blue tank body (normal or shield)
-                if (hasActiveShield(&shield, 0)) {
-                    // Draw blue shield body with scaled up size
-                    float shieldScale = 1.15f; // 15% larger
-                    SDL_Rect scaledRect = {
-                        blueTankObj.rect.x - (int)(blueTankObj.rect.w * (shieldScale - 1.0f) / 2),
-                        blueTankObj.rect.y - (int)(blueTankObj.rect.h * (shieldScale - 1.0f) / 2),
-                        (int)(blueTankObj.rect.w * shieldScale),
-                        (int)(blueTankObj.rect.h * shieldScale)
-                    };
-                    SDL_RenderCopyEx(renderer, blueShieldTank, NULL, &scaledRect, 
-                                   blueTankObj.rotation, NULL, SDL_FLIP_NONE);
-                } else {
-                    // Draw normal blue body
-                    SDL_RenderCopyEx(renderer, blueBody, NULL, &blueTankObj.rect, 
-                                   blueTankObj.rotation, NULL, SDL_FLIP_NONE);
-                }
-                
-                // Draw blue tank gun (always the same)
-                SDL_RenderCopyEx(renderer, blueGun, NULL, &blueTankObj.gunRect, 
-                               blueTankObj.rotation + blueTankObj.gunRotation, NULL, SDL_FLIP_NONE);
-            }
             
-            if (redTankObj.isDestroyed && redTankObj.hasShadow) {
-                // Draw red tank shadow
-                SDL_RenderCopyEx(renderer, tankShadow, NULL, &redTankObj.rect, 
-                               redTankObj.rotation, NULL, SDL_FLIP_NONE);
-            } else if (!redTankObj.isDestroyed) {
-                // Draw red tank body (normal or shield)
-                if (hasActiveShield(&shield, 1)) {
-                    // Draw red shield body with scaled up size
-                    float shieldScale = 1.15f; // 15% larger
-                    SDL_Rect scaledRect = {
-                        redTankObj.rect.x - (int)(redTankObj.rect.w * (shieldScale - 1.0f) / 2),
-                        redTankObj.rect.y - (int)(redTankObj.rect.h * (shieldScale - 1.0f) / 2),
-                        (int)(redTankObj.rect.w * shieldScale),
-                        (int)(redTankObj.rect.h * shieldScale)
-                    };
-                    SDL_RenderCopyEx(renderer, redShieldTank, NULL, &scaledRect, 
-                                   redTankObj.rotation, NULL, SDL_FLIP_NONE);
-                } else {
-                    // Draw normal red body
-                    SDL_RenderCopyEx(renderer, redBody, NULL, &redTankObj.rect, 
-                                   redTankObj.rotation, NULL, SDL_FLIP_NONE);
+                // Draw bomb items (explosion items following their tank)
+                for (int i = 0; i < world.tanks.count; i++) {
+                    int bombCount = std::min(world.tanks.info[i].explosionItemCount, TANK_BOMB_ICONS);
+                    for (int slot = 0; slot < bombCount; slot++) {
+                        const float bombScale = 0.8f;
+                        SDL_Rect bombRect = getTankBombRect(tankPoses[i].rect, slot);
+                        bombRect.w = (int)(bombRect.w * bombScale);
+                        bombRect.h = (int)(bombRect.h * bombScale);
+                        drawSprite(&spriteBatch, bombSprite, worldToScreen(&camera, bombRect));
+                    }
                 }
-                
-                // Draw red tank gun (always the same)
-                SDL_RenderCopyEx(renderer, redGun, NULL, &redTankObj.gunRect, 
-                               redTankObj.rotation + redTankObj.gunRotation, NULL, SDL_FLIP_NONE);
-            }
             
-            // Draw bullets
-            for (int i = 0; i < MAX_BULLETS; i++) {
-                if (bullets[i].active) {
-                    if (bullets[i].owner == 0) { // Blue tank bullet
-                        SDL_RenderCopyEx(renderer, blueBullet, NULL, &bullets[i].rect, 
-                                       bullets[i].rotation, NULL, SDL_FLIP_NONE);
-                    } else { // Red tank bullet
-                        SDL_RenderCopyEx(renderer, redBullet, NULL, &bullets[i].rect, 
-                                       bullets[i].rotation, NULL, SDL_FLIP_NONE);
+                // Draw explosions
+                for (int i = 0; i < MAX_EXPLOSIONS; i++) {
+                    if (world.explosions[i].active) {
+                        drawSprite(&spriteBatch, explosionSprite, worldToScreen(&camera, world.explosions[i].rect));
                     }
                 }
             }
             
-            // Draw power box with different visual for different types
-            if (powerBox.active) {
-                if (powerBox.boxType == 0) {
-                    // Shield box - normal color
-                    SDL_RenderCopy(renderer, powerBoxTexture, NULL, &powerBox.rect);
-                } else {
-                    // Power-up box - yellow tint
-                    SDL_SetTextureColorMod(powerBoxTexture, 255, 255, 0);
-                    SDL_RenderCopy(renderer, powerBoxTexture, NULL, &powerBox.rect);
-                    SDL_SetTextureColorMod(powerBoxTexture, 255, 255, 255); // Reset
-                } 
+            // Move and draw the particles; their cost against the budget sets how much later bursts emit
+            {
+                PROFILE_ZONE("Particles");
+                Uint64 particleStartCounter = SDL_GetPerformanceCounter();
+                updateParticles(&particles, (float)frameTime);
+                drawParticles(&spriteBatch, &particles, &camera);
+                adjustParticleQuality(&particles,
+                                      (SDL_GetPerformanceCounter() - particleStartCounter) * 1000.0 / counterFrequency);
             }
             
+            // Draw ammo bars and HP bars
+            {
+                PROFILE_ZONE("HUD");
+                const SDL_Color teamColors[2] = {{0, 100, 255, 255}, {255, 100, 0, 255}}; // Blue and red
+                SDL_Color greenColor = {0, 255, 0, 255};  // Green color for HP
             
-            // Draw bomb items (bombs following tanks)
-            for (int i = 0; i < MAX_BOMB_ITEMS; i++) {
-                if (bombItems[i].active && bombTexture) {
-                    SDL_Rect scaledRect = {
-                        bombItems[i].rect.x,
-                        bombItems[i].rect.y,
-                        (int)(bombItems[i].rect.w * bombItems[i].scale),
-                        (int)(bombItems[i].rect.h * bombItems[i].scale)
-                    };
-                    SDL_RenderCopy(renderer, bombTexture, NULL, &scaledRect);
+                // Small ammo and HP bars over every live tank
+                for (int i = 0; i < world.tanks.count; i++) {
+                    if (!isTankAlive(&world.tanks, i)) continue;
+                    SDL_Rect screenRect = worldToScreen(&camera, tankPoses[i].rect);
+                    int barWidth = std::max(screenRect.w, 30);
+                    int barX = screenRect.x + (screenRect.w - barWidth) / 2;
+                    SDL_Color color = teamColors[world.tanks.info[i].team];
+                    drawAmmoBar(&spriteBatch, &world.tanks, i, barX, screenRect.y - 14, barWidth, 5, color);
+                    drawHPBar(&spriteBatch, &world.tanks, i, barX, screenRect.y - 8, barWidth, 4, greenColor);
                 }
-            }
             
-            // Draw explosions
-            for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-                if (explosions[i].active && explosionTexture) {
-                    SDL_RenderCopy(renderer, explosionTexture, NULL, &explosions[i].rect);
+                // Local player ammo bar, HP bar and score (bottom left)
+                int localTank = getLocalTank();
+                SDL_Color localColor = teamColors[world.tanks.info[localTank].team];
+                drawAmmoBar(&spriteBatch, &world.tanks, localTank, 10, 500, 200, 20, localColor);
+                drawHPBar(&spriteBatch, &world.tanks, localTank, 10, 500, 200, 15, greenColor);
+                drawScoreWithNumbers(&spriteBatch, numberSprites, world.tanks.info[localTank].score, 30, 450, 20, 30);
+            
+                // Second local player on the arrow keys (top right)
+                if (!(singlePlayer || netplayMatch || serverMatch) && world.tanks.count > 1) {
+                    SDL_Color secondColor = teamColors[world.tanks.info[1].team];
+                    drawAmmoBar(&spriteBatch, &world.tanks, 1, 750, 10, 200, 20, secondColor);
+                    drawHPBar(&spriteBatch, &world.tanks, 1, 750, 35, 200, 15, greenColor);
+                    drawScoreWithNumbers(&spriteBatch, numberSprites, world.tanks.info[1].score, 900, 50, 20, 30);
                 }
             }
             
-            // Draw ammo bars and HP bars
-            SDL_Color blueColor = {0, 100, 255, 255}; // Blue color
-            SDL_Color redColor = {255, 100, 0, 255};  // Red color
-            SDL_Color greenColor = {0, 255, 0, 255};  // Green color for HP
-            
-            // Blue tank ammo bar (bottom left)
-            drawAmmoBar(renderer, blueTankObj, 10, 500, 200, 20, blueColor);
-            
-            // Blue tank HP bar (below ammo bar)
-            drawHPBar(renderer, blueTankObj, 10, 500, 200, 15, greenColor);
-            
-            // Red tank ammo bar (top right)
-            drawAmmoBar(renderer, redTankObj, 750, 10, 200, 20, redColor);
-            
-            // Red tank HP bar (below ammo bar)
-            drawHPBar(renderer, redTankObj, 750, 35, 200, 15, greenColor);
-            
-            // Draw scores using number images
-            drawScoreWithNumbers(renderer, numberTextures, blueTankObj.score, 30, 450, 20, 30);
-            drawScoreWithNumbers(renderer, numberTextures, redTankObj.score, 900, 50, 20, 30);
-            
             // Debug: Log tank positions every 60 frames (about 1 second at 60 FPS)
             static int frameCounter = 0;
             frameCounter++;
             if (frameCounter % 60 == 0) {
-                std::cout << "[DEBUG] Tank positions - Blue: (" << blueTankObj.rect.x 
-                         << "," << blueTankObj.rect.y << ") Red: (" << redTankObj.rect.x 
-                         << "," << redTankObj.rect.y << ")" << std::endl;
+                LOG_DEBUG("[DEBUG] Player positions - Blue: (%d,%d) Red: (%d,%d)",
+                          world.tanks.rect[0].x, world.tanks.rect[0].y, world.tanks.rect[1].x, world.tanks.rect[1].y);
+                LOG_DEBUG("[BOTS] %d bots, %d thought, %d deferred, %.3f ms", (int)bots.bots.size(),
+                          bots.thinksLastFrame, bots.skippedLastFrame, bots.thinkSecondsLastFrame * 1000.0);
             }
         }
         else if (currentState == WINNER_SCREEN) {
+            // Keep answering the peer, which may still be waiting for our last inputs
+            if (netplayMatch) {
+                pollNetplay(&netplay, &world, &jobs);
+            }
+            if (serverMatch) {
+                updateGameClient(&serverClient, &world, TankInput());
+            }
+            
             // Draw winner screen
             SDL_RenderCopy(renderer, gameBackground, NULL, NULL);
             
             // Draw winner image
             SDL_Rect winnerImageRect = {330, 150, 300, 150}; // Center the image
-            if (winner == 0) {
-                // Blue tank wins
-                SDL_RenderCopy(renderer, blueWinImage, NULL, &winnerImageRect);
-                std::cout << "BLUE TANK WINS! Final Score: " << blueTankObj.score << std::endl;
-            } else if (winner == 1) {
-                // Red tank wins
-                SDL_RenderCopy(renderer, redWinImage, NULL, &winnerImageRect);
-                std::cout << "RED TANK WINS! Final Score: " << redTankObj.score << std::endl;
-            }
-            
-            // Draw final score using number images
-            if (winner == 0) {
-                drawScoreWithNumbers(renderer, numberTextures, blueTankObj.score, 480, 250, 25, 35);
-            } else if (winner == 1) {
-                drawScoreWithNumbers(renderer, numberTextures, redTankObj.score, 480, 250, 25, 35);
+            if (world.winner >= 0) { // A draw (WINNER_DRAW) shows no winner
+                // Winner's team image and final score using number images
+                int winnerScore = world.tanks.info[world.winner].score;
+                if (world.tanks.info[world.winner].team == 0) {
+                    drawSprite(&spriteBatch, blueWinImage, winnerImageRect);
+                    LOG_DEBUG("BLUE TANK %d WINS! Final Score: %d", world.winner, winnerScore);
+                } else {
+                    drawSprite(&spriteBatch, redWinImage, winnerImageRect);
+                    LOG_DEBUG("RED TANK %d WINS! Final Score: %d", world.winner, winnerScore);
+                }
+                drawScoreWithNumbers(&spriteBatch, numberSprites, winnerScore, 480, 250, 25, 35);
             }
             
             // Draw buttons
-            SDL_RenderCopy(renderer, playAgainButton, NULL, &playAgainButtonRect);
-            SDL_RenderCopy(renderer, homeButton, NULL, &homeButtonRect);
+            drawSprite(&spriteBatch, playAgainButton, playAgainButtonRect);
+            drawSprite(&spriteBatch, homeButton, homeButtonRect);
             
-            // Draw remaining explosions
+            // Draw remaining explosions (the camera stays where the match ended)
             for (int i = 0; i < MAX_EXPLOSIONS; i++) {
-                if (explosions[i].active && explosionTexture) {
-                    SDL_RenderCopy(renderer, explosionTexture, NULL, &explosions[i].rect);
+                if (world.explosions[i].active) {
+                    drawSprite(&spriteBatch, explosionSprite, worldToScreen(&camera, world.explosions[i].rect));
                 }
             }
         }
         
-        SDL_RenderPresent(renderer);
+        // Profiler overlay goes on top of everything (F3)
+        if (showProfiler) {
+            drawProfilerOverlay(&spriteBatch, 10, 60);
+        }
+        
+        // Submit whatever the sprite batch still holds
+        {
+            PROFILE_ZONE("Batch flush");
+            flushSpriteBatch(&spriteBatch);
+        }
+        
+        // Debug: Log batching stats every 300 frames
+        static int batchLogCounter = 0;
+        batchLogCounter++;
+        if (batchLogCounter % 300 == 0) {
+            LOG_DEBUG("[DEBUG] Sprite batch: %d sprites in %d draw calls", spriteBatch.spriteCount, spriteBatch.drawCalls);
+            LOG_DEBUG("[DEBUG] Particles: %d live, quality %.2f, %.2f ms; %llu emitted, %llu skipped, %llu recycled",
+                      particles.count, particles.quality, particles.costMs, (unsigned long long)particles.emitted,
+                      (unsigned long long)particles.skipped, (unsigned long long)particles.recycled);
+        }
+        
+        {
+            PROFILE_ZONE("Present");
+            SDL_RenderPresent(renderer);
+        }
+        endProfileFrame();
+        if (!firstFramePresented) {
+            firstFramePresented = true;
+            LOG_INFO("[ASSETS] First frame presented %.2f ms after SDL_Init",
+                     (SDL_GetPerformanceCounter() - startupCounter) * 1000.0 / counterFrequency);
+        }
+        
+        // Frame limiter: vsync normally paces us, otherwise sleep off the rest of the frame
+        double elapsed = (SDL_GetPerformanceCounter() - frameStartCounter) / counterFrequency;
+        if (elapsed < MIN_FRAME_TIME) {
+            SDL_Delay((Uint32)((MIN_FRAME_TIME - elapsed) * 1000.0));
+        }
     }
     
     // Cleanup
+    endNetplayMatch();
+    stopJobSystem(&jobs);
     SDL_DestroyTexture(welcomeBackground);
-    SDL_DestroyTexture(startButton);
     SDL_DestroyTexture(gameModeBackground);
-    SDL_DestroyTexture(multiplayerButton);
-    SDL_DestroyTexture(multiplayerButtonHover);
-
     SDL_DestroyTexture(gameBackground);
-    SDL_DestroyTexture(blueBody);
-    SDL_DestroyTexture(blueGun);
-    SDL_DestroyTexture(redBody);
-    SDL_DestroyTexture(redGun);
-    SDL_DestroyTexture(grass);
-    SDL_DestroyTexture(rock);
-    SDL_DestroyTexture(blueBullet);
-    SDL_DestroyTexture(redBullet);
-    SDL_DestroyTexture(grassShadow);
-    SDL_DestroyTexture(rockShadow);
-    SDL_DestroyTexture(explosionTexture);
-    SDL_DestroyTexture(tankShadow);
-    SDL_DestroyTexture(blueWinImage);
-    SDL_DestroyTexture(redWinImage);
-    SDL_DestroyTexture(playAgainButton);
-    SDL_DestroyTexture(homeButton);
-    
-    // Cleanup number textures
-    for (int i = 0; i < 10; i++) {
-        SDL_DestroyTexture(numberTextures[i]);
-    }
     
-    // Cleanup power box and shield textures
-    SDL_DestroyTexture(powerBoxTexture);
-    SDL_DestroyTexture(blueShieldTank);
-    SDL_DestroyTexture(redShieldTank);
-    SDL_DestroyTexture(bombTexture);
+    // Cleanup atlas pages (every other sprite lives there)
+    destroyTextureAtlas(&atlas);
+    closeMap(&map);
     
-    // Audio cleanup commented out - SDL_mixer not available
-    // Mix_FreeMusic(backgroundMusic);
-    // Mix_FreeChunk(explosionSound);
-    // Mix_FreeChunk(winnerSound);
-    // Mix_CloseAudio();
+    closeAudioEngine(&audio);
     
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
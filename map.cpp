@@ -0,0 +1,150 @@
+#include "map.h"
+#include "log.h"
+#include <cstring>
+
+static_assert(sizeof(MapHeader) == 32, "MapHeader layout is part of the file format");
+static_assert(sizeof(MapObstacle) == 24, "MapObstacle layout is part of the file format");
+static_assert(sizeof(MapSpawn) == 16, "MapSpawn layout is part of the file format");
+static_assert(sizeof(MapZone) == 16, "MapZone layout is part of the file format");
+
+// Function to hash a whole map image (FNV-1a)
+static uint64_t hashMapImage(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// Function to check that a rect (or a point, with w = h = 0) lies entirely inside the arena
+static bool isInsideArena(const MapHeader* header, int32_t x, int32_t y, int32_t w, int32_t h) {
+    // Widened so a corrupt record cannot overflow the sum
+    return x >= 0 && y >= 0 && (int64_t)x + w <= header->width && (int64_t)y + h <= header->height;
+}
+
+// Function to check a map image and point the record arrays into it
+bool openMapFromMemory(GameMap* map, const uint8_t* data, size_t size, const std::string& name) {
+    map->header = nullptr;
+    map->obstacles = nullptr;
+    map->spawns = nullptr;
+    map->zones = nullptr;
+
+    // Validate everything up front so the game can trust every record
+    const char* error = nullptr;
+    const MapHeader* header = (const MapHeader*)data;
+    if (size < sizeof(MapHeader) || memcmp(header->magic, MAP_MAGIC, sizeof(header->magic)) != 0) {
+        error = "not a map";
+    } else if (header->version != MAP_VERSION) {
+        error = "unsupported version";
+    } else if (header->width <= 0 || header->height <= 0) {
+        error = "empty arena";
+    } else if (header->width > MAP_MAX_SIZE || header->height > MAP_MAX_SIZE) {
+        error = "arena too large";
+    } else if (size != sizeof(MapHeader) + (uint64_t)header->obstacleCount * sizeof(MapObstacle) +
+                          (uint64_t)header->spawnCount * sizeof(MapSpawn) +
+                          (uint64_t)header->zoneCount * sizeof(MapZone)) {
+        error = "size does not match the record counts";
+    } else {
+        map->header = header;
+        map->obstacles = (const MapObstacle*)(data + sizeof(MapHeader));
+        map->spawns = (const MapSpawn*)(map->obstacles + header->obstacleCount);
+        map->zones = (const MapZone*)(map->spawns + header->spawnCount);
+
+        for (uint32_t i = 0; i < header->obstacleCount && !error; i++) {
+            const MapObstacle& obstacle = map->obstacles[i];
+            if (obstacle.type != MAP_GRASS && obstacle.type != MAP_ROCK) {
+                error = "unknown obstacle type";
+            } else if (obstacle.w <= 0 || obstacle.h <= 0) {
+                error = "obstacle with an empty rect";
+            } else if (!isInsideArena(header, obstacle.x, obstacle.y, obstacle.w, obstacle.h)) {
+                error = "obstacle outside the arena";
+            }
+        }
+        for (uint32_t i = 0; i < header->spawnCount && !error; i++) {
+            if (!isInsideArena(header, map->spawns[i].x, map->spawns[i].y, 0, 0)) {
+                error = "spawn point outside the arena";
+            }
+        }
+        for (uint32_t i = 0; i < header->zoneCount && !error; i++) {
+            const MapZone& zone = map->zones[i];
+            if (zone.w <= 0 || zone.h <= 0) {
+                error = "empty power box zone";
+            } else if (!isInsideArena(header, zone.x, zone.y, zone.w, zone.h)) {
+                error = "power box zone outside the arena";
+            }
+        }
+        if (!error && (!findMapSpawn(map, 0) || !findMapSpawn(map, 1))) {
+            error = "both teams need a spawn point";
+        }
+    }
+
+    if (error) {
+        LOG_ERROR("[ERROR] Map %s is invalid: %s", name.c_str(), error);
+        map->header = nullptr;
+        return false;
+    }
+
+    map->hash = hashMapImage(data, size);
+    return true;
+}
+
+// Function to map a map file and validate it
+bool loadMap(GameMap* map, const std::string& path) {
+    if (!mapFile(&map->file, path)) {
+        LOG_ERROR("[ERROR] Unable to open map %s", path.c_str());
+        return false;
+    }
+    if (!openMapFromMemory(map, map->file.data, map->file.size, path)) {
+        unmapFile(&map->file);
+        return false;
+    }
+
+    LOG_INFO("[MAP] Mapped %s: %dx%d, %u obstacles, %u spawns, %u power box zones", path.c_str(),
+             map->header->width, map->header->height, map->header->obstacleCount, map->header->spawnCount,
+             map->header->zoneCount);
+    return true;
+}
+
+// Function to unmap a map
+void closeMap(GameMap* map) {
+    unmapFile(&map->file);
+    map->header = nullptr;
+    map->obstacles = nullptr;
+    map->spawns = nullptr;
+    map->zones = nullptr;
+}
+
+// Function to find a team's spawn point
+const MapSpawn* findMapSpawn(const GameMap* map, uint32_t team) {
+    for (uint32_t i = 0; i < map->header->spawnCount; i++) {
+        if (map->spawns[i].team == team) {
+            return &map->spawns[i];
+        }
+    }
+    return nullptr;
+}
+
+// Function to lay out a map file image from its parts
+std::vector<uint8_t> buildMapImage(int width, int height, const std::vector<MapObstacle>& obstacles,
+                                   const std::vector<MapSpawn>& spawns, const std::vector<MapZone>& zones) {
+    MapHeader header = {};
+    memcpy(header.magic, MAP_MAGIC, sizeof(header.magic));
+    header.version = MAP_VERSION;
+    header.width = width;
+    header.height = height;
+    header.obstacleCount = (uint32_t)obstacles.size();
+    header.spawnCount = (uint32_t)spawns.size();
+    header.zoneCount = (uint32_t)zones.size();
+
+    std::vector<uint8_t> image(sizeof(MapHeader) + obstacles.size() * sizeof(MapObstacle) +
+                               spawns.size() * sizeof(MapSpawn) + zones.size() * sizeof(MapZone));
+    uint8_t* cursor = image.data();
+    memcpy(cursor, &header, sizeof(header));
+    cursor += sizeof(header);
+    if (!obstacles.empty()) memcpy(cursor, obstacles.data(), obstacles.size() * sizeof(MapObstacle));
+    cursor += obstacles.size() * sizeof(MapObstacle);
+    if (!spawns.empty()) memcpy(cursor, spawns.data(), spawns.size() * sizeof(MapSpawn));
+    cursor += spawns.size() * sizeof(MapSpawn);
+    if (!zones.empty()) memcpy(cursor, zones.data(), zones.size() * sizeof(MapZone));
+    return image;
+}
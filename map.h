@@ -0,0 +1,98 @@
+#pragma once
+
+// Arena maps. A map file holds the arena size, every obstacle (type,
+// rect, rotation), the tank spawn points and the zones power boxes may
+// appear in. Files are memory-mapped and the record arrays are used in
+// place: loading allocates nothing, and its cost (validating every
+// record and hashing the file) is linear in the file size.
+//
+// Layout (little-endian, every record 4-byte aligned):
+//   MapHeader
+//   MapObstacle[obstacleCount]
+//   MapSpawn[spawnCount]
+//   MapZone[zoneCount]
+//
+// Maps are written by the make_map tool (map_tool.cpp), from a text
+// description or generated for stress testing.
+
+#include "mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Map the game loads when none is given on the command line
+const char* const DEFAULT_MAP_FILE = "resource/arena.tmap";
+
+const char MAP_MAGIC[4] = {'T', 'M', 'A', 'P'};
+const uint32_t MAP_VERSION = 1;
+
+// Largest arena side in pixels (positions must fit the simulation's Fixed numbers)
+const int32_t MAP_MAX_SIZE = 30000;
+
+// Obstacle types
+const uint32_t MAP_GRASS = 0; // Destroyed by any bullet
+const uint32_t MAP_ROCK = 1; // Destroyed by any bullet
+
+// Structure at the start of a map file
+struct MapHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t width; // Arena size in pixels
+    int32_t height;
+    uint32_t obstacleCount;
+    uint32_t spawnCount;
+    uint32_t zoneCount;
+    uint32_t reserved;
+};
+
+// Structure for one obstacle
+struct MapObstacle {
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+    float rotation; // Degrees, only used for drawing
+    uint32_t type; // MAP_GRASS or MAP_ROCK
+};
+
+// Structure for a tank spawn point
+struct MapSpawn {
+    int32_t x; // Where the tank's center is placed
+    int32_t y;
+    float rotation; // Facing in degrees (0 = up)
+    uint32_t team; // 0 = blue, 1 = red
+};
+
+// Structure for an area power boxes may spawn in
+struct MapZone {
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+};
+
+// Structure for a loaded map (the arrays point into the mapping)
+struct GameMap {
+    MappedFile file; // file.data is null for maps opened from memory
+    const MapHeader* header;
+    const MapObstacle* obstacles;
+    const MapSpawn* spawns;
+    const MapZone* zones;
+    uint64_t hash; // FNV-1a of the whole file, identifies the map in replays
+};
+
+// Function to map a map file and validate it (false if missing or invalid)
+bool loadMap(GameMap* map, const std::string& path);
+
+// Function to use a map image that is already in memory (the caller keeps it alive)
+bool openMapFromMemory(GameMap* map, const uint8_t* data, size_t size, const std::string& name);
+
+// Function to unmap a map
+void closeMap(GameMap* map);
+
+// Function to find a team's spawn point (null if the map has none)
+const MapSpawn* findMapSpawn(const GameMap* map, uint32_t team);
+
+// Function to lay out a map file image from its parts
+std::vector<uint8_t> buildMapImage(int width, int height, const std::vector<MapObstacle>& obstacles,
+                                   const std::vector<MapSpawn>& spawns, const std::vector<MapZone>& zones);
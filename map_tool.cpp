@@ -0,0 +1,197 @@
+// make_map: builds arena map files (see map.h).
+//
+//   make_map build <map.txt> <out.tmap>     text description -> map file
+//   make_map dump <map.tmap>                map file -> text description (stdout)
+//   make_map generate <out.tmap> <width> <height> <obstacles> [seed]
+//                                           random arena for stress testing
+//
+// The text format is one record per line ('#' starts a comment):
+//   size  <width> <height>
+//   spawn <team> <center x> <center y> <rotation>
+//   zone  <x> <y> <w> <h>
+//   grass <x> <y> <w> <h> [rotation]
+//   rock  <x> <y> <w> <h> [rotation]
+
+#include "log.h"
+#include "map.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Structure for a map being assembled
+struct MapSource {
+    int width = 0;
+    int height = 0;
+    std::vector<MapObstacle> obstacles;
+    std::vector<MapSpawn> spawns;
+    std::vector<MapZone> zones;
+};
+
+// Function to parse a text description (false on the first bad line)
+static bool parseMapText(MapSource* source, const std::string& path) {
+    std::ifstream input(path);
+    if (!input) {
+        fprintf(stderr, "Unable to open %s\n", path.c_str());
+        return false;
+    }
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(input, line); lineNumber++) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        char keyword[16] = {};
+        if (sscanf(line.c_str(), "%15s", keyword) != 1) continue; // Blank line
+
+        bool valid = false;
+        const char* args = line.c_str() + line.find(keyword) + strlen(keyword);
+        if (strcmp(keyword, "size") == 0) {
+            valid = sscanf(args, "%d %d", &source->width, &source->height) == 2;
+        } else if (strcmp(keyword, "spawn") == 0) {
+            MapSpawn spawn = {};
+            valid = sscanf(args, "%u %d %d %f", &spawn.team, &spawn.x, &spawn.y, &spawn.rotation) == 4;
+            source->spawns.push_back(spawn);
+        } else if (strcmp(keyword, "zone") == 0) {
+            MapZone zone = {};
+            valid = sscanf(args, "%d %d %d %d", &zone.x, &zone.y, &zone.w, &zone.h) == 4;
+            source->zones.push_back(zone);
+        } else if (strcmp(keyword, "grass") == 0 || strcmp(keyword, "rock") == 0) {
+            MapObstacle obstacle = {};
+            obstacle.type = strcmp(keyword, "grass") == 0 ? MAP_GRASS : MAP_ROCK;
+            valid = sscanf(args, "%d %d %d %d %f", &obstacle.x, &obstacle.y, &obstacle.w, &obstacle.h,
+                           &obstacle.rotation) >= 4;
+            source->obstacles.push_back(obstacle);
+        }
+
+        if (!valid) {
+            fprintf(stderr, "%s:%d: cannot parse '%s'\n", path.c_str(), lineNumber, line.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to scatter obstacles over an arena, keeping the spawn corners clear
+static void generateMap(MapSource* source, int width, int height, int obstacleCount, unsigned seed) {
+    const int SPAWN_CLEARANCE = 120; // Free square around each spawn point
+    std::mt19937 random(seed);
+
+    source->width = width;
+    source->height = height;
+    source->spawns.push_back(MapSpawn{70, height - 74, 0.0f, 0});
+    source->spawns.push_back(MapSpawn{width - 120, 74, 180.0f, 1});
+    source->zones.push_back(MapZone{50, 50, width - 100, height - 100});
+
+    std::uniform_int_distribution<int> sizes(20, 50);
+    std::uniform_int_distribution<int> rotations(0, 359);
+    while ((int)source->obstacles.size() < obstacleCount) {
+        MapObstacle obstacle = {};
+        obstacle.w = obstacle.h = sizes(random);
+        obstacle.x = std::uniform_int_distribution<int>(0, width - obstacle.w)(random);
+        obstacle.y = std::uniform_int_distribution<int>(0, height - obstacle.h)(random);
+        obstacle.rotation = (float)rotations(random);
+        obstacle.type = random() % 3 == 0 ? MAP_ROCK : MAP_GRASS;
+
+        bool blocksSpawn = false;
+        for (const MapSpawn& spawn : source->spawns) {
+            if (obstacle.x < spawn.x + SPAWN_CLEARANCE && obstacle.x + obstacle.w > spawn.x - SPAWN_CLEARANCE &&
+                obstacle.y < spawn.y + SPAWN_CLEARANCE && obstacle.y + obstacle.h > spawn.y - SPAWN_CLEARANCE) {
+                blocksSpawn = true;
+            }
+        }
+        if (!blocksSpawn) {
+            source->obstacles.push_back(obstacle);
+        }
+    }
+}
+
+// Function to validate and write a map file
+static bool writeMapFile(const MapSource& source, const std::string& path) {
+    std::vector<uint8_t> image = buildMapImage(source.width, source.height, source.obstacles, source.spawns,
+                                               source.zones);
+    GameMap check = {};
+    if (!openMapFromMemory(&check, image.data(), image.size(), path)) {
+        return false;
+    }
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to write %s\n", path.c_str());
+        return false;
+    }
+    bool success = fwrite(image.data(), 1, image.size(), file) == image.size();
+    success = fclose(file) == 0 && success;
+
+    printf("Wrote %s: %dx%d, %zu obstacles, %zu spawns, %zu zones, %.1f KB\n", path.c_str(), source.width,
+           source.height, source.obstacles.size(), source.spawns.size(), source.zones.size(), image.size() / 1024.0);
+    return success;
+}
+
+// Function to print a map file in the text format
+static bool dumpMapFile(const std::string& path) {
+    GameMap map = {};
+    if (!loadMap(&map, path)) {
+        return false;
+    }
+
+    const MapHeader* header = map.header;
+    printf("size %d %d\n\n", header->width, header->height);
+    for (uint32_t i = 0; i < header->spawnCount; i++) {
+        const MapSpawn& spawn = map.spawns[i];
+        printf("spawn %u %d %d %g\n", spawn.team, spawn.x, spawn.y, spawn.rotation);
+    }
+    printf("\n");
+    for (uint32_t i = 0; i < header->zoneCount; i++) {
+        const MapZone& zone = map.zones[i];
+        printf("zone %d %d %d %d\n", zone.x, zone.y, zone.w, zone.h);
+    }
+    printf("\n");
+    for (uint32_t i = 0; i < header->obstacleCount; i++) {
+        const MapObstacle& obstacle = map.obstacles[i];
+        printf("%s %d %d %d %d %g\n", obstacle.type == MAP_GRASS ? "grass" : "rock", obstacle.x, obstacle.y,
+               obstacle.w, obstacle.h, obstacle.rotation);
+    }
+    closeMap(&map);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // Map loading logs asynchronously, which would interleave with dump output
+    setLogLevel(LOG_LEVEL_WARN);
+
+    int status = 1;
+    if (argc == 4 && strcmp(argv[1], "build") == 0) {
+        MapSource source;
+        status = parseMapText(&source, argv[2]) && writeMapFile(source, argv[3]) ? 0 : 1;
+    } else if (argc == 3 && strcmp(argv[1], "dump") == 0) {
+        status = dumpMapFile(argv[2]) ? 0 : 1;
+    } else if ((argc == 6 || argc == 7) && strcmp(argv[1], "generate") == 0) {
+        int width = atoi(argv[3]);
+        int height = atoi(argv[4]);
+        int obstacleCount = atoi(argv[5]);
+        if (width < 400 || height < 300 || obstacleCount < 0) {
+            fprintf(stderr, "Arena must be at least 400x300 with a non-negative obstacle count\n");
+        } else if (width > MAP_MAX_SIZE || height > MAP_MAX_SIZE) {
+            fprintf(stderr, "Map %s is invalid: arena too large (at most %dx%d)\n", argv[2], MAP_MAX_SIZE,
+                    MAP_MAX_SIZE);
+        } else {
+            MapSource source;
+            generateMap(&source, width, height, obstacleCount, argc == 7 ? (unsigned)atoi(argv[6]) : 1u);
+            status = writeMapFile(source, argv[2]) ? 0 : 1;
+        }
+    } else {
+        fprintf(stderr,
+                "Usage: %s build <map.txt> <out.tmap>\n"
+                "       %s dump <map.tmap>\n"
+                "       %s generate <out.tmap> <width> <height> <obstacles> [seed]\n",
+                argv[0], argv[0], argv[0]);
+    }
+
+    // Validation errors are logged, make sure they are out before exiting
+    flushLog();
+    return status;
+}
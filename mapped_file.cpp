@@ -0,0 +1,90 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Function to map a whole file read-only
+bool mapFile(MappedFile* file, const std::string& path) {
+    file->data = nullptr;
+    file->size = 0;
+#ifdef _WIN32
+    file->fileHandle = nullptr;
+    file->mappingHandle = nullptr;
+
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+
+    file->fileHandle = handle;
+    file->mappingHandle = mapping;
+    file->data = (const uint8_t*)view;
+    file->size = (size_t)fileSize.QuadPart;
+#else
+    file->fileDescriptor = -1;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    file->fileDescriptor = fd;
+    file->data = (const uint8_t*)view;
+    file->size = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+// Function to unmap a file
+void unmapFile(MappedFile* file) {
+    if (!file->data) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(file->data);
+    CloseHandle((HANDLE)file->mappingHandle);
+    CloseHandle((HANDLE)file->fileHandle);
+    file->fileHandle = nullptr;
+    file->mappingHandle = nullptr;
+#else
+    munmap((void*)file->data, file->size);
+    close(file->fileDescriptor);
+    file->fileDescriptor = -1;
+#endif
+    file->data = nullptr;
+    file->size = 0;
+}
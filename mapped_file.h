@@ -0,0 +1,27 @@
+#pragma once
+
+// Read-only memory mapping of a whole file (mmap on POSIX,
+// CreateFileMapping on Windows). Used by the asset pack and map loaders
+// so their data is paged in on demand instead of read and copied.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Structure for an open mapping
+struct MappedFile {
+    const uint8_t* data; // Start of the mapping (null if not open)
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+};
+
+// Function to map a whole file read-only (false if it is missing or empty)
+bool mapFile(MappedFile* file, const std::string& path);
+
+// Function to unmap a file (safe to call on a file that was never mapped)
+void unmapFile(MappedFile* file);
@@ -0,0 +1,277 @@
+#include "match_host.h"
+#include "log.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Function to get how many workers to run when none is asked for
+static int getDefaultThreadCount(int threadCount) {
+    if (threadCount > 0) return threadCount;
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+// Function to keep a worker on one core (best effort; elsewhere the OS picks)
+static void pinThreadToCore(std::thread* thread, int core) {
+#if defined(_WIN32)
+    SetThreadAffinityMask((HANDLE)thread->native_handle(), (DWORD_PTR)1 << (core % 64));
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % CPU_SETSIZE, &set);
+    pthread_setaffinity_np(thread->native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+// Function to get the next seed of a match (64-bit LCG step, so every port plays a different series)
+static uint64_t getNextMatchSeed(uint64_t seed) {
+    return seed * 6364136223846793005ull + 1442695040888963407ull;
+}
+
+// Function to run one worker's matches until the host stops
+static void runMatchWorker(MatchHost* host, MatchWorker* worker) {
+    while (!host->stopping.load()) {
+        auto start = std::chrono::steady_clock::now();
+        double idle = SERVER_IDLE_POLL;
+        uint64_t ticks = 0;
+        uint64_t bytesSent = 0;
+        int playing = 0;
+        int players = 0;
+        for (int index : worker->matches) {
+            HostedMatch* match = &host->matches[index];
+            GameServer* server = &match->server;
+            int ticksBefore = server->stats.ticks;
+            updateGameServer(server);
+            ticks += server->stats.ticks - ticksBefore;
+
+            // A match that is over starts again on the same port
+            if (server->finished) {
+                LOG_INFO("[HOST] Match on port %u over after %u ticks (winner %d)", (unsigned)match->port,
+                         server->world.tick, server->world.winner);
+                match->played++;
+                worker->finished++;
+                match->seed = getNextMatchSeed(match->seed);
+                restartGameServer(server, match->seed);
+            }
+
+            playing += server->started && !server->ended ? 1 : 0;
+            for (const ServerClient& client : server->clients) {
+                players += client.connected ? 1 : 0;
+            }
+            bytesSent += server->socket.bytesSent;
+            idle = std::min(idle, getGameServerIdleTime(server));
+        }
+
+        worker->ticks += ticks;
+        worker->bytesSent = bytesSent;
+        worker->playing = playing;
+        worker->players = players;
+        worker->busyMicroseconds += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now() - start).count();
+        if (idle > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(idle));
+        }
+    }
+}
+
+// Function to open every match's port and start the workers
+bool startMatchHost(MatchHost* host, const GameMap* map, const MatchHostConfig* config) {
+    host->config = *config;
+    host->config.threadCount = std::min(getDefaultThreadCount(config->threadCount), std::max(1, config->matchCount));
+    host->stopping = false;
+    host->matches.clear();
+    host->workers.clear();
+
+    for (int i = 0; i < config->matchCount; i++) {
+        host->matches.emplace_back();
+        HostedMatch* match = &host->matches.back();
+        match->port = (uint16_t)(config->firstPort + i);
+        match->seed = getNextMatchSeed(config->seed + (uint64_t)i);
+        match->played = 0;
+        if (!openGameServer(&match->server, map, match->port, config->seatsPerMatch, config->tankWidth,
+                            config->tankHeight, match->seed)) {
+            LOG_ERROR("[HOST] Could not open match %d on port %u", i, (unsigned)match->port);
+            host->matches.pop_back();
+            for (HostedMatch& opened : host->matches) {
+                closeGameServer(&opened.server);
+            }
+            host->matches.clear();
+            return false;
+        }
+    }
+
+    // Match i belongs to worker i % threadCount for good
+    for (int i = 0; i < host->config.threadCount; i++) {
+        host->workers.emplace_back();
+        MatchWorker* worker = &host->workers.back();
+        worker->ticks = 0;
+        worker->busyMicroseconds = 0;
+        worker->bytesSent = 0;
+        worker->playing = 0;
+        worker->players = 0;
+        worker->finished = 0;
+    }
+    for (int i = 0; i < config->matchCount; i++) {
+        host->workers[i % host->config.threadCount].matches.push_back(i);
+    }
+    int cores = getDefaultThreadCount(0);
+    for (int i = 0; i < host->config.threadCount; i++) {
+        MatchWorker* worker = &host->workers[i];
+        worker->thread = std::thread(runMatchWorker, host, worker);
+        pinThreadToCore(&worker->thread, i % cores);
+    }
+    LOG_INFO("[HOST] %d matches of %d seats on UDP ports %u-%u, %d worker threads", config->matchCount,
+             config->seatsPerMatch, (unsigned)config->firstPort, (unsigned)(config->firstPort + config->matchCount - 1),
+             host->config.threadCount);
+    return true;
+}
+
+// Function to sum the workers' figures
+MatchHostStats getMatchHostStats(MatchHost* host) {
+    MatchHostStats stats = {};
+    for (MatchWorker& worker : host->workers) {
+        stats.ticks += worker.ticks.load();
+        stats.busyMicroseconds += worker.busyMicroseconds.load();
+        stats.bytesSent += worker.bytesSent.load();
+        stats.playing += worker.playing.load();
+        stats.players += worker.players.load();
+        stats.finished += worker.finished.load();
+    }
+    return stats;
+}
+
+// Function to stop the workers and close every match
+void stopMatchHost(MatchHost* host) {
+    host->stopping = true;
+    for (MatchWorker& worker : host->workers) {
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+    }
+    for (HostedMatch& match : host->matches) {
+        closeGameServer(&match.server);
+    }
+    host->workers.clear();
+    host->matches.clear();
+}
+
+// Structure for one match of the capacity test
+struct CapacityMatch {
+    World world;
+    std::vector<TankInput> inputs;
+    std::vector<int> holdTicks;
+    GameRng script;
+    ReplicatedState acked; // What every seat is assumed to have acknowledged
+    ReplicatedState current;
+};
+
+// Structure for one worker's share of the capacity test
+struct CapacityWorker {
+    std::thread thread;
+    std::vector<int> matches;
+    double simulateSeconds;
+    double snapshotSeconds;
+    uint64_t snapshotBytes;
+    uint64_t snapshots;
+};
+
+// Function to play a worker's matches of the capacity test, one tick of each in turn
+static void runCapacityWorker(std::vector<CapacityMatch>* matches, CapacityWorker* worker, int ticks, int seats) {
+    uint8_t buffer[NET_MAX_PACKET];
+    for (int tick = 0; tick < ticks; tick++) {
+        for (int index : worker->matches) {
+            CapacityMatch* match = &(*matches)[index];
+
+            // Scripted players, as in the loopback tests
+            for (int i = 0; i < seats; i++) {
+                TankInput& input = match->inputs[i];
+                if (--match->holdTicks[i] <= 0) {
+                    input = unpackTankInput((uint8_t)random(&match->script, 0, 15));
+                    match->holdTicks[i] = random(&match->script, 10, 90);
+                }
+                input.fire = random(&match->script, 0, 29) == 0;
+                input.fireExplosion = random(&match->script, 0, 299) == 0;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            stepWorld(&match->world, match->inputs.data());
+            auto simulated = std::chrono::steady_clock::now();
+            worker->simulateSeconds += std::chrono::duration<double>(simulated - start).count();
+            if (match->world.tick % SERVER_SNAPSHOT_INTERVAL != 0) continue;
+
+            // Every seat gets its own delta, as from the server
+            captureReplicatedState(&match->current, &match->world);
+            for (int i = 0; i < seats; i++) {
+                BitWriter writer;
+                beginBitWriter(&writer, buffer, sizeof(buffer));
+                writeVarUint(&writer, 1);
+                encodeReplicatedState(&writer, &match->acked, &match->current);
+                worker->snapshotBytes += sizeof(ServerPacketHeader) + finishBitWriter(&writer);
+                worker->snapshots++;
+            }
+            std::swap(match->acked, match->current);
+            worker->snapshotSeconds +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - simulated).count();
+        }
+    }
+}
+
+// Function to measure what hosting costs without the network
+MatchCapacityResult runMatchCapacityTest(const GameMap* map, int matchCount, int ticks, int seatsPerMatch,
+                                         int threadCount, int tankWidth, int tankHeight) {
+    MatchCapacityResult result = {};
+    result.matches = matchCount;
+    result.ticks = ticks;
+    threadCount = std::min(getDefaultThreadCount(threadCount), std::max(1, matchCount));
+
+    std::vector<CapacityMatch> matches(matchCount);
+    for (int i = 0; i < matchCount; i++) {
+        CapacityMatch* match = &matches[i];
+        initializeWorld(&match->world, map, tankWidth, tankHeight, getNextMatchSeed(i), seatsPerMatch);
+        match->inputs.assign(seatsPerMatch, TankInput());
+        match->holdTicks.assign(seatsPerMatch, 0);
+        seedRng(&match->script, 100 + i);
+        captureReplicatedState(&match->acked, &match->world);
+    }
+
+    std::vector<CapacityWorker> workers(threadCount);
+    for (int i = 0; i < matchCount; i++) {
+        workers[i % threadCount].matches.push_back(i);
+    }
+    auto start = std::chrono::steady_clock::now();
+    int cores = getDefaultThreadCount(0);
+    for (int i = 0; i < threadCount; i++) {
+        workers[i].thread = std::thread(runCapacityWorker, &matches, &workers[i], ticks, seatsPerMatch);
+        pinThreadToCore(&workers[i].thread, i % cores);
+    }
+    double simulateSeconds = 0.0;
+    double snapshotSeconds = 0.0;
+    uint64_t snapshotBytes = 0;
+    uint64_t snapshots = 0;
+    for (CapacityWorker& worker : workers) {
+        worker.thread.join();
+        simulateSeconds += worker.simulateSeconds;
+        snapshotSeconds += worker.snapshotSeconds;
+        snapshotBytes += worker.snapshotBytes;
+        snapshots += worker.snapshots;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double matchTicks = std::max(1.0, (double)matchCount * ticks);
+    result.simulateMicroseconds = simulateSeconds * 1e6 / matchTicks;
+    result.snapshotMicroseconds = snapshotSeconds * 1e6 / matchTicks;
+    result.snapshotBytes = snapshots > 0 ? (int)(snapshotBytes / snapshots) : 0;
+    double tickMicroseconds = result.simulateMicroseconds + result.snapshotMicroseconds;
+    result.matchesPerThread = tickMicroseconds > 0.0 ? 1e6 / SIMULATION_TICK_RATE / tickMicroseconds : 0.0;
+    return result;
+}
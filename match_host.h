@@ -0,0 +1,95 @@
+#pragma once
+
+// Many server matches in one process, for the dedicated server. Match i
+// listens on UDP port firstPort + i and belongs to worker thread
+// i % threadCount for its whole life, so a match's world is only ever
+// touched by one thread (no locks, its data stays in that core's cache)
+// and workers never wait for each other. A worker updates its matches
+// and then sleeps until the earliest of them has a tick due.
+//
+// When a match is over it starts again on the same port with a new seed,
+// and the seats are open to whoever joins next.
+
+#include "map.h"
+#include "net_server.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <vector>
+
+// Structure for how to run the matches
+struct MatchHostConfig {
+    uint16_t firstPort; // Match i listens on firstPort + i
+    int matchCount;
+    int seatsPerMatch; // 1 to SERVER_MAX_TANKS
+    int threadCount; // Worker threads (0 = one per hardware thread)
+    int tankWidth;
+    int tankHeight;
+    uint64_t seed; // Seeds of the matches derive from it
+};
+
+// Structure for one hosted match
+struct HostedMatch {
+    GameServer server;
+    uint16_t port;
+    uint64_t seed; // Seed of the match being played
+    int played; // Matches finished on this port
+};
+
+// Structure for one worker thread and its figures (written by the worker, read by anyone)
+struct MatchWorker {
+    std::thread thread;
+    std::vector<int> matches; // Indexes into MatchHost::matches
+    std::atomic<uint64_t> ticks; // Simulated, all its matches
+    std::atomic<uint64_t> busyMicroseconds; // Time spent updating rather than sleeping
+    std::atomic<uint64_t> bytesSent;
+    std::atomic<int> playing; // Matches started and not over
+    std::atomic<int> players; // Connected clients
+    std::atomic<int> finished; // Matches played to the end
+};
+
+// Structure for the dedicated server's matches and workers
+struct MatchHost {
+    MatchHostConfig config;
+    std::deque<HostedMatch> matches; // Stable addresses (workers hold them)
+    std::deque<MatchWorker> workers;
+    std::atomic<bool> stopping;
+};
+
+// Structure for the host's figures summed over its workers
+struct MatchHostStats {
+    uint64_t ticks;
+    uint64_t busyMicroseconds;
+    uint64_t bytesSent;
+    int playing;
+    int players;
+    int finished;
+};
+
+// Function to open every match's port and start the workers (false if a port could not be opened)
+bool startMatchHost(MatchHost* host, const GameMap* map, const MatchHostConfig* config);
+
+// Function to sum the workers' figures
+MatchHostStats getMatchHostStats(MatchHost* host);
+
+// Function to stop the workers and close every match
+void stopMatchHost(MatchHost* host);
+
+// Structure for the outcome of runMatchCapacityTest
+struct MatchCapacityResult {
+    int matches;
+    int ticks; // Per match
+    double seconds; // Wall time
+    double simulateMicroseconds; // Per match tick, summed over threads
+    double snapshotMicroseconds; // Per match tick: capturing and coding every seat's snapshots
+    int snapshotBytes; // Average snapshot
+    double matchesPerThread; // Matches one thread could keep at SIMULATION_TICK_RATE
+};
+
+// Function to measure what hosting costs without the network: matchCount
+// matches of scripted players, each pinned to a worker like the real
+// host, simulated for ticks ticks as fast as the workers go, with every
+// seat's snapshot captured and coded as the server would
+MatchCapacityResult runMatchCapacityTest(const GameMap* map, int matchCount, int ticks, int seatsPerMatch,
+                                         int threadCount, int tankWidth, int tankHeight);
@@ -0,0 +1,302 @@
+#include "net_client.h"
+#include "log.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+// Input bits that fire once rather than being held
+const uint8_t INPUT_SHOTS = INPUT_FIRE | INPUT_FIRE_EXPLOSION;
+
+// Seconds between SERVER_CONNECT messages while joining
+const double CLIENT_CONNECT_INTERVAL = 0.25;
+
+// Function to get the client clock in seconds
+static double getClientTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Function to open the client's socket
+bool openGameClient(GameClient* client, uint16_t port) {
+    client->active = false;
+    client->stats = ClientStats();
+    if (!openNetSocket(&client->socket, port)) {
+        return false;
+    }
+    LOG_INFO("[CLIENT] Using UDP port %u", (unsigned)getNetSocketPort(&client->socket));
+    return true;
+}
+
+// Function to join a server
+bool connectGameServer(GameClient* client, const NetAddress* server, ServerMatchInfo* match, double timeout) {
+    LOG_INFO("[CLIENT] Joining %s", formatNetAddress(server).c_str());
+    double start = getClientTime();
+    double lastConnect = -CLIENT_CONNECT_INTERVAL;
+    while (getClientTime() - start < timeout) {
+        // The request or the answer may be lost, so keep asking
+        double now = getClientTime() - start;
+        if (now - lastConnect >= CLIENT_CONNECT_INTERVAL) {
+            sendServerMatchInfo(&client->socket, server, SERVER_CONNECT, match);
+            lastConnect = now;
+        }
+        flushNetShim(&client->socket);
+
+        uint8_t buffer[NET_MAX_PACKET];
+        NetAddress from;
+        int size = receiveNetPacket(&client->socket, &from, buffer, sizeof(buffer));
+        if (size == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        ServerPacketHeader header;
+        ServerMatchInfo theirs;
+        if (from.host != server->host || from.port != server->port || !readServerPacketHeader(buffer, size, &header) ||
+            header.type != SERVER_ACCEPT || !readServerMatchInfo(buffer, size, &theirs)) {
+            continue;
+        }
+        if (theirs.tankCount < 1 || theirs.tankCount > SERVER_MAX_TANKS || theirs.tank >= theirs.tankCount) {
+            LOG_ERROR("[CLIENT] The server offered seat %d of %d", theirs.tank, theirs.tankCount);
+            return false;
+        }
+
+        *match = theirs;
+        client->server = *server;
+        client->match = theirs;
+        client->active = true;
+        client->lastReceiveTime = getClientTime();
+        LOG_INFO("[CLIENT] Joined as seat %d of %d (seed %llu)", theirs.tank, theirs.tankCount,
+                 (unsigned long long)theirs.seed);
+        return true;
+    }
+    LOG_ERROR("[CLIENT] No answer from %s within %.0f s", formatNetAddress(server).c_str(), timeout);
+    return false;
+}
+
+// Function to start drawing a match
+void beginGameClientMatch(GameClient* client, const World* world) {
+    captureReplicatedState(&client->initial, world);
+    std::fill(client->receivedSequences, client->receivedSequences + SERVER_HISTORY, 0u);
+    client->latestSequence = 0;
+    memset(client->inputs, 0, sizeof(client->inputs));
+    client->inputSequence = 0;
+    client->pendingShots = 0;
+    client->lastSendTime = 0.0;
+}
+
+// Function to decode a snapshot and show it if it is the newest
+static void receiveClientSnapshot(GameClient* client, World* world, const ServerPacketHeader* header,
+                                  const uint8_t* data, int size) {
+    uint32_t sequence = header->sequence;
+    if (sequence <= client->latestSequence) {
+        client->stats.staleSnapshots++;
+        return;
+    }
+
+    BitReader reader;
+    beginBitReader(&reader, data + sizeof(ServerPacketHeader), size - (int)sizeof(ServerPacketHeader));
+    uint32_t distance = readVarUint(&reader);
+    if (reader.overflow || distance == 0 || distance > sequence) {
+        client->stats.badSnapshots++;
+        return;
+    }
+
+    // The base is the match start or a snapshot we kept
+    uint32_t baseSequence = sequence - distance;
+    const ReplicatedState* base = &client->initial;
+    if (baseSequence != 0) {
+        if (distance >= SERVER_HISTORY || client->receivedSequences[baseSequence % SERVER_HISTORY] != baseSequence) {
+            client->stats.missingBase++;
+            return;
+        }
+        base = &client->received[baseSequence % SERVER_HISTORY];
+    }
+
+    int slot = sequence % SERVER_HISTORY;
+    client->receivedSequences[slot] = 0;
+    if (!decodeReplicatedState(&reader, base, &client->received[slot])) {
+        client->stats.badSnapshots++;
+        return;
+    }
+    client->receivedSequences[slot] = sequence;
+    client->latestSequence = sequence;
+    client->stats.snapshots++;
+    client->stats.snapshotBytes += size;
+    applyReplicatedState(world, &client->received[slot]);
+}
+
+// Function to send input and show the newest snapshot (call every frame)
+void updateGameClient(GameClient* client, World* world, const TankInput& input) {
+    world->events.clear();
+    if (!client->active) return;
+    double now = getClientTime();
+    flushNetShim(&client->socket);
+
+    uint8_t buffer[NET_MAX_PACKET];
+    NetAddress from;
+    int size;
+    while ((size = receiveNetPacket(&client->socket, &from, buffer, sizeof(buffer))) > 0) {
+        ServerPacketHeader header;
+        if (from.host != client->server.host || from.port != client->server.port ||
+            !readServerPacketHeader(buffer, size, &header)) {
+            continue;
+        }
+        client->lastReceiveTime = now;
+        if (header.type == SERVER_SNAPSHOT) {
+            receiveClientSnapshot(client, world, &header, buffer, size);
+        }
+    }
+
+    // Shots are kept until the next message, which acknowledges the newest snapshot too
+    uint8_t packed = packTankInput(input);
+    client->pendingShots |= packed & INPUT_SHOTS;
+    double interval = client->match.snapshotInterval * FIXED_TIMESTEP;
+    if (now - client->lastSendTime >= interval) {
+        client->lastSendTime = now - client->lastSendTime < 2.0 * interval ? client->lastSendTime + interval : now;
+        memmove(client->inputs + 1, client->inputs, SERVER_INPUT_REDUNDANCY - 1);
+        client->inputs[0] = (uint8_t)((packed & ~INPUT_SHOTS) | client->pendingShots);
+        client->pendingShots = 0;
+        client->inputSequence++;
+
+        uint8_t packet[sizeof(ServerPacketHeader) + sizeof(ServerInputMessage)];
+        ServerPacketHeader header;
+        fillServerPacketHeader(&header, SERVER_INPUT, client->latestSequence);
+        ServerInputMessage message;
+        message.sequence = client->inputSequence;
+        memcpy(message.inputs, client->inputs, sizeof(message.inputs));
+        memcpy(packet, &header, sizeof(header));
+        memcpy(packet + sizeof(header), &message, sizeof(message));
+        sendNetPacket(&client->socket, &client->server, packet, sizeof(packet));
+    }
+
+    if (now - client->lastReceiveTime > SERVER_DISCONNECT_TIMEOUT) {
+        LOG_WARN("[CLIENT] Nothing from the server for %.0f s", SERVER_DISCONNECT_TIMEOUT);
+        client->active = false;
+    }
+}
+
+// Function to get the newest state received
+const ReplicatedState* getGameClientState(const GameClient* client) {
+    if (client->latestSequence == 0) return &client->initial;
+    return &client->received[client->latestSequence % SERVER_HISTORY];
+}
+
+// Function to log the client's statistics and close it
+void closeGameClient(GameClient* client) {
+    const ClientStats& stats = client->stats;
+    LOG_INFO("[CLIENT] %d snapshots (%llu bytes), %d stale, %d without their base, %d bad", stats.snapshots,
+             (unsigned long long)stats.snapshotBytes, stats.staleSnapshots, stats.missingBase, stats.badSnapshots);
+    LOG_INFO("[CLIENT] %llu datagrams sent (%llu dropped by the shim, %llu bytes), %llu received",
+             (unsigned long long)client->socket.packetsSent, (unsigned long long)client->socket.packetsDropped,
+             (unsigned long long)client->socket.bytesSent, (unsigned long long)client->socket.packetsReceived);
+    closeNetSocket(&client->socket);
+    client->active = false;
+}
+
+// Structure for one scripted player of the loopback test
+struct LoopbackClient {
+    GameClient client;
+    World world;
+    GameRng script;
+    TankInput input;
+    int holdTicks;
+};
+
+// Function to serve a match on loopback to scripted clients and check they all ended on the server's state
+ServerTestResult runServerLoopback(const GameMap* map, int ticks, int clientCount, int tankWidth, int tankHeight,
+                                   int latencyMs, int jitterMs, float lossRate) {
+    ServerTestResult result = {};
+    result.clients = clientCount;
+
+    GameServer server;
+    if (!openGameServer(&server, map, 0, clientCount, tankWidth, tankHeight, 12345)) {
+        return result;
+    }
+    server.tickLimit = (uint32_t)ticks;
+    server.measureFullSnapshots = true;
+    setNetShim(&server.socket, latencyMs, jitterMs, lossRate, 1);
+    NetAddress serverAddress;
+    serverAddress.host = 0x7F000001; // 127.0.0.1
+    serverAddress.port = getNetSocketPort(&server.socket);
+
+    // The server runs on its own thread, as it would in its own process
+    std::atomic<bool> serverDone(false);
+    std::thread serverThread([&] {
+        double start = getClientTime();
+        while (!server.finished && (server.started || getClientTime() - start < 10.0)) {
+            updateGameServer(&server);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        serverDone = true;
+    });
+
+    // Clients hold a snapshot history each, so keep them off the stack
+    std::vector<LoopbackClient> players(clientCount);
+    int opened = 0;
+    bool connected = true;
+    for (int i = 0; i < clientCount && connected; i++) {
+        LoopbackClient* player = &players[i];
+        if (!openGameClient(&player->client)) {
+            connected = false;
+            break;
+        }
+        opened++;
+        setNetShim(&player->client.socket, latencyMs, jitterMs, lossRate, 2 + i);
+
+        ServerMatchInfo match = {};
+        match.mapHash = map->hash;
+        match.tankWidth = tankWidth;
+        match.tankHeight = tankHeight;
+        connected = connectGameServer(&player->client, &serverAddress, &match, 10.0);
+        if (connected) {
+            initializeWorld(&player->world, map, tankWidth, tankHeight, match.seed, match.tankCount);
+            beginGameClientMatch(&player->client, &player->world);
+            seedRng(&player->script, 100 + i);
+            player->input = TankInput();
+            player->holdTicks = 0;
+        }
+    }
+
+    // Scripted players: each holds a direction for a while and fires now and then
+    double nextTickTime = getClientTime();
+    while (connected && !serverDone.load()) {
+        bool tick = getClientTime() >= nextTickTime;
+        if (tick) nextTickTime += FIXED_TIMESTEP;
+        for (LoopbackClient& player : players) {
+            if (tick) {
+                if (--player.holdTicks <= 0) {
+                    player.input = unpackTankInput((uint8_t)random(&player.script, 0, 15));
+                    player.holdTicks = random(&player.script, 10, 90);
+                }
+                player.input.fire = random(&player.script, 0, 29) == 0;
+                player.input.fireExplosion = random(&player.script, 0, 299) == 0;
+            }
+            updateGameClient(&player.client, &player.world, player.input);
+            player.input.fire = false;
+            player.input.fireExplosion = false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    serverThread.join();
+
+    result.connected = connected && server.started;
+    result.ticks = server.stats.ticks;
+    result.server = server.stats;
+    result.matched = result.connected;
+    for (int i = 0; i < opened; i++) {
+        GameClient* client = &players[i].client;
+        if (result.connected) {
+            result.matched = result.matched && isSameReplicatedState(getGameClientState(client), &server.current);
+        }
+        result.client.snapshots += client->stats.snapshots;
+        result.client.staleSnapshots += client->stats.staleSnapshots;
+        result.client.missingBase += client->stats.missingBase;
+        result.client.badSnapshots += client->stats.badSnapshots;
+        result.client.snapshotBytes += client->stats.snapshotBytes;
+        result.inputBytesSent += client->socket.bytesSent;
+        closeGameClient(client);
+    }
+    closeGameServer(&server);
+    return result;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+// Client of a server match (see net_server.h for the protocol). The
+// client draws the newest snapshot it has and never simulates: what the
+// player sees is the server's match, one snapshot interval plus the trip
+// from the server late. Inputs go out at the snapshot rate, with shots
+// collected in between so none is lost between two messages.
+
+#include "net_server.h"
+
+// Structure for one client's side of a match
+struct ClientStats {
+    int snapshots; // Received and applied
+    int staleSnapshots; // Arrived after a newer one
+    int missingBase; // Coded against a snapshot we no longer have
+    int badSnapshots; // Did not decode
+    uint64_t snapshotBytes; // Payload received
+};
+
+// Structure for a client of a server match
+struct GameClient {
+    NetSocket socket;
+    NetAddress server;
+    bool active; // Connected and the server is still talking
+    ServerMatchInfo match;
+    ReplicatedState initial; // Match start, built locally
+    ReplicatedState received[SERVER_HISTORY]; // By snapshot number % SERVER_HISTORY
+    uint32_t receivedSequences[SERVER_HISTORY]; // Number of each state in received (0 = unusable)
+    uint32_t latestSequence; // Newest snapshot applied (0 = none)
+    uint8_t inputs[SERVER_INPUT_REDUNDANCY]; // Sent inputs, newest first
+    uint32_t inputSequence; // Number of inputs[0]
+    uint8_t pendingShots; // Shots since the last input message
+    double lastSendTime;
+    double lastReceiveTime;
+    ClientStats stats;
+};
+
+// Function to open the client's socket (port 0 = any free port)
+bool openGameClient(GameClient* client, uint16_t port = 0);
+
+// Function to join a server. match gives the map hash and tank size and
+// gets the seed, the seat and the tank count.
+bool connectGameServer(GameClient* client, const NetAddress* server, ServerMatchInfo* match,
+                       double timeout = SERVER_CONNECT_TIMEOUT);
+
+// Function to start drawing a match just initialized with the match info's seed and tank count
+void beginGameClientMatch(GameClient* client, const World* world);
+
+// Function to send input and show the newest snapshot in world (call
+// every frame). world->events gets the events of the snapshots applied.
+void updateGameClient(GameClient* client, World* world, const TankInput& input);
+
+// Function to get the newest state received (the match start if none yet)
+const ReplicatedState* getGameClientState(const GameClient* client);
+
+// Function to log the client's statistics and close it
+void closeGameClient(GameClient* client);
+
+// Structure for the outcome of runServerLoopback
+struct ServerTestResult {
+    bool connected;
+    int ticks; // Simulated by the server
+    int clients;
+    bool matched; // Every client ended on the server's final state
+    ServerStats server;
+    ClientStats client; // Summed over the clients
+    uint64_t inputBytesSent; // By every client
+};
+
+// Function to serve a match on loopback to clientCount scripted clients,
+// in real time through the shim, and check every client ended on the
+// server's final state
+ServerTestResult runServerLoopback(const GameMap* map, int ticks, int clientCount, int tankWidth, int tankHeight,
+                                   int latencyMs, int jitterMs, float lossRate);
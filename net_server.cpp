@@ -0,0 +1,399 @@
+#include "net_server.h"
+#include "log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// Input bits that fire once rather than being held
+const uint8_t INPUT_SHOTS = INPUT_FIRE | INPUT_FIRE_EXPLOSION;
+
+// Seconds the server may fall behind before it skips ahead instead of catching up
+const double SERVER_MAX_CATCH_UP = 0.25;
+
+// Function to get the server clock in seconds
+static double getServerTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Function to fill in the fields every message starts with
+void fillServerPacketHeader(ServerPacketHeader* header, uint8_t type, uint32_t sequence) {
+    memcpy(header->magic, SERVER_MAGIC, sizeof(header->magic));
+    header->type = type;
+    header->version = SERVER_PROTOCOL_VERSION;
+    header->sequence = sequence;
+}
+
+// Function to read and check the header of a received message
+bool readServerPacketHeader(const uint8_t* data, int size, ServerPacketHeader* header) {
+    if (size < (int)sizeof(ServerPacketHeader)) return false;
+    memcpy(header, data, sizeof(*header));
+    return memcmp(header->magic, SERVER_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == SERVER_PROTOCOL_VERSION;
+}
+
+// Function to send a SERVER_CONNECT or SERVER_ACCEPT with the match info
+void sendServerMatchInfo(NetSocket* socket, const NetAddress* to, uint8_t type, const ServerMatchInfo* match) {
+    uint8_t packet[sizeof(ServerPacketHeader) + sizeof(ServerMatchInfo)];
+    ServerPacketHeader header;
+    fillServerPacketHeader(&header, type, 0);
+    memcpy(packet, &header, sizeof(header));
+    memcpy(packet + sizeof(header), match, sizeof(*match));
+    sendNetPacket(socket, to, packet, sizeof(packet));
+}
+
+// Function to read the match info after a header (false if the message is too short)
+bool readServerMatchInfo(const uint8_t* data, int size, ServerMatchInfo* match) {
+    if (size < (int)(sizeof(ServerPacketHeader) + sizeof(ServerMatchInfo))) return false;
+    memcpy(match, data + sizeof(ServerPacketHeader), sizeof(*match));
+    return true;
+}
+
+// Function to open the server for a match
+bool openGameServer(GameServer* server, const GameMap* map, uint16_t port, int tankCount, int tankWidth, int tankHeight,
+                    uint64_t seed) {
+    if (tankCount < 1 || tankCount > SERVER_MAX_TANKS) {
+        LOG_ERROR("[SERVER] A match has 1 to %d seats, not %d", SERVER_MAX_TANKS, tankCount);
+        return false;
+    }
+
+    server->match = ServerMatchInfo();
+    server->match.mapHash = map->hash;
+    server->match.tankWidth = tankWidth;
+    server->match.tankHeight = tankHeight;
+    server->match.tankCount = (uint8_t)tankCount;
+    server->match.snapshotInterval = SERVER_SNAPSHOT_INTERVAL;
+    server->tickLimit = 0;
+    server->measureFullSnapshots = false;
+    server->stats = ServerStats();
+    server->world.map = map;
+    restartGameServer(server, seed);
+
+    if (!openNetSocket(&server->socket, port)) {
+        return false;
+    }
+    LOG_INFO("[SERVER] Serving a %d-player match on UDP port %u (seed %llu)", tankCount,
+             (unsigned)getNetSocketPort(&server->socket), (unsigned long long)seed);
+    return true;
+}
+
+// Function to start a new match on an open server
+void restartGameServer(GameServer* server, uint64_t seed) {
+    const GameMap* map = server->world.map;
+    int tankCount = server->match.tankCount;
+    server->match.seed = seed;
+    server->started = false;
+    server->ended = false;
+    server->finished = false;
+    server->nextTickTime = 0.0;
+    server->nextSnapshotTime = 0.0;
+    server->endTime = 0.0;
+
+    server->clients.assign(tankCount, ServerClient());
+    for (int i = 0; i < tankCount; i++) {
+        server->clients[i].tank = i;
+    }
+    server->inputs.assign(tankCount, TankInput());
+    initializeWorld(&server->world, map, server->match.tankWidth, server->match.tankHeight, seed, tankCount);
+    captureReplicatedState(&server->initial, &server->world);
+    server->current = server->initial;
+}
+
+// Function to find the seat of a connected address (NULL if none)
+static ServerClient* findServerClient(GameServer* server, const NetAddress* address) {
+    for (ServerClient& client : server->clients) {
+        if (client.connected && client.address.host == address->host && client.address.port == address->port) {
+            return &client;
+        }
+    }
+    return NULL;
+}
+
+// Function to give a joining client a free seat (or answer again if its accept was lost)
+static void acceptServerClient(GameServer* server, const NetAddress* from, const ServerMatchInfo* theirs,
+                               double now) {
+    ServerClient* client = findServerClient(server, from);
+    if (client == NULL) {
+        if (theirs->mapHash != server->match.mapHash || theirs->tankWidth != server->match.tankWidth ||
+            theirs->tankHeight != server->match.tankHeight) {
+            LOG_WARN("[SERVER] %s plays a different map or tank size, ignored", formatNetAddress(from).c_str());
+            return;
+        }
+
+        // A seat whose client left can be taken again; its tank stood still meanwhile
+        for (ServerClient& seat : server->clients) {
+            if (!seat.connected) {
+                client = &seat;
+                break;
+            }
+        }
+        if (client == NULL) return; // Full
+
+        client->connected = true;
+        client->address = *from;
+        client->input = 0;
+        client->inputSequence = 0;
+        client->snapshotSequence = 0;
+        client->ackSequence = 0;
+        std::fill(client->sentSequences, client->sentSequences + SERVER_HISTORY, 0u);
+        LOG_INFO("[SERVER] %s takes seat %d", formatNetAddress(from).c_str(), client->tank);
+    }
+    client->lastReceiveTime = now;
+
+    ServerMatchInfo match = server->match;
+    match.tank = (uint8_t)client->tank;
+    sendServerMatchInfo(&server->socket, from, SERVER_ACCEPT, &match);
+
+    // The match starts once every seat has been taken
+    if (!server->started) {
+        bool full = true;
+        for (const ServerClient& seat : server->clients) {
+            full = full && seat.connected;
+        }
+        if (full) {
+            server->started = true;
+            server->nextTickTime = now;
+            LOG_INFO("[SERVER] Every seat taken, match started");
+        }
+    }
+}
+
+// Function to take in a client's inputs and acknowledgement
+static void receiveServerInput(GameServer* server, ServerClient* client, const ServerPacketHeader* header,
+                               const uint8_t* data, int size) {
+    if (size < (int)(sizeof(ServerPacketHeader) + sizeof(ServerInputMessage))) return;
+    ServerInputMessage message;
+    memcpy(&message, data + sizeof(ServerPacketHeader), sizeof(message));
+    server->stats.inputBytes += size;
+    server->stats.inputMessages++;
+
+    if (header->sequence > client->ackSequence && header->sequence <= client->snapshotSequence) {
+        client->ackSequence = header->sequence;
+    }
+
+    // Movement comes from the newest input; shots from every input not seen yet
+    if (message.sequence > client->inputSequence) {
+        uint32_t fresh = std::min(message.sequence - client->inputSequence, (uint32_t)SERVER_INPUT_REDUNDANCY);
+        uint8_t shots = client->input & INPUT_SHOTS;
+        for (uint32_t i = 0; i < fresh; i++) {
+            shots |= message.inputs[i] & INPUT_SHOTS;
+        }
+        client->input = (uint8_t)((message.inputs[0] & ~INPUT_SHOTS) | (server->started ? shots : 0));
+        client->inputSequence = message.sequence;
+    }
+}
+
+// Function to take in every waiting message
+static void receiveServerMessages(GameServer* server, double now) {
+    uint8_t buffer[NET_MAX_PACKET];
+    NetAddress from;
+    int size;
+    while ((size = receiveNetPacket(&server->socket, &from, buffer, sizeof(buffer))) > 0) {
+        ServerPacketHeader header;
+        if (!readServerPacketHeader(buffer, size, &header)) continue;
+
+        if (header.type == SERVER_CONNECT) {
+            ServerMatchInfo theirs;
+            if (readServerMatchInfo(buffer, size, &theirs)) {
+                acceptServerClient(server, &from, &theirs, now);
+            }
+            continue;
+        }
+
+        ServerClient* client = findServerClient(server, &from);
+        if (client == NULL) continue;
+        client->lastReceiveTime = now;
+        if (header.type == SERVER_INPUT) {
+            receiveServerInput(server, client, &header, buffer, size);
+        }
+    }
+}
+
+// Function to simulate one tick with every client's input
+static void simulateServerTick(GameServer* server, JobSystem* jobs, double now) {
+    for (ServerClient& client : server->clients) {
+        server->inputs[client.tank] = client.connected ? unpackTankInput(client.input) : TankInput();
+        client.input &= ~INPUT_SHOTS; // Shots are used up
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    stepWorld(&server->world, server->inputs.data(), jobs);
+    server->stats.simulateMs +=
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    server->stats.ticks++;
+
+    // The tick's events go to the telemetry and the log
+    const World* world = &server->world;
+    countGameEvents(world->events.data(), (int)world->events.size(), &server->stats.events);
+    logGameEvents(world->events.data(), (int)world->events.size(), &world->tanks);
+
+    if (server->world.winner != -1 || (server->tickLimit > 0 && server->world.tick >= server->tickLimit)) {
+        server->ended = true;
+        server->endTime = now;
+        captureReplicatedState(&server->current, &server->world);
+        LOG_INFO("[SERVER] Match over after %u ticks (winner %d)", server->world.tick, server->world.winner);
+    }
+}
+
+// Function to send a client the current state, coded against the newest snapshot it has
+static void sendServerSnapshot(GameServer* server, ServerClient* client) {
+    uint32_t sequence = client->snapshotSequence + 1;
+    uint32_t ack = client->ackSequence;
+    const ReplicatedState* base = &server->initial;
+    uint32_t baseSequence = 0;
+    if (ack != 0 && sequence - ack < SERVER_HISTORY && client->sentSequences[ack % SERVER_HISTORY] == ack) {
+        base = &client->sent[ack % SERVER_HISTORY];
+        baseSequence = ack;
+    }
+
+    // Obstacles beyond what one delta may add follow in the next snapshots
+    int slot = sequence % SERVER_HISTORY;
+    ReplicatedState* state = &client->sent[slot];
+    *state = server->current;
+    size_t obstacleLimit = base->destroyedObstacles.size() + NET_MAX_NEW_OBSTACLES;
+    if (state->destroyedObstacles.size() > obstacleLimit) {
+        state->destroyedObstacles.resize(obstacleLimit);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint8_t packet[NET_MAX_PACKET];
+    ServerPacketHeader header;
+    fillServerPacketHeader(&header, SERVER_SNAPSHOT, sequence);
+    memcpy(packet, &header, sizeof(header));
+    BitWriter writer;
+    beginBitWriter(&writer, packet + sizeof(header), sizeof(packet) - (int)sizeof(header));
+    writeVarUint(&writer, sequence - baseSequence);
+    encodeReplicatedState(&writer, base, state);
+    int size = (int)sizeof(header) + finishBitWriter(&writer);
+    server->stats.encodeMs +=
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (writer.overflow) {
+        if (server->stats.overflows++ == 0) {
+            LOG_WARN("[SERVER] Snapshot for seat %d does not fit in %d bytes, not sent", client->tank, NET_MAX_PACKET);
+        }
+        client->sentSequences[slot] = 0;
+        return;
+    }
+    client->sentSequences[slot] = sequence;
+    client->snapshotSequence = sequence;
+    sendNetPacket(&server->socket, &client->address, packet, size);
+
+    ServerStats* stats = &server->stats;
+    stats->snapshots++;
+    stats->deltaSnapshots += baseSequence != 0 ? 1 : 0;
+    stats->snapshotBytes += size;
+    stats->maxSnapshotBytes = std::max(stats->maxSnapshotBytes, size);
+
+    // What the snapshot would have cost without an acknowledged base
+    if (server->measureFullSnapshots) {
+        server->scratch.resize(64 * 1024);
+        beginBitWriter(&writer, server->scratch.data(), (int)server->scratch.size());
+        writeVarUint(&writer, sequence);
+        encodeReplicatedState(&writer, &server->initial, &server->current);
+        stats->fullBytes += sizeof(header) + finishBitWriter(&writer);
+    }
+}
+
+// Function to serve the match (call often)
+void updateGameServer(GameServer* server, JobSystem* jobs) {
+    double now = getServerTime();
+    flushNetShim(&server->socket);
+    receiveServerMessages(server, now);
+
+    // A client that went quiet frees its seat
+    bool anyConnected = false;
+    for (ServerClient& client : server->clients) {
+        if (client.connected && now - client.lastReceiveTime > SERVER_DISCONNECT_TIMEOUT) {
+            LOG_WARN("[SERVER] Seat %d (%s) timed out", client.tank, formatNetAddress(&client.address).c_str());
+            client.connected = false;
+        }
+        anyConnected = anyConnected || client.connected;
+    }
+    if (server->started && !anyConnected) {
+        LOG_WARN("[SERVER] Every client left, closing the match");
+        server->ended = true;
+        server->finished = true;
+        return;
+    }
+
+    // Simulate in real time; after a stall, skip ahead rather than rush
+    if (server->started) {
+        if (now - server->nextTickTime > SERVER_MAX_CATCH_UP) {
+            server->nextTickTime = now;
+        }
+        while (!server->ended && now >= server->nextTickTime) {
+            simulateServerTick(server, jobs, now);
+            server->nextTickTime += FIXED_TIMESTEP;
+        }
+    }
+
+    // Snapshots go out from the first seat taken (so waiting clients know
+    // the server is there) until every client has the final one
+    if (anyConnected && now >= server->nextSnapshotTime) {
+        if (now - server->nextSnapshotTime > SERVER_MAX_CATCH_UP) {
+            server->nextSnapshotTime = now;
+        }
+        server->nextSnapshotTime += SERVER_SNAPSHOT_INTERVAL * FIXED_TIMESTEP;
+        if (!server->ended) {
+            captureReplicatedState(&server->current, &server->world);
+        }
+        for (ServerClient& client : server->clients) {
+            if (client.connected) {
+                sendServerSnapshot(server, &client);
+            }
+        }
+    }
+
+    if (server->ended) {
+        bool delivered = true;
+        for (const ServerClient& client : server->clients) {
+            if (!client.connected) continue;
+            int slot = client.ackSequence % SERVER_HISTORY;
+            delivered = delivered && client.ackSequence != 0 && client.sentSequences[slot] == client.ackSequence &&
+                        isSameReplicatedState(&client.sent[slot], &server->current);
+        }
+        if (delivered || now - server->endTime > SERVER_END_LINGER) {
+            server->finished = true;
+        }
+    }
+}
+
+// Function to get the seconds until the server next has work
+double getGameServerIdleTime(const GameServer* server) {
+    double now = getServerTime();
+    double next = now + SERVER_IDLE_POLL;
+    if (server->started && !server->ended) {
+        next = std::min(next, server->nextTickTime);
+    }
+    for (const ServerClient& client : server->clients) {
+        if (client.connected) {
+            next = std::min(next, server->nextSnapshotTime);
+            break;
+        }
+    }
+    return std::max(0.0, next - now);
+}
+
+// Function to log the server's statistics and close it
+void closeGameServer(GameServer* server) {
+    const ServerStats& stats = server->stats;
+    int seats = std::max(1, (int)server->clients.size());
+    int ticks = std::max(1, stats.ticks);
+    LOG_INFO("[SERVER] %d ticks simulated, %.3f ms per tick", stats.ticks, stats.simulateMs / ticks);
+    LOG_INFO("[SERVER] %d snapshots (%d against an acknowledged one), %.1f bytes on average, %d at most, "
+             "coded in %.2f us",
+             stats.snapshots, stats.deltaSnapshots,
+             stats.snapshots > 0 ? (double)stats.snapshotBytes / stats.snapshots : 0.0, stats.maxSnapshotBytes,
+             stats.snapshots > 0 ? stats.encodeMs * 1000.0 / stats.snapshots : 0.0);
+    LOG_INFO("[SERVER] %.1f snapshot bytes per tick per client (%.1f with UDP/IP headers)",
+             (double)stats.snapshotBytes / ticks / seats,
+             (double)(stats.snapshotBytes + (uint64_t)stats.snapshots * NET_DATAGRAM_OVERHEAD) / ticks / seats);
+    LOG_INFO("[SERVER] %llu datagrams sent (%llu dropped by the shim, %llu bytes), %llu received",
+             (unsigned long long)server->socket.packetsSent, (unsigned long long)server->socket.packetsDropped,
+             (unsigned long long)server->socket.bytesSent, (unsigned long long)server->socket.packetsReceived);
+    const int* events = stats.events.counts;
+    LOG_INFO("[SERVER] %d hits, %d tanks destroyed, %d reflections, %d pickups, %d obstacles destroyed",
+             events[GAME_EVENT_HIT], events[GAME_EVENT_DESTROYED], events[GAME_EVENT_REFLECTED],
+             events[GAME_EVENT_PICKED_UP], events[GAME_EVENT_OBSTACLE_DESTROYED]);
+    closeNetSocket(&server->socket);
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+// Server-authoritative network play. The server alone runs the match;
+// clients send their inputs and draw the states the server sends back,
+// so a client cannot cheat or drift, and players can come and go without
+// the others re-simulating anything.
+//
+// Every SERVER_SNAPSHOT_INTERVAL ticks each client gets a snapshot: the
+// match's ReplicatedState coded as a delta against the newest snapshot the
+// client has acknowledged (or against the match start, which every client
+// builds itself from the seed). Snapshots are numbered per client, and a
+// lost one costs nothing: the next is coded against an older base.
+//
+// Inputs flow the other way at the same rate. Each message repeats the
+// last SERVER_INPUT_REDUNDANCY inputs, so a shot survives lost datagrams
+// and reaches the server exactly once.
+//
+// Packets (little-endian): a ServerPacketHeader, then a ServerMatchInfo for
+// SERVER_CONNECT and SERVER_ACCEPT, a ServerInputMessage for SERVER_INPUT,
+// or for SERVER_SNAPSHOT a bit stream: how many snapshots back its base
+// is (back to number 0 means the match start) and the delta (see
+// net_snapshot.h).
+
+#include "net_snapshot.h"
+#include "net_socket.h"
+#include "world.h"
+#include <cstdint>
+#include <vector>
+
+struct JobSystem;
+
+// Port used when --server or --connect give none
+const uint16_t SERVER_DEFAULT_PORT = 27961;
+
+// Most seats in one match (keeps the largest snapshot inside NET_MAX_PACKET)
+const int SERVER_MAX_TANKS = 8;
+
+// Ticks between snapshots and between input messages (60 per second)
+const int SERVER_SNAPSHOT_INTERVAL = 2;
+
+// Snapshots each side keeps as delta bases (power of two; half a second at 60 per second)
+const int SERVER_HISTORY = 32;
+
+// Inputs repeated in every input message
+const int SERVER_INPUT_REDUNDANCY = 4;
+
+// Seconds of silence before a client counts as gone, and that the server
+// keeps sending the final state for clients that have not acknowledged it
+const double SERVER_DISCONNECT_TIMEOUT = 5.0;
+const double SERVER_END_LINGER = 3.0;
+
+// Seconds an idle server may leave joining clients waiting for an answer
+const double SERVER_IDLE_POLL = 0.01;
+
+// Tank body size headless servers play with (the tank sprite's; clients must match)
+const int SERVER_TANK_WIDTH = 81;
+const int SERVER_TANK_HEIGHT = 73;
+
+// Seconds a client keeps asking to join
+const double SERVER_CONNECT_TIMEOUT = 60.0;
+
+// UDP and IPv4 header bytes per datagram, for the bandwidth report
+const int NET_DATAGRAM_OVERHEAD = 28;
+
+const char SERVER_MAGIC[2] = {'T', 'S'};
+const uint8_t SERVER_PROTOCOL_VERSION = 1;
+
+// Message types
+const uint8_t SERVER_CONNECT = 1; // Client asks for a seat (followed by ServerMatchInfo)
+const uint8_t SERVER_ACCEPT = 2; // Server gives a seat and the seed (followed by ServerMatchInfo)
+const uint8_t SERVER_INPUT = 3; // Client inputs (followed by ServerInputMessage)
+const uint8_t SERVER_SNAPSHOT = 4; // Match state (followed by the bit stream)
+
+// Structure for the start of every message
+struct ServerPacketHeader {
+    char magic[2];
+    uint8_t type;
+    uint8_t version;
+    uint32_t sequence; // SERVER_SNAPSHOT: snapshot number; SERVER_INPUT: newest snapshot the client has (0 = none)
+};
+
+// Structure for what client and server must agree on
+struct ServerMatchInfo {
+    uint64_t seed; // Chosen by the server
+    uint64_t mapHash;
+    int32_t tankWidth;
+    int32_t tankHeight;
+    uint8_t tank; // Seat given to the client
+    uint8_t tankCount;
+    uint16_t snapshotInterval;
+    uint32_t reserved;
+};
+
+// Structure for a client's inputs
+struct ServerInputMessage {
+    uint32_t sequence; // Number of inputs[0]; inputs[i] is number sequence - i
+    uint8_t inputs[SERVER_INPUT_REDUNDANCY]; // Packed TankInput, newest first
+};
+
+static_assert(sizeof(ServerPacketHeader) == 8, "ServerPacketHeader layout is part of the protocol");
+static_assert(sizeof(ServerMatchInfo) == 32, "ServerMatchInfo layout is part of the protocol");
+static_assert(sizeof(ServerInputMessage) == 4 + SERVER_INPUT_REDUNDANCY,
+              "ServerInputMessage layout is part of the protocol");
+
+// Structure for one seat of the match
+struct ServerClient {
+    bool connected;
+    NetAddress address;
+    int tank;
+    uint8_t input; // Movement of the newest input, plus every shot not yet simulated
+    uint32_t inputSequence; // Newest input received
+    uint32_t snapshotSequence; // Newest snapshot sent
+    uint32_t ackSequence; // Newest snapshot the client has (0 = none)
+    double lastReceiveTime;
+    ReplicatedState sent[SERVER_HISTORY]; // By snapshot number % SERVER_HISTORY
+    uint32_t sentSequences[SERVER_HISTORY]; // Number of each state in sent (0 = unusable)
+};
+
+// Structure for what serving the match has cost so far
+struct ServerStats {
+    int ticks; // Simulated
+    int snapshots; // Sent, all clients
+    int deltaSnapshots; // Coded against an acknowledged snapshot (the rest against the match start)
+    uint64_t snapshotBytes; // Payload of every snapshot sent
+    int maxSnapshotBytes;
+    uint64_t fullBytes; // What the same snapshots cost against the match start (when measured)
+    int overflows; // Snapshots too big for a datagram (not sent)
+    uint64_t inputBytes; // Payload of every input message received
+    int inputMessages;
+    double simulateMs; // Total time in stepWorld
+    double encodeMs; // Total time coding snapshots
+    GameEventTotals events; // Gameplay events of every tick
+};
+
+// Structure for a server running one match
+struct GameServer {
+    NetSocket socket;
+    ServerMatchInfo match; // seed, map hash, tank size and count (tank unused)
+    World world;
+    ReplicatedState initial; // State at the match start (what clients build themselves)
+    ReplicatedState current; // State at the newest tick
+    std::vector<ServerClient> clients; // One seat per tank
+    std::vector<TankInput> inputs; // Scratch for stepWorld
+    bool started; // Every seat taken
+    bool ended; // Winner found or tickLimit reached
+    bool finished; // Every client has the final state, or they are gone
+    uint32_t tickLimit; // Ticks after which the match ends without a winner (0 = none)
+    double nextTickTime; // Server clock
+    double nextSnapshotTime;
+    double endTime;
+    bool measureFullSnapshots; // Also code every snapshot against the match start, for stats.fullBytes
+    std::vector<uint8_t> scratch; // Buffer for those measurements
+    ServerStats stats;
+};
+
+// Functions for the parts of the protocol client and server share
+void fillServerPacketHeader(ServerPacketHeader* header, uint8_t type, uint32_t sequence);
+bool readServerPacketHeader(const uint8_t* data, int size, ServerPacketHeader* header);
+void sendServerMatchInfo(NetSocket* socket, const NetAddress* to, uint8_t type, const ServerMatchInfo* match);
+bool readServerMatchInfo(const uint8_t* data, int size, ServerMatchInfo* match);
+
+// Function to open the server on port (0 = any free port) for a match of
+// tankCount seats (up to SERVER_MAX_TANKS), played on map with the given tank size and seed
+bool openGameServer(GameServer* server, const GameMap* map, uint16_t port, int tankCount, int tankWidth, int tankHeight,
+                    uint64_t seed);
+
+// Function to start a new match on an open server: the world goes back
+// to the start with a new seed and every seat is free again (clients of
+// the last match have to join anew)
+void restartGameServer(GameServer* server, uint64_t seed);
+
+// Function to take in messages, simulate the ticks that are due once
+// every seat is taken, and send snapshots (call often, at least every tick)
+void updateGameServer(GameServer* server, JobSystem* jobs = NULL);
+
+// Function to get the seconds until the server next has work (a tick or
+// snapshots due); messages that arrive meanwhile can wait until then
+double getGameServerIdleTime(const GameServer* server);
+
+// Function to log the server's statistics and close it
+void closeGameServer(GameServer* server);
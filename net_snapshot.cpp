@@ -0,0 +1,335 @@
+#include "net_snapshot.h"
+#include <algorithm>
+
+// Fixed steps per quarter degree
+const int QUARTER_DEGREE_SHIFT = FIXED_SHIFT - 2;
+
+// Function to round a Fixed angle to quarter degrees (gun steps and right angles are exact)
+static int32_t toQuarterDegrees(Fixed degrees) {
+    return (int32_t)(((int64_t)degrees.raw + (1 << (QUARTER_DEGREE_SHIFT - 1))) >> QUARTER_DEGREE_SHIFT);
+}
+
+// Function to turn quarter degrees back into a Fixed angle
+static Fixed fromQuarterDegrees(int32_t quarters) {
+    return fixedFromRaw((int32_t)((uint32_t)quarters << QUARTER_DEGREE_SHIFT));
+}
+
+// Functions to run field(base, value) over every field of a record in
+// wire order; encoding and decoding share them, so the two cannot drift
+template <typename Tank, typename F>
+static void visitTankFields(const ReplicatedTank& base, Tank& tank, F field) {
+    field(base.x, tank.x);
+    field(base.y, tank.y);
+    field(base.w, tank.w);
+    field(base.h, tank.h);
+    field(base.rotation, tank.rotation);
+    field(base.gunRotation, tank.gunRotation);
+    field(base.hp, tank.hp);
+    field(base.ammo, tank.ammo);
+    field(base.reloadTimer, tank.reloadTimer);
+    field(base.flags, tank.flags);
+    field(base.score, tank.score);
+    field(base.explosionItems, tank.explosionItems);
+}
+
+template <typename Bullet, typename F>
+static void visitBulletMotion(const ReplicatedBullet& base, Bullet& bullet, F field) {
+    field(base.x, bullet.x);
+    field(base.y, bullet.y);
+    field(base.rotation, bullet.rotation);
+}
+
+template <typename Effect, typename F>
+static void visitEffectFields(const ReplicatedEffect& base, Effect& effect, F field) {
+    field(base.active, effect.active);
+    field(base.type, effect.type);
+    field(base.x, effect.x);
+    field(base.y, effect.y);
+    field(base.w, effect.w);
+    field(base.h, effect.h);
+}
+
+template <typename State, typename F>
+static void visitMatchFields(const ReplicatedState& base, State& state, F field) {
+    field(base.winner, state.winner);
+    field(base.shieldActive, state.shieldActive);
+    field(base.shieldOwner, state.shieldOwner);
+    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
+        visitEffectFields(base.explosions[i], state.explosions[i], field);
+    }
+    visitEffectFields(base.powerBox, state.powerBox, field);
+}
+
+// Function to make an effect record from a rect
+static ReplicatedEffect makeEffect(bool active, int type, SDL_Rect rect) {
+    ReplicatedEffect effect;
+    effect.active = active ? 1 : 0;
+    effect.type = type;
+    effect.x = rect.x;
+    effect.y = rect.y;
+    effect.w = rect.w;
+    effect.h = rect.h;
+    return effect;
+}
+
+// Function to take what clients need from a world
+void captureReplicatedState(ReplicatedState* state, const World* world) {
+    state->tick = world->tick;
+    state->winner = world->winner;
+    state->shieldActive = world->shield.active ? 1 : 0;
+    state->shieldOwner = world->shield.owner;
+    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
+        state->explosions[i] = makeEffect(world->explosions[i].active, 0, world->explosions[i].rect);
+    }
+    state->powerBox = makeEffect(world->powerBox.active, world->powerBox.boxType, world->powerBox.rect);
+
+    const TankStore* tanks = &world->tanks;
+    state->tanks.resize(tanks->count);
+    for (int i = 0; i < tanks->count; i++) {
+        ReplicatedTank& tank = state->tanks[i];
+        tank.x = tanks->rect[i].x;
+        tank.y = tanks->rect[i].y;
+        tank.w = tanks->rect[i].w;
+        tank.h = tanks->rect[i].h;
+        tank.rotation = toQuarterDegrees(tanks->rotation[i]);
+        tank.gunRotation = toQuarterDegrees(tanks->gunRotation[i]);
+        tank.hp = tanks->hp[i];
+        tank.ammo = tanks->ammo[i];
+        tank.reloadTimer = tanks->reloadTimer[i];
+        tank.flags = tanks->flags[i];
+        tank.score = tanks->info[i].score;
+        tank.explosionItems = tanks->info[i].explosionItemCount;
+    }
+
+    const BulletPool* bullets = &world->bullets;
+    state->bullets.clear();
+    for (int i = 0; i < (int)bullets->flags.size() && (int)state->bullets.size() < NET_MAX_SNAPSHOT_BULLETS; i++) {
+        if (!isBulletActive(bullets, i)) continue;
+        ReplicatedBullet bullet;
+        bullet.slot = i;
+        bullet.owner = bullets->owner[i];
+        bullet.flags = bullets->flags[i] & BULLET_EXPLOSION;
+        bullet.x = fixedFloor(bullets->x[i]);
+        bullet.y = fixedFloor(bullets->y[i]);
+        bullet.rotation = toQuarterDegrees(bullets->rotation[i]);
+        state->bullets.push_back(bullet);
+    }
+
+    state->destroyedObstacles.assign(world->destroyedObstacles.begin(), world->destroyedObstacles.end());
+}
+
+// Function to get what a bullet new since the base is coded against: a
+// bullet leaving the center of its owner, where new bullets appear
+static ReplicatedBullet getSpawnBase(const ReplicatedState* state, int owner) {
+    ReplicatedBullet base = {};
+    if (owner >= 0 && owner < (int)state->tanks.size()) {
+        const ReplicatedTank& tank = state->tanks[owner];
+        base.x = tank.x + tank.w / 2 - BULLET_WIDTH / 2;
+        base.y = tank.y + tank.h / 2 - BULLET_HEIGHT / 2;
+        base.rotation = tank.rotation + tank.gunRotation;
+    }
+    return base;
+}
+
+// Function to write state as a delta against base
+void encodeReplicatedState(BitWriter* writer, const ReplicatedState* base, const ReplicatedState* state) {
+    auto writeField = [writer](int32_t from, int32_t value) { writeDelta(writer, from, value); };
+    writeVarUint(writer, state->tick - base->tick);
+    visitMatchFields(*base, *state, writeField);
+
+    // Tanks, each against the same tank in the base
+    const ReplicatedTank NO_TANK = {};
+    writeVarUint(writer, (uint32_t)state->tanks.size());
+    for (size_t i = 0; i < state->tanks.size(); i++) {
+        visitTankFields(i < base->tanks.size() ? base->tanks[i] : NO_TANK, state->tanks[i], writeField);
+    }
+
+    // Bullets by slot, walking the base's list alongside for the same slots
+    writeVarUint(writer, (uint32_t)state->bullets.size());
+    size_t baseIndex = 0;
+    int previousSlot = -1;
+    for (const ReplicatedBullet& bullet : state->bullets) {
+        writeVarUint(writer, (uint32_t)(bullet.slot - previousSlot - 1));
+        previousSlot = bullet.slot;
+        while (baseIndex < base->bullets.size() && base->bullets[baseIndex].slot < bullet.slot) {
+            baseIndex++;
+        }
+        bool inBase = baseIndex < base->bullets.size() && base->bullets[baseIndex].slot == bullet.slot;
+        writeBits(writer, inBase ? 1 : 0, 1);
+        ReplicatedBullet from = inBase ? base->bullets[baseIndex] : ReplicatedBullet();
+        writeDelta(writer, from.owner, bullet.owner);
+        writeDelta(writer, from.flags, bullet.flags);
+        if (!inBase) from = getSpawnBase(state, bullet.owner);
+        visitBulletMotion(from, bullet, writeField);
+    }
+
+    // Obstacles destroyed since the base
+    size_t known = std::min(base->destroyedObstacles.size(), state->destroyedObstacles.size());
+    writeVarUint(writer, (uint32_t)(state->destroyedObstacles.size() - known));
+    for (size_t i = known; i < state->destroyedObstacles.size(); i++) {
+        writeVarUint(writer, (uint32_t)state->destroyedObstacles[i]);
+    }
+}
+
+// Function to read a delta written against base
+bool decodeReplicatedState(BitReader* reader, const ReplicatedState* base, ReplicatedState* state) {
+    auto readField = [reader](int32_t from, int32_t& value) { value = readDelta(reader, from); };
+    state->tick = base->tick + readVarUint(reader);
+    visitMatchFields(*base, *state, readField);
+
+    const ReplicatedTank NO_TANK = {};
+    uint32_t tankCount = readVarUint(reader);
+    if (tankCount > (uint32_t)MAX_TANKS) return false;
+    state->tanks.resize(tankCount);
+    for (size_t i = 0; i < tankCount; i++) {
+        visitTankFields(i < base->tanks.size() ? base->tanks[i] : NO_TANK, state->tanks[i], readField);
+    }
+
+    uint32_t bulletCount = readVarUint(reader);
+    if (bulletCount > (uint32_t)NET_MAX_SNAPSHOT_BULLETS) return false;
+    state->bullets.resize(bulletCount);
+    size_t baseIndex = 0;
+    int previousSlot = -1;
+    for (ReplicatedBullet& bullet : state->bullets) {
+        uint32_t gap = readVarUint(reader);
+        if (gap > (uint32_t)(INT32_MAX / 2)) return false;
+        bullet.slot = previousSlot + 1 + (int32_t)gap;
+        previousSlot = bullet.slot;
+        while (baseIndex < base->bullets.size() && base->bullets[baseIndex].slot < bullet.slot) {
+            baseIndex++;
+        }
+        bool inBase = readBits(reader, 1) != 0;
+        if (inBase && (baseIndex >= base->bullets.size() || base->bullets[baseIndex].slot != bullet.slot)) {
+            return false;
+        }
+        ReplicatedBullet from = inBase ? base->bullets[baseIndex] : ReplicatedBullet();
+        bullet.owner = readDelta(reader, from.owner);
+        bullet.flags = readDelta(reader, from.flags);
+        if (!inBase) from = getSpawnBase(state, bullet.owner);
+        visitBulletMotion(from, bullet, readField);
+    }
+
+    uint32_t newObstacles = readVarUint(reader);
+    if (newObstacles > (uint32_t)NET_MAX_NEW_OBSTACLES) return false;
+    state->destroyedObstacles.assign(base->destroyedObstacles.begin(), base->destroyedObstacles.end());
+    for (uint32_t i = 0; i < newObstacles; i++) {
+        state->destroyedObstacles.push_back((int32_t)readVarUint(reader));
+    }
+    return !reader->overflow;
+}
+
+// Function to copy an effect record back into a rect
+static SDL_Rect getEffectRect(const ReplicatedEffect& effect) {
+    SDL_Rect rect = {effect.x, effect.y, effect.w, effect.h};
+    return rect;
+}
+
+// Function to check if two rects overlap (without SDL, which the headless server does not link)
+static bool rectsOverlap(SDL_Rect a, SDL_Rect b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Function to make a client's world show a state
+void applyReplicatedState(World* world, const ReplicatedState* state) {
+    // A power box that was there and is gone next to a tank was picked up
+    TankStore* tanks = &world->tanks;
+    int tankCount = std::min(tanks->count, (int)state->tanks.size());
+    if (world->powerBox.active && state->powerBox.active == 0) {
+        for (int i = 0; i < tankCount; i++) {
+            const ReplicatedTank& tank = state->tanks[i];
+            if (rectsOverlap(SDL_Rect{tank.x, tank.y, tank.w, tank.h}, world->powerBox.rect)) {
+                pushGameEvent(&world->events, GAME_EVENT_PICKED_UP, 0, i, world->powerBox.boxType, 0,
+                              world->powerBox.rect);
+                break;
+            }
+        }
+    }
+
+    world->tick = state->tick;
+    world->winner = state->winner;
+    world->shield.active = state->shieldActive != 0;
+    world->shield.owner = state->shieldOwner;
+    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
+        world->explosions[i].active = state->explosions[i].active != 0;
+        world->explosions[i].rect = getEffectRect(state->explosions[i]);
+    }
+    world->powerBox.active = state->powerBox.active != 0;
+    world->powerBox.boxType = state->powerBox.type;
+    world->powerBox.rect = getEffectRect(state->powerBox);
+
+    // Tanks (the previous state stays behind for interpolation)
+    storeTankPrevious(tanks);
+    for (int i = 0; i < tankCount; i++) {
+        const ReplicatedTank& tank = state->tanks[i];
+        SDL_Rect rect = {tank.x, tank.y, tank.w, tank.h};
+
+        // HP lost since the last state was a hit (an explosion bullet if it took that much)
+        int damage = tanks->hp[i] - tank.hp;
+        if (damage > 0) {
+            uint8_t flags = damage >= EXPLOSION_BULLET_DAMAGE ? GAME_EVENT_EXPLOSIVE : 0;
+            pushGameEvent(&world->events, GAME_EVENT_HIT, flags, i, i, damage, rect);
+            if (isTankAlive(tanks, i) && (tank.flags & TANK_DESTROYED)) {
+                pushGameEvent(&world->events, GAME_EVENT_DESTROYED, flags, i, i, 0, rect);
+            }
+        }
+        tanks->rect[i] = rect;
+        tanks->rotation[i] = fromQuarterDegrees(tank.rotation);
+        tanks->gunRotation[i] = fromQuarterDegrees(tank.gunRotation);
+        tanks->gunRect[i] = getGunRect(rect, tanks->rotation[i]);
+        tanks->hp[i] = tank.hp;
+        tanks->ammo[i] = tank.ammo;
+        tanks->reloadTimer[i] = tank.reloadTimer;
+        tanks->flags[i] = (uint8_t)tank.flags;
+        tanks->info[i].score = tank.score;
+        tanks->info[i].explosionItemCount = tank.explosionItems;
+    }
+
+    // Bullets are rebuilt from the list (slots on the client do not matter)
+    BulletPool* bullets = &world->bullets;
+    for (int i = 0; i < (int)bullets->flags.size(); i++) {
+        releaseBullet(bullets, i);
+    }
+    for (const ReplicatedBullet& bullet : state->bullets) {
+        int index = allocateBullet(bullets);
+        bullets->x[index] = fixedFromInt(bullet.x);
+        bullets->y[index] = fixedFromInt(bullet.y);
+        bullets->prevX[index] = bullets->x[index];
+        bullets->prevY[index] = bullets->y[index];
+        bullets->rotation[index] = fromQuarterDegrees(bullet.rotation);
+        bullets->owner[index] = (uint8_t)std::max(0, std::min(bullet.owner, tankCount - 1));
+        bullets->flags[index] = (uint8_t)(BULLET_ACTIVE | (bullet.flags & BULLET_EXPLOSION));
+    }
+
+    // Obstacles destroyed since the last state applied
+    int obstacleCount = (int)(world->grassObjects.size() + world->rockObjects.size());
+    for (size_t i = world->destroyedObstacles.size(); i < state->destroyedObstacles.size(); i++) {
+        int id = state->destroyedObstacles[i];
+        if (id < 0 || id >= obstacleCount) continue;
+        GameObject* obstacle = getWorldObstacle(world, id);
+        destroyGameObject(obstacle, &world->obstacleGrid, &world->navGrid, id);
+        world->destroyedObstacles.push_back(id);
+        uint8_t flags = id < (int)world->grassObjects.size() ? GAME_EVENT_GRASS : 0;
+        pushGameEvent(&world->events, GAME_EVENT_OBSTACLE_DESTROYED, flags, 0, id, 0, obstacle->rect);
+    }
+}
+
+// Function to check if two states hold the same values
+bool isSameReplicatedState(const ReplicatedState* a, const ReplicatedState* b) {
+    bool same = a->tick == b->tick && a->tanks.size() == b->tanks.size() && a->bullets.size() == b->bullets.size() &&
+                a->destroyedObstacles == b->destroyedObstacles;
+    if (!same) return false;
+
+    // Every record is plain int32 fields, so they compare field by field through the visitors
+    auto compare = [&same](int32_t x, int32_t y) { same = same && x == y; };
+    visitMatchFields(*a, *b, compare);
+    for (size_t i = 0; i < a->tanks.size(); i++) {
+        visitTankFields(a->tanks[i], b->tanks[i], compare);
+    }
+    for (size_t i = 0; i < a->bullets.size(); i++) {
+        const ReplicatedBullet& x = a->bullets[i];
+        const ReplicatedBullet& y = b->bullets[i];
+        same = same && x.slot == y.slot && x.owner == y.owner && x.flags == y.flags;
+        visitBulletMotion(x, y, compare);
+    }
+    return same;
+}
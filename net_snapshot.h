@@ -0,0 +1,96 @@
+#pragma once
+
+// What the server tells clients about a match. A ReplicatedState holds
+// only what clients draw (tank rects, rotations, health, ammo, bullets,
+// destroyed grass and rocks, effects), as plain integers: positions in
+// whole pixels, angles in quarter degrees. Clients never simulate, so
+// nothing else of the World needs to cross the network.
+//
+// A state goes out as a bit-packed delta against a base state the client
+// already has: each field costs one bit when it did not change and a
+// short variable-length difference when it did. Bullets are matched to
+// the base by pool slot; a bullet new since the base is coded against the
+// tank that fired it. Destroyed obstacles only ever grow during a match,
+// so just the ids destroyed since the base are sent.
+
+#include "bit_stream.h"
+#include "world.h"
+#include <cstdint>
+#include <vector>
+
+// Most bullets in one state (the ones in the lowest slots are kept)
+const int NET_MAX_SNAPSHOT_BULLETS = 48;
+
+// Most obstacles added to the destroyed list in one delta (the rest follow in later ones)
+const int NET_MAX_NEW_OBSTACLES = 32;
+
+// Structure for one tank as clients see it
+struct ReplicatedTank {
+    int32_t x; // Body rect
+    int32_t y;
+    int32_t w;
+    int32_t h;
+    int32_t rotation; // Quarter degrees
+    int32_t gunRotation; // Quarter degrees relative to the body
+    int32_t hp;
+    int32_t ammo;
+    int32_t reloadTimer; // For the ammo bar
+    int32_t flags; // TANK_* bits
+    int32_t score;
+    int32_t explosionItems;
+};
+
+// Structure for one bullet as clients see it
+struct ReplicatedBullet {
+    int32_t slot; // Server pool slot (identifies the bullet between states)
+    int32_t owner;
+    int32_t flags; // BULLET_EXPLOSION or 0
+    int32_t x; // Top-left in whole pixels
+    int32_t y;
+    int32_t rotation; // Quarter degrees
+};
+
+// Structure for an effect drawn as a rect (explosions, the power box)
+struct ReplicatedEffect {
+    int32_t active;
+    int32_t type; // Power box type (0 for explosions)
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+};
+
+// Structure for everything clients draw at one tick
+struct ReplicatedState {
+    uint32_t tick;
+    int32_t winner;
+    int32_t shieldActive;
+    int32_t shieldOwner;
+    ReplicatedEffect explosions[MAX_EXPLOSIONS];
+    ReplicatedEffect powerBox;
+    std::vector<ReplicatedTank> tanks;
+    std::vector<ReplicatedBullet> bullets; // Sorted by slot
+    std::vector<int32_t> destroyedObstacles; // In the order they were destroyed
+};
+
+// Function to take what clients need from a world
+void captureReplicatedState(ReplicatedState* state, const World* world);
+
+// Function to write state as a delta against base. base's destroyed
+// obstacles must be the start of state's (both from the same match, base
+// no later than state).
+void encodeReplicatedState(BitWriter* writer, const ReplicatedState* base, const ReplicatedState* state);
+
+// Function to read a delta written against base (false if the data is cut short or does not fit)
+bool decodeReplicatedState(BitReader* reader, const ReplicatedState* base, ReplicatedState* state);
+
+// Function to make a client's world show a state (the world must have
+// been initialized for the same match; nothing is simulated). Events are
+// not replicated, so the ones presentation needs are derived from what
+// changed and appended to world->events: hits and destroyed tanks from
+// lost HP, destroyed obstacles, and a power box gone next to a tank. The
+// shooter is not known, so those name the tank hit (tank 0 for obstacles).
+void applyReplicatedState(World* world, const ReplicatedState* state);
+
+// Function to check if two states hold the same values
+bool isSameReplicatedState(const ReplicatedState* a, const ReplicatedState* b);
@@ -0,0 +1,245 @@
+#include "net_socket.h"
+#include "log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// Function to get the shim clock in seconds
+static double getShimTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Function to draw a number in [0, 1) for the shim (xorshift64)
+static double nextShimRandom(NetShim* shim) {
+    shim->rngState ^= shim->rngState << 13;
+    shim->rngState ^= shim->rngState >> 7;
+    shim->rngState ^= shim->rngState << 17;
+    return (shim->rngState >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Function to start Winsock once for the process (sockets and name lookups both need it; no-op elsewhere)
+static bool startNetworking() {
+#ifdef _WIN32
+    // A function-local static is initialized once even with several threads opening sockets
+    static const bool started = []() {
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            LOG_ERROR("[NET] Unable to start Winsock");
+            return false;
+        }
+        return true;
+    }();
+    return started;
+#else
+    return true;
+#endif
+}
+
+// Function to fill a sockaddr from an address
+static sockaddr_in toSockaddr(const NetAddress* address) {
+    sockaddr_in result;
+    memset(&result, 0, sizeof(result));
+    result.sin_family = AF_INET;
+    result.sin_addr.s_addr = htonl(address->host);
+    result.sin_port = htons(address->port);
+    return result;
+}
+
+// Function to open a non-blocking UDP socket bound to port
+bool openNetSocket(NetSocket* socket, uint16_t port) {
+    socket->handle = -1;
+    socket->shim.latencyMs = 0;
+    socket->shim.jitterMs = 0;
+    socket->shim.lossRate = 0.0f;
+    socket->shim.rngState = 1;
+    socket->shim.queue.clear();
+    socket->packetsSent = 0;
+    socket->packetsDropped = 0;
+    socket->packetsReceived = 0;
+    socket->bytesSent = 0;
+    if (!startNetworking()) return false;
+
+    intptr_t handle = (intptr_t)::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+    if ((SOCKET)handle == INVALID_SOCKET) {
+#else
+    if (handle < 0) {
+#endif
+        LOG_ERROR("[NET] Unable to create a UDP socket");
+        return false;
+    }
+
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool ready = bind((SOCKET)handle, (sockaddr*)&local, sizeof(local)) == 0 &&
+                 ioctlsocket((SOCKET)handle, FIONBIO, &nonBlocking) == 0;
+#else
+    bool ready = bind((int)handle, (sockaddr*)&local, sizeof(local)) == 0 &&
+                 fcntl((int)handle, F_SETFL, fcntl((int)handle, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    socket->handle = handle;
+    if (!ready) {
+        LOG_ERROR("[NET] Unable to bind UDP port %u", (unsigned)port);
+        closeNetSocket(socket);
+        return false;
+    }
+    return true;
+}
+
+// Function to close a socket
+void closeNetSocket(NetSocket* socket) {
+    if (socket->handle == -1) return;
+#ifdef _WIN32
+    closesocket((SOCKET)socket->handle);
+#else
+    close((int)socket->handle);
+#endif
+    socket->handle = -1;
+    socket->shim.queue.clear();
+}
+
+// Function to get the port a socket is bound to
+uint16_t getNetSocketPort(const NetSocket* socket) {
+    sockaddr_in local;
+    socklen_t length = sizeof(local);
+#ifdef _WIN32
+    if (getsockname((SOCKET)socket->handle, (sockaddr*)&local, &length) != 0) return 0;
+#else
+    if (getsockname((int)socket->handle, (sockaddr*)&local, &length) != 0) return 0;
+#endif
+    return ntohs(local.sin_port);
+}
+
+// Function to turn "host" or "host:port" into an address
+bool resolveNetAddress(NetAddress* address, const std::string& text, uint16_t defaultPort) {
+    std::string host = text;
+    uint16_t port = defaultPort;
+    size_t colon = text.rfind(':');
+    if (colon != std::string::npos) {
+        host = text.substr(0, colon);
+        port = (uint16_t)atoi(text.c_str() + colon + 1);
+    }
+    if (!startNetworking()) return false;
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = NULL;
+    if (getaddrinfo(host.c_str(), NULL, &hints, &found) != 0 || found == NULL) {
+        LOG_ERROR("[NET] Unable to resolve %s", host.c_str());
+        return false;
+    }
+    address->host = ntohl(((sockaddr_in*)found->ai_addr)->sin_addr.s_addr);
+    address->port = port;
+    freeaddrinfo(found);
+    return true;
+}
+
+// Function to set the shim's latency, jitter and loss
+void setNetShim(NetSocket* socket, int latencyMs, int jitterMs, float lossRate, uint64_t seed) {
+    socket->shim.latencyMs = latencyMs;
+    socket->shim.jitterMs = jitterMs;
+    socket->shim.lossRate = lossRate;
+    socket->shim.rngState = seed != 0 ? seed : 1;
+    if (latencyMs > 0 || jitterMs > 0 || lossRate > 0.0f) {
+        LOG_INFO("[NET] Shim: %d ms latency, %d ms jitter, %.0f%% loss", latencyMs, jitterMs, lossRate * 100.0f);
+    }
+}
+
+// Function to put a datagram on the wire
+static void sendNow(NetSocket* socket, const NetAddress* to, const void* data, int size) {
+    sockaddr_in target = toSockaddr(to);
+#ifdef _WIN32
+    sendto((SOCKET)socket->handle, (const char*)data, size, 0, (const sockaddr*)&target, sizeof(target));
+#else
+    sendto((int)socket->handle, data, size, 0, (const sockaddr*)&target, sizeof(target));
+#endif
+}
+
+// Function to send a datagram through the shim
+void sendNetPacket(NetSocket* socket, const NetAddress* to, const void* data, int size) {
+    if (socket->handle == -1 || size <= 0 || size > NET_MAX_PACKET) return;
+    socket->packetsSent++;
+    socket->bytesSent += size;
+
+    NetShim* shim = &socket->shim;
+    if (shim->lossRate > 0.0f && nextShimRandom(shim) < shim->lossRate) {
+        socket->packetsDropped++;
+        return;
+    }
+    if (shim->latencyMs <= 0 && shim->jitterMs <= 0) {
+        sendNow(socket, to, data, size);
+        return;
+    }
+
+    // Keep the queue sorted by send time; jitter may put a datagram ahead of earlier ones
+    double delay = (shim->latencyMs + nextShimRandom(shim) * shim->jitterMs) / 1000.0;
+    NetDelayedPacket packet;
+    packet.sendTime = getShimTime() + delay;
+    packet.to = *to;
+    packet.size = size;
+    memcpy(packet.data, data, size);
+    auto position = shim->queue.end();
+    while (position != shim->queue.begin() && (position - 1)->sendTime > packet.sendTime) {
+        --position;
+    }
+    shim->queue.insert(position, packet);
+}
+
+// Function to send the held-back datagrams that are due
+void flushNetShim(NetSocket* socket) {
+    double now = getShimTime();
+    NetShim* shim = &socket->shim;
+    while (!shim->queue.empty() && shim->queue.front().sendTime <= now) {
+        const NetDelayedPacket& packet = shim->queue.front();
+        sendNow(socket, &packet.to, packet.data, packet.size);
+        shim->queue.pop_front();
+    }
+}
+
+// Function to receive one datagram if any is waiting
+int receiveNetPacket(NetSocket* socket, NetAddress* from, void* buffer, int capacity) {
+    if (socket->handle == -1) return 0;
+
+    sockaddr_in source;
+    socklen_t length = sizeof(source);
+#ifdef _WIN32
+    int size = recvfrom((SOCKET)socket->handle, (char*)buffer, capacity, 0, (sockaddr*)&source, &length);
+#else
+    int size = (int)recvfrom((int)socket->handle, buffer, capacity, 0, (sockaddr*)&source, &length);
+#endif
+    if (size <= 0) return 0; // Nothing waiting (or an ICMP error from a peer that went away)
+
+    from->host = ntohl(source.sin_addr.s_addr);
+    from->port = ntohs(source.sin_port);
+    socket->packetsReceived++;
+    return size;
+}
+
+// Function to format an address as "a.b.c.d:port"
+std::string formatNetAddress(const NetAddress* address) {
+    char text[32];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u:%u", (address->host >> 24) & 255, (address->host >> 16) & 255,
+             (address->host >> 8) & 255, address->host & 255, (unsigned)address->port);
+    return text;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// Thin non-blocking UDP socket (Winsock or BSD sockets) for network play.
+// Datagrams go out through a NetShim, which can hold them back and drop
+// some to test how the game copes with a bad connection on loopback.
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+// Largest datagram the game sends or accepts (fits an Ethernet frame with room for headers)
+const int NET_MAX_PACKET = 1200;
+
+// Structure for an IPv4 address and port (host byte order)
+struct NetAddress {
+    uint32_t host;
+    uint16_t port;
+};
+
+// Structure for a datagram held back by the shim
+struct NetDelayedPacket {
+    double sendTime; // Seconds on the shim clock when it goes out
+    NetAddress to;
+    int size;
+    uint8_t data[NET_MAX_PACKET];
+};
+
+// Structure for the artificial latency and loss applied to outgoing datagrams
+struct NetShim {
+    int latencyMs; // Added to every datagram (one way)
+    int jitterMs; // Extra random delay of 0 to jitterMs (datagrams may arrive out of order)
+    float lossRate; // Chance of dropping a datagram (0 to 1)
+    uint64_t rngState;
+    std::deque<NetDelayedPacket> queue; // Sorted by sendTime
+};
+
+// Structure for an open socket
+struct NetSocket {
+    intptr_t handle; // -1 when closed
+    NetShim shim;
+    uint64_t packetsSent; // Statistics (sent counts datagrams the shim dropped)
+    uint64_t packetsDropped;
+    uint64_t packetsReceived;
+    uint64_t bytesSent;
+};
+
+// Function to open a non-blocking UDP socket bound to port (0 = any free port)
+bool openNetSocket(NetSocket* socket, uint16_t port);
+
+// Function to close a socket (datagrams still held by the shim are lost)
+void closeNetSocket(NetSocket* socket);
+
+// Function to get the port a socket is bound to (0 if unknown)
+uint16_t getNetSocketPort(const NetSocket* socket);
+
+// Function to turn "host" or "host:port" into an address (defaultPort when none is given)
+bool resolveNetAddress(NetAddress* address, const std::string& text, uint16_t defaultPort);
+
+// Function to set the shim's latency, jitter and loss (all 0 = send directly)
+void setNetShim(NetSocket* socket, int latencyMs, int jitterMs, float lossRate, uint64_t seed = 1);
+
+// Function to send a datagram through the shim
+void sendNetPacket(NetSocket* socket, const NetAddress* to, const void* data, int size);
+
+// Function to send the held-back datagrams that are due (call every frame)
+void flushNetShim(NetSocket* socket);
+
+// Function to receive one datagram if any is waiting (returns its size, 0 if none)
+int receiveNetPacket(NetSocket* socket, NetAddress* from, void* buffer, int capacity);
+
+// Function to format an address as "a.b.c.d:port"
+std::string formatNetAddress(const NetAddress* address);
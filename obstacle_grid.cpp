@@ -0,0 +1,214 @@
+#include "obstacle_grid.h"
+#include <algorithm>
+
+// Function to get the cell range covered by a rect, clamped to the grid
+static void getCellRange(const ObstacleGrid* grid, SDL_Rect rect, int* minX, int* minY, int* maxX, int* maxY) {
+    *minX = std::max(0, std::min(grid->columns - 1, rect.x / grid->cellSize));
+    *minY = std::max(0, std::min(grid->rows - 1, rect.y / grid->cellSize));
+    *maxX = std::max(0, std::min(grid->columns - 1, (rect.x + rect.w - 1) / grid->cellSize));
+    *maxY = std::max(0, std::min(grid->rows - 1, (rect.y + rect.h - 1) / grid->cellSize));
+}
+
+// Function to check if two rects overlap (touching edges do not count)
+static bool rectsOverlap(SDL_Rect a, SDL_Rect b) {
+    return a.x < b.x + b.w && a.x + a.w > b.x &&
+           a.y < b.y + b.h && a.y + a.h > b.y;
+}
+
+// Function to (re)build the grid from the obstacle arrays (skips destroyed objects)
+void buildObstacleGrid(ObstacleGrid* grid, const GameObject* grassObjects, const GameObject* rockObjects,
+                       int grassCount, int rockCount, int cellSize) {
+    int total = grassCount + rockCount;
+    grid->cellSize = cellSize;
+    grid->grassCount = grassCount;
+    grid->bounds.resize(total);
+
+    // Size the grid to cover every obstacle
+    int maxRight = 1;
+    int maxBottom = 1;
+    for (int id = 0; id < total; id++) {
+        const GameObject& obj = (id < grassCount) ? grassObjects[id] : rockObjects[id - grassCount];
+        grid->bounds[id] = obj.rect;
+        maxRight = std::max(maxRight, obj.rect.x + obj.rect.w);
+        maxBottom = std::max(maxBottom, obj.rect.y + obj.rect.h);
+    }
+    grid->columns = (maxRight + cellSize - 1) / cellSize;
+    grid->rows = (maxBottom + cellSize - 1) / cellSize;
+
+    int cellTotal = grid->columns * grid->rows;
+    grid->cellStart.assign(cellTotal + 1, 0);
+    grid->cellCount.assign(cellTotal, 0);
+
+    // First pass: count obstacles per cell
+    for (int id = 0; id < total; id++) {
+        const GameObject& obj = (id < grassCount) ? grassObjects[id] : rockObjects[id - grassCount];
+        if (obj.isDestroyed) continue;
+
+        int minX, minY, maxX, maxY;
+        getCellRange(grid, obj.rect, &minX, &minY, &maxX, &maxY);
+        for (int cy = minY; cy <= maxY; cy++) {
+            for (int cx = minX; cx <= maxX; cx++) {
+                grid->cellCount[cy * grid->columns + cx]++;
+            }
+        }
+    }
+
+    // Prefix sum gives each cell its slice of items
+    for (int c = 0; c < cellTotal; c++) {
+        grid->cellStart[c + 1] = grid->cellStart[c] + grid->cellCount[c];
+        grid->cellCount[c] = 0;
+    }
+    grid->items.assign(grid->cellStart[cellTotal], -1);
+
+    // Second pass: fill the slices
+    for (int id = 0; id < total; id++) {
+        const GameObject& obj = (id < grassCount) ? grassObjects[id] : rockObjects[id - grassCount];
+        if (obj.isDestroyed) continue;
+
+        int minX, minY, maxX, maxY;
+        getCellRange(grid, obj.rect, &minX, &minY, &maxX, &maxY);
+        for (int cy = minY; cy <= maxY; cy++) {
+            for (int cx = minX; cx <= maxX; cx++) {
+                int cell = cy * grid->columns + cx;
+                grid->items[grid->cellStart[cell] + grid->cellCount[cell]++] = id;
+            }
+        }
+    }
+}
+
+// Function to take an obstacle out of every cell it covers
+void removeFromObstacleGrid(ObstacleGrid* grid, int id) {
+    int minX, minY, maxX, maxY;
+    getCellRange(grid, grid->bounds[id], &minX, &minY, &maxX, &maxY);
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            int cell = cy * grid->columns + cx;
+            int start = grid->cellStart[cell];
+            int count = grid->cellCount[cell];
+
+            // Swap with the last live entry of the cell
+            for (int i = 0; i < count; i++) {
+                if (grid->items[start + i] == id) {
+                    grid->items[start + i] = grid->items[start + count - 1];
+                    grid->cellCount[cell]--;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Function to put a removed obstacle back into every cell it covers
+void insertIntoObstacleGrid(ObstacleGrid* grid, int id) {
+    int minX, minY, maxX, maxY;
+    getCellRange(grid, grid->bounds[id], &minX, &minY, &maxX, &maxY);
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            // Queries do not depend on the order within a cell, so append
+            int cell = cy * grid->columns + cx;
+            if (grid->cellStart[cell] + grid->cellCount[cell] < grid->cellStart[cell + 1]) {
+                grid->items[grid->cellStart[cell] + grid->cellCount[cell]++] = id;
+            }
+        }
+    }
+}
+
+// Function to find the obstacle overlapping rect (lowest id wins, -1 if none)
+int findObstacleOverlap(const ObstacleGrid* grid, SDL_Rect rect) {
+    if (grid->items.empty()) return -1;
+
+    int minX, minY, maxX, maxY;
+    getCellRange(grid, rect, &minX, &minY, &maxX, &maxY);
+
+    int found = -1;
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            int cell = cy * grid->columns + cx;
+            int start = grid->cellStart[cell];
+            int end = start + grid->cellCount[cell];
+            for (int i = start; i < end; i++) {
+                int id = grid->items[i];
+                if ((found == -1 || id < found) && rectsOverlap(rect, grid->bounds[id])) {
+                    found = id;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+// Function to divide rounding towards negative infinity (cells left of or above the grid)
+static int floorDivide(int value, int divisor) {
+    int quotient = value / divisor;
+    return quotient * divisor > value ? quotient - 1 : quotient;
+}
+
+// Function to find the first obstacle a moving box runs into (earliest hit, then lowest id; -1 if none)
+int sweepObstacleGrid(const ObstacleGrid* grid, Fixed x, Fixed y, int w, int h, Fixed dx, Fixed dy, Fixed* hitTime) {
+    if (grid->items.empty()) return -1;
+
+    // Walk the cells under the box center in the order the move crosses
+    // them (DDA). Times are fractions of the move; 2 means never (times
+    // are capped there, so stepping along a near-parallel axis cannot overflow).
+    const Fixed NEVER = fixedFromInt(2);
+    const Fixed ONE = fixedFromInt(1);
+    Fixed size = fixedFromInt(grid->cellSize);
+    Fixed centerX = x + fixedFromRatio(w, 2);
+    Fixed centerY = y + fixedFromRatio(h, 2);
+    int cellX = floorDivide(fixedFloor(centerX), grid->cellSize);
+    int cellY = floorDivide(fixedFloor(centerY), grid->cellSize);
+    Fixed edgeX = size * (cellX + (dx.raw > 0 ? 1 : 0));
+    Fixed edgeY = size * (cellY + (dy.raw > 0 ? 1 : 0));
+    Fixed nextX = dx.raw != 0 ? std::min(NEVER, (edgeX - centerX) / dx) : NEVER;
+    Fixed nextY = dy.raw != 0 ? std::min(NEVER, (edgeY - centerY) / dy) : NEVER;
+    Fixed stepX = dx.raw != 0 ? std::min(NEVER, size / fixedAbs(dx)) : NEVER;
+    Fixed stepY = dy.raw != 0 ? std::min(NEVER, size / fixedAbs(dy)) : NEVER;
+
+    int found = -1;
+    Fixed foundTime = NEVER;
+    Fixed enter = fixedFromInt(0);
+    while (true) {
+        Fixed exit = std::min(ONE, std::min(nextX, nextY));
+
+        // Cells the box sweeps over while its center crosses this cell;
+        // any obstacle first touched in that stretch is stored in one of them
+        Fixed left = x + std::min(dx * enter, dx * exit);
+        Fixed top = y + std::min(dy * enter, dy * exit);
+        Fixed right = x + std::max(dx * enter, dx * exit) + fixedFromInt(w);
+        Fixed bottom = y + std::max(dy * enter, dy * exit) + fixedFromInt(h);
+        SDL_Rect area = {fixedFloor(left), fixedFloor(top), fixedCeil(right) - fixedFloor(left),
+                         fixedCeil(bottom) - fixedFloor(top)};
+
+        int minX, minY, maxX, maxY;
+        getCellRange(grid, area, &minX, &minY, &maxX, &maxY);
+        for (int cy = minY; cy <= maxY; cy++) {
+            for (int cx = minX; cx <= maxX; cx++) {
+                int cell = cy * grid->columns + cx;
+                int start = grid->cellStart[cell];
+                int end = start + grid->cellCount[cell];
+                for (int i = start; i < end; i++) {
+                    int id = grid->items[i];
+                    Fixed time;
+                    if (sweepBox(x, y, w, h, dx, dy, grid->bounds[id], &time) &&
+                        (time < foundTime || (time == foundTime && id < found))) {
+                        found = id;
+                        foundTime = time;
+                    }
+                }
+            }
+        }
+
+        // Later cells can only hold hits after this stretch
+        if ((found != -1 && foundTime <= exit) || exit >= ONE) break;
+        if (nextX < nextY) {
+            enter = nextX;
+            nextX += stepX;
+        } else {
+            enter = nextY;
+            nextY += stepY;
+        }
+    }
+
+    if (found != -1) *hitTime = foundTime;
+    return found;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// Uniform grid over the static obstacles (grass and rocks) so rect
+// queries only test the obstacles in the cells they touch instead of
+// scanning every object.
+//
+// Obstacles are identified by id: grass i is id i, rock i is
+// id grassCount + i. Destroyed obstacles are removed from the grid.
+
+#include "game.h"
+#include <vector>
+
+// Default cell size in pixels (about one tank)
+const int OBSTACLE_GRID_CELL_SIZE = 64;
+
+// Structure for the obstacle grid (cells stored as slices of one array)
+struct ObstacleGrid {
+    int cellSize;
+    int columns;
+    int rows;
+    int grassCount; // Ids below this are grass, the rest are rocks
+    std::vector<int> cellStart; // First slot of each cell in items
+    std::vector<int> cellCount; // Live obstacles in each cell
+    std::vector<int> items; // Obstacle ids grouped by cell
+    std::vector<SDL_Rect> bounds; // Rect of each obstacle id
+};
+
+// Function to (re)build the grid from the obstacle arrays (skips destroyed objects)
+void buildObstacleGrid(ObstacleGrid* grid, const GameObject* grassObjects, const GameObject* rockObjects,
+                       int grassCount, int rockCount, int cellSize = OBSTACLE_GRID_CELL_SIZE);
+
+// Function to take an obstacle out of every cell it covers
+void removeFromObstacleGrid(ObstacleGrid* grid, int id);
+
+// Function to put a removed obstacle back (only obstacles that were live
+// when the grid was built, as cells keep just the room they had then)
+void insertIntoObstacleGrid(ObstacleGrid* grid, int id);
+
+// Function to find the obstacle overlapping rect (lowest id wins, -1 if none)
+int findObstacleOverlap(const ObstacleGrid* grid, SDL_Rect rect);
+
+// Function to find the first obstacle a box of w x h at (x, y) runs into
+// while moving by (dx, dy): the earliest hit wins, then the lowest id
+// (-1 if none). *hitTime gets the fraction of the move done at contact.
+int sweepObstacleGrid(const ObstacleGrid* grid, Fixed x, Fixed y, int w, int h, Fixed dx, Fixed dy, Fixed* hitTime);
@@ -0,0 +1,246 @@
+#include "particle_system.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLE_SYSTEM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#define PARTICLE_SYSTEM_AVX 1
+#include <immintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Bursts of the gameplay events
+static const ParticleBurst HIT_SPARKS = {
+    150, 6.0f, 60.0f, 260.0f, 0.15f, 0.45f, 2.0f, 4.0f, {255, 240, 150, 255}, {255, 140, 30, 255}};
+static const ParticleBurst EXPLOSION_FIRE = {
+    900, 12.0f, 40.0f, 320.0f, 0.3f, 0.9f, 3.0f, 7.0f, {255, 220, 90, 255}, {230, 60, 20, 255}};
+static const ParticleBurst EXPLOSION_SMOKE = {
+    300, 16.0f, 10.0f, 80.0f, 0.8f, 1.6f, 5.0f, 10.0f, {90, 90, 90, 160}, {50, 45, 40, 160}};
+static const ParticleBurst WRECK_FIRE = {
+    2500, 20.0f, 60.0f, 420.0f, 0.4f, 1.2f, 3.0f, 8.0f, {255, 230, 120, 255}, {220, 40, 10, 255}};
+static const ParticleBurst WRECK_SMOKE = {
+    800, 24.0f, 10.0f, 100.0f, 1.0f, 2.0f, 6.0f, 12.0f, {80, 80, 80, 170}, {40, 35, 30, 170}};
+static const ParticleBurst SHIELD_SPARKS = {
+    80, 10.0f, 80.0f, 240.0f, 0.15f, 0.35f, 2.0f, 3.0f, {200, 240, 255, 255}, {60, 140, 255, 255}};
+static const ParticleBurst SHIELD_GLITTER = {
+    120, 14.0f, 20.0f, 120.0f, 0.4f, 0.9f, 2.0f, 4.0f, {150, 255, 255, 255}, {40, 160, 255, 255}};
+static const ParticleBurst POWER_UP_GLITTER = {
+    120, 14.0f, 20.0f, 120.0f, 0.4f, 0.9f, 2.0f, 4.0f, {255, 255, 160, 255}, {255, 200, 0, 255}};
+static const ParticleBurst GRASS_DEBRIS = {
+    250, 16.0f, 30.0f, 180.0f, 0.3f, 0.8f, 2.0f, 5.0f, {120, 200, 60, 255}, {50, 110, 30, 255}};
+static const ParticleBurst ROCK_DEBRIS = {
+    250, 16.0f, 30.0f, 200.0f, 0.3f, 0.8f, 2.0f, 5.0f, {170, 160, 150, 255}, {90, 80, 70, 255}};
+
+// Function to get a random float in [min, max)
+static float randomFloat(GameRng* rng, float min, float max) {
+    return min + (max - min) * (float)(nextRandom(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Function to allocate the arrays and empty the system
+void initializeParticleSystem(ParticleSystem* system, int capacity) {
+    // Sized once so emitting never allocates
+    system->x.assign(capacity, 0.0f);
+    system->y.assign(capacity, 0.0f);
+    system->velocityX.assign(capacity, 0.0f);
+    system->velocityY.assign(capacity, 0.0f);
+    system->life.assign(capacity, 0.0f);
+    system->fade.assign(capacity, 0.0f);
+    system->size.assign(capacity, 0.0f);
+    system->color.assign(capacity, SDL_Color{0, 0, 0, 0});
+    system->capacity = capacity;
+    system->quality = 1.0f;
+    system->costMs = 0.0;
+    seedRng(&system->rng, 0x9e3779b97f4a7c15ull);
+    clearParticles(system);
+}
+
+// Function to remove every particle
+void clearParticles(ParticleSystem* system) {
+    system->count = 0;
+    system->recycleCursor = 0;
+    system->emitted = 0;
+    system->skipped = 0;
+    system->recycled = 0;
+}
+
+// Function to emit a burst centered on (x, y) at the current quality
+int emitParticles(ParticleSystem* system, float x, float y, const ParticleBurst* burst) {
+    if (system->capacity <= 0) return 0;
+    int count = std::max(std::min(PARTICLE_MIN_BURST, burst->count), (int)(burst->count * system->quality + 0.5f));
+    count = std::min(count, system->capacity);
+    system->skipped += burst->count - count;
+
+    GameRng* rng = &system->rng;
+    for (int i = 0; i < count; i++) {
+        int slot;
+        if (system->count < system->capacity) {
+            slot = system->count++;
+        } else {
+            // Full: overwrite from the front, where compaction keeps the oldest particles
+            if (system->recycleCursor >= system->count) system->recycleCursor = 0;
+            slot = system->recycleCursor++;
+            system->recycled++;
+        }
+
+        float angle = randomFloat(rng, 0.0f, 2.0f * (float)M_PI);
+        float offset = randomFloat(rng, 0.0f, burst->spread);
+        float speed = randomFloat(rng, burst->minSpeed, burst->maxSpeed);
+        float cosine = cosf(angle);
+        float sine = sinf(angle);
+        float lifetime = randomFloat(rng, burst->minLife, burst->maxLife);
+        float blend = randomFloat(rng, 0.0f, 1.0f);
+
+        system->x[slot] = x + cosine * offset;
+        system->y[slot] = y + sine * offset;
+        system->velocityX[slot] = cosine * speed;
+        system->velocityY[slot] = sine * speed;
+        system->life[slot] = lifetime;
+        system->fade[slot] = 1.0f / lifetime;
+        system->size[slot] = randomFloat(rng, burst->minSize, burst->maxSize);
+        SDL_Color color;
+        color.r = (Uint8)(burst->color.r + (burst->otherColor.r - burst->color.r) * blend);
+        color.g = (Uint8)(burst->color.g + (burst->otherColor.g - burst->color.g) * blend);
+        color.b = (Uint8)(burst->color.b + (burst->otherColor.b - burst->color.b) * blend);
+        color.a = (Uint8)(burst->color.a + (burst->otherColor.a - burst->color.a) * blend);
+        system->color[slot] = color;
+    }
+    system->emitted += count;
+    return count;
+}
+
+// Function to emit the bursts of a tick's gameplay events
+void emitEventParticles(ParticleSystem* system, const GameEvent* events, int count) {
+    for (int i = 0; i < count; i++) {
+        const GameEvent& event = events[i];
+        float centerX = event.rect.x + event.rect.w * 0.5f;
+        float centerY = event.rect.y + event.rect.h * 0.5f;
+        switch (event.type) {
+        case GAME_EVENT_HIT:
+            if (event.flags & GAME_EVENT_EXPLOSIVE) {
+                emitParticles(system, centerX, centerY, &EXPLOSION_FIRE);
+                emitParticles(system, centerX, centerY, &EXPLOSION_SMOKE);
+            } else {
+                emitParticles(system, centerX, centerY, &HIT_SPARKS);
+            }
+            break;
+        case GAME_EVENT_DESTROYED:
+            emitParticles(system, centerX, centerY, &WRECK_FIRE);
+            emitParticles(system, centerX, centerY, &WRECK_SMOKE);
+            break;
+        case GAME_EVENT_REFLECTED:
+            emitParticles(system, centerX, centerY, &SHIELD_SPARKS);
+            break;
+        case GAME_EVENT_PICKED_UP:
+            emitParticles(system, centerX, centerY, event.target == 0 ? &SHIELD_GLITTER : &POWER_UP_GLITTER);
+            break;
+        case GAME_EVENT_OBSTACLE_DESTROYED:
+            emitParticles(system, centerX, centerY, (event.flags & GAME_EVENT_GRASS) ? &GRASS_DEBRIS : &ROCK_DEBRIS);
+            break;
+        }
+    }
+}
+
+// Function to integrate particles [0, count) and return whether any ran out of life
+static bool advanceParticles(ParticleSystem* system, float seconds, float drag) {
+    float* x = system->x.data();
+    float* y = system->y.data();
+    float* velocityX = system->velocityX.data();
+    float* velocityY = system->velocityY.data();
+    float* life = system->life.data();
+    int count = system->count;
+    int i = 0;
+    int dead = 0;
+
+#ifdef PARTICLE_SYSTEM_AVX
+    const __m256 seconds8 = _mm256_set1_ps(seconds);
+    const __m256 drag8 = _mm256_set1_ps(drag);
+    const __m256 zero8 = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        __m256 vx = _mm256_loadu_ps(velocityX + i);
+        __m256 vy = _mm256_loadu_ps(velocityY + i);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(vx, seconds8)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(vy, seconds8)));
+        _mm256_storeu_ps(velocityX + i, _mm256_mul_ps(vx, drag8));
+        _mm256_storeu_ps(velocityY + i, _mm256_mul_ps(vy, drag8));
+        __m256 left = _mm256_sub_ps(_mm256_loadu_ps(life + i), seconds8);
+        _mm256_storeu_ps(life + i, left);
+        dead |= _mm256_movemask_ps(_mm256_cmp_ps(left, zero8, _CMP_LE_OQ));
+    }
+#endif
+
+#ifdef PARTICLE_SYSTEM_SSE2
+    const __m128 seconds4 = _mm_set1_ps(seconds);
+    const __m128 drag4 = _mm_set1_ps(drag);
+    const __m128 zero4 = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(velocityX + i);
+        __m128 vy = _mm_loadu_ps(velocityY + i);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(vx, seconds4)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(vy, seconds4)));
+        _mm_storeu_ps(velocityX + i, _mm_mul_ps(vx, drag4));
+        _mm_storeu_ps(velocityY + i, _mm_mul_ps(vy, drag4));
+        __m128 left = _mm_sub_ps(_mm_loadu_ps(life + i), seconds4);
+        _mm_storeu_ps(life + i, left);
+        dead |= _mm_movemask_ps(_mm_cmple_ps(left, zero4));
+    }
+#endif
+
+    // Remaining particles (or everything without SIMD)
+    for (; i < count; i++) {
+        x[i] += velocityX[i] * seconds;
+        y[i] += velocityY[i] * seconds;
+        velocityX[i] *= drag;
+        velocityY[i] *= drag;
+        life[i] -= seconds;
+        dead |= life[i] <= 0.0f;
+    }
+    return dead != 0;
+}
+
+// Function to pack the live particles to the front, keeping their order (oldest first)
+static void compactParticles(ParticleSystem* system) {
+    int live = 0;
+    for (int i = 0; i < system->count; i++) {
+        if (system->life[i] <= 0.0f) continue;
+        if (live != i) {
+            system->x[live] = system->x[i];
+            system->y[live] = system->y[i];
+            system->velocityX[live] = system->velocityX[i];
+            system->velocityY[live] = system->velocityY[i];
+            system->life[live] = system->life[i];
+            system->fade[live] = system->fade[i];
+            system->size[live] = system->size[i];
+            system->color[live] = system->color[i];
+        }
+        live++;
+    }
+    system->count = live;
+    if (system->recycleCursor > live) system->recycleCursor = 0;
+}
+
+// Function to move every particle by seconds and remove the ones that ran out of life
+void updateParticles(ParticleSystem* system, float seconds) {
+    if (system->count == 0) return;
+    float drag = powf(PARTICLE_DRAG, seconds);
+    if (advanceParticles(system, seconds, drag)) {
+        compactParticles(system);
+    }
+}
+
+// Function to feed back one frame's update and draw time
+void adjustParticleQuality(ParticleSystem* system, double costMs) {
+    system->costMs = costMs;
+    if (costMs > PARTICLE_BUDGET_MS) {
+        // Cost follows the particle count, so scale the emission down by the overshoot
+        system->quality = std::max(PARTICLE_MIN_QUALITY, (float)(system->quality * PARTICLE_BUDGET_MS / costMs));
+    } else {
+        system->quality = std::min(1.0f, system->quality + PARTICLE_QUALITY_RECOVERY);
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+// Structure-of-arrays particle system for hit sparks, explosions and
+// obstacle debris. Particles are cosmetic: they are emitted from a
+// tick's gameplay events on the drawing side and never touch World, so
+// the simulation (and its hash) is the same with or without them.
+//
+// Each particle field lives in its own array and the live particles are
+// kept packed at the front, so the per-frame update is one SIMD pass
+// over contiguous floats followed by a stable compaction of the ones
+// that ran out of life. Update plus drawing has a millisecond budget:
+// a frame over it lowers the quality, and every later burst emits that
+// fraction of its particles (never fewer than PARTICLE_MIN_BURST). When
+// the arrays are full a burst overwrites the oldest particles, so an
+// effect is thinned out but never dropped.
+
+#include "game.h"
+#include "game_events.h"
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// Particles alive at once
+const int PARTICLE_CAPACITY = 65536;
+
+// Time allowed for the particle update and draw per frame (milliseconds)
+const double PARTICLE_BUDGET_MS = 2.0;
+
+// Quality limits: bursts emit between PARTICLE_MIN_QUALITY and all of their particles
+const float PARTICLE_MIN_QUALITY = 0.05f;
+const float PARTICLE_QUALITY_RECOVERY = 0.02f; // Regained per frame under budget
+const int PARTICLE_MIN_BURST = 4;
+
+// Fraction of a particle's speed left after one second
+const float PARTICLE_DRAG = 0.1f;
+
+// Structure for what one burst looks like
+struct ParticleBurst {
+    int count; // Particles at full quality
+    float spread; // Spawn radius around the burst center (pixels)
+    float minSpeed; // Pixels per second
+    float maxSpeed;
+    float minLife; // Seconds
+    float maxLife;
+    float minSize; // Pixels
+    float maxSize;
+    SDL_Color color; // Each particle gets a random blend of the two
+    SDL_Color otherColor;
+};
+
+// Structure for all particles; index i is one particle across every array, live ones are [0, count)
+struct ParticleSystem {
+    std::vector<float> x; // Center, world pixels
+    std::vector<float> y;
+    std::vector<float> velocityX; // Pixels per second
+    std::vector<float> velocityY;
+    std::vector<float> life; // Seconds left
+    std::vector<float> fade; // 1 / lifetime, so life * fade is the alpha from 1 down to 0
+    std::vector<float> size;
+    std::vector<SDL_Color> color;
+    int count;
+    int capacity;
+    int recycleCursor; // Next slot a burst overwrites when full (the front holds the oldest)
+    float quality; // Fraction of each burst emitted
+    GameRng rng; // Its own, so the match's random numbers are untouched
+    uint64_t emitted; // Particles emitted
+    uint64_t skipped; // Particles left out by the quality
+    uint64_t recycled; // Particles overwritten while full
+    double costMs; // Update and draw time of the last frame
+};
+
+// Function to allocate the arrays and empty the system
+void initializeParticleSystem(ParticleSystem* system, int capacity = PARTICLE_CAPACITY);
+
+// Function to remove every particle
+void clearParticles(ParticleSystem* system);
+
+// Function to emit a burst centered on (x, y) at the current quality (returns the particles emitted)
+int emitParticles(ParticleSystem* system, float x, float y, const ParticleBurst* burst);
+
+// Function to emit the bursts of a tick's gameplay events
+void emitEventParticles(ParticleSystem* system, const GameEvent* events, int count);
+
+// Function to move every particle by seconds and remove the ones that ran out of life
+void updateParticles(ParticleSystem* system, float seconds);
+
+// Function to feed back one frame's update and draw time, raising or lowering the quality
+void adjustParticleQuality(ParticleSystem* system, double costMs);
@@ -0,0 +1,253 @@
+#include "profiler.h"
+#include "log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// Structure for one recorded zone instance
+struct ProfileEvent {
+    int64_t start; // Nanoseconds since the profiler started
+    int64_t end;
+    uint32_t frame;
+    int16_t zone;
+    int16_t depth;
+};
+
+// Structure for all profiler state (one per process)
+struct Profiler {
+    std::mutex zonesMutex; // Only taken when registering a zone
+    const char* zoneNames[PROFILER_MAX_ZONES];
+    int zoneDepth[PROFILER_MAX_ZONES];
+    int zoneCount = 0;
+
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    uint32_t frameIndex = 0;
+    bool frameOpen = false;
+
+    // Open zones of the current frame
+    int stackZone[PROFILER_MAX_DEPTH];
+    int64_t stackStart[PROFILER_MAX_DEPTH];
+    int depth = 0;
+
+    // Time per zone in the current frame, and the rolling history of finished frames
+    int64_t current[PROFILER_MAX_ZONES] = {};
+    std::vector<int64_t> history = std::vector<int64_t>((size_t)PROFILER_HISTORY_FRAMES * PROFILER_MAX_ZONES, 0);
+    std::vector<uint32_t> historyFrame = std::vector<uint32_t>(PROFILER_HISTORY_FRAMES, 0);
+    int historyCount = 0;
+    int historyNext = 0;
+
+    // Ring of recent zone instances for trace export
+    std::vector<ProfileEvent> events = std::vector<ProfileEvent>(PROFILER_MAX_EVENTS);
+    size_t eventCount = 0; // Total ever recorded (ring index is eventCount % size)
+
+    Profiler() {
+        zoneNames[PROFILE_FRAME_ZONE] = "Frame";
+        zoneDepth[PROFILE_FRAME_ZONE] = 0;
+        zoneCount = 1;
+    }
+};
+
+// True on the thread running the profiled frames
+static thread_local bool isProfiledThread = false;
+
+// Function to get the process-wide profiler
+static Profiler& getProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+// Function to get nanoseconds since the profiler started
+static int64_t profileNow(const Profiler& profiler) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profiler.epoch).count();
+}
+
+// Function to get the id of a zone name
+int registerProfileZone(const char* name) {
+    Profiler& profiler = getProfiler();
+    std::lock_guard<std::mutex> lock(profiler.zonesMutex);
+    for (int i = 0; i < profiler.zoneCount; i++) {
+        if (strcmp(profiler.zoneNames[i], name) == 0) {
+            return i;
+        }
+    }
+    if (profiler.zoneCount >= PROFILER_MAX_ZONES) {
+        LOG_WARN("[PROFILER] Too many zones, '%s' is merged into Frame", name);
+        return PROFILE_FRAME_ZONE;
+    }
+    profiler.zoneNames[profiler.zoneCount] = name;
+    profiler.zoneDepth[profiler.zoneCount] = 1;
+    return profiler.zoneCount++;
+}
+
+// Function to open a zone
+void beginProfileZone(int zone) {
+    if (!isProfiledThread) return;
+    Profiler& profiler = getProfiler();
+    if (!profiler.frameOpen || profiler.depth >= PROFILER_MAX_DEPTH) return;
+
+    profiler.stackZone[profiler.depth] = zone;
+    profiler.stackStart[profiler.depth] = profileNow(profiler);
+    profiler.depth++;
+}
+
+// Function to close a zone
+void endProfileZone(int zone) {
+    if (!isProfiledThread) return;
+    Profiler& profiler = getProfiler();
+    if (profiler.depth == 0 || profiler.stackZone[profiler.depth - 1] != zone) return;
+
+    profiler.depth--;
+    int64_t start = profiler.stackStart[profiler.depth];
+    int64_t end = profileNow(profiler);
+    profiler.current[zone] += end - start;
+    profiler.zoneDepth[zone] = profiler.depth;
+
+    ProfileEvent& event = profiler.events[profiler.eventCount % profiler.events.size()];
+    event.start = start;
+    event.end = end;
+    event.frame = profiler.frameIndex;
+    event.zone = (int16_t)zone;
+    event.depth = (int16_t)profiler.depth;
+    profiler.eventCount++;
+}
+
+// Function to start a frame
+void beginProfileFrame() {
+    Profiler& profiler = getProfiler();
+    isProfiledThread = true;
+    if (profiler.frameOpen) {
+        endProfileFrame();
+    }
+
+    memset(profiler.current, 0, sizeof(profiler.current));
+    profiler.depth = 0;
+    profiler.frameOpen = true;
+    beginProfileZone(PROFILE_FRAME_ZONE);
+}
+
+// Function to end the frame and store its zone totals in the history
+void endProfileFrame() {
+    Profiler& profiler = getProfiler();
+    if (!profiler.frameOpen) return;
+
+    // Close anything left open, then the frame zone itself
+    while (profiler.depth > 0) {
+        endProfileZone(profiler.stackZone[profiler.depth - 1]);
+    }
+    profiler.frameOpen = false;
+
+    int64_t* slot = &profiler.history[(size_t)profiler.historyNext * PROFILER_MAX_ZONES];
+    memcpy(slot, profiler.current, sizeof(profiler.current));
+    profiler.historyFrame[profiler.historyNext] = profiler.frameIndex;
+    profiler.historyNext = (profiler.historyNext + 1) % PROFILER_HISTORY_FRAMES;
+    profiler.historyCount = std::min(profiler.historyCount + 1, PROFILER_HISTORY_FRAMES);
+    profiler.frameIndex++;
+}
+
+// Function to get the number of registered zones
+int getProfileZoneCount() {
+    Profiler& profiler = getProfiler();
+    std::lock_guard<std::mutex> lock(profiler.zonesMutex);
+    return profiler.zoneCount;
+}
+
+// Function to get the value at a percentile of sorted-on-demand samples
+static float percentile(std::vector<int64_t>& samples, float fraction) {
+    size_t index = (size_t)(fraction * (samples.size() - 1) + 0.5f);
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index] / 1e6f;
+}
+
+// Function to get percentiles of one zone over the history window
+ProfileZoneStats getProfileZoneStats(int zone) {
+    Profiler& profiler = getProfiler();
+    ProfileZoneStats stats = {};
+    stats.name = profiler.zoneNames[zone];
+    stats.depth = profiler.zoneDepth[zone];
+    if (profiler.historyCount == 0) return stats;
+
+    std::vector<int64_t> samples(profiler.historyCount);
+    for (int i = 0; i < profiler.historyCount; i++) {
+        samples[i] = profiler.history[(size_t)i * PROFILER_MAX_ZONES + zone];
+    }
+    stats.p50 = percentile(samples, 0.50f);
+    stats.p95 = percentile(samples, 0.95f);
+    stats.p99 = percentile(samples, 0.99f);
+    stats.max = *std::max_element(samples.begin(), samples.end()) / 1e6f;
+    return stats;
+}
+
+// Function to copy the last count frame times (ms, oldest first)
+int getProfileFrameTimes(float* frameTimes, int count) {
+    Profiler& profiler = getProfiler();
+    count = std::min(count, profiler.historyCount);
+    for (int i = 0; i < count; i++) {
+        int slot = (profiler.historyNext - count + i + PROFILER_HISTORY_FRAMES) % PROFILER_HISTORY_FRAMES;
+        frameTimes[i] = profiler.history[(size_t)slot * PROFILER_MAX_ZONES + PROFILE_FRAME_ZONE] / 1e6f;
+    }
+    return count;
+}
+
+// Function to write the recorded zone instances as Chrome trace JSON
+bool exportProfileTrace(const std::string& path) {
+    Profiler& profiler = getProfiler();
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("[PROFILER] Unable to write %s", path.c_str());
+        return false;
+    }
+
+    size_t ringSize = profiler.events.size();
+    size_t count = std::min(profiler.eventCount, ringSize);
+    size_t first = profiler.eventCount - count;
+
+    // Complete ("X") events, timestamps in microseconds
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Main loop\"}}");
+    for (size_t i = first; i < profiler.eventCount; i++) {
+        const ProfileEvent& event = profiler.events[i % ringSize];
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+                profiler.zoneNames[event.zone], event.start / 1000.0, (event.end - event.start) / 1000.0, event.frame);
+    }
+    fprintf(file, "\n]}\n");
+    bool success = ferror(file) == 0;
+    fclose(file);
+
+    LOG_INFO("[PROFILER] Wrote %zu zone events to %s", count, path.c_str());
+    return success;
+}
+
+// Function to write per-frame zone totals (ms) of the history window as CSV
+bool exportProfileCsv(const std::string& path) {
+    Profiler& profiler = getProfiler();
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("[PROFILER] Unable to write %s", path.c_str());
+        return false;
+    }
+
+    int zoneCount = getProfileZoneCount();
+    fprintf(file, "frame");
+    for (int zone = 0; zone < zoneCount; zone++) {
+        fprintf(file, ",%s_ms", profiler.zoneNames[zone]);
+    }
+    fprintf(file, "\n");
+
+    // Oldest frame first
+    for (int i = 0; i < profiler.historyCount; i++) {
+        int slot = (profiler.historyNext - profiler.historyCount + i + PROFILER_HISTORY_FRAMES) % PROFILER_HISTORY_FRAMES;
+        fprintf(file, "%u", profiler.historyFrame[slot]);
+        for (int zone = 0; zone < zoneCount; zone++) {
+            fprintf(file, ",%.4f", profiler.history[(size_t)slot * PROFILER_MAX_ZONES + zone] / 1e6);
+        }
+        fprintf(file, "\n");
+    }
+    bool success = ferror(file) == 0;
+    fclose(file);
+
+    LOG_INFO("[PROFILER] Wrote %d frames to %s", profiler.historyCount, path.c_str());
+    return success;
+}
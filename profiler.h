@@ -0,0 +1,86 @@
+#pragma once
+
+// Frame profiler. Code marks phases with PROFILE_ZONE("name"), which
+// times the enclosing scope. Each frame's per-zone totals go into a
+// rolling history for percentiles (p50/p95/p99), and every zone instance
+// is kept in a ring buffer that can be exported as a Chrome trace
+// (chrome://tracing or ui.perfetto.dev) or as per-frame CSV.
+//
+// Zones are only recorded on the thread that calls beginProfileFrame()
+// (the main loop). Zones hit on other threads are ignored.
+//
+// Build with PROFILER_ENABLED=0 to compile every zone out.
+
+#include <cstdint>
+#include <string>
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+// Sizing
+const int PROFILER_MAX_ZONES = 64; // Distinct zone names
+const int PROFILER_HISTORY_FRAMES = 600; // Frames kept for percentiles (several seconds)
+const int PROFILER_MAX_EVENTS = 65536; // Zone instances kept for trace export
+const int PROFILER_MAX_DEPTH = 32; // Nesting limit for zones
+
+// Zone 0 always measures the whole frame
+const int PROFILE_FRAME_ZONE = 0;
+
+// Structure for one zone's timing over the history window (milliseconds)
+struct ProfileZoneStats {
+    const char* name;
+    int depth; // Nesting depth the zone was last seen at (for indenting)
+    float p50;
+    float p95;
+    float p99;
+    float max;
+};
+
+// Function to get the id of a zone name (the same name always gets the same id)
+int registerProfileZone(const char* name);
+
+// Functions to open and close a zone (prefer PROFILE_ZONE)
+void beginProfileZone(int zone);
+void endProfileZone(int zone);
+
+// Function to start a frame (the calling thread becomes the profiled thread)
+void beginProfileFrame();
+
+// Function to end the frame and store its zone totals in the history
+void endProfileFrame();
+
+// Function to get the number of registered zones
+int getProfileZoneCount();
+
+// Function to get percentiles of one zone over the history window
+ProfileZoneStats getProfileZoneStats(int zone);
+
+// Function to copy the last count frame times (ms, oldest first), returns how many were copied
+int getProfileFrameTimes(float* frameTimes, int count);
+
+// Function to write the recorded zone instances as Chrome trace JSON
+bool exportProfileTrace(const std::string& path);
+
+// Function to write per-frame zone totals (ms) of the history window as CSV
+bool exportProfileCsv(const std::string& path);
+
+// Structure that times its own lifetime as a zone
+struct ProfileScope {
+    int zone;
+    explicit ProfileScope(int zoneId) : zone(zoneId) { beginProfileZone(zone); }
+    ~ProfileScope() { endProfileZone(zone); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_ZONE(name) \
+    static const int PROFILE_CONCAT(profileZone, __LINE__) = registerProfileZone(name); \
+    ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileZone, __LINE__))
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
@@ -0,0 +1,137 @@
+#include "profiler_overlay.h"
+#include "profiler.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Overlay layout (pixels)
+const int OVERLAY_FONT_SCALE = 2; // Each font pixel is a 2x2 block
+const int OVERLAY_CHAR_ADVANCE = 4 * OVERLAY_FONT_SCALE;
+const int OVERLAY_LINE_HEIGHT = 6 * OVERLAY_FONT_SCALE;
+const int OVERLAY_PADDING = 6;
+const int OVERLAY_NAME_CHARS = 13;
+const int OVERLAY_GRAPH_FRAMES = 150;
+const int OVERLAY_GRAPH_HEIGHT = 60;
+const float OVERLAY_GRAPH_MAX_MS = 33.3f; // Top of the graph (two 60 Hz frames)
+const float OVERLAY_BUDGET_MS = 1000.0f / 60.0f; // Line marking one 60 Hz frame
+const int OVERLAY_REFRESH_FRAMES = 30; // Percentiles are recomputed this often
+
+// Structure for one 3x5 glyph ('#' = lit pixel)
+struct OverlayGlyph {
+    char character;
+    const char* rows[5];
+};
+
+// Pixel font covering what zone names and numbers need
+static const OverlayGlyph OVERLAY_FONT[] = {
+    {'0', {"###", "#.#", "#.#", "#.#", "###"}}, {'1', {".#.", "##.", ".#.", ".#.", "###"}},
+    {'2', {"###", "..#", "###", "#..", "###"}}, {'3', {"###", "..#", ".##", "..#", "###"}},
+    {'4', {"#.#", "#.#", "###", "..#", "..#"}}, {'5', {"###", "#..", "###", "..#", "###"}},
+    {'6', {"###", "#..", "###", "#.#", "###"}}, {'7', {"###", "..#", ".#.", ".#.", ".#."}},
+    {'8', {"###", "#.#", "###", "#.#", "###"}}, {'9', {"###", "#.#", "###", "..#", "###"}},
+    {'A', {".#.", "#.#", "###", "#.#", "#.#"}}, {'B', {"##.", "#.#", "##.", "#.#", "##."}},
+    {'C', {".##", "#..", "#..", "#..", ".##"}}, {'D', {"##.", "#.#", "#.#", "#.#", "##."}},
+    {'E', {"###", "#..", "##.", "#..", "###"}}, {'F', {"###", "#..", "##.", "#..", "#.."}},
+    {'G', {".##", "#..", "#.#", "#.#", ".##"}}, {'H', {"#.#", "#.#", "###", "#.#", "#.#"}},
+    {'I', {"###", ".#.", ".#.", ".#.", "###"}}, {'J', {"..#", "..#", "..#", "#.#", ".#."}},
+    {'K', {"#.#", "#.#", "##.", "#.#", "#.#"}}, {'L', {"#..", "#..", "#..", "#..", "###"}},
+    {'M', {"#.#", "###", "###", "#.#", "#.#"}}, {'N', {"##.", "#.#", "#.#", "#.#", "#.#"}},
+    {'O', {".#.", "#.#", "#.#", "#.#", ".#."}}, {'P', {"##.", "#.#", "##.", "#..", "#.."}},
+    {'Q', {".#.", "#.#", "#.#", "##.", ".##"}}, {'R', {"##.", "#.#", "##.", "#.#", "#.#"}},
+    {'S', {".##", "#..", ".#.", "..#", "##."}}, {'T', {"###", ".#.", ".#.", ".#.", ".#."}},
+    {'U', {"#.#", "#.#", "#.#", "#.#", "###"}}, {'V', {"#.#", "#.#", "#.#", "#.#", ".#."}},
+    {'W', {"#.#", "#.#", "###", "###", "#.#"}}, {'X', {"#.#", "#.#", ".#.", "#.#", "#.#"}},
+    {'Y', {"#.#", "#.#", ".#.", ".#.", ".#."}}, {'Z', {"###", "..#", ".#.", "#..", "###"}},
+    {'.', {"...", "...", "...", "...", ".#."}}, {':', {"...", ".#.", "...", ".#.", "..."}},
+    {'-', {"...", "...", "###", "...", "..."}}, {'/', {"..#", "..#", ".#.", "#..", "#.."}},
+    {'%', {"#.#", "..#", ".#.", "#..", "#.#"}}, {'(', {".#.", "#..", "#..", "#..", ".#."}},
+    {')', {".#.", "..#", "..#", "..#", ".#."}}, {'>', {"#..", ".#.", "..#", ".#.", "#.."}},
+};
+
+// Function to draw text with the pixel font (unknown characters are left blank)
+static void drawOverlayText(SpriteBatch* batch, const char* text, int x, int y, SDL_Color color) {
+    for (const char* c = text; *c; c++, x += OVERLAY_CHAR_ADVANCE) {
+        char upper = (char)toupper((unsigned char)*c);
+        for (const OverlayGlyph& glyph : OVERLAY_FONT) {
+            if (glyph.character != upper) continue;
+
+            for (int row = 0; row < 5; row++) {
+                for (int column = 0; column < 3; column++) {
+                    if (glyph.rows[row][column] == '#') {
+                        SDL_Rect pixel = {x + column * OVERLAY_FONT_SCALE, y + row * OVERLAY_FONT_SCALE,
+                                          OVERLAY_FONT_SCALE, OVERLAY_FONT_SCALE};
+                        drawBatchRect(batch, pixel, color);
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+
+// Function to draw the profiler overlay with its top-left corner at (x, y)
+void drawProfilerOverlay(SpriteBatch* batch, int x, int y) {
+    // Percentiles over hundreds of frames are too costly (and too jumpy to read) every frame
+    static std::vector<ProfileZoneStats> stats;
+    static int framesUntilRefresh = 0;
+    if (--framesUntilRefresh <= 0 || stats.empty()) {
+        framesUntilRefresh = OVERLAY_REFRESH_FRAMES;
+        int zoneCount = getProfileZoneCount();
+        stats.resize(zoneCount);
+        for (int zone = 0; zone < zoneCount; zone++) {
+            stats[zone] = getProfileZoneStats(zone);
+        }
+    }
+
+    int columnWidth = 6 * OVERLAY_CHAR_ADVANCE;
+    int width = 2 * OVERLAY_PADDING + (OVERLAY_NAME_CHARS + 1) * OVERLAY_CHAR_ADVANCE + 4 * columnWidth;
+    int tableTop = y + OVERLAY_PADDING + OVERLAY_GRAPH_HEIGHT + OVERLAY_PADDING;
+    int height = tableTop - y + (int)(stats.size() + 1) * OVERLAY_LINE_HEIGHT + OVERLAY_PADDING;
+
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Color grey = {170, 170, 170, 255};
+    drawBatchRect(batch, SDL_Rect{x, y, width, height}, SDL_Color{0, 0, 0, 190});
+
+    // Frame-time graph, newest frame on the right
+    float frameTimes[OVERLAY_GRAPH_FRAMES];
+    int frameCount = getProfileFrameTimes(frameTimes, OVERLAY_GRAPH_FRAMES);
+    int graphLeft = x + OVERLAY_PADDING;
+    int graphBottom = y + OVERLAY_PADDING + OVERLAY_GRAPH_HEIGHT;
+    int barWidth = (width - 2 * OVERLAY_PADDING) / OVERLAY_GRAPH_FRAMES;
+    for (int i = 0; i < frameCount; i++) {
+        float ms = frameTimes[i] < OVERLAY_GRAPH_MAX_MS ? frameTimes[i] : OVERLAY_GRAPH_MAX_MS;
+        int barHeight = (int)(ms / OVERLAY_GRAPH_MAX_MS * OVERLAY_GRAPH_HEIGHT) + 1;
+        int barX = graphLeft + (OVERLAY_GRAPH_FRAMES - frameCount + i) * barWidth;
+        SDL_Color color = frameTimes[i] <= OVERLAY_BUDGET_MS ? SDL_Color{60, 200, 60, 255} : SDL_Color{230, 60, 40, 255};
+        drawBatchRect(batch, SDL_Rect{barX, graphBottom - barHeight, barWidth, barHeight}, color);
+    }
+    int budgetY = graphBottom - (int)(OVERLAY_BUDGET_MS / OVERLAY_GRAPH_MAX_MS * OVERLAY_GRAPH_HEIGHT);
+    drawBatchRect(batch, SDL_Rect{graphLeft, budgetY, width - 2 * OVERLAY_PADDING, 1}, SDL_Color{255, 220, 0, 200});
+
+    // Zone table (milliseconds per frame)
+    int nameX = x + OVERLAY_PADDING;
+    int firstColumnX = nameX + (OVERLAY_NAME_CHARS + 1) * OVERLAY_CHAR_ADVANCE;
+    const char* headers[4] = {"P50", "P95", "P99", "MAX"};
+    drawOverlayText(batch, "ZONE MS", nameX, tableTop, grey);
+    for (int column = 0; column < 4; column++) {
+        drawOverlayText(batch, headers[column], firstColumnX + column * columnWidth, tableTop, grey);
+    }
+
+    char text[32];
+    for (size_t zone = 0; zone < stats.size(); zone++) {
+        int rowY = tableTop + (int)(zone + 1) * OVERLAY_LINE_HEIGHT;
+        const ProfileZoneStats& zoneStats = stats[zone];
+
+        // Nested zones are indented one character per level
+        int indent = zoneStats.depth < 3 ? zoneStats.depth : 3;
+        snprintf(text, sizeof(text), "%.*s", OVERLAY_NAME_CHARS - indent, zoneStats.name);
+        drawOverlayText(batch, text, nameX + indent * OVERLAY_CHAR_ADVANCE, rowY, white);
+
+        float values[4] = {zoneStats.p50, zoneStats.p95, zoneStats.p99, zoneStats.max};
+        for (int column = 0; column < 4; column++) {
+            snprintf(text, sizeof(text), "%5.2f", values[column]);
+            drawOverlayText(batch, text, firstColumnX + column * columnWidth, rowY, white);
+        }
+    }
+}
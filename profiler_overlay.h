@@ -0,0 +1,10 @@
+#pragma once
+
+// On-screen view of the frame profiler: a frame-time graph plus a table
+// of p50/p95/p99/max per zone, drawn through the sprite batch with a
+// built-in pixel font (no font files needed).
+
+#include "sprite_batch.h"
+
+// Function to draw the profiler overlay with its top-left corner at (x, y)
+void drawProfilerOverlay(SpriteBatch* batch, int x, int y);
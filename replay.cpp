@@ -0,0 +1,132 @@
+#include "replay.h"
+#include "log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+static_assert(sizeof(ReplayHeader) == 40, "ReplayHeader layout is part of the file format");
+
+// Function to start recording a match that was just initialized
+void beginReplay(Replay* replay, const World* world) {
+    replay->seed = world->seed;
+    replay->mapHash = world->map->hash;
+    replay->tankWidth = world->tankWidth;
+    replay->tankHeight = world->tankHeight;
+    replay->tankCount = world->tanks.count;
+    replay->inputs.clear();
+    replay->hashes.clear();
+}
+
+// Function to record one tick
+void recordReplayTick(Replay* replay, const TankInput* inputs, const World* world) {
+    for (int i = 0; i < replay->tankCount; i++) {
+        replay->inputs.push_back(packTankInput(inputs[i]));
+    }
+    replay->hashes.push_back(foldWorldHash(hashWorld(world)));
+}
+
+// Function to write a replay to disk
+bool saveReplay(const Replay* replay, const std::string& path) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        LOG_ERROR("[REPLAY] Unable to write %s", path.c_str());
+        return false;
+    }
+
+    ReplayHeader header = {};
+    memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+    header.version = REPLAY_VERSION;
+    header.seed = replay->seed;
+    header.mapHash = replay->mapHash;
+    header.tankWidth = replay->tankWidth;
+    header.tankHeight = replay->tankHeight;
+    header.tickCount = (uint32_t)replay->hashes.size();
+    header.tankCount = (uint32_t)replay->tankCount;
+
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(replay->inputs.data(), 1, replay->inputs.size(), file);
+    fwrite(replay->hashes.data(), sizeof(uint32_t), replay->hashes.size(), file);
+    bool success = ferror(file) == 0;
+    fclose(file);
+
+    if (success) {
+        LOG_INFO("[REPLAY] Saved %u ticks (seed %llu) to %s", header.tickCount,
+                 (unsigned long long)header.seed, path.c_str());
+    } else {
+        LOG_ERROR("[REPLAY] Failed while writing %s", path.c_str());
+    }
+    return success;
+}
+
+// Function to read a replay from disk
+bool loadReplay(Replay* replay, const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        LOG_ERROR("[REPLAY] Unable to open %s", path.c_str());
+        return false;
+    }
+
+    ReplayHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) != 0) {
+        LOG_ERROR("[REPLAY] %s is not a replay", path.c_str());
+        fclose(file);
+        return false;
+    }
+    if (header.version != REPLAY_VERSION) {
+        LOG_ERROR("[REPLAY] %s has version %u, expected %u", path.c_str(), header.version, REPLAY_VERSION);
+        fclose(file);
+        return false;
+    }
+    if (header.tankCount < 1 || header.tankCount > (uint32_t)MAX_TANKS) {
+        LOG_ERROR("[REPLAY] %s has %u tanks, expected 1 to %d", path.c_str(), header.tankCount, MAX_TANKS);
+        fclose(file);
+        return false;
+    }
+
+    replay->seed = header.seed;
+    replay->mapHash = header.mapHash;
+    replay->tankWidth = header.tankWidth;
+    replay->tankHeight = header.tankHeight;
+    replay->tankCount = (int)header.tankCount;
+    replay->inputs.resize((size_t)header.tickCount * header.tankCount);
+    replay->hashes.resize(header.tickCount);
+    bool complete = fread(replay->inputs.data(), 1, replay->inputs.size(), file) == replay->inputs.size() &&
+                    fread(replay->hashes.data(), sizeof(uint32_t), replay->hashes.size(), file) == replay->hashes.size();
+    fclose(file);
+
+    if (!complete) {
+        LOG_ERROR("[REPLAY] %s is truncated", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Function to re-simulate a replay on its map and compare every tick's hash
+ReplayResult playReplay(const Replay* replay, const GameMap* map) {
+    ReplayResult result = {};
+    result.firstDivergentTick = -1;
+
+    World world;
+    initializeWorld(&world, map, replay->tankWidth, replay->tankHeight, replay->seed, replay->tankCount);
+    std::vector<TankInput> inputs(replay->tankCount);
+
+    auto start = std::chrono::steady_clock::now();
+    int tickCount = (int)replay->hashes.size();
+    for (int tick = 0; tick < tickCount; tick++) {
+        for (int i = 0; i < replay->tankCount; i++) {
+            inputs[i] = unpackTankInput(replay->inputs[(size_t)tick * replay->tankCount + i]);
+        }
+        stepWorld(&world, inputs.data());
+
+        // Keep going after a mismatch so the timing still covers the whole match
+        if (result.firstDivergentTick < 0 && foldWorldHash(hashWorld(&world)) != replay->hashes[tick]) {
+            result.firstDivergentTick = tick;
+            LOG_WARN("[REPLAY] State diverged at tick %d", tick);
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.ticks = tickCount;
+    result.winner = world.winner;
+    return result;
+}
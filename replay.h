@@ -0,0 +1,66 @@
+#pragma once
+
+// Match recording and deterministic playback. A replay stores the match
+// seed, which map it was played on, the tank size and count, and every
+// tank's packed input for every tick, plus a hash of the world after each
+// tick. Playing it back re-simulates
+// the match headless as fast as possible and reports the first tick
+// whose hash differs from the recording.
+//
+// File layout (little-endian): ReplayHeader, then tickCount groups of
+// tankCount input bytes (tank 0 first), then tickCount uint32 state hashes.
+
+#include "world.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const char REPLAY_MAGIC[4] = {'T', 'R', 'P', 'L'};
+const uint32_t REPLAY_VERSION = 4;
+
+// Structure for the start of a replay file
+struct ReplayHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t seed;
+    uint64_t mapHash; // GameMap::hash of the arena
+    int32_t tankWidth;
+    int32_t tankHeight;
+    uint32_t tickCount;
+    uint32_t tankCount;
+};
+
+// Structure for one recorded match
+struct Replay {
+    uint64_t seed;
+    uint64_t mapHash;
+    int tankWidth;
+    int tankHeight;
+    int tankCount;
+    std::vector<uint8_t> inputs; // tankCount packed TankInputs per tick
+    std::vector<uint32_t> hashes; // World hash after each tick
+};
+
+// Structure for the outcome of a playback
+struct ReplayResult {
+    int ticks; // Ticks simulated
+    int firstDivergentTick; // First tick whose hash did not match (-1 = none)
+    int winner; // World winner after the last tick
+    double seconds; // Wall-clock time spent simulating
+};
+
+// Function to start recording a match that was just initialized
+void beginReplay(Replay* replay, const World* world);
+
+// Function to record one tick (call right after stepWorld with the inputs it was given)
+void recordReplayTick(Replay* replay, const TankInput* inputs, const World* world);
+
+// Function to write a replay to disk
+bool saveReplay(const Replay* replay, const std::string& path);
+
+// Function to read a replay from disk (false if missing or malformed)
+bool loadReplay(Replay* replay, const std::string& path);
+
+// Function to re-simulate a replay on its map and compare every tick's hash
+// (check replay->mapHash against map->hash first)
+ReplayResult playReplay(const Replay* replay, const GameMap* map);
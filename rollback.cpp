@@ -0,0 +1,563 @@
+#include "rollback.h"
+#include "log.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+// No pending rollback
+const uint32_t ROLLBACK_NONE = UINT32_MAX;
+
+// Ticks between waits that let a peer running behind catch up
+const int ROLLBACK_SYNC_INTERVAL = 30;
+
+// Seconds between NET_HELLO messages while joining
+const double NETPLAY_HELLO_INTERVAL = 0.25;
+
+// Function to get the session clock in seconds
+static double getNetplayTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Function to fill in the fields every message starts with
+static void fillPacketHeader(NetPacketHeader* header, uint8_t type) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, NETPLAY_MAGIC, sizeof(header->magic));
+    header->type = type;
+    header->version = NETPLAY_VERSION;
+}
+
+// Function to read and check the header of a received message
+static bool readPacketHeader(const uint8_t* data, int size, NetPacketHeader* header) {
+    if (size < (int)sizeof(NetPacketHeader)) return false;
+    memcpy(header, data, sizeof(*header));
+    return memcmp(header->magic, NETPLAY_MAGIC, sizeof(header->magic)) == 0 && header->version == NETPLAY_VERSION;
+}
+
+// Function to send a NET_HELLO or NET_START with the match info
+static void sendMatchInfo(RollbackSession* session, const NetAddress* to, uint8_t type, const NetMatchInfo* match) {
+    uint8_t packet[sizeof(NetPacketHeader) + sizeof(NetMatchInfo)];
+    NetPacketHeader header;
+    fillPacketHeader(&header, type);
+    memcpy(packet, &header, sizeof(header));
+    memcpy(packet + sizeof(header), match, sizeof(*match));
+    sendNetPacket(&session->socket, to, packet, sizeof(packet));
+}
+
+// Function to read the match info after a header (false if the message is too short)
+static bool readMatchInfo(const uint8_t* data, int size, NetMatchInfo* match) {
+    if (size < (int)(sizeof(NetPacketHeader) + sizeof(NetMatchInfo))) return false;
+    memcpy(match, data + sizeof(NetPacketHeader), sizeof(*match));
+    return true;
+}
+
+// Function to check if two addresses are the same
+static bool isSameAddress(const NetAddress* a, const NetAddress* b) {
+    return a->host == b->host && a->port == b->port;
+}
+
+// Function to open the session's socket
+bool openNetplay(RollbackSession* session, uint16_t port) {
+    session->active = false;
+    session->isHost = false;
+    session->localTank = 0;
+    session->remoteTank = 1;
+    session->desyncTick = -1;
+    session->stats = RollbackStats();
+    if (!openNetSocket(&session->socket, port)) {
+        return false;
+    }
+    LOG_INFO("[NET] Using UDP port %u", (unsigned)getNetSocketPort(&session->socket));
+    return true;
+}
+
+// Function to wait for a player to join
+bool waitForNetplayPeer(RollbackSession* session, const NetMatchInfo* match, double timeout) {
+    LOG_INFO("[NET] Waiting for a player on port %u", (unsigned)getNetSocketPort(&session->socket));
+    double start = getNetplayTime();
+    while (getNetplayTime() - start < timeout) {
+        flushNetShim(&session->socket);
+
+        uint8_t buffer[NET_MAX_PACKET];
+        NetAddress from;
+        int size = receiveNetPacket(&session->socket, &from, buffer, sizeof(buffer));
+        if (size == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        NetPacketHeader header;
+        NetMatchInfo theirs;
+        if (!readPacketHeader(buffer, size, &header) || header.type != NET_HELLO ||
+            !readMatchInfo(buffer, size, &theirs)) {
+            continue;
+        }
+        if (theirs.mapHash != match->mapHash || theirs.tankWidth != match->tankWidth ||
+            theirs.tankHeight != match->tankHeight) {
+            LOG_WARN("[NET] %s plays a different map or tank size, ignored", formatNetAddress(&from).c_str());
+            continue;
+        }
+
+        session->peer = from;
+        session->match = *match;
+        session->isHost = true;
+        session->localTank = 0;
+        session->remoteTank = 1;
+        session->active = true;
+        sendMatchInfo(session, &from, NET_START, match);
+        while (!session->socket.shim.queue.empty()) {
+            flushNetShim(&session->socket); // Out before the caller gets busy setting up the match
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        LOG_INFO("[NET] %s joined (seed %llu)", formatNetAddress(&from).c_str(), (unsigned long long)match->seed);
+        return true;
+    }
+    LOG_ERROR("[NET] Nobody joined within %.0f s", timeout);
+    return false;
+}
+
+// Function to join a host
+bool connectNetplayPeer(RollbackSession* session, const NetAddress* host, NetMatchInfo* match, double timeout) {
+    LOG_INFO("[NET] Joining %s", formatNetAddress(host).c_str());
+    double start = getNetplayTime();
+    double lastHello = -NETPLAY_HELLO_INTERVAL;
+    while (getNetplayTime() - start < timeout) {
+        // The hello or the answer may be lost, so keep asking
+        double now = getNetplayTime() - start;
+        if (now - lastHello >= NETPLAY_HELLO_INTERVAL) {
+            sendMatchInfo(session, host, NET_HELLO, match);
+            lastHello = now;
+        }
+        flushNetShim(&session->socket);
+
+        uint8_t buffer[NET_MAX_PACKET];
+        NetAddress from;
+        int size = receiveNetPacket(&session->socket, &from, buffer, sizeof(buffer));
+        if (size == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        NetPacketHeader header;
+        NetMatchInfo theirs;
+        if (!isSameAddress(&from, host) || !readPacketHeader(buffer, size, &header) || header.type != NET_START ||
+            !readMatchInfo(buffer, size, &theirs)) {
+            continue;
+        }
+        if (theirs.mapHash != match->mapHash || theirs.tankWidth != match->tankWidth ||
+            theirs.tankHeight != match->tankHeight) {
+            LOG_ERROR("[NET] %s plays a different map or tank size", formatNetAddress(host).c_str());
+            return false;
+        }
+
+        match->seed = theirs.seed;
+        session->peer = *host;
+        session->match = *match;
+        session->isHost = false;
+        session->localTank = 1;
+        session->remoteTank = 0;
+        session->active = true;
+        LOG_INFO("[NET] Joined %s (seed %llu)", formatNetAddress(host).c_str(), (unsigned long long)match->seed);
+        return true;
+    }
+    LOG_ERROR("[NET] No answer from %s within %.0f s", formatNetAddress(host).c_str(), timeout);
+    return false;
+}
+
+// Function to start rollback for a match just initialized with the session's seed
+void beginNetplayMatch(RollbackSession* session, const World* world) {
+    // Neither side has input for the first ROLLBACK_INPUT_DELAY ticks, so both start out known (empty)
+    memset(session->inputs, 0, sizeof(session->inputs));
+    session->localInputEnd = world->tick + ROLLBACK_INPUT_DELAY;
+    session->remoteInputEnd = world->tick + ROLLBACK_INPUT_DELAY;
+    session->peerAck = world->tick;
+    session->rollbackTick = ROLLBACK_NONE;
+    session->peerTick = world->tick;
+    session->peerAdvantage = 0;
+    session->ticksSinceSync = 0;
+    session->hasPeerCheck = false;
+    session->desyncTick = -1;
+    session->lastReceiveTime = getNetplayTime();
+    for (WorldSnapshot& snapshot : session->snapshots) {
+        snapshot.header.tick = ROLLBACK_NONE;
+    }
+    session->stepInputs.assign(world->tanks.count, TankInput());
+    session->stats = RollbackStats();
+}
+
+// Function to guess the remote input of a tick that has not arrived: the
+// last one received, still held, but without shots (those are one tick each)
+static uint8_t predictRemoteInput(const RollbackSession* session) {
+    uint8_t last = session->inputs[(session->remoteInputEnd - 1) % ROLLBACK_HISTORY][session->remoteTank];
+    return last & ~(INPUT_FIRE | INPUT_FIRE_EXPLOSION);
+}
+
+// Function to snapshot the world and simulate its current tick with the
+// inputs known (or predicted) for it
+static void simulateTick(RollbackSession* session, World* world, JobSystem* jobs) {
+    uint32_t tick = world->tick;
+    int slot = tick % ROLLBACK_HISTORY;
+
+    auto start = std::chrono::steady_clock::now();
+    saveWorldSnapshot(&session->snapshots[slot], world);
+    session->stats.saveMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    session->stats.saves++;
+    session->stats.snapshotBytes = getSnapshotSize(&session->snapshots[slot]);
+    session->hashes[slot] = foldWorldHash(hashWorld(world));
+
+    if (tick >= session->remoteInputEnd) {
+        session->inputs[slot][session->remoteTank] = predictRemoteInput(session);
+    }
+    session->stepInputs[session->localTank] = unpackTankInput(session->inputs[slot][session->localTank]);
+    session->stepInputs[session->remoteTank] = unpackTankInput(session->inputs[slot][session->remoteTank]);
+    stepWorld(world, session->stepInputs.data(), jobs);
+}
+
+// Function to take in one NET_INPUT message
+static void receiveInputs(RollbackSession* session, const World* world, const NetPacketHeader* header,
+                          const uint8_t* inputs) {
+    // Inputs arrive in order within a message; any before remoteInputEnd are repeats
+    for (int i = 0; i < header->inputCount; i++) {
+        uint32_t tick = header->firstTick + i;
+        if (tick < session->remoteInputEnd) continue;
+        if (tick > session->remoteInputEnd) break; // A gap (cannot happen, the sender starts at our ack)
+
+        int slot = tick % ROLLBACK_HISTORY;
+        if (tick < world->tick && inputs[i] != session->inputs[slot][session->remoteTank]) {
+            session->rollbackTick = std::min(session->rollbackTick, tick); // Simulated on a wrong guess
+        }
+        session->inputs[slot][session->remoteTank] = inputs[i];
+        session->remoteInputEnd++;
+    }
+
+    session->peerAck = std::max(session->peerAck, header->ackTick);
+    if (header->tick >= session->peerTick) {
+        session->peerTick = header->tick;
+        session->peerAdvantage = header->advantage;
+    }
+    if (!session->hasPeerCheck || header->checkTick > session->peerCheckTick) {
+        session->hasPeerCheck = true;
+        session->peerCheckTick = header->checkTick;
+        session->peerCheckHash = header->checkHash;
+    }
+}
+
+// Function to read every waiting message
+static void receiveNetplay(RollbackSession* session, const World* world) {
+    uint8_t buffer[NET_MAX_PACKET];
+    NetAddress from;
+    int size;
+    while ((size = receiveNetPacket(&session->socket, &from, buffer, sizeof(buffer))) > 0) {
+        NetPacketHeader header;
+        if (!isSameAddress(&from, &session->peer) || !readPacketHeader(buffer, size, &header)) continue;
+        session->lastReceiveTime = getNetplayTime();
+
+        if (header.type == NET_HELLO && session->isHost) {
+            sendMatchInfo(session, &from, NET_START, &session->match); // Our NET_START was lost
+        } else if (header.type == NET_INPUT && size >= (int)sizeof(header) + header.inputCount) {
+            receiveInputs(session, world, &header, buffer + sizeof(header));
+        }
+    }
+}
+
+// Function to go back to the earliest mispredicted tick and simulate forward again
+static void applyRollback(RollbackSession* session, World* world, JobSystem* jobs) {
+    uint32_t from = session->rollbackTick;
+    session->rollbackTick = ROLLBACK_NONE;
+    if (from == ROLLBACK_NONE || from >= world->tick) return;
+
+    const WorldSnapshot* snapshot = &session->snapshots[from % ROLLBACK_HISTORY];
+    if (snapshot->header.tick != from) {
+        LOG_ERROR("[NET] No snapshot of tick %u left to roll back to", from);
+        return;
+    }
+
+    // Events of the replayed ticks are logged again; only the state matters
+    auto start = std::chrono::steady_clock::now();
+    uint32_t target = world->tick;
+    restoreWorldSnapshot(world, snapshot);
+    auto restored = std::chrono::steady_clock::now();
+    while (world->tick < target && world->winner == -1) {
+        simulateTick(session, world, jobs);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    int ticks = (int)(target - from);
+    RollbackStats* stats = &session->stats;
+    stats->rollbacks++;
+    stats->resimulatedTicks += ticks;
+    stats->longestRollback = std::max(stats->longestRollback, ticks);
+    stats->restoreMs += std::chrono::duration<double, std::milli>(restored - start).count();
+    stats->worstRollbackMs = std::max(stats->worstRollbackMs, std::chrono::duration<double, std::milli>(end - start).count());
+}
+
+// Function to get the folded hash of a state we hold, current or in the history (false if gone)
+static bool getTickHash(const RollbackSession* session, const World* world, uint32_t tick, uint32_t* hash) {
+    if (tick == world->tick) {
+        *hash = foldWorldHash(hashWorld(world));
+        return true;
+    }
+    int slot = tick % ROLLBACK_HISTORY;
+    if (tick > world->tick || session->snapshots[slot].header.tick != tick) return false;
+    *hash = session->hashes[slot];
+    return true;
+}
+
+// Function to compare the peer's hash of a final tick with ours once ours is final too
+static void checkPeerHash(RollbackSession* session, const World* world) {
+    if (!session->hasPeerCheck) return;
+    uint32_t tick = session->peerCheckTick;
+    if (tick > std::min(session->remoteInputEnd, world->tick)) return; // Not final here yet
+
+    session->hasPeerCheck = false;
+    uint32_t hash;
+    if (!getTickHash(session, world, tick, &hash)) return;
+
+    session->stats.checks++;
+    if (hash != session->peerCheckHash && session->desyncTick < 0) {
+        session->desyncTick = (int)tick;
+        LOG_ERROR("[NET] Simulations diverged at tick %u", tick);
+    }
+}
+
+// Function to send the inputs the peer has not acknowledged, with our sync and check fields
+static void sendNetplayInputs(RollbackSession* session, const World* world) {
+    uint8_t packet[sizeof(NetPacketHeader) + NETPLAY_MAX_INPUTS];
+    NetPacketHeader header;
+    fillPacketHeader(&header, NET_INPUT);
+
+    uint32_t first = std::max(session->peerAck, session->localInputEnd - std::min(session->localInputEnd,
+                                                                                  (uint32_t)NETPLAY_MAX_INPUTS));
+    int count = (int)(session->localInputEnd - first);
+    for (int i = 0; i < count; i++) {
+        packet[sizeof(header) + i] = session->inputs[(first + i) % ROLLBACK_HISTORY][session->localTank];
+    }
+    header.inputCount = (uint8_t)count;
+    header.firstTick = first;
+    header.ackTick = session->remoteInputEnd;
+    header.tick = world->tick;
+    header.advantage = (int32_t)world->tick - (int32_t)session->peerTick;
+
+    // The newest state that no longer depends on a guess
+    header.checkTick = std::min(session->remoteInputEnd, world->tick);
+    if (!getTickHash(session, world, header.checkTick, &header.checkHash)) {
+        header.checkTick = 0;
+        header.checkHash = 0;
+    }
+
+    memcpy(packet, &header, sizeof(header));
+    sendNetPacket(&session->socket, &session->peer, packet, (int)sizeof(header) + count);
+}
+
+// Function to take in messages, fix mispredictions and check the peer's hash
+static void updateNetplay(RollbackSession* session, World* world, JobSystem* jobs) {
+    flushNetShim(&session->socket);
+    receiveNetplay(session, world);
+    applyRollback(session, world, jobs);
+    checkPeerHash(session, world);
+
+    if (getNetplayTime() - session->lastReceiveTime > NETPLAY_DISCONNECT_TIMEOUT) {
+        LOG_WARN("[NET] No word from %s for %.0f s, the network match is over",
+                 formatNetAddress(&session->peer).c_str(), NETPLAY_DISCONNECT_TIMEOUT);
+        session->active = false;
+    }
+}
+
+// Function to exchange messages and apply late corrections
+void pollNetplay(RollbackSession* session, World* world, JobSystem* jobs) {
+    if (!session->active) return;
+    updateNetplay(session, world, jobs);
+    sendNetplayInputs(session, world);
+}
+
+// Function to poll, then simulate one tick with the local player's input
+bool advanceNetplay(RollbackSession* session, World* world, const TankInput& localInput, JobSystem* jobs) {
+    if (!session->active) return false;
+    updateNetplay(session, world, jobs);
+
+    // Hold still while a winner may still be undone, or while the peer is
+    // so far behind that a rollback would need snapshots we no longer have
+    bool wait = world->winner != -1 || world->tick >= session->remoteInputEnd + ROLLBACK_MAX_FRAMES;
+
+    // Both sides see the other behind by the latency; when we are ahead
+    // by more than that, skip a tick now and then so the peer catches up
+    // instead of rolling back all the time
+    int localAdvantage = (int)world->tick - (int)session->peerTick;
+    if (!wait && ++session->ticksSinceSync >= ROLLBACK_SYNC_INTERVAL &&
+        (localAdvantage - session->peerAdvantage) / 2 >= 1) {
+        session->ticksSinceSync = 0;
+        wait = true;
+    }
+
+    if (wait) {
+        if (world->winner == -1) session->stats.stalls++;
+        sendNetplayInputs(session, world);
+        return false;
+    }
+
+    session->inputs[session->localInputEnd % ROLLBACK_HISTORY][session->localTank] = packTankInput(localInput);
+    session->localInputEnd++;
+    simulateTick(session, world, jobs);
+    sendNetplayInputs(session, world);
+    return true;
+}
+
+// Function to log the session's statistics and close it
+void closeNetplay(RollbackSession* session) {
+    const RollbackStats& stats = session->stats;
+    LOG_INFO("[NET] %d rollbacks (%d ticks simulated again, longest %d, worst %.2f ms), %d ticks waiting, "
+             "%d hash checks",
+             stats.rollbacks, stats.resimulatedTicks, stats.longestRollback, stats.worstRollbackMs, stats.stalls,
+             stats.checks);
+    LOG_INFO("[NET] Snapshots of %zu bytes saved in %.2f us, restored in %.2f us on average", stats.snapshotBytes,
+             stats.saves > 0 ? stats.saveMs * 1000.0 / stats.saves : 0.0,
+             stats.rollbacks > 0 ? stats.restoreMs * 1000.0 / stats.rollbacks : 0.0);
+    LOG_INFO("[NET] %llu datagrams sent (%llu dropped by the shim, %llu bytes), %llu received",
+             (unsigned long long)session->socket.packetsSent, (unsigned long long)session->socket.packetsDropped,
+             (unsigned long long)session->socket.bytesSent, (unsigned long long)session->socket.packetsReceived);
+    closeNetSocket(&session->socket);
+    session->active = false;
+}
+
+// Structure for one side of the loopback test
+struct LoopbackSide {
+    RollbackSession session;
+    World world;
+    uint64_t scriptSeed; // Seed of the scripted player
+    bool done; // Final state reached
+    uint64_t finalHash;
+};
+
+// Function to play one side of the loopback test until tick ticks (or a
+// confirmed winner), then wait until the state is final on both sides
+static void playLoopbackSide(LoopbackSide* side, const GameMap* map, int ticks, std::atomic<int>* finished) {
+    RollbackSession* session = &side->session;
+    World* world = &side->world;
+    initializeWorld(world, map, session->match.tankWidth, session->match.tankHeight, session->match.seed, 2);
+    beginNetplayMatch(session, world);
+
+    // Scripted player: holds a direction for a while, fires now and then
+    GameRng script;
+    seedRng(&script, side->scriptSeed);
+    TankInput input = TankInput();
+    int holdTicks = 0;
+
+    double nextTickTime = getNetplayTime();
+    while (session->active && (int)world->tick < ticks &&
+           !(world->winner != -1 && isNetplayStateConfirmed(session, world))) {
+        if (getNetplayTime() < nextTickTime) {
+            pollNetplay(session, world);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        nextTickTime += FIXED_TIMESTEP;
+
+        if (--holdTicks <= 0) {
+            input = unpackTankInput((uint8_t)random(&script, 0, 15));
+            holdTicks = random(&script, 10, 90);
+        }
+        input.fire = random(&script, 0, 29) == 0;
+        input.fireExplosion = random(&script, 0, 299) == 0;
+        advanceNetplay(session, world, input);
+    }
+
+    // Final once every input before our tick is in and the peer has all of ours
+    while (session->active &&
+           (session->remoteInputEnd < world->tick || session->peerAck < world->tick)) {
+        pollNetplay(session, world);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    side->done = session->active;
+    side->finalHash = hashWorld(world);
+
+    // Keep answering until the other side is final too (it may still need our acks)
+    finished->fetch_add(1);
+    while (session->active && finished->load() < 2) {
+        pollNetplay(session, world);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Function to play a match between two sessions on loopback and check both ended in the same state
+NetplayTestResult runNetplayLoopback(const GameMap* map, int ticks, int tankWidth, int tankHeight, int latencyMs,
+                                     int jitterMs, float lossRate) {
+    NetplayTestResult result = {};
+    result.desyncTick = -1;
+
+    // Sessions hold a snapshot history each, so keep them off the stack
+    std::vector<LoopbackSide> sides(2);
+    LoopbackSide* host = &sides[0];
+    LoopbackSide* client = &sides[1];
+    host->scriptSeed = 1;
+    client->scriptSeed = 2;
+
+    NetMatchInfo match = {};
+    match.seed = 12345;
+    match.mapHash = map->hash;
+    match.tankWidth = tankWidth;
+    match.tankHeight = tankHeight;
+
+    if (!openNetplay(&host->session, 0) || !openNetplay(&client->session, 0)) {
+        return result;
+    }
+    setNetShim(&host->session.socket, latencyMs, jitterMs, lossRate, 1);
+    setNetShim(&client->session.socket, latencyMs, jitterMs, lossRate, 2);
+
+    NetAddress hostAddress;
+    hostAddress.host = 0x7F000001; // 127.0.0.1
+    hostAddress.port = getNetSocketPort(&host->session.socket);
+
+    // Each side starts playing as soon as it is connected, as two games would
+    std::atomic<int> finished(0);
+    bool hostJoined = false;
+    std::thread hostThread([&] {
+        hostJoined = waitForNetplayPeer(&host->session, &match, 10.0);
+        if (hostJoined) {
+            playLoopbackSide(host, map, ticks, &finished);
+        } else {
+            finished.fetch_add(1);
+        }
+    });
+    NetMatchInfo joined = match;
+    joined.seed = 0;
+    bool clientJoined = connectNetplayPeer(&client->session, &hostAddress, &joined, 10.0);
+    if (clientJoined) {
+        playLoopbackSide(client, map, ticks, &finished);
+    } else {
+        finished.fetch_add(1);
+    }
+    hostThread.join();
+
+    result.connected = hostJoined && clientJoined;
+    if (!result.connected) {
+        closeNetplay(&host->session);
+        closeNetplay(&client->session);
+        return result;
+    }
+
+    result.ticks = (int)host->world.tick;
+    result.matched = host->done && client->done && host->world.tick == client->world.tick &&
+                     host->finalHash == client->finalHash;
+    result.desyncTick = host->session.desyncTick >= 0 ? host->session.desyncTick : client->session.desyncTick;
+
+    result.host = host->session.stats;
+    result.client = client->session.stats;
+
+    // Worst case the game allows: roll back the full window and simulate it
+    // again. The inputs are all final, so the state must come out the same.
+    World* world = &host->world;
+    if (world->tick >= (uint32_t)ROLLBACK_MAX_FRAMES) {
+        auto start = std::chrono::steady_clock::now();
+        host->session.rollbackTick = world->tick - ROLLBACK_MAX_FRAMES;
+        applyRollback(&host->session, world, NULL);
+        result.forcedRollbackMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.matched = result.matched && hashWorld(world) == host->finalHash;
+    }
+
+    closeNetplay(&host->session);
+    closeNetplay(&client->session);
+    return result;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+// Two-player network play with rollback. Each peer runs the whole match
+// and only inputs cross the network. A tick whose remote input has not
+// arrived yet is simulated with a prediction (the last input received,
+// held, without its shots); when the real input arrives and differs, the
+// world is restored from the snapshot of that tick and the ticks since
+// are simulated again with what is now known. Local play never waits for
+// the network unless the remote player falls ROLLBACK_MAX_FRAMES behind.
+//
+// Every input message repeats the inputs the peer has not acknowledged,
+// so a lost datagram costs nothing but a later correction. Messages also
+// carry a hash of a tick whose inputs are final on the sender, so the
+// receiver notices when the two simulations drift apart.
+//
+// Packets (little-endian): a NetPacketHeader, then a NetMatchInfo for
+// NET_HELLO and NET_START or inputCount packed inputs for NET_INPUT.
+
+#include "net_socket.h"
+#include "snapshot.h"
+#include "world.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Port used when --host or --join give none
+const uint16_t NETPLAY_DEFAULT_PORT = 27960;
+
+// Ticks simulated on predicted input before the local side waits for the peer
+const int ROLLBACK_MAX_FRAMES = 16;
+
+// Ticks between reading a local input and simulating it. Both peers see
+// the input this much earlier than it counts, which hides short latency.
+const int ROLLBACK_INPUT_DELAY = 2;
+
+// Ticks of inputs, snapshots and hashes kept (power of two, well above
+// ROLLBACK_MAX_FRAMES plus both input delays)
+const int ROLLBACK_HISTORY = 64;
+
+// Most inputs in one message
+const int NETPLAY_MAX_INPUTS = 48;
+
+// Seconds to wait for the other player to show up, and of silence before the peer counts as gone
+const double NETPLAY_CONNECT_TIMEOUT = 60.0;
+const double NETPLAY_DISCONNECT_TIMEOUT = 5.0;
+
+const char NETPLAY_MAGIC[4] = {'T', 'N', 'E', 'T'};
+const uint16_t NETPLAY_VERSION = 2;
+
+// Message types
+const uint8_t NET_HELLO = 1; // Joining player asks to play (followed by NetMatchInfo)
+const uint8_t NET_START = 2; // Host accepts and picks the seed (followed by NetMatchInfo)
+const uint8_t NET_INPUT = 3; // Inputs from firstTick on, plus sync and check fields
+
+// Structure for the start of every message
+struct NetPacketHeader {
+    char magic[4];
+    uint8_t type;
+    uint8_t inputCount; // NET_INPUT: packed inputs after the header
+    uint16_t version;
+    uint32_t firstTick; // Tick the first input is for
+    uint32_t ackTick; // Sender has the receiver's inputs for every tick before this
+    uint32_t tick; // Sender's world tick when sending
+    int32_t advantage; // Ticks the sender sees itself ahead of the receiver
+    uint32_t checkTick; // Tick whose state is final on the sender...
+    uint32_t checkHash; // ...and its folded world hash
+};
+
+// Structure for what both players must agree on before a match
+struct NetMatchInfo {
+    uint64_t seed; // Chosen by the host
+    uint64_t mapHash;
+    int32_t tankWidth;
+    int32_t tankHeight;
+};
+
+static_assert(sizeof(NetPacketHeader) == 32, "NetPacketHeader layout is part of the protocol");
+static_assert(sizeof(NetMatchInfo) == 24, "NetMatchInfo layout is part of the protocol");
+
+// Structure for what the rollback has cost so far
+struct RollbackStats {
+    int rollbacks;
+    int resimulatedTicks;
+    int longestRollback; // Ticks
+    double worstRollbackMs; // Restore plus resimulation
+    int stalls; // Ticks spent waiting for the peer
+    int checks; // Peer hashes compared
+    double saveMs; // Total time saving snapshots
+    int saves;
+    double restoreMs; // Total time restoring snapshots
+    size_t snapshotBytes; // Size of the last snapshot
+};
+
+// Structure for one side of a network match
+struct RollbackSession {
+    NetSocket socket;
+    NetAddress peer;
+    bool active; // Connected and the peer is still talking
+    bool isHost;
+    int localTank; // Host drives tank 0, the joining player tank 1
+    int remoteTank;
+    NetMatchInfo match;
+    uint8_t inputs[ROLLBACK_HISTORY][2]; // Packed input per tick (tick % ROLLBACK_HISTORY) and player tank
+    uint32_t localInputEnd; // Local inputs are known for every tick before this
+    uint32_t remoteInputEnd; // Remote inputs are confirmed for every tick before this
+    uint32_t peerAck; // Peer has our inputs for every tick before this
+    uint32_t rollbackTick; // Earliest simulated tick whose prediction was wrong (UINT32_MAX = none)
+    uint32_t peerTick; // Latest tick the peer reported
+    int peerAdvantage;
+    int ticksSinceSync; // Ticks since the last wait to let the peer catch up
+    bool hasPeerCheck;
+    uint32_t peerCheckTick;
+    uint32_t peerCheckHash;
+    int desyncTick; // First tick whose hash differed from the peer's (-1 = none)
+    double lastReceiveTime;
+    WorldSnapshot snapshots[ROLLBACK_HISTORY]; // State at the start of each tick
+    uint32_t hashes[ROLLBACK_HISTORY]; // Folded hash of the same states
+    std::vector<TankInput> stepInputs; // Scratch for stepWorld
+    RollbackStats stats;
+};
+
+// Function to open the session's socket on port (0 = any free port)
+bool openNetplay(RollbackSession* session, uint16_t port);
+
+// Function to wait for a player to join (host). match gives the map hash,
+// tank size and seed; the joining player's must match.
+bool waitForNetplayPeer(RollbackSession* session, const NetMatchInfo* match, double timeout = NETPLAY_CONNECT_TIMEOUT);
+
+// Function to join a host. match gives the map hash and tank size and gets the host's seed.
+bool connectNetplayPeer(RollbackSession* session, const NetAddress* host, NetMatchInfo* match,
+                        double timeout = NETPLAY_CONNECT_TIMEOUT);
+
+// Function to start rollback for a match just initialized with the session's seed
+void beginNetplayMatch(RollbackSession* session, const World* world);
+
+// Function to exchange messages and apply late corrections (call every frame)
+void pollNetplay(RollbackSession* session, World* world, JobSystem* jobs = NULL);
+
+// Function to poll, then simulate one tick with the local player's input.
+// Returns false when the tick had to wait (peer too far behind or a
+// winner not yet confirmed); the input is not used then.
+bool advanceNetplay(RollbackSession* session, World* world, const TankInput& localInput, JobSystem* jobs = NULL);
+
+// Function to check if the world's current state rests only on real inputs (no predictions)
+inline bool isNetplayStateConfirmed(const RollbackSession* session, const World* world) {
+    return world->tick <= session->remoteInputEnd;
+}
+
+// Function to log the session's statistics and close it
+void closeNetplay(RollbackSession* session);
+
+// Structure for the outcome of runNetplayLoopback
+struct NetplayTestResult {
+    bool connected;
+    int ticks; // Ticks both sides ended on
+    bool matched; // Both worlds hashed the same at the end
+    int desyncTick; // First hash mismatch either side noticed (-1 = none)
+    RollbackStats host;
+    RollbackStats client;
+    double forcedRollbackMs; // Restore plus ROLLBACK_MAX_FRAMES resimulated ticks, measured at the end
+};
+
+// Function to play a match between two sessions on loopback, each on its
+// own thread in real time with scripted inputs, through the shim, and
+// check both ended in the same state
+NetplayTestResult runNetplayLoopback(const GameMap* map, int ticks, int tankWidth, int tankHeight, int latencyMs,
+                                     int jitterMs, float lossRate);
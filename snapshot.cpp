@@ -0,0 +1,120 @@
+#include "snapshot.h"
+#include <algorithm>
+#include <cstring>
+
+// Function to call copy(array, count) on every tank and bullet array, in
+// the order they sit in the snapshot data. Shared by save and restore so
+// the two can never disagree on the layout.
+template <typename Tanks, typename Bullets, typename Copy>
+static void visitSnapshotArrays(Tanks* tanks, Bullets* bullets, const WorldSnapshotHeader& header, Copy copy) {
+    int tankCount = header.tankCount;
+    copy(&tanks->rect, tankCount);
+    copy(&tanks->prevRect, tankCount);
+    copy(&tanks->rotation, tankCount);
+    copy(&tanks->speed, tankCount);
+    copy(&tanks->gunRotation, tankCount);
+    copy(&tanks->prevGunRotation, tankCount);
+    copy(&tanks->gunRect, tankCount);
+    copy(&tanks->ammo, tankCount);
+    copy(&tanks->reloadTimer, tankCount);
+    copy(&tanks->powerTimer, tankCount);
+    copy(&tanks->hp, tankCount);
+    copy(&tanks->flags, tankCount);
+    copy(&tanks->info, tankCount);
+
+    int slots = header.bulletSlots;
+    copy(&bullets->x, slots);
+    copy(&bullets->y, slots);
+    copy(&bullets->prevX, slots);
+    copy(&bullets->prevY, slots);
+    copy(&bullets->velocityX, slots);
+    copy(&bullets->velocityY, slots);
+    copy(&bullets->rotation, slots);
+    copy(&bullets->owner, slots);
+    copy(&bullets->flags, slots);
+    copy(&bullets->freeList, header.freeBullets);
+}
+
+// Function to save the gameplay state of a world
+void saveWorldSnapshot(WorldSnapshot* snapshot, const World* world) {
+    WorldSnapshotHeader* header = &snapshot->header;
+    header->tick = world->tick;
+    header->winner = world->winner;
+    header->rngState = world->rng.state;
+    header->destroyedObstacleHash = world->destroyedObstacleHash;
+    header->tankCount = world->tanks.count;
+    header->bulletSlots = (int32_t)world->bullets.flags.size();
+    header->freeBullets = (int32_t)world->bullets.freeList.size();
+    header->liveBullets = world->bullets.liveCount;
+    header->destroyedObstacles = (int32_t)world->destroyedObstacles.size();
+    std::copy(world->explosions, world->explosions + MAX_EXPLOSIONS, header->explosions);
+    header->powerBox = world->powerBox;
+    header->shield = world->shield;
+
+    // Size the buffer first (it only reallocates when it has to grow)
+    size_t size = world->destroyedObstacles.size() * sizeof(int);
+    visitSnapshotArrays(&world->tanks, &world->bullets, *header, [&size](const auto* array, int count) {
+        size += sizeof((*array)[0]) * count;
+    });
+    snapshot->data.resize(size);
+
+    // Obstacle ids go first, where the buffer is aligned for ints
+    uint8_t* out = snapshot->data.data();
+    if (!world->destroyedObstacles.empty()) {
+        memcpy(out, world->destroyedObstacles.data(), world->destroyedObstacles.size() * sizeof(int));
+        out += world->destroyedObstacles.size() * sizeof(int);
+    }
+    visitSnapshotArrays(&world->tanks, &world->bullets, *header, [&out](const auto* array, int count) {
+        size_t bytes = sizeof((*array)[0]) * count;
+        if (bytes > 0) memcpy(out, array->data(), bytes);
+        out += bytes;
+    });
+}
+
+// Function to bring the destroyed obstacles in line with a snapshot's list
+static void restoreDestroyedObstacles(World* world, const int* ids, int count) {
+    // Both lists usually share a long prefix (the snapshot is from earlier
+    // in the same match), so only the tail after it changes
+    std::vector<int>& destroyed = world->destroyedObstacles;
+    int common = 0;
+    int limit = std::min(count, (int)destroyed.size());
+    while (common < limit && destroyed[common] == ids[common]) {
+        common++;
+    }
+
+    for (int i = (int)destroyed.size() - 1; i >= common; i--) {
+        restoreGameObject(getWorldObstacle(world, destroyed[i]), &world->obstacleGrid, &world->navGrid, destroyed[i]);
+    }
+    destroyed.resize(common);
+    for (int i = common; i < count; i++) {
+        destroyGameObject(getWorldObstacle(world, ids[i]), &world->obstacleGrid, &world->navGrid, ids[i]);
+        destroyed.push_back(ids[i]);
+    }
+}
+
+// Function to put a world back in the state of a snapshot
+void restoreWorldSnapshot(World* world, const WorldSnapshot* snapshot) {
+    const WorldSnapshotHeader& header = snapshot->header;
+    world->tick = header.tick;
+    world->winner = header.winner;
+    world->rng.state = header.rngState;
+    world->destroyedObstacleHash = header.destroyedObstacleHash;
+    world->tanks.count = header.tankCount;
+    world->bullets.liveCount = header.liveBullets;
+    std::copy(header.explosions, header.explosions + MAX_EXPLOSIONS, world->explosions);
+    world->powerBox = header.powerBox;
+    world->shield = header.shield;
+
+    const uint8_t* in = snapshot->data.data();
+    restoreDestroyedObstacles(world, (const int*)in, header.destroyedObstacles);
+    in += header.destroyedObstacles * sizeof(int);
+    visitSnapshotArrays(&world->tanks, &world->bullets, header, [&in](auto* array, int count) {
+        size_t bytes = sizeof((*array)[0]) * count;
+        array->resize(count);
+        if (bytes > 0) memcpy(array->data(), in, bytes);
+        in += bytes;
+    });
+
+    // Chunk activity follows the tanks, as at the end of stepWorld
+    updateActiveChunks(&world->chunks, world->tanks.rect.data(), world->tanks.count);
+}
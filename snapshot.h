@@ -0,0 +1,57 @@
+#pragma once
+
+// Whole-match snapshots for rollback. A snapshot is the fixed-size part
+// of a World (tick, RNG, winner, explosions, power box, shield) as one POD
+// header plus every tank and bullet array and the ids of the destroyed
+// obstacles copied back to back into one byte buffer. Saving and restoring
+// are a handful of memcpy calls; the buffer is reused, so a ring of
+// snapshots stops allocating once it has seen the largest bullet count.
+//
+// Obstacles themselves are not copied (a big map has thousands); only the
+// ids destroyed so far are, and restoring destroys or puts back the few
+// that differ, keeping the obstacle grid and nav grid in step.
+//
+// Everything derived from the saved state (active chunks, bullet hit
+// scratch) is recomputed or left alone, so a restored world steps exactly
+// like the one that was saved.
+
+#include "world.h"
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Structure for the fixed-size part of a snapshot
+struct WorldSnapshotHeader {
+    uint32_t tick;
+    int32_t winner;
+    uint64_t rngState;
+    uint64_t destroyedObstacleHash;
+    int32_t tankCount;
+    int32_t bulletSlots; // Size of every bullet array
+    int32_t freeBullets; // Entries of the bullet free list
+    int32_t liveBullets;
+    int32_t destroyedObstacles; // Ids at the start of the data
+    Explosion explosions[MAX_EXPLOSIONS];
+    PowerBox powerBox;
+    Shield shield;
+};
+
+static_assert(std::is_trivially_copyable<WorldSnapshotHeader>::value, "Snapshot headers are copied as bytes");
+
+// Structure for the saved state of a match at one tick
+struct WorldSnapshot {
+    WorldSnapshotHeader header;
+    std::vector<uint8_t> data; // Destroyed obstacle ids, tank arrays, bullet arrays, free list
+};
+
+// Function to save the gameplay state of a world
+void saveWorldSnapshot(WorldSnapshot* snapshot, const World* world);
+
+// Function to put a world back in the state of a snapshot taken from the
+// same match (same map and tank count)
+void restoreWorldSnapshot(World* world, const WorldSnapshot* snapshot);
+
+// Function to get how many bytes a snapshot holds
+inline size_t getSnapshotSize(const WorldSnapshot* snapshot) {
+    return sizeof(snapshot->header) + snapshot->data.size();
+}
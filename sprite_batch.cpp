@@ -0,0 +1,176 @@
+#include "sprite_batch.h"
+#include "log.h"
+#include <algorithm>
+#include <cmath>
+
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+#error "SpriteBatch needs SDL 2.0.18 or newer (SDL_RenderGeometry)"
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Quads queued before a flush is forced (keeps the vertex arrays bounded)
+const int SPRITE_BATCH_MAX_QUADS = 4096;
+
+// Function to set up a batch that draws from atlas
+void initializeSpriteBatch(SpriteBatch* batch, SDL_Renderer* renderer, const TextureAtlas* atlas) {
+    batch->renderer = renderer;
+    batch->atlas = atlas;
+    batch->texture = nullptr;
+    batch->vertices.clear();
+    batch->indices.clear();
+    batch->vertices.reserve(SPRITE_BATCH_MAX_QUADS * 4);
+    batch->indices.reserve(SPRITE_BATCH_MAX_QUADS * 6);
+    resetSpriteBatchStats(batch);
+}
+
+// Function to append one quad (corners in clockwise order from top-left)
+static void pushQuad(SpriteBatch* batch, SDL_Texture* texture, const SDL_FPoint corners[4],
+                     float u0, float v0, float u1, float v1, SDL_Color color) {
+    if (texture != batch->texture || (int)batch->vertices.size() >= SPRITE_BATCH_MAX_QUADS * 4) {
+        flushSpriteBatch(batch);
+        batch->texture = texture;
+    }
+
+    int base = (int)batch->vertices.size();
+    const SDL_FPoint uvs[4] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+    for (int i = 0; i < 4; i++) {
+        SDL_Vertex vertex;
+        vertex.position = corners[i];
+        vertex.color = color;
+        vertex.tex_coord = uvs[i];
+        batch->vertices.push_back(vertex);
+    }
+
+    batch->indices.push_back(base);
+    batch->indices.push_back(base + 1);
+    batch->indices.push_back(base + 2);
+    batch->indices.push_back(base);
+    batch->indices.push_back(base + 2);
+    batch->indices.push_back(base + 3);
+    batch->spriteCount++;
+}
+
+// Function to queue a sprite stretched over dst and rotated around its center
+void drawSprite(SpriteBatch* batch, int sprite, SDL_Rect dst, double angle, SDL_Color tint) {
+    if (sprite < 0 || sprite >= (int)batch->atlas->sprites.size()) return;
+    const AtlasSprite& source = batch->atlas->sprites[sprite];
+    if (source.page < 0) return; // Atlas not built yet
+
+    float halfW = dst.w * 0.5f;
+    float halfH = dst.h * 0.5f;
+    float centerX = dst.x + halfW;
+    float centerY = dst.y + halfH;
+    SDL_FPoint corners[4] = {{-halfW, -halfH}, {halfW, -halfH}, {halfW, halfH}, {-halfW, halfH}};
+
+    // Screen y points down, so this turns clockwise like SDL_RenderCopyEx
+    float sine = 0.0f;
+    float cosine = 1.0f;
+    if (angle != 0.0) {
+        float radians = (float)(angle * M_PI / 180.0);
+        sine = sinf(radians);
+        cosine = cosf(radians);
+    }
+    for (int i = 0; i < 4; i++) {
+        float x = corners[i].x;
+        float y = corners[i].y;
+        corners[i].x = centerX + x * cosine - y * sine;
+        corners[i].y = centerY + x * sine + y * cosine;
+    }
+
+    pushQuad(batch, batch->atlas->pages[source.page], corners,
+             source.u0, source.v0, source.u1, source.v1, tint);
+}
+
+// Function to queue a filled rect
+void drawBatchRect(SpriteBatch* batch, SDL_Rect rect, SDL_Color color) {
+    if (rect.w <= 0 || rect.h <= 0 || batch->atlas->whiteSprite < 0) return;
+    const AtlasSprite& white = batch->atlas->sprites[batch->atlas->whiteSprite];
+    if (white.page < 0) return;
+
+    SDL_FPoint corners[4] = {
+        {(float)rect.x, (float)rect.y},
+        {(float)(rect.x + rect.w), (float)rect.y},
+        {(float)(rect.x + rect.w), (float)(rect.y + rect.h)},
+        {(float)rect.x, (float)(rect.y + rect.h)}
+    };
+
+    // Every corner samples the middle of the white image
+    float u = (white.u0 + white.u1) * 0.5f;
+    float v = (white.v0 + white.v1) * 0.5f;
+    pushQuad(batch, batch->atlas->pages[white.page], corners, u, v, u, v, color);
+}
+
+// Function to queue a 1 pixel rect outline
+void drawBatchRectOutline(SpriteBatch* batch, SDL_Rect rect, SDL_Color color) {
+    SDL_Rect top = {rect.x, rect.y, rect.w, 1};
+    SDL_Rect bottom = {rect.x, rect.y + rect.h - 1, rect.w, 1};
+    SDL_Rect left = {rect.x, rect.y + 1, 1, rect.h - 2};
+    SDL_Rect right = {rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2};
+    drawBatchRect(batch, top, color);
+    drawBatchRect(batch, bottom, color);
+    drawBatchRect(batch, left, color);
+    drawBatchRect(batch, right, color);
+}
+
+// Function to queue up to count filled quads at once and return their vertices
+SDL_Vertex* reserveBatchQuads(SpriteBatch* batch, int count, int* reserved) {
+    *reserved = 0;
+    if (count <= 0 || batch->atlas->whiteSprite < 0) return nullptr;
+    const AtlasSprite& white = batch->atlas->sprites[batch->atlas->whiteSprite];
+    if (white.page < 0) return nullptr;
+
+    SDL_Texture* texture = batch->atlas->pages[white.page];
+    int queued = (int)batch->vertices.size() / 4;
+    if (texture != batch->texture || queued >= SPRITE_BATCH_MAX_QUADS) {
+        flushSpriteBatch(batch);
+        batch->texture = texture;
+        queued = 0;
+    }
+
+    // Grow the arrays once for the whole run instead of per quad
+    int quads = std::min(count, SPRITE_BATCH_MAX_QUADS - queued);
+    batch->vertices.resize((queued + quads) * 4);
+    batch->indices.resize((queued + quads) * 6);
+    SDL_Vertex* vertices = batch->vertices.data() + queued * 4;
+    int* indices = batch->indices.data() + queued * 6;
+
+    // Every corner samples the middle of the white image
+    SDL_FPoint uv = {(white.u0 + white.u1) * 0.5f, (white.v0 + white.v1) * 0.5f};
+    for (int i = 0; i < quads; i++) {
+        int base = (queued + i) * 4;
+        for (int corner = 0; corner < 4; corner++) {
+            vertices[i * 4 + corner].tex_coord = uv;
+        }
+        indices[i * 6] = base;
+        indices[i * 6 + 1] = base + 1;
+        indices[i * 6 + 2] = base + 2;
+        indices[i * 6 + 3] = base;
+        indices[i * 6 + 4] = base + 2;
+        indices[i * 6 + 5] = base + 3;
+    }
+    batch->spriteCount += quads;
+    *reserved = quads;
+    return vertices;
+}
+
+// Function to draw everything queued so far
+void flushSpriteBatch(SpriteBatch* batch) {
+    if (batch->indices.empty()) return;
+
+    if (SDL_RenderGeometry(batch->renderer, batch->texture, batch->vertices.data(), (int)batch->vertices.size(),
+                           batch->indices.data(), (int)batch->indices.size()) != 0) {
+        LOG_ERROR("[ERROR] SDL_RenderGeometry failed! SDL Error: %s", SDL_GetError());
+    }
+    batch->drawCalls++;
+    batch->vertices.clear();
+    batch->indices.clear();
+}
+
+// Function to zero the draw call and sprite counters
+void resetSpriteBatchStats(SpriteBatch* batch) {
+    batch->drawCalls = 0;
+    batch->spriteCount = 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// Queues textured, optionally rotated quads from a TextureAtlas and
+// submits them with one SDL_RenderGeometry call per atlas page instead
+// of one SDL_RenderCopyEx per sprite. Quads are drawn in submission
+// order. Flush before drawing anything with the renderer directly.
+
+#include "texture_atlas.h"
+#include <vector>
+
+// Structure for the queued quads of the current page
+struct SpriteBatch {
+    SDL_Renderer* renderer;
+    const TextureAtlas* atlas;
+    SDL_Texture* texture; // Page the queued quads sample from
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    int drawCalls; // Geometry submissions since the last resetSpriteBatchStats
+    int spriteCount; // Quads submitted since the last resetSpriteBatchStats
+};
+
+// Function to set up a batch that draws from atlas
+void initializeSpriteBatch(SpriteBatch* batch, SDL_Renderer* renderer, const TextureAtlas* atlas);
+
+// Function to queue a sprite stretched over dst and rotated by angle degrees
+// clockwise around its center, like SDL_RenderCopyEx (skips sprite -1)
+void drawSprite(SpriteBatch* batch, int sprite, SDL_Rect dst, double angle = 0.0,
+                SDL_Color tint = SDL_Color{255, 255, 255, 255});
+
+// Function to queue a filled rect, like SDL_RenderFillRect
+void drawBatchRect(SpriteBatch* batch, SDL_Rect rect, SDL_Color color);
+
+// Function to queue a 1 pixel rect outline, like SDL_RenderDrawRect
+void drawBatchRectOutline(SpriteBatch* batch, SDL_Rect rect, SDL_Color color);
+
+// Function to queue up to count filled quads at once and return their
+// vertices (4 per quad, clockwise from top-left) for the caller to set
+// position and color; the texture coordinates and indices are filled in.
+// Sets *reserved to how many quads fit before the next forced flush, so
+// the caller loops until everything is queued (nullptr without an atlas).
+SDL_Vertex* reserveBatchQuads(SpriteBatch* batch, int count, int* reserved);
+
+// Function to draw everything queued so far
+void flushSpriteBatch(SpriteBatch* batch);
+
+// Function to zero the draw call and sprite counters
+void resetSpriteBatchStats(SpriteBatch* batch);
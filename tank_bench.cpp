@@ -0,0 +1,476 @@
+// tank_bench: headless microbenchmarks for the collision, bullet, particle,
+// navigation and spawn kernels at scaled obstacle and bullet counts.
+// Results are printed as JSON so runs before and after a change can be
+// diffed.
+//
+//   tank_bench [--filter <substring>] [--min-time <seconds>] [--out <file>]
+//
+// Obstacles are spread over a map whose area grows with the count, so
+// the density matches the real 960x540 map with 35 obstacles, until a
+// side reaches MAP_MAX_SIZE; larger counts pack the obstacles denser.
+
+#define SDL_MAIN_HANDLED
+#include "bullet_pool.h"
+#include "flow_field.h"
+#include "game.h"
+#include "log.h"
+#include "obstacle_grid.h"
+#include "particle_system.h"
+#include "tank_store.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Element counts every kernel is measured at
+const int BENCH_COUNTS[] = {35, 1000, 10000, 100000};
+
+// Size of the real map and how many obstacles it holds
+const int BASE_MAP_WIDTH = 960;
+const int BASE_MAP_HEIGHT = 540;
+const int BASE_OBSTACLE_COUNT = 35;
+
+// Timed runs per benchmark (the median is reported)
+const int BENCH_REPETITIONS = 5;
+
+// Structure for one measured kernel at one count
+struct BenchResult {
+    std::string name;
+    int count;
+    long long iterations; // Operations per timed run
+    double nsPerOp; // Median over the repetitions
+    double itemsPerOp; // Elements one operation covers (count for whole-set kernels, else 1)
+};
+
+// Structure for the synthetic scene a benchmark runs against
+struct BenchScene {
+    int count;
+    int mapWidth;
+    int mapHeight;
+    std::vector<GameObject> grass; // First half of the obstacles
+    std::vector<GameObject> rocks; // Second half
+    std::vector<SDL_Rect> rects; // Every obstacle rect
+    std::vector<SDL_Rect> probes; // Tank-sized rects at random spots on the map
+    std::vector<SDL_Rect> missProbes; // Tank-sized rects just outside the map (never hit)
+    std::vector<SDL_Rect> bulletProbes; // Bullet-sized rects at random spots on the map
+    ObstacleGrid grid;
+    std::vector<uint8_t> mapImage; // Map file image the spawn benchmark reads zones from
+    GameMap map;
+};
+
+// Results are folded into this so the compiler cannot drop the work
+static volatile uint64_t benchSink = 0;
+
+// Function to build a scene with count obstacles (false if the game would not load its map)
+static bool buildBenchScene(BenchScene* scene, int count) {
+    GameRng rng;
+    seedRng(&rng, 0xB3AC4 + count);
+
+    double scale = std::sqrt((double)count / BASE_OBSTACLE_COUNT);
+    scene->count = count;
+    // Sides stop at the largest arena the game loads, which also keeps every position inside Fixed
+    scene->mapWidth = std::min(MAP_MAX_SIZE, std::max(BASE_MAP_WIDTH, (int)(BASE_MAP_WIDTH * scale)));
+    scene->mapHeight = std::min(MAP_MAX_SIZE, std::max(BASE_MAP_HEIGHT, (int)(BASE_MAP_HEIGHT * scale)));
+
+    int grassCount = count / 2;
+    scene->grass.resize(grassCount);
+    scene->rocks.resize(count - grassCount);
+    scene->rects.resize(count);
+    for (int i = 0; i < count; i++) {
+        GameObject& object = i < grassCount ? scene->grass[i] : scene->rocks[i - grassCount];
+        int size = random(&rng, 20, 50);
+        object.rect = {random(&rng, 0, scene->mapWidth - size), random(&rng, 0, scene->mapHeight - size), size, size};
+        object.rotation = (float)random(&rng, 0, 360);
+        object.rotationSpeed = 0.0f;
+        object.size = size;
+        object.isDestroyed = random(&rng, 0, 9) == 0; // About one in ten already shot away
+        object.hasShadow = object.isDestroyed;
+        scene->rects[i] = object.rect;
+    }
+
+    // Probe streams are a power of two long so the index can wrap with a mask
+    const int PROBE_COUNT = 4096;
+    scene->probes.resize(PROBE_COUNT);
+    scene->missProbes.resize(PROBE_COUNT);
+    scene->bulletProbes.resize(PROBE_COUNT);
+    for (int i = 0; i < PROBE_COUNT; i++) {
+        scene->probes[i] = {random(&rng, 0, scene->mapWidth - 40), random(&rng, 0, scene->mapHeight - 48), 40, 48};
+        scene->missProbes[i] = {random(&rng, 0, scene->mapWidth), scene->mapHeight + 100, 40, 48};
+        scene->bulletProbes[i] = {random(&rng, 0, scene->mapWidth - BULLET_WIDTH),
+                                  random(&rng, 0, scene->mapHeight - BULLET_HEIGHT), BULLET_WIDTH, BULLET_HEIGHT};
+    }
+
+    buildObstacleGrid(&scene->grid, scene->grass.data(), scene->rocks.data(), grassCount, count - grassCount);
+
+    // Power boxes spawn in the real map's zone, so spawn cost tracks obstacle density
+    std::vector<MapSpawn> spawns = {{70, 466, 0.0f, 0}, {840, 74, 180.0f, 1}};
+    std::vector<MapZone> zones = {{50, 50, 830, 410}};
+    scene->mapImage = buildMapImage(scene->mapWidth, scene->mapHeight, {}, spawns, zones);
+    scene->map = {};
+    return openMapFromMemory(&scene->map, scene->mapImage.data(), scene->mapImage.size(), "bench");
+}
+
+// Function to time iterations calls of a kernel (returns seconds)
+static double timeKernel(const std::function<uint64_t(long long)>& kernel, long long iterations) {
+    auto start = std::chrono::steady_clock::now();
+    benchSink = benchSink + kernel(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Function to size a run to the time budget, then take the median of several runs
+static BenchResult runBenchmark(const std::string& name, int count, double itemsPerOp, double minSeconds,
+                                const std::function<uint64_t(long long)>& kernel) {
+    // Grow the iteration count until one run fills its share of the budget
+    double runSeconds = minSeconds / BENCH_REPETITIONS;
+    long long iterations = 1;
+    double elapsed = timeKernel(kernel, iterations);
+    while (elapsed < runSeconds && iterations < (1ll << 40)) {
+        double growth = elapsed > 0.0 ? std::min(10.0, std::max(2.0, 1.2 * runSeconds / elapsed)) : 10.0;
+        iterations = (long long)(iterations * growth);
+        elapsed = timeKernel(kernel, iterations);
+    }
+
+    std::vector<double> nsPerOp(BENCH_REPETITIONS);
+    for (int i = 0; i < BENCH_REPETITIONS; i++) {
+        nsPerOp[i] = timeKernel(kernel, iterations) * 1e9 / iterations;
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+
+    BenchResult result;
+    result.name = name;
+    result.count = count;
+    result.iterations = iterations;
+    result.nsPerOp = nsPerOp[BENCH_REPETITIONS / 2];
+    result.itemsPerOp = itemsPerOp;
+    fprintf(stderr, "%-32s %7d %14.1f ns/op\n", name.c_str(), count, result.nsPerOp);
+    return result;
+}
+
+// Function to list the cells of the largest passable region of a nav grid
+// (a flow field seeded in it reaches exactly these cells)
+static std::vector<int> findLargestNavRegion(const NavGrid* nav) {
+    std::vector<bool> seen(nav->blockers.size(), false);
+    std::vector<int> largest;
+    std::vector<int> region;
+    for (int start = 0; start < (int)nav->blockers.size(); start++) {
+        if (seen[start] || nav->blockers[start] != 0) continue;
+        region.clear();
+        region.push_back(start);
+        seen[start] = true;
+        for (size_t head = 0; head < region.size(); head++) {
+            int column = region[head] % nav->columns;
+            int row = region[head] / nav->columns;
+            const int neighbours[4][2] = {{column - 1, row}, {column + 1, row}, {column, row - 1}, {column, row + 1}};
+            for (const int* neighbour : neighbours) {
+                if (neighbour[0] < 0 || neighbour[0] >= nav->columns || neighbour[1] < 0 || neighbour[1] >= nav->rows) {
+                    continue;
+                }
+                int cell = neighbour[1] * nav->columns + neighbour[0];
+                if (!seen[cell] && nav->blockers[cell] == 0) {
+                    seen[cell] = true;
+                    region.push_back(cell);
+                }
+            }
+        }
+        if (region.size() > largest.size()) largest.swap(region);
+    }
+    return largest;
+}
+
+// Function to count the cells a flow field reaches
+static int countReachedCells(const FlowField* field) {
+    return (int)std::count_if(field->distance.begin(), field->distance.end(),
+                              [](uint16_t distance) { return distance != FLOW_UNREACHABLE; });
+}
+
+// Function to run every kernel against one scene
+static void benchmarkScene(BenchScene* scene, const std::string& filter, double minSeconds,
+                           std::vector<BenchResult>* results) {
+    int count = scene->count;
+    int grassCount = (int)scene->grass.size();
+    int rockCount = (int)scene->rocks.size();
+    const int PROBE_MASK = (int)scene->probes.size() - 1;
+    auto selected = [&](const char* name) { return filter.empty() || strstr(name, filter.c_str()) != nullptr; };
+
+    // One rect pair per operation
+    if (selected("checkCollision")) {
+        results->push_back(runBenchmark("checkCollision", count, 1, minSeconds, [&](long long iterations) {
+            uint64_t hits = 0;
+            int object = 0;
+            for (long long i = 0; i < iterations; i++) {
+                hits += checkCollision(scene->probes[i & PROBE_MASK], scene->rects[object]);
+                if (++object == count) object = 0;
+            }
+            return hits;
+        }));
+    }
+
+    // One rect against every obstacle (probes never hit, so the whole list is scanned)
+    if (selected("checkObjectCollision")) {
+        results->push_back(runBenchmark("checkObjectCollision", count, count, minSeconds, [&](long long iterations) {
+            uint64_t hits = 0;
+            for (long long i = 0; i < iterations; i++) {
+                hits += checkObjectCollision(scene->missProbes[i & PROBE_MASK], scene->rects.data(), count);
+            }
+            return hits;
+        }));
+    }
+
+    // Tank against every obstacle by linear scan (random spots, so some return early)
+    if (selected("checkTankCollisionWithObjects")) {
+        results->push_back(runBenchmark("checkTankCollisionWithObjects", count, count, minSeconds, [&](long long iterations) {
+            uint64_t hits = 0;
+            for (long long i = 0; i < iterations; i++) {
+                hits += checkTankCollisionWithObjects(scene->probes[i & PROBE_MASK], scene->grass.data(),
+                                                      scene->rocks.data(), grassCount, rockCount);
+            }
+            return hits;
+        }));
+    }
+
+    // The same query through the obstacle grid the game uses, for comparison
+    if (selected("checkTankCollisionWithGrid")) {
+        results->push_back(runBenchmark("checkTankCollisionWithGrid", count, 1, minSeconds, [&](long long iterations) {
+            uint64_t hits = 0;
+            for (long long i = 0; i < iterations; i++) {
+                hits += checkTankCollisionWithGrid(scene->probes[i & PROBE_MASK], &scene->grid);
+            }
+            return hits;
+        }));
+    }
+
+    // One bullet against one obstacle per operation
+    if (selected("checkBulletObjectCollision")) {
+        std::vector<GameObject> objects(scene->grass);
+        objects.insert(objects.end(), scene->rocks.begin(), scene->rocks.end());
+        results->push_back(runBenchmark("checkBulletObjectCollision", count, 1, minSeconds, [&](long long iterations) {
+            uint64_t hits = 0;
+            int object = 0;
+            for (long long i = 0; i < iterations; i++) {
+                hits += checkBulletObjectCollision(scene->bulletProbes[i & PROBE_MASK], objects[object]);
+                if (++object == count) object = 0;
+            }
+            return hits;
+        }));
+    }
+
+    // One bullet move swept through the obstacle grid, at the current speed
+    // and at a speed that would tunnel through thin objects without the sweep
+    for (Fixed speed : {BULLET_SPEED, fixedFromInt(48)}) {
+        std::string name = speed == BULLET_SPEED ? "sweepObstacleGrid" : "sweepObstacleGrid/fast";
+        if (!selected(name.c_str())) continue;
+        results->push_back(runBenchmark(name, count, 1, minSeconds, [&, speed](long long iterations) {
+            uint64_t hits = 0;
+            for (long long i = 0; i < iterations; i++) {
+                SDL_Rect probe = scene->bulletProbes[i & PROBE_MASK];
+                Fixed direction = fixedFromInt((int)(i % 360));
+                Fixed hitTime;
+                hits += sweepObstacleGrid(&scene->grid, fixedFromInt(probe.x), fixedFromInt(probe.y), probe.w, probe.h,
+                                          speed * fixedSin(direction), -(speed * fixedCos(direction)), &hitTime) != -1;
+            }
+            return hits;
+        }));
+    }
+
+    // One tick of count bullets in flight. The bounds are far away so no
+    // bullet is culled and every run moves the same number.
+    if (selected("updateBullets")) {
+        BulletPool pool;
+        initializeBulletPool(&pool, count);
+        SDL_Rect shooter = {scene->mapWidth / 2, scene->mapHeight / 2, 40, 48};
+        for (int i = 0; i < count; i++) {
+            fireBullet(&pool, shooter, fixedFromInt(i % 360), i & 1, i % 7 == 0);
+        }
+        results->push_back(runBenchmark("updateBullets", count, count, minSeconds, [&](long long iterations) {
+            for (long long i = 0; i < iterations; i++) {
+                updateBullets(&pool, FIXED_MAX, FIXED_MAX);
+            }
+            return (uint64_t)pool.liveCount;
+        }));
+    }
+
+    // One frame of count particles in a steady state: lifetimes are spread
+    // over a second, so about count/60 run out each frame and a burst refills them
+    if (selected("updateParticles")) {
+        ParticleSystem particles;
+        initializeParticleSystem(&particles, count);
+        ParticleBurst burst = {count, 8.0f, 20.0f, 200.0f, 0.02f, 1.0f, 2.0f, 5.0f, {255, 200, 80, 255},
+                               {200, 40, 10, 255}};
+        emitParticles(&particles, scene->mapWidth / 2.0f, scene->mapHeight / 2.0f, &burst);
+        results->push_back(runBenchmark("updateParticles", count, count, minSeconds, [&](long long iterations) {
+            for (long long i = 0; i < iterations; i++) {
+                updateParticles(&particles, 1.0f / 60.0f);
+                burst.count = count - particles.count;
+                if (burst.count > 0) {
+                    emitParticles(&particles, scene->mapWidth / 2.0f, scene->mapHeight / 2.0f, &burst);
+                }
+            }
+            return (uint64_t)particles.count;
+        }));
+    }
+
+    // One tick of the per-tank systems (gun sweep, reload, power-up timers)
+    // over count tanks, half of them reloading and a third powered up
+    if (selected("updateTanks")) {
+        TankStore tanks;
+        clearTankStore(&tanks, count);
+        for (int i = 0; i < count; i++) {
+            SDL_Rect rect = scene->probes[i & PROBE_MASK];
+            addTank(&tanks, i & 1, rect.x, rect.y, fixedFromInt((i % 4) * 90), rect.w, rect.h);
+            tanks.ammo[i] = i % TANK_MAX_AMMO;
+            if (i % 3 == 0) activatePowerUp(&tanks, i);
+        }
+        results->push_back(runBenchmark("updateTanks", count, count, minSeconds, [&](long long iterations) {
+            for (long long i = 0; i < iterations; i++) {
+                updateTankGuns(&tanks);
+                updateTankAmmo(&tanks);
+                updateTankPowerUps(&tanks);
+            }
+            return (uint64_t)tanks.gunRect[0].x;
+        }));
+    }
+
+    // Flow field towards a random spot, computed from scratch over the whole
+    // map. Targets are cells of the largest connected region, so every build
+    // visits the same cells and the items are the cells actually reached.
+    NavGrid nav;
+    std::vector<int> region;
+    if (selected("FlowField")) {
+        buildNavGrid(&nav, scene->grass.data(), scene->rocks.data(), grassCount, rockCount, scene->mapWidth,
+                     scene->mapHeight, 40, 48);
+        region = findLargestNavRegion(&nav);
+    }
+    if (selected("buildFlowField") && !region.empty()) {
+        FlowField field;
+        std::vector<int> targets(scene->probes.size());
+        for (size_t i = 0; i < targets.size(); i++) {
+            SDL_Rect probe = scene->probes[i];
+            targets[i] = region[(size_t)(probe.y * scene->mapWidth + probe.x) % region.size()];
+        }
+        results->push_back(runBenchmark("buildFlowField", count, (double)region.size(), minSeconds,
+                                        [&](long long iterations) {
+            uint64_t total = 0;
+            for (long long i = 0; i < iterations; i++) {
+                buildFlowField(&field, &nav, targets[i & PROBE_MASK]);
+                total += field.distance[i % field.distance.size()];
+            }
+            return total;
+        }));
+    }
+
+    // Shooting away every obstacle one at a time, repairing the field after
+    // each (one operation = rebuild the grid and field, then clear the map).
+    // The field starts in the largest region and the items are the cells it
+    // reaches once the map is clear.
+    if (selected("repairFlowField") && !region.empty()) {
+        FlowField field;
+        std::vector<SDL_Rect> live;
+        for (const GameObject& object : scene->grass) {
+            if (!object.isDestroyed) live.push_back(object.rect);
+        }
+        for (const GameObject& object : scene->rocks) {
+            if (!object.isDestroyed) live.push_back(object.rect);
+        }
+        int target = region[region.size() / 2];
+        auto clearMap = [&]() {
+            buildNavGrid(&nav, scene->grass.data(), scene->rocks.data(), grassCount, rockCount, scene->mapWidth,
+                         scene->mapHeight, 40, 48);
+            buildFlowField(&field, &nav, target);
+            for (const SDL_Rect& rect : live) {
+                openNavObstacle(&nav, rect);
+                repairFlowField(&field, &nav);
+            }
+        };
+        clearMap();
+        results->push_back(runBenchmark("repairFlowField", count, (double)countReachedCells(&field), minSeconds,
+                                        [&](long long iterations) {
+            uint64_t total = 0;
+            for (long long i = 0; i < iterations; i++) {
+                clearMap();
+                total += field.distance[target];
+            }
+            return total;
+        }));
+    }
+
+    // Placing a power box on the map
+    if (selected("spawnPowerBox")) {
+        GameRng rng;
+        seedRng(&rng, 42);
+        PowerBox powerBox = {};
+        TankStore tanks;
+        clearTankStore(&tanks, 2);
+        addTank(&tanks, 0, 100, 100, fixedFromInt(0), 40, 48);
+        addTank(&tanks, 1, 700, 400, fixedFromInt(180), 40, 48);
+        results->push_back(runBenchmark("spawnPowerBox", count, 1, minSeconds, [&](long long iterations) {
+            uint64_t total = 0;
+            for (long long i = 0; i < iterations; i++) {
+                powerBox.active = false;
+                spawnPowerBox(&powerBox, &scene->map, &scene->grid, &tanks, &rng);
+                total += powerBox.rect.x;
+            }
+            return total;
+        }));
+    }
+}
+
+// Function to write the results as JSON
+static void writeResultsJson(FILE* file, const std::vector<BenchResult>& results) {
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        double opsPerSecond = result.nsPerOp > 0.0 ? 1e9 / result.nsPerOp : 0.0;
+        fprintf(file,
+                "    {\"name\": \"%s\", \"count\": %d, \"iterations\": %lld, \"ns_per_op\": %.3f, "
+                "\"ops_per_sec\": %.1f, \"items_per_op\": %.0f, \"items_per_sec\": %.1f}%s\n",
+                result.name.c_str(), result.count, result.iterations, result.nsPerOp, opsPerSecond,
+                result.itemsPerOp, opsPerSecond * result.itemsPerOp, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string outPath;
+    double minSeconds = 0.5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--filter <substring>] [--min-time <seconds>] [--out <file>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // The kernels log (power box spawns); keep that out of the timings
+    setLogLevel(LOG_LEVEL_OFF);
+
+    std::vector<BenchResult> results;
+    for (int count : BENCH_COUNTS) {
+        BenchScene scene;
+        if (!buildBenchScene(&scene, count)) {
+            fprintf(stderr, "Unable to build the %d obstacle scene\n", count);
+            return 1;
+        }
+        benchmarkScene(&scene, filter, minSeconds, &results);
+    }
+
+    FILE* file = outPath.empty() ? stdout : fopen(outPath.c_str(), "w");
+    if (!file) {
+        fprintf(stderr, "Unable to write %s\n", outPath.c_str());
+        return 1;
+    }
+    writeResultsJson(file, results);
+    if (file != stdout) {
+        fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+// tank_server: dedicated server hosting many independent matches in one
+// process, without a window or renderer (see match_host.h).
+//
+//   tank_server [--map <map.tmap>] [--port <first port>] [--matches <n>]
+//               [--seats <n>] [--threads <n>] [--seconds <n>] [--tank-size <w> <h>]
+//   tank_server --capacity-test <matches> [--ticks <n>] [--map ...] [--seats ...] [--threads ...]
+//
+// Match i listens on UDP port <first port> + i; players join it with
+// "app --connect <host>:<port>". --capacity-test simulates the matches
+// with scripted players and no network, as fast as the workers go, and
+// reports how many matches one thread can keep at the tick rate.
+
+#define SDL_MAIN_HANDLED
+#include "log.h"
+#include "map.h"
+#include "match_host.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// Seconds between the host's statistics lines
+const double HOST_STATS_INTERVAL = 10.0;
+
+// Set by SIGINT/SIGTERM
+static std::atomic<bool> stopRequested(false);
+
+// Function to ask the main loop to stop
+static void handleStopSignal(int) {
+    stopRequested = true;
+}
+
+// Function to print how to run the server
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--map <map.tmap>] [--port <first port>] [--matches <n>] [--seats <n>] [--threads <n>]\n"
+            "          [--seconds <n>] [--tank-size <w> <h>]\n"
+            "       %s --capacity-test <matches> [--ticks <n>] [--map ...] [--seats ...] [--threads ...]\n",
+            program, program);
+}
+
+// Function to report the capacity test
+static int runCapacityTest(const GameMap* map, const MatchHostConfig* config, int ticks) {
+    LOG_WARN("[HOST] Capacity test: %d matches of %d seats, %d ticks each, %d threads", config->matchCount,
+             config->seatsPerMatch, ticks, config->threadCount);
+    MatchCapacityResult result = runMatchCapacityTest(map, config->matchCount, ticks, config->seatsPerMatch,
+                                                      config->threadCount, config->tankWidth, config->tankHeight);
+    double matchTicks = (double)result.matches * result.ticks;
+    LOG_WARN("[HOST] %.0f match ticks in %.2f s (%.0f per second)", matchTicks, result.seconds,
+             result.seconds > 0.0 ? matchTicks / result.seconds : 0.0);
+    LOG_WARN("[HOST] Per match tick: simulation %.1f us, snapshots %.1f us (%d bytes on average)",
+             result.simulateMicroseconds, result.snapshotMicroseconds, result.snapshotBytes);
+    LOG_WARN("[HOST] One thread keeps about %.0f matches at %d Hz", result.matchesPerThread, SIMULATION_TICK_RATE);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string mapPath = DEFAULT_MAP_FILE;
+    MatchHostConfig config = {};
+    config.firstPort = SERVER_DEFAULT_PORT;
+    config.matchCount = 16;
+    config.seatsPerMatch = 2;
+    config.threadCount = 0;
+    config.tankWidth = SERVER_TANK_WIDTH;
+    config.tankHeight = SERVER_TANK_HEIGHT;
+    config.seed = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+    double seconds = 0.0;
+    int capacityMatches = 0;
+    int capacityTicks = 1200;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--map") == 0 && i + 1 < argc) {
+            mapPath = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            config.firstPort = (uint16_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+            config.matchCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seats") == 0 && i + 1 < argc) {
+            config.seatsPerMatch = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threadCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--tank-size") == 0 && i + 2 < argc) {
+            config.tankWidth = atoi(argv[++i]);
+            config.tankHeight = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--capacity-test") == 0 && i + 1 < argc) {
+            capacityMatches = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            capacityTicks = atoi(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.seatsPerMatch < 1 || config.seatsPerMatch > SERVER_MAX_TANKS) {
+        fprintf(stderr, "--seats must be 1 to %d\n", SERVER_MAX_TANKS);
+        return 1;
+    }
+    if (config.threadCount <= 0) {
+        config.threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    if (config.matchCount < 1 || config.firstPort + config.matchCount - 1 > 65535) {
+        fprintf(stderr, "--matches must be at least 1 and the ports must fit below 65536\n");
+        return 1;
+    }
+
+    GameMap map;
+    if (!loadMap(&map, mapPath)) {
+        LOG_ERROR("[HOST] Could not load map %s", mapPath.c_str());
+        return 1;
+    }
+
+    if (capacityMatches > 0) {
+        setLogLevel(LOG_LEVEL_WARN);
+        config.matchCount = capacityMatches;
+        int result = runCapacityTest(&map, &config, capacityTicks);
+        closeMap(&map);
+        return result;
+    }
+
+    // Every match logs its own events; a few hundred of them need a quieter log
+    if (config.matchCount > 32) {
+        setLogLevel(LOG_LEVEL_WARN);
+    }
+
+    MatchHost host;
+    if (!startMatchHost(&host, &map, &config)) {
+        closeMap(&map);
+        return 1;
+    }
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+
+    auto start = std::chrono::steady_clock::now();
+    double lastStatsTime = 0.0;
+    MatchHostStats last = getMatchHostStats(&host);
+    while (!stopRequested.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds > 0.0 && now >= seconds) break;
+        if (now - lastStatsTime < HOST_STATS_INTERVAL) continue;
+
+        // Load is busy time over wall time, summed over the workers
+        MatchHostStats stats = getMatchHostStats(&host);
+        double elapsed = now - lastStatsTime;
+        LOG_WARN("[HOST] %d players, %d matches playing, %d finished; %.0f ticks/s, %.1f kB/s sent, "
+                 "load %.1f%% of %d threads",
+                 stats.players, stats.playing, stats.finished, (stats.ticks - last.ticks) / elapsed,
+                 (stats.bytesSent - last.bytesSent) / elapsed / 1024.0,
+                 (stats.busyMicroseconds - last.busyMicroseconds) / (elapsed * 1e4 * host.config.threadCount),
+                 host.config.threadCount);
+        last = stats;
+        lastStatsTime = now;
+    }
+
+    LOG_WARN("[HOST] Stopping");
+    stopMatchHost(&host);
+    closeMap(&map);
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include "tank_store.h"
+#include "bullet_pool.h"
+#include "log.h"
+#include <algorithm>
+
+// Function to remove every tank and reserve room for capacity of them
+void clearTankStore(TankStore* tanks, int capacity) {
+    tanks->count = 0;
+    tanks->rect.clear();
+    tanks->prevRect.clear();
+    tanks->rotation.clear();
+    tanks->speed.clear();
+    tanks->gunRotation.clear();
+    tanks->prevGunRotation.clear();
+    tanks->gunRect.clear();
+    tanks->ammo.clear();
+    tanks->reloadTimer.clear();
+    tanks->powerTimer.clear();
+    tanks->hp.clear();
+    tanks->flags.clear();
+    tanks->info.clear();
+
+    tanks->rect.reserve(capacity);
+    tanks->prevRect.reserve(capacity);
+    tanks->rotation.reserve(capacity);
+    tanks->speed.reserve(capacity);
+    tanks->gunRotation.reserve(capacity);
+    tanks->prevGunRotation.reserve(capacity);
+    tanks->gunRect.reserve(capacity);
+    tanks->ammo.reserve(capacity);
+    tanks->reloadTimer.reserve(capacity);
+    tanks->powerTimer.reserve(capacity);
+    tanks->hp.reserve(capacity);
+    tanks->flags.reserve(capacity);
+    tanks->info.reserve(capacity);
+}
+
+// Function to add a tank in its spawn state
+int addTank(TankStore* tanks, int team, int x, int y, Fixed rotation, int width, int height) {
+    SDL_Rect rect = {x, y, width, height};
+    tanks->rect.push_back(rect);
+    tanks->prevRect.push_back(rect); // No motion to interpolate from on spawn
+    tanks->rotation.push_back(rotation);
+    tanks->speed.push_back(TANK_SPEED);
+    tanks->gunRotation.push_back(fixedFromInt(0)); // Gun starts at center
+    tanks->prevGunRotation.push_back(fixedFromInt(0));
+    tanks->gunRect.push_back(getGunRect(rect, rotation));
+    tanks->ammo.push_back(TANK_MAX_AMMO); // Start with full ammo
+    tanks->reloadTimer.push_back(0);
+    tanks->powerTimer.push_back(0);
+    tanks->hp.push_back(TANK_MAX_HP);
+    tanks->flags.push_back(TANK_GUN_RIGHT); // Gun starts sweeping right
+
+    TankInfo info;
+    info.team = team;
+    info.score = 0;
+    info.explosionItemCount = 0;
+    info.originalSpeed = TANK_SPEED;
+    info.originalWidth = width;
+    info.originalHeight = height;
+    tanks->info.push_back(info);
+    return tanks->count++;
+}
+
+// Function to count the tanks still in the match
+int countAliveTanks(const TankStore* tanks, int* lastAlive) {
+    int alive = 0;
+    *lastAlive = -1;
+    for (int i = 0; i < tanks->count; i++) {
+        if (isTankAlive(tanks, i)) {
+            alive++;
+            *lastAlive = i;
+        }
+    }
+    return alive;
+}
+
+// Function to remember every tank's position for interpolation
+void storeTankPrevious(TankStore* tanks) {
+    tanks->prevRect = tanks->rect;
+    tanks->prevGunRotation = tanks->gunRotation;
+}
+
+// Function to get the gun rect for a body rect and rotation
+SDL_Rect getGunRect(SDL_Rect body, Fixed rotation) {
+    // Calculate gun dimensions
+    int gunWidth = body.w * TANK_GUN_WIDTH_PERCENT / 100;
+    int gunHeight = body.h * TANK_GUN_HEIGHT_PERCENT / 100;
+
+    // Set specific offsets for each direction
+    int offsetX = 0;
+    int offsetY = 0;
+    if (rotation == fixedFromInt(0)) {
+        // Facing up - gun above center
+        offsetY = -20;
+    } else if (rotation == fixedFromInt(90)) {
+        // Facing right - gun to the right
+        offsetX = 25;
+        offsetY = 5;
+    } else if (rotation == fixedFromInt(180)) {
+        // Facing down - gun below center
+        offsetY = body.h / 2 - 18;
+    } else if (rotation == fixedFromInt(270)) {
+        // Facing left - gun to the left
+        offsetX = -12;
+        offsetY = 6;
+    }
+
+    // Position gun at center of tank body with specific offset
+    SDL_Rect gun = {body.x + (body.w - gunWidth) / 2 + offsetX, body.y + (body.h - gunHeight) / 2 + offsetY,
+                    gunWidth, gunHeight};
+    return gun;
+}
+
+// Function to sweep every gun back and forth and update the gun rects
+void updateTankGuns(TankStore* tanks, int begin, int end) {
+    end = std::min(end, tanks->count);
+    for (int i = begin; i < end; i++) {
+        Fixed gunRotation = tanks->gunRotation[i];
+        if (tanks->flags[i] & TANK_GUN_RIGHT) {
+            gunRotation += TANK_GUN_ROTATION_STEP;
+            if (gunRotation >= TANK_GUN_MAX_ROTATION) {
+                gunRotation = TANK_GUN_MAX_ROTATION;
+                tanks->flags[i] &= ~TANK_GUN_RIGHT;
+            }
+        } else {
+            gunRotation -= TANK_GUN_ROTATION_STEP;
+            if (gunRotation <= -TANK_GUN_MAX_ROTATION) {
+                gunRotation = -TANK_GUN_MAX_ROTATION;
+                tanks->flags[i] |= TANK_GUN_RIGHT;
+            }
+        }
+        tanks->gunRotation[i] = gunRotation;
+        tanks->gunRect[i] = getGunRect(tanks->rect[i], tanks->rotation[i]);
+    }
+}
+
+// Function to reload every tank for one tick, one round per TANK_RELOAD_TICKS
+void updateTankAmmo(TankStore* tanks, int begin, int end) {
+    end = std::min(end, tanks->count);
+    for (int i = begin; i < end; i++) {
+        if (tanks->ammo[i] >= TANK_MAX_AMMO) continue;
+
+        tanks->reloadTimer[i]++;
+        if (tanks->reloadTimer[i] >= TANK_RELOAD_TICKS) {
+            tanks->ammo[i]++;
+            tanks->reloadTimer[i] = 0;
+            LOG_DEBUG("[AMMO] Tank %d reloaded! Current ammo: %d/%d", i, tanks->ammo[i], TANK_MAX_AMMO);
+        }
+    }
+}
+
+// Function to count down every power-up one tick and restore tanks whose power-up ended
+void updateTankPowerUps(TankStore* tanks, int begin, int end) {
+    end = std::min(end, tanks->count);
+    for (int i = begin; i < end; i++) {
+        if (!(tanks->flags[i] & TANK_POWERED)) continue;
+
+        tanks->powerTimer[i]--;
+        if (tanks->powerTimer[i] <= 0) {
+            // Restore original speed, size and position
+            const TankInfo& info = tanks->info[i];
+            tanks->speed[i] = info.originalSpeed;
+            tanks->rect[i].x -= info.originalWidth / 4;
+            tanks->rect[i].y -= info.originalHeight / 4;
+            tanks->rect[i].w = info.originalWidth;
+            tanks->rect[i].h = info.originalHeight;
+
+            tanks->flags[i] &= ~TANK_POWERED;
+            LOG_INFO("[POWERUP] Tank %d power-up expired! Size and speed restored.", i);
+        }
+    }
+}
+
+// Function to get the rect of one explosion item icon next to a tank
+SDL_Rect getTankBombRect(SDL_Rect body, int slot) {
+    SDL_Rect bomb = {body.x + body.w + 5 + slot * 20, // In a row to the right
+                     body.y + body.h / 2 - 12, // Centered vertically
+                     24, 24};
+    return bomb;
+}
+
+// Function to destroy a tank (leaves a shadow)
+void destroyTank(TankStore* tanks, int tank) {
+    if (isTankAlive(tanks, tank)) {
+        tanks->flags[tank] |= TANK_DESTROYED | TANK_SHADOW;
+        tanks->hp[tank] = 0;
+    }
+}
+
+// Function to activate the speed power-up on a tank
+void activatePowerUp(TankStore* tanks, int tank) {
+    if (tanks->flags[tank] & TANK_POWERED) return;
+
+    // Store original values
+    TankInfo* info = &tanks->info[tank];
+    info->originalSpeed = tanks->speed[tank];
+    info->originalWidth = tanks->rect[tank].w;
+    info->originalHeight = tanks->rect[tank].h;
+
+    tanks->flags[tank] |= TANK_POWERED;
+    tanks->powerTimer[tank] = TANK_POWER_TICKS;
+    tanks->speed[tank] = tanks->speed[tank] * 2; // Double speed
+    LOG_INFO("[POWERUP] Tank %d activated power-up! Size reduced, speed doubled!", tank);
+}
+
+// Function to fire a normal bullet if the tank has ammo
+bool tryFireBullet(BulletPool* bullets, TankStore* tanks, int tank) {
+    if (tanks->ammo[tank] <= 0) {
+        return false;
+    }
+
+    // Consume ammo
+    tanks->ammo[tank]--;
+    tanks->reloadTimer[tank] = 0; // Reset reload timer
+
+    // Fire along body + gun rotation
+    fireBullet(bullets, tanks->rect[tank], tanks->rotation[tank] + tanks->gunRotation[tank], tank);
+    LOG_DEBUG("[AMMO] Tank %d fired! Remaining ammo: %d/%d", tank, tanks->ammo[tank], TANK_MAX_AMMO);
+    return true;
+}
+
+// Function to fire an explosion bullet if the tank has explosion items
+bool fireExplosionBullet(BulletPool* bullets, TankStore* tanks, int tank) {
+    TankInfo* info = &tanks->info[tank];
+    if (info->explosionItemCount <= 0) {
+        return false;
+    }
+
+    info->explosionItemCount--; // Use one explosion item
+    fireBullet(bullets, tanks->rect[tank], tanks->rotation[tank] + tanks->gunRotation[tank], tank, true);
+    LOG_INFO("[EXPLOSION] Tank %d fired explosion bullet! Remaining items: %d", tank, info->explosionItemCount);
+    return true;
+}
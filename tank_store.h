@@ -0,0 +1,124 @@
+#pragma once
+
+// Component storage for every tank in a match. The fields the simulation
+// touches each tick (transform, gun, ammo, health) each live in their own
+// packed array, so every system (gun rotation, ammo, power-ups, movement,
+// drawing) is one loop over just the arrays it needs. Fields only read on
+// rare events (score, pickups, values restored when a power-up ends) sit
+// together in TankInfo, off the hot path.
+//
+// A tank is an index 0..count-1. Bullets, the shield and the winner refer
+// to tanks by index. Every tank is hostile to every other one; the team
+// only picks the spawn point and the sprite color (0 blue, 1 red).
+
+#include "game.h"
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+struct BulletPool;
+
+// Most tanks in one match
+const int MAX_TANKS = 64;
+
+// Tank tuning
+const Fixed TANK_SPEED = fixedFromInt(2); // Pixels per tick
+const Fixed TANK_GUN_ROTATION_STEP = fixedFromRatio(30, SIMULATION_TICK_RATE); // Degrees per tick (30 per second)
+const Fixed TANK_GUN_MAX_ROTATION = fixedFromInt(45); // Gun sweeps between -45 and +45 degrees
+const int TANK_GUN_WIDTH_PERCENT = 50; // Gun size relative to the body
+const int TANK_GUN_HEIGHT_PERCENT = 70;
+const int TANK_MAX_AMMO = 5;
+const int TANK_RELOAD_TICKS = SIMULATION_TICK_RATE / 2; // Half a second per round
+const int TANK_MAX_HP = 100;
+const int TANK_POWER_TICKS = 15 * SIMULATION_TICK_RATE; // 15 seconds of speed boost per power-up
+const int TANK_BOMB_ICONS = 5; // Explosion items drawn next to a tank
+
+// Tank flags
+const uint8_t TANK_MOVING = 1;
+const uint8_t TANK_DESTROYED = 2;
+const uint8_t TANK_GUN_RIGHT = 4; // Gun is sweeping right
+const uint8_t TANK_POWERED = 8; // Power-up active
+const uint8_t TANK_SHADOW = 16; // Shadow left where the tank was destroyed
+
+// Structure for the fields of a tank that are not touched every tick
+struct TankInfo {
+    int team; // Spawn point and sprite color
+    int score;
+    int explosionItemCount; // Explosion bullets left
+    Fixed originalSpeed; // Restored when the power-up ends
+    int originalWidth;
+    int originalHeight;
+};
+
+// Structure for all tanks of a match; index i is one tank across every array
+struct TankStore {
+    int count;
+    std::vector<SDL_Rect> rect; // Body
+    std::vector<SDL_Rect> prevRect; // Body at the previous tick (render interpolation)
+    std::vector<Fixed> rotation; // Body rotation in degrees
+    std::vector<Fixed> speed; // Pixels per tick
+    std::vector<Fixed> gunRotation; // Degrees relative to the body (-45 to +45)
+    std::vector<Fixed> prevGunRotation; // Gun rotation at the previous tick
+    std::vector<SDL_Rect> gunRect; // Gun position and size for drawing
+    std::vector<int> ammo; // Rounds ready (0 to TANK_MAX_AMMO)
+    std::vector<int> reloadTimer; // Ticks spent on the next round
+    std::vector<int> powerTimer; // Power-up ticks left
+    std::vector<int> hp;
+    std::vector<uint8_t> flags; // TANK_* bits
+    std::vector<TankInfo> info;
+};
+
+// Structure for where to draw a tank between two ticks
+struct TankPose {
+    SDL_Rect rect;
+    SDL_Rect gunRect;
+    float rotation; // Degrees
+    float gunRotation;
+};
+
+// Function to remove every tank and reserve room for capacity of them
+void clearTankStore(TankStore* tanks, int capacity = MAX_TANKS);
+
+// Function to add a tank in its spawn state (returns its index)
+int addTank(TankStore* tanks, int team, int x, int y, Fixed rotation, int width, int height);
+
+// Function to check if a tank is still in the match
+inline bool isTankAlive(const TankStore* tanks, int tank) {
+    return (tanks->flags[tank] & TANK_DESTROYED) == 0;
+}
+
+// Function to count the tanks still in the match (*lastAlive gets one of them, -1 if none)
+int countAliveTanks(const TankStore* tanks, int* lastAlive);
+
+// Function to remember every tank's position for interpolation
+void storeTankPrevious(TankStore* tanks);
+
+// Per-tank systems over tanks [begin, end) (every tank by default). Each
+// tank only touches its own slots, so ranges can run on different threads.
+
+// Function to sweep the guns one tick and update the gun rects
+void updateTankGuns(TankStore* tanks, int begin = 0, int end = INT_MAX);
+
+// Function to reload the tanks for one tick
+void updateTankAmmo(TankStore* tanks, int begin = 0, int end = INT_MAX);
+
+// Function to count down the power-ups one tick and restore tanks whose power-up ended
+void updateTankPowerUps(TankStore* tanks, int begin = 0, int end = INT_MAX);
+
+// Function to get the gun rect for a body rect and rotation
+SDL_Rect getGunRect(SDL_Rect body, Fixed rotation);
+
+// Function to get the rect of one explosion item icon next to a tank
+SDL_Rect getTankBombRect(SDL_Rect body, int slot);
+
+// Function to destroy a tank (leaves a shadow)
+void destroyTank(TankStore* tanks, int tank);
+
+// Function to activate the speed power-up on a tank
+void activatePowerUp(TankStore* tanks, int tank);
+
+// Function to fire a normal bullet if the tank has ammo (true if fired)
+bool tryFireBullet(BulletPool* bullets, TankStore* tanks, int tank);
+
+// Function to fire an explosion bullet if the tank has explosion items (true if fired)
+bool fireExplosionBullet(BulletPool* bullets, TankStore* tanks, int tank);
@@ -0,0 +1,204 @@
+#include "texture_atlas.h"
+#include "log.h"
+#include <algorithm>
+
+// Size of the solid white image (sampled at its center, so filtering stays white)
+const int ATLAS_WHITE_SIZE = 4;
+
+// Structure for a page being filled shelf by shelf
+struct PageLayout {
+    int width;
+    int height; // Rows used so far (pages are trimmed to this)
+    int shelfX; // Next free column on the current shelf
+    int shelfY; // Top of the current shelf
+    int shelfHeight; // Tallest image on the current shelf
+    bool dedicated; // Holds a single image too large for a shared page
+};
+
+// Function to start an empty atlas (adds the white sprite)
+void initializeTextureAtlas(TextureAtlas* atlas, int pageSize) {
+    atlas->pageSize = pageSize;
+    atlas->pages.clear();
+    atlas->sprites.clear();
+    atlas->pending.clear();
+    atlas->whiteSprite = -1;
+
+    SDL_Surface* white = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WHITE_SIZE, ATLAS_WHITE_SIZE, 32, SDL_PIXELFORMAT_RGBA32);
+    if (white) {
+        SDL_FillRect(white, NULL, 0xFFFFFFFF);
+        atlas->whiteSprite = addAtlasImage(atlas, white);
+        SDL_FreeSurface(white);
+    }
+}
+
+// Function to queue an image for packing and get its sprite id
+int addAtlasImage(TextureAtlas* atlas, SDL_Surface* surface) {
+    if (!surface) return -1;
+
+    SDL_Surface* copy = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    if (!copy) {
+        LOG_ERROR("[ERROR] Unable to convert image for the atlas! SDL Error: %s", SDL_GetError());
+        return -1;
+    }
+
+    AtlasSprite sprite = {};
+    sprite.page = -1;
+    sprite.source.w = copy->w;
+    sprite.source.h = copy->h;
+    atlas->sprites.push_back(sprite);
+    atlas->pending.push_back(copy);
+    return (int)atlas->sprites.size() - 1;
+}
+
+// Function to place an image on the last shared page (opening a new shelf or page when full)
+static int placeOnPage(std::vector<PageLayout>& layouts, int pageSize, int width, int height, int* x, int* y) {
+    // Images that cannot share a page get one of their own
+    if (width > pageSize || height > pageSize) {
+        PageLayout layout = {width, height, width, 0, height, true};
+        layouts.push_back(layout);
+        *x = 0;
+        *y = 0;
+        return (int)layouts.size() - 1;
+    }
+
+    int page = -1;
+    for (int i = (int)layouts.size() - 1; i >= 0; i--) {
+        if (!layouts[i].dedicated) {
+            page = i;
+            break;
+        }
+    }
+
+    if (page != -1) {
+        PageLayout& layout = layouts[page];
+        if (layout.shelfX + width > pageSize) {
+            // Start a new shelf below the current one
+            layout.shelfY += layout.shelfHeight;
+            layout.shelfX = 0;
+            layout.shelfHeight = 0;
+        }
+        if (layout.shelfY + height > pageSize) {
+            page = -1; // Page is full
+        }
+    }
+
+    if (page == -1) {
+        PageLayout layout = {pageSize, 0, 0, 0, 0, false};
+        layouts.push_back(layout);
+        page = (int)layouts.size() - 1;
+    }
+
+    PageLayout& layout = layouts[page];
+    *x = layout.shelfX;
+    *y = layout.shelfY;
+    layout.shelfX += width;
+    layout.shelfHeight = std::max(layout.shelfHeight, height);
+    layout.height = std::max(layout.height, layout.shelfY + layout.shelfHeight);
+    return page;
+}
+
+// Function to pack every queued image and upload the pages
+bool buildTextureAtlas(TextureAtlas* atlas, SDL_Renderer* renderer) {
+    int pageSize = atlas->pageSize;
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.max_texture_width > 0) {
+        pageSize = std::min(pageSize, std::min(info.max_texture_width, info.max_texture_height));
+    }
+
+    // Tallest images first keeps the shelves tight
+    std::vector<int> order;
+    for (int id = 0; id < (int)atlas->pending.size(); id++) {
+        if (atlas->pending[id]) {
+            order.push_back(id);
+        }
+    }
+    std::sort(order.begin(), order.end(), [atlas](int a, int b) {
+        if (atlas->pending[a]->h != atlas->pending[b]->h) {
+            return atlas->pending[a]->h > atlas->pending[b]->h;
+        }
+        return a < b;
+    });
+
+    std::vector<PageLayout> layouts;
+    int firstPage = (int)atlas->pages.size();
+    for (int id : order) {
+        AtlasSprite& sprite = atlas->sprites[id];
+        int x, y;
+        int page = placeOnPage(layouts, pageSize, sprite.source.w + 2 * ATLAS_PADDING,
+                               sprite.source.h + 2 * ATLAS_PADDING, &x, &y);
+        sprite.page = firstPage + page;
+        sprite.source.x = x + ATLAS_PADDING;
+        sprite.source.y = y + ATLAS_PADDING;
+    }
+
+    // Copy the images into one surface per page (starts fully transparent)
+    std::vector<SDL_Surface*> pageSurfaces(layouts.size(), nullptr);
+    bool success = true;
+    for (size_t i = 0; i < layouts.size(); i++) {
+        pageSurfaces[i] = SDL_CreateRGBSurfaceWithFormat(0, layouts[i].width, layouts[i].height, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!pageSurfaces[i]) {
+            LOG_ERROR("[ERROR] Unable to create %dx%d atlas page! SDL Error: %s",
+                      layouts[i].width, layouts[i].height, SDL_GetError());
+            success = false;
+        }
+    }
+
+    for (int id : order) {
+        AtlasSprite& sprite = atlas->sprites[id];
+        SDL_Surface* target = pageSurfaces[sprite.page - firstPage];
+        if (target) {
+            // Copy alpha as-is instead of blending onto the empty page
+            SDL_SetSurfaceBlendMode(atlas->pending[id], SDL_BLENDMODE_NONE);
+            SDL_Rect destination = sprite.source;
+            SDL_BlitSurface(atlas->pending[id], NULL, target, &destination);
+        }
+        SDL_FreeSurface(atlas->pending[id]);
+        atlas->pending[id] = nullptr;
+    }
+
+    // Upload the pages and work out texture coordinates
+    for (size_t i = 0; i < layouts.size(); i++) {
+        SDL_Texture* texture = nullptr;
+        if (pageSurfaces[i]) {
+            texture = SDL_CreateTextureFromSurface(renderer, pageSurfaces[i]);
+            SDL_FreeSurface(pageSurfaces[i]);
+            if (!texture) {
+                LOG_ERROR("[ERROR] Unable to create atlas page texture! SDL Error: %s", SDL_GetError());
+                success = false;
+            } else {
+                SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            }
+        }
+        atlas->pages.push_back(texture);
+    }
+
+    for (int id : order) {
+        AtlasSprite& sprite = atlas->sprites[id];
+        const PageLayout& layout = layouts[sprite.page - firstPage];
+        sprite.u0 = (float)sprite.source.x / layout.width;
+        sprite.v0 = (float)sprite.source.y / layout.height;
+        sprite.u1 = (float)(sprite.source.x + sprite.source.w) / layout.width;
+        sprite.v1 = (float)(sprite.source.y + sprite.source.h) / layout.height;
+    }
+
+    LOG_INFO("[ATLAS] Packed %d images into %d page(s)", (int)order.size(), (int)layouts.size());
+    return success;
+}
+
+// Function to free the pages and any images still queued
+void destroyTextureAtlas(TextureAtlas* atlas) {
+    for (SDL_Texture* page : atlas->pages) {
+        if (page) {
+            SDL_DestroyTexture(page);
+        }
+    }
+    for (SDL_Surface* surface : atlas->pending) {
+        if (surface) {
+            SDL_FreeSurface(surface);
+        }
+    }
+    atlas->pages.clear();
+    atlas->sprites.clear();
+    atlas->pending.clear();
+    atlas->whiteSprite = -1;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// Packs many small images into a few large textures ("pages") so sprites
+// that share a page can be drawn together in one SDL_RenderGeometry call
+// (see sprite_batch.h).
+//
+// Images are added as surfaces, then buildTextureAtlas() shelf-packs them
+// and uploads one texture per page. Sprites are referred to by the id
+// returned from addAtlasImage().
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Largest page edge in pixels (smaller if the renderer cannot do it)
+const int ATLAS_PAGE_SIZE = 2048;
+
+// Transparent gap around every image so neighbours never bleed into each other
+const int ATLAS_PADDING = 1;
+
+// Structure for one packed image
+struct AtlasSprite {
+    int page; // Index into pages
+    SDL_Rect source; // Pixel rect inside the page (w/h are valid before building)
+    float u0, v0, u1, v1; // Normalized texture coordinates of source
+};
+
+// Structure for the atlas pages and every sprite packed into them
+struct TextureAtlas {
+    int pageSize;
+    std::vector<SDL_Texture*> pages;
+    std::vector<AtlasSprite> sprites;
+    std::vector<SDL_Surface*> pending; // RGBA copies waiting for buildTextureAtlas (one per sprite)
+    int whiteSprite; // Solid white image for untextured rects
+};
+
+// Function to start an empty atlas (adds the white sprite)
+void initializeTextureAtlas(TextureAtlas* atlas, int pageSize = ATLAS_PAGE_SIZE);
+
+// Function to queue an image for packing and get its sprite id
+// (-1 if surface is null). The atlas keeps its own copy, the caller still owns surface.
+int addAtlasImage(TextureAtlas* atlas, SDL_Surface* surface);
+
+// Function to pack every queued image and upload the pages
+bool buildTextureAtlas(TextureAtlas* atlas, SDL_Renderer* renderer);
+
+// Function to free the pages and any images still queued
+void destroyTextureAtlas(TextureAtlas* atlas);
@@ -0,0 +1,567 @@
+#include "world.h"
+#include "job_system.h"
+#include "log.h"
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+
+// Function to pick the spawn point for the n-th tank of a team (cycles through the team's spawns)
+static const MapSpawn* pickTeamSpawn(const GameMap* map, int team, int n) {
+    int teamSpawns = 0;
+    for (uint32_t i = 0; i < map->header->spawnCount; i++) {
+        if ((int)map->spawns[i].team == team) teamSpawns++;
+    }
+
+    int wanted = n % teamSpawns; // Maps always have spawns for both teams
+    for (uint32_t i = 0; i < map->header->spawnCount; i++) {
+        if ((int)map->spawns[i].team == team && wanted-- == 0) return &map->spawns[i];
+    }
+    return &map->spawns[0];
+}
+
+// Function to check if a rect overlaps any tank other than skip
+static bool isBlockedByTank(const TankStore* tanks, int skip, SDL_Rect rect) {
+    for (int i = 0; i < tanks->count; i++) {
+        if (i != skip && checkTankCollision(rect, tanks->rect[i])) return true;
+    }
+    return false;
+}
+
+// Function to find a free spot for a new tank, searching rings of
+// tank-sized steps around the spawn point
+static SDL_Rect findTankSpawnRect(const World* world, const MapSpawn* spawn) {
+    const int SPAWN_GAP = 8; // Space left between tanks spawned side by side
+    const int SPAWN_RINGS = 32;
+    int width = world->tankWidth;
+    int height = world->tankHeight;
+    SDL_Rect center = {spawn->x - width / 2, spawn->y - height / 2, width, height};
+
+    for (int ring = 0; ring <= SPAWN_RINGS; ring++) {
+        for (int dy = -ring; dy <= ring; dy++) {
+            for (int dx = -ring; dx <= ring; dx++) {
+                if (std::max(std::abs(dx), std::abs(dy)) != ring) continue; // Only the edge of the ring
+
+                SDL_Rect rect = center;
+                rect.x += dx * (width + SPAWN_GAP);
+                rect.y += dy * (height + SPAWN_GAP);
+                if (rect.x < 0 || rect.y < 0 || rect.x + width > world->mapWidth ||
+                    rect.y + height > world->mapHeight) {
+                    continue;
+                }
+                if (!checkTankCollisionWithGrid(rect, &world->obstacleGrid) &&
+                    !isBlockedByTank(&world->tanks, -1, rect)) {
+                    return rect;
+                }
+            }
+        }
+    }
+    return center; // Crowded map, stack on the spawn point
+}
+
+// Function to reset the whole match (tanks, bullets, obstacles, pickups)
+void initializeWorld(World* world, const GameMap* map, int tankWidth, int tankHeight, uint64_t seed, int tankCount) {
+    world->map = map;
+    world->mapWidth = map->header->width;
+    world->mapHeight = map->header->height;
+    world->tankWidth = tankWidth;
+    world->tankHeight = tankHeight;
+    world->winner = -1;
+    world->seed = seed;
+    world->tick = 0;
+    world->destroyedObstacleHash = 0;
+    world->destroyedObstacles.clear();
+    seedRng(&world->rng, seed);
+
+    initializeGameObjects(&world->grassObjects, &world->rockObjects, map, &world->obstacleGrid);
+    buildWorldChunks(&world->chunks, world->grassObjects.data(), world->rockObjects.data(),
+                     (int)world->grassObjects.size(), (int)world->rockObjects.size(), world->mapWidth, world->mapHeight);
+    buildNavGrid(&world->navGrid, world->grassObjects.data(), world->rockObjects.data(),
+                 (int)world->grassObjects.size(), (int)world->rockObjects.size(), world->mapWidth, world->mapHeight,
+                 tankWidth, tankHeight);
+
+    // Teams alternate, so tanks 0 and 1 are the blue and red players
+    tankCount = std::max(1, std::min(MAX_TANKS, tankCount));
+    clearTankStore(&world->tanks, tankCount);
+    for (int i = 0; i < tankCount; i++) {
+        int team = i % 2;
+        const MapSpawn* spawn = pickTeamSpawn(map, team, i / 2);
+        SDL_Rect rect = findTankSpawnRect(world, spawn);
+        addTank(&world->tanks, team, rect.x, rect.y, fixedFromFloat(spawn->rotation), tankWidth, tankHeight);
+    }
+
+    initializeBulletPool(&world->bullets);
+
+    // Inactive effects are zeroed too, as snapshots carry their fields
+    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
+        world->explosions[i] = Explosion();
+    }
+
+    world->powerBox.rect = {0, 0, 0, 0};
+    world->powerBox.active = false;
+    world->powerBox.spawnTimer = 0;
+    world->powerBox.disappearTimer = 0;
+    world->powerBox.spawnCount = 0;
+    world->powerBox.boxType = 0;
+
+    world->shield.active = false;
+    world->shield.timer = 0;
+    world->shield.duration = 0;
+    world->shield.owner = -1;
+
+    updateActiveChunks(&world->chunks, world->tanks.rect.data(), world->tanks.count);
+}
+
+// Function to handle shooting requests for one tank
+static void handleTankShooting(World* world, int tank, const TankInput& input) {
+    if (!isTankAlive(&world->tanks, tank)) return;
+
+    if (input.fire) {
+        if (!tryFireBullet(&world->bullets, &world->tanks, tank)) {
+            LOG_DEBUG("Tank %d out of ammo!", tank);
+        }
+    }
+
+    if (input.fireExplosion) {
+        if (!fireExplosionBullet(&world->bullets, &world->tanks, tank)) {
+            LOG_DEBUG("Tank %d has no explosion items!", tank);
+        }
+    }
+}
+
+// Function to move tank one step in a direction unless blocked
+static void tryMoveTank(World* world, int tank, int dirX, int dirY, int rotation) {
+    TankStore* tanks = &world->tanks;
+    tanks->rotation[tank] = fixedFromInt(rotation);
+    int speed = fixedFloor(tanks->speed[tank]); // Tanks move in whole pixels
+    SDL_Rect newRect = tanks->rect[tank];
+    newRect.x += dirX * speed;
+    newRect.y += dirY * speed;
+
+    // Check collision before applying movement
+    if (!checkTankCollisionWithGrid(newRect, &world->obstacleGrid) && !isBlockedByTank(tanks, tank, newRect)) {
+        tanks->rect[tank].x = newRect.x;
+        tanks->rect[tank].y = newRect.y;
+    }
+}
+
+// Function to update tank movement from input (only if not destroyed)
+static void updateTankMovement(World* world, int tank, const TankInput& input) {
+    TankStore* tanks = &world->tanks;
+    bool keysPressed = input.up || input.down || input.left || input.right;
+    if (!keysPressed || !isTankAlive(tanks, tank)) {
+        tanks->flags[tank] &= ~TANK_MOVING;
+        return;
+    }
+
+    tanks->flags[tank] |= TANK_MOVING;
+    LOG_DEBUG("[DEBUG] Tank %d keys pressed - UP:%d DOWN:%d LEFT:%d RIGHT:%d", tank,
+              input.up, input.down, input.left, input.right);
+
+    const SDL_Rect& rect = tanks->rect[tank];
+    if (input.up && rect.y > 0) {
+        tryMoveTank(world, tank, 0, -1, 0); // Face up
+    }
+    if (input.down && rect.y < world->mapHeight - rect.h) {
+        tryMoveTank(world, tank, 0, 1, 180); // Face down
+    }
+    if (input.left && rect.x > 0) {
+        tryMoveTank(world, tank, -1, 0, 270); // Face left
+    }
+    if (input.right && rect.x < world->mapWidth - rect.w) {
+        tryMoveTank(world, tank, 1, 0, 90); // Face right
+    }
+}
+
+// Function to resolve a bullet reaching a tank hitTime into its move
+static void handleBulletTankHit(World* world, int bullet, Fixed hitTime, int target) {
+    BulletPool* bullets = &world->bullets;
+    TankStore* tanks = &world->tanks;
+
+    // Shielded tanks reflect the bullet back from where it touched the tank
+    int shooter = bullets->owner[bullet];
+    if (hasActiveShield(&world->shield, target)) {
+        bullets->x[bullet] = bullets->prevX[bullet] + (bullets->x[bullet] - bullets->prevX[bullet]) * hitTime;
+        bullets->y[bullet] = bullets->prevY[bullet] + (bullets->y[bullet] - bullets->prevY[bullet]) * hitTime;
+        reflectBullet(bullets, bullet, target);
+        pushGameEvent(&world->events, GAME_EVENT_REFLECTED, 0, target, shooter, 0, tanks->rect[target]);
+        return;
+    }
+
+    // HP drops right away, as later bullets this tick must see it; points
+    // and the explosion effect follow from the event
+    bool explosive = (bullets->flags[bullet] & BULLET_EXPLOSION) != 0;
+    int damage = explosive ? EXPLOSION_BULLET_DAMAGE : BULLET_DAMAGE;
+    tanks->hp[target] -= damage;
+    pushGameEvent(&world->events, GAME_EVENT_HIT, explosive ? GAME_EVENT_EXPLOSIVE : 0, shooter, target, damage,
+                  tanks->rect[target]);
+
+    if (tanks->hp[target] <= 0) {
+        destroyTank(tanks, target);
+        pushGameEvent(&world->events, GAME_EVENT_DESTROYED, explosive ? GAME_EVENT_EXPLOSIVE : 0, shooter, target, 0,
+                      tanks->rect[target]);
+    }
+
+    releaseBullet(bullets, bullet);
+}
+
+// Function to resolve a bullet reaching a grass or rock object
+static void handleBulletObjectHit(World* world, int bullet, int id, int shooter) {
+    bool isGrass = id < (int)world->grassObjects.size();
+    GameObject* obj = getWorldObstacle(world, id);
+    if (!obj->isDestroyed) {
+        world->destroyedObstacleHash ^= (id + 1) * 0x9E3779B97F4A7C15ull;
+        world->destroyedObstacles.push_back(id);
+    }
+    destroyGameObject(obj, &world->obstacleGrid, &world->navGrid, id);
+    pushGameEvent(&world->events, GAME_EVENT_OBSTACLE_DESTROYED, isGrass ? GAME_EVENT_GRASS : 0, shooter, id, 0,
+                  obj->rect);
+
+    releaseBullet(&world->bullets, bullet); // Bullet is destroyed
+}
+
+// Function to find what a bullet's move this tick runs into first
+static BulletHit findBulletHit(const World* world, int bullet) {
+    const BulletPool* bullets = &world->bullets;
+    const TankStore* tanks = &world->tanks;
+
+    // Sweep the whole move of this tick, so a fast bullet cannot pass
+    // through a thin object or a tank between two positions
+    Fixed startX = bullets->prevX[bullet];
+    Fixed startY = bullets->prevY[bullet];
+    Fixed moveX = bullets->x[bullet] - startX;
+    Fixed moveY = bullets->y[bullet] - startY;
+    int shooter = bullets->owner[bullet];
+
+    // Every other live tank is a target (earliest hit, then lowest index)
+    BulletHit hit;
+    hit.tank = -1;
+    hit.tankTime = fixedFromInt(0);
+    for (int t = 0; t < tanks->count; t++) {
+        Fixed time;
+        if (t != shooter && isTankAlive(tanks, t) &&
+            sweepBox(startX, startY, BULLET_WIDTH, BULLET_HEIGHT, moveX, moveY, tanks->rect[t], &time) &&
+            (hit.tank == -1 || time < hit.tankTime)) {
+            hit.tank = t;
+            hit.tankTime = time;
+        }
+    }
+    hit.obstacleTime = fixedFromInt(0);
+    hit.obstacle = sweepObstacleGrid(&world->obstacleGrid, startX, startY, BULLET_WIDTH, BULLET_HEIGHT, moveX, moveY,
+                                     &hit.obstacleTime);
+    return hit;
+}
+
+// Function to check if an obstacle id has been destroyed
+static bool isObstacleDestroyed(const World* world, int id) {
+    int grassCount = (int)world->grassObjects.size();
+    return id < grassCount ? world->grassObjects[id].isDestroyed : world->rockObjects[id - grassCount].isDestroyed;
+}
+
+// Function to move bullets and resolve their hits
+static void updateWorldBullets(World* world, JobSystem* jobs) {
+    BulletPool* bullets = &world->bullets;
+    const TankStore* tanks = &world->tanks;
+    int count = (int)bullets->flags.size();
+
+    // Advance every bullet, then cull in slot order (the free list, and so
+    // which slot the next bullet gets, does not depend on the chunking)
+    std::atomic<int> flagged(0);
+    parallelFor(jobs, count, BULLET_ADVANCE_GRAIN, [&](int begin, int end) {
+        flagged += advanceBullets(bullets, begin, end, fixedFromInt(world->mapWidth), fixedFromInt(world->mapHeight));
+    });
+    if (flagged > 0) {
+        cullBullets(bullets);
+    }
+
+    // Find every bullet's first hit against the tanks and obstacles as they
+    // were at the start of the phase. Only reads the world.
+    world->bulletHits.resize(count);
+    parallelFor(jobs, count, BULLET_HIT_GRAIN, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            if (isBulletActive(bullets, i)) {
+                world->bulletHits[i] = findBulletHit(world, i);
+            }
+        }
+    });
+
+    // Resolve in slot order. Earlier hits this tick can only remove tanks
+    // and obstacles, so a precomputed hit still stands unless its own tank
+    // or obstacle is gone, and then the sweep is simply redone.
+    for (int i = 0; i < count; i++) {
+        if (!isBulletActive(bullets, i)) continue;
+
+        BulletHit hit = world->bulletHits[i];
+        if ((hit.tank != -1 && !isTankAlive(tanks, hit.tank)) ||
+            (hit.obstacle != -1 && isObstacleDestroyed(world, hit.obstacle))) {
+            hit = findBulletHit(world, i);
+        }
+
+        // Whatever the bullet reaches first takes the hit (the tank on a tie)
+        if (hit.tank != -1 && (hit.obstacle == -1 || hit.tankTime <= hit.obstacleTime)) {
+            handleBulletTankHit(world, i, hit.tankTime, hit.tank);
+        } else if (hit.obstacle != -1) {
+            handleBulletObjectHit(world, i, hit.obstacle, bullets->owner[i]);
+        } else if (!isPointInActiveChunk(&world->chunks, fixedFloor(bullets->x[i]) + BULLET_WIDTH / 2,
+                                         fixedFloor(bullets->y[i]) + BULLET_HEIGHT / 2)) {
+            // Bullets that fly away from every tank are out of play
+            releaseBullet(bullets, i);
+        }
+    }
+}
+
+// Function to update the guns, ammo and power-ups of every tank, in
+// chunks of tanks. Power-ups resize the bodies the gun rects are placed
+// on, so they run in a second pass once every gun has been updated.
+static void updateTankSystems(TankStore* tanks, JobSystem* jobs) {
+    parallelFor(jobs, tanks->count, TANK_SYSTEM_GRAIN, [tanks](int begin, int end) {
+        updateTankGuns(tanks, begin, end);
+        updateTankAmmo(tanks, begin, end);
+    });
+    parallelFor(jobs, tanks->count, TANK_SYSTEM_GRAIN, [tanks](int begin, int end) {
+        updateTankPowerUps(tanks, begin, end);
+    });
+}
+
+// Function to advance the match by one tick
+void stepWorld(World* world, const TankInput* inputs, JobSystem* jobs) {
+    TankStore* tanks = &world->tanks;
+
+    // Remember positions of the previous tick for interpolation (bullets
+    // keep theirs in updateBullets())
+    storeTankPrevious(tanks);
+    world->tick++;
+    world->events.clear();
+
+    // Shooting (F and / for bullets, J and . for explosion bullets)
+    {
+        PROFILE_ZONE("Shooting");
+        for (int i = 0; i < tanks->count; i++) {
+            handleTankShooting(world, i, inputs[i]);
+        }
+    }
+
+    // Update gun rotation and gun rects, ammo and power-ups for every tank
+    {
+        PROFILE_ZONE("Tank systems");
+        updateTankSystems(tanks, jobs);
+    }
+
+    // Update explosions, the power box and the shield
+    {
+        PROFILE_ZONE("Power-ups");
+
+        // Update explosions
+        for (int i = 0; i < MAX_EXPLOSIONS; i++) {
+            updateExplosion(&world->explosions[i]);
+        }
+
+        // Update power box spawning
+        updatePowerBoxSpawning(&world->powerBox, world->map, &world->obstacleGrid, tanks, &world->rng);
+
+        // Update shield
+        updateShield(&world->shield);
+
+        // Check power box collection
+        PowerBox box = world->powerBox;
+        int collector = checkPowerBoxCollection(&world->powerBox, tanks, &world->shield);
+        if (collector != -1) {
+            pushGameEvent(&world->events, GAME_EVENT_PICKED_UP, 0, collector, box.boxType, 0, box.rect);
+        }
+    }
+
+    // Tank movement and collision
+    {
+        PROFILE_ZONE("Movement");
+        for (int i = 0; i < tanks->count; i++) {
+            updateTankMovement(world, i, inputs[i]);
+        }
+
+        // Simulation follows the tanks
+        updateActiveChunks(&world->chunks, tanks->rect.data(), tanks->count);
+    }
+
+    // Update bullets
+    {
+        PROFILE_ZONE("Bullets");
+        updateWorldBullets(world, jobs);
+    }
+
+    // Last tank standing wins, once every bullet of the tick has landed, so
+    // tanks that destroy each other in the same tick end the match in a draw
+    int lastAlive;
+    if (world->winner == -1 && tanks->count > 1 && countAliveTanks(tanks, &lastAlive) <= 1) {
+        world->winner = lastAlive != -1 ? lastAlive : WINNER_DRAW;
+    }
+
+    // Scoring and effects take the tick's events in one batch
+    {
+        PROFILE_ZONE("Events");
+        int count = (int)world->events.size();
+        applyEventScores(world->events.data(), count, tanks);
+        applyEventEffects(world->events.data(), count, world->explosions, MAX_EXPLOSIONS);
+    }
+}
+
+// Function to convert a TankInput to INPUT_* bits
+uint8_t packTankInput(const TankInput& input) {
+    return (input.up ? INPUT_UP : 0) | (input.down ? INPUT_DOWN : 0) |
+           (input.left ? INPUT_LEFT : 0) | (input.right ? INPUT_RIGHT : 0) |
+           (input.fire ? INPUT_FIRE : 0) | (input.fireExplosion ? INPUT_FIRE_EXPLOSION : 0);
+}
+
+// Function to convert INPUT_* bits back to a TankInput
+TankInput unpackTankInput(uint8_t bits) {
+    TankInput input;
+    input.up = (bits & INPUT_UP) != 0;
+    input.down = (bits & INPUT_DOWN) != 0;
+    input.left = (bits & INPUT_LEFT) != 0;
+    input.right = (bits & INPUT_RIGHT) != 0;
+    input.fire = (bits & INPUT_FIRE) != 0;
+    input.fireExplosion = (bits & INPUT_FIRE_EXPLOSION) != 0;
+    return input;
+}
+
+// Function to mix raw bytes into an FNV-1a hash
+static void hashBytes(uint64_t* hash, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        *hash = (*hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+}
+
+// Function to mix one value into the hash (Fixed values by their raw bits)
+template <typename T>
+static void hashValue(uint64_t* hash, T value) {
+    hashBytes(hash, &value, sizeof(value));
+}
+
+// Function to mix a rect into the hash
+static void hashRect(uint64_t* hash, SDL_Rect rect) {
+    hashValue(hash, rect.x);
+    hashValue(hash, rect.y);
+    hashValue(hash, rect.w);
+    hashValue(hash, rect.h);
+}
+
+// Function to mix every tank's gameplay fields into the hash
+static void hashTanks(uint64_t* hash, const TankStore* tanks) {
+    hashValue(hash, tanks->count);
+    for (int i = 0; i < tanks->count; i++) {
+        hashRect(hash, tanks->rect[i]);
+        hashValue(hash, tanks->speed[i]);
+        hashValue(hash, tanks->rotation[i]);
+        hashValue(hash, tanks->gunRotation[i]);
+        hashValue(hash, tanks->ammo[i]);
+        hashValue(hash, tanks->reloadTimer[i]);
+        hashValue(hash, tanks->hp[i]);
+        hashValue(hash, tanks->powerTimer[i]);
+        hashValue(hash, (uint8_t)(tanks->flags[i] & ~TANK_MOVING)); // Moving only affects drawing
+        hashValue(hash, tanks->info[i].score);
+        hashValue(hash, tanks->info[i].explosionItemCount);
+    }
+}
+
+// Function to hash the gameplay state
+uint64_t hashWorld(const World* world) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hashValue(&hash, world->tick);
+    hashValue(&hash, world->rng.state);
+    hashValue(&hash, world->winner);
+    hashTanks(&hash, &world->tanks);
+
+    hashValue(&hash, world->destroyedObstacleHash);
+
+    const BulletPool& bullets = world->bullets;
+    for (int i = 0; i < (int)bullets.flags.size(); i++) {
+        if (!isBulletActive(&bullets, i)) continue;
+        hashValue(&hash, i);
+        hashValue(&hash, bullets.x[i]);
+        hashValue(&hash, bullets.y[i]);
+        hashValue(&hash, bullets.velocityX[i]);
+        hashValue(&hash, bullets.velocityY[i]);
+        hashValue(&hash, bullets.owner[i]);
+        hashValue(&hash, bullets.flags[i]);
+    }
+
+    for (int i = 0; i < MAX_EXPLOSIONS; i++) {
+        hashValue(&hash, world->explosions[i].active);
+        if (world->explosions[i].active) {
+            hashRect(&hash, world->explosions[i].rect);
+            hashValue(&hash, world->explosions[i].timer);
+        }
+    }
+
+    hashValue(&hash, world->powerBox.active);
+    if (world->powerBox.active) {
+        hashRect(&hash, world->powerBox.rect);
+    }
+    hashValue(&hash, world->powerBox.spawnTimer);
+    hashValue(&hash, world->powerBox.disappearTimer);
+    hashValue(&hash, world->powerBox.spawnCount);
+
+    hashValue(&hash, world->shield.active);
+    hashValue(&hash, world->shield.timer);
+    hashValue(&hash, world->shield.owner);
+    return hash;
+}
+
+// Function to blend a rect between two ticks
+SDL_Rect interpolateRect(SDL_Rect previous, SDL_Rect current, float alpha) {
+    SDL_Rect result;
+    result.x = previous.x + (int)lroundf((current.x - previous.x) * alpha);
+    result.y = previous.y + (int)lroundf((current.y - previous.y) * alpha);
+    result.w = current.w;
+    result.h = current.h;
+    return result;
+}
+
+// Function to get a tank positioned between two ticks for drawing
+TankPose interpolateTank(const TankStore* tanks, int tank, float alpha) {
+    TankPose pose;
+    pose.rect = interpolateRect(tanks->prevRect[tank], tanks->rect[tank], alpha);
+    pose.rotation = fixedToFloat(tanks->rotation[tank]);
+    float previousGun = fixedToFloat(tanks->prevGunRotation[tank]);
+    pose.gunRotation = previousGun + (fixedToFloat(tanks->gunRotation[tank]) - previousGun) * alpha;
+    pose.gunRect = getGunRect(pose.rect, tanks->rotation[tank]);
+    return pose;
+}
+
+// Function to play one scripted duel on an empty arena: both tanks at 25 HP
+// facing each other, and the given tanks firing a bullet at the other
+static int playRulesDuel(bool blueFires, bool redFires) {
+    std::vector<MapSpawn> spawns = {{200, 270, 90.0f, 0}, {760, 270, 270.0f, 1}};
+    std::vector<uint8_t> image = buildMapImage(960, 540, {}, spawns, {});
+    GameMap map = {};
+    if (!openMapFromMemory(&map, image.data(), image.size(), "rules test")) return -3;
+
+    World world;
+    initializeWorld(&world, &map, 40, 48, 1, 2);
+    world.tanks.hp[0] = 25;
+    world.tanks.hp[1] = 25;
+    if (blueFires) fireBullet(&world.bullets, world.tanks.rect[0], fixedFromInt(90), 0, false);
+    if (redFires) fireBullet(&world.bullets, world.tanks.rect[1], fixedFromInt(270), 1, false);
+
+    TankInput inputs[2] = {};
+    for (int tick = 0; tick < 10 * SIMULATION_TICK_RATE && world.winner == -1; tick++) {
+        stepWorld(&world, inputs);
+    }
+    return world.winner;
+}
+
+// Function to check the match rules headless
+bool runWorldRulesTest() {
+    bool passed = true;
+    int winner = playRulesDuel(true, false);
+    if (winner != 0) {
+        LOG_ERROR("[RULES] A lone kill should win for tank 0, got winner %d", winner);
+        passed = false;
+    }
+    winner = playRulesDuel(true, true);
+    if (winner != WINNER_DRAW) {
+        LOG_ERROR("[RULES] Two tanks destroying each other in one tick should draw, got winner %d", winner);
+        passed = false;
+    }
+    return passed;
+}
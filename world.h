@@ -0,0 +1,133 @@
+#pragma once
+
+// Match state and fixed simulation step. Nothing in here touches the
+// renderer, so a World can be stepped headless as fast as the CPU allows.
+
+#include "game.h"
+#include "game_events.h"
+#include "flow_field.h"
+#include "obstacle_grid.h"
+#include "bullet_pool.h"
+#include "tank_store.h"
+#include "map.h"
+#include "world_chunks.h"
+#include <vector>
+
+struct JobSystem;
+
+// Seconds of real time per tick (SIMULATION_TICK_RATE is in game.h), for
+// the frame loop's accumulator; the simulation itself only counts ticks
+const float FIXED_TIMESTEP = 1.0f / SIMULATION_TICK_RATE;
+
+// Match limits
+const int MAX_EXPLOSIONS = 3;
+
+// HP a bullet takes from a tank
+const int BULLET_DAMAGE = 25;
+const int EXPLOSION_BULLET_DAMAGE = 75; // 3x damage
+
+// World::winner when the last tanks were destroyed in the same tick
+const int WINNER_DRAW = -2;
+
+// Work split for stepWorld on a job system. Below these counts a phase
+// runs on the calling thread, as handing it out would cost more than the
+// work itself.
+const int TANK_SYSTEM_GRAIN = 32; // Tanks per chunk of the gun, ammo and power-up updates
+const int BULLET_ADVANCE_GRAIN = 4096; // Bullets per chunk of the move kernel
+const int BULLET_HIT_GRAIN = 64; // Bullets per chunk of hit detection
+
+// Structure for one tank's input during a single step
+struct TankInput {
+    bool up;
+    bool down;
+    bool left;
+    bool right;
+    bool fire; // Fire normal bullet this step (F / slash)
+    bool fireExplosion; // Fire explosion bullet this step (J / period)
+};
+
+// Bits of a packed TankInput (replays and network messages)
+const uint8_t INPUT_UP = 1;
+const uint8_t INPUT_DOWN = 2;
+const uint8_t INPUT_LEFT = 4;
+const uint8_t INPUT_RIGHT = 8;
+const uint8_t INPUT_FIRE = 16;
+const uint8_t INPUT_FIRE_EXPLOSION = 32;
+
+// Structure for what a bullet's move this tick runs into first (-1 = nothing)
+struct BulletHit {
+    int tank;
+    Fixed tankTime; // Fraction of the move done at contact
+    int obstacle;
+    Fixed obstacleTime;
+};
+
+// Structure holding the whole state of a match
+struct World {
+    TankStore tanks; // Every tank in the match (0 = blue player, 1 = red player)
+    const GameMap* map; // Arena the match is played on (must outlive the world)
+    int mapWidth; // Arena size in pixels
+    int mapHeight;
+    std::vector<GameObject> grassObjects; // Created from the map's obstacles
+    std::vector<GameObject> rockObjects;
+    uint64_t destroyedObstacleHash; // XOR of mixed ids of destroyed obstacles (hashWorld stays O(1) in map size)
+    std::vector<int> destroyedObstacles; // Ids in the order they were destroyed (snapshots copy just these)
+    ObstacleGrid obstacleGrid; // Spatial index over live grass and rocks
+    NavGrid navGrid; // Where a tank fits, for flow-field navigation (not part of the hash)
+    WorldChunks chunks; // Coarse split of the arena for drawing and simulation activity
+    BulletPool bullets;
+    std::vector<BulletHit> bulletHits; // Per bullet slot, scratch for stepWorld
+    std::vector<GameEvent> events; // What happened in the last tick, in order (not part of the hash)
+    Explosion explosions[MAX_EXPLOSIONS];
+    PowerBox powerBox;
+    Shield shield;
+    GameRng rng; // Only source of randomness in the match
+    uint64_t seed; // Seed the match started from
+    uint32_t tick; // Steps taken since initializeWorld
+    int winner; // -1 = no winner yet, WINNER_DRAW, otherwise the index of the last tank standing
+    int tankWidth; // Body size taken from the tank texture
+    int tankHeight;
+};
+
+// Function to reset the whole match (tanks, bullets, obstacles, pickups) on a map.
+// Tanks alternate between the blue (even) and red (odd) team and are placed
+// around their team's spawn points. The same map, seed, tank count and
+// inputs always play out the same match.
+void initializeWorld(World* world, const GameMap* map, int tankWidth, int tankHeight, uint64_t seed,
+                     int tankCount = 2);
+
+// Function to get a grass or rock object by obstacle id (grass first, then rocks)
+inline GameObject* getWorldObstacle(World* world, int id) {
+    int grassCount = (int)world->grassObjects.size();
+    return id < grassCount ? &world->grassObjects[id] : &world->rockObjects[id - grassCount];
+}
+
+// Function to advance the match by one tick (FIXED_TIMESTEP seconds).
+// inputs[i] drives tank i (one input per tank). With a job system the
+// independent per-tank and per-bullet work runs in parallel; the result
+// is the same as without one, bit for bit. Only integer and Fixed math
+// runs here, so it is also the same on every compiler and machine.
+void stepWorld(World* world, const TankInput* inputs, JobSystem* jobs = NULL);
+
+// Functions to convert a TankInput to and from INPUT_* bits
+uint8_t packTankInput(const TankInput& input);
+TankInput unpackTankInput(uint8_t bits);
+
+// Function to hash the gameplay state (not render-only fields), used to
+// check that two simulations of the same match have not diverged
+uint64_t hashWorld(const World* world);
+
+// Function to fold a world hash into the 32 bits replays and network checks carry
+inline uint32_t foldWorldHash(uint64_t hash) {
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+// Render interpolation between the previous and current tick.
+// alpha is in [0, 1]: 0 = previous tick, 1 = current tick.
+SDL_Rect interpolateRect(SDL_Rect previous, SDL_Rect current, float alpha);
+TankPose interpolateTank(const TankStore* tanks, int tank, float alpha);
+
+// Function to check the match rules on scripted duels, headless: a lone
+// kill wins, and two tanks destroying each other in one tick is a draw
+// (false, with the broken rule logged, if one does not hold)
+bool runWorldRulesTest();
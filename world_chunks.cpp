@@ -0,0 +1,100 @@
+#include "world_chunks.h"
+#include <algorithm>
+#include <cmath>
+
+// Function to get the chunk an obstacle belongs to (the one holding its center)
+static int getObstacleChunk(const WorldChunks* chunks, SDL_Rect rect) {
+    int column = std::max(0, std::min(chunks->columns - 1, (rect.x + rect.w / 2) / chunks->chunkSize));
+    int row = std::max(0, std::min(chunks->rows - 1, (rect.y + rect.h / 2) / chunks->chunkSize));
+    return row * chunks->columns + column;
+}
+
+// Function to split the world into chunks and sort the obstacles into them
+void buildWorldChunks(WorldChunks* chunks, const GameObject* grassObjects, const GameObject* rockObjects,
+                      int grassCount, int rockCount, int worldWidth, int worldHeight, int chunkSize) {
+    int total = grassCount + rockCount;
+    chunks->chunkSize = chunkSize;
+    chunks->columns = std::max(1, (worldWidth + chunkSize - 1) / chunkSize);
+    chunks->rows = std::max(1, (worldHeight + chunkSize - 1) / chunkSize);
+    chunks->grassCount = grassCount;
+    chunks->margin = 0;
+
+    int chunkTotal = chunks->columns * chunks->rows;
+    chunks->chunkStart.assign(chunkTotal + 1, 0);
+    chunks->items.resize(total);
+    chunks->active.assign(chunkTotal, 1);
+
+    // Counting sort by chunk; ids stay ascending within each chunk
+    std::vector<int> chunkOf(total);
+    for (int id = 0; id < total; id++) {
+        SDL_Rect rect = (id < grassCount) ? grassObjects[id].rect : rockObjects[id - grassCount].rect;
+        chunkOf[id] = getObstacleChunk(chunks, rect);
+        chunks->chunkStart[chunkOf[id] + 1]++;
+
+        // Sprites are drawn rotated about their center, so they can reach half a diagonal out
+        int reach = (int)std::ceil(std::sqrt((double)rect.w * rect.w + (double)rect.h * rect.h) / 2.0);
+        chunks->margin = std::max(chunks->margin, reach);
+    }
+    for (int c = 0; c < chunkTotal; c++) {
+        chunks->chunkStart[c + 1] += chunks->chunkStart[c];
+    }
+    std::vector<int> fill(chunks->chunkStart.begin(), chunks->chunkStart.end() - 1);
+    for (int id = 0; id < total; id++) {
+        chunks->items[fill[chunkOf[id]]++] = id;
+    }
+}
+
+// Function to get the chunk range covered by a rect, clamped to the world
+void getChunkRange(const WorldChunks* chunks, SDL_Rect rect, int* minX, int* minY, int* maxX, int* maxY) {
+    *minX = std::max(0, std::min(chunks->columns - 1, rect.x / chunks->chunkSize));
+    *minY = std::max(0, std::min(chunks->rows - 1, rect.y / chunks->chunkSize));
+    *maxX = std::max(0, std::min(chunks->columns - 1, (rect.x + rect.w - 1) / chunks->chunkSize));
+    *maxY = std::max(0, std::min(chunks->rows - 1, (rect.y + rect.h - 1) / chunks->chunkSize));
+}
+
+// Function to collect the ids of every obstacle that may be visible in area
+void collectChunkObstacles(const WorldChunks* chunks, SDL_Rect area, std::vector<int>* ids) {
+    ids->clear();
+
+    // An obstacle centered in a neighbouring chunk can still reach into the area
+    SDL_Rect reach = {area.x - chunks->margin, area.y - chunks->margin, area.w + 2 * chunks->margin,
+                      area.h + 2 * chunks->margin};
+    int minX, minY, maxX, maxY;
+    getChunkRange(chunks, reach, &minX, &minY, &maxX, &maxY);
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            int chunk = cy * chunks->columns + cx;
+            ids->insert(ids->end(), chunks->items.begin() + chunks->chunkStart[chunk],
+                        chunks->items.begin() + chunks->chunkStart[chunk + 1]);
+        }
+    }
+
+    // Chunks are visited row by row, put grass back before rocks
+    std::sort(ids->begin(), ids->end());
+}
+
+// Function to mark the chunks near the focus rects as active
+void updateActiveChunks(WorldChunks* chunks, const SDL_Rect* focus, int focusCount) {
+    std::fill(chunks->active.begin(), chunks->active.end(), 0);
+    for (int i = 0; i < focusCount; i++) {
+        int minX, minY, maxX, maxY;
+        getChunkRange(chunks, focus[i], &minX, &minY, &maxX, &maxY);
+        minX = std::max(0, minX - WORLD_CHUNK_ACTIVE_RADIUS);
+        minY = std::max(0, minY - WORLD_CHUNK_ACTIVE_RADIUS);
+        maxX = std::min(chunks->columns - 1, maxX + WORLD_CHUNK_ACTIVE_RADIUS);
+        maxY = std::min(chunks->rows - 1, maxY + WORLD_CHUNK_ACTIVE_RADIUS);
+        for (int cy = minY; cy <= maxY; cy++) {
+            std::fill(chunks->active.begin() + cy * chunks->columns + minX,
+                      chunks->active.begin() + cy * chunks->columns + maxX + 1, 1);
+        }
+    }
+}
+
+// Function to check if the chunk holding a point is simulated
+bool isPointInActiveChunk(const WorldChunks* chunks, int x, int y) {
+    if (x < 0 || y < 0) return false;
+    int column = x / chunks->chunkSize;
+    int row = y / chunks->chunkSize;
+    if (column >= chunks->columns || row >= chunks->rows) return false;
+    return chunks->active[row * chunks->columns + column] != 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// The arena split into fixed-size square chunks. Every obstacle belongs
+// to the one chunk its center is in, so drawing only has to visit the
+// chunks that intersect the camera view. Chunks also carry an "active"
+// flag: only chunks near a tank are simulated, and bullets that fly
+// into an inactive chunk are retired.
+//
+// The obstacle grid (obstacle_grid.h) answers exact overlap queries for
+// collisions; chunks are the coarse unit for visibility and activity.
+
+#include "game.h"
+#include <cstdint>
+#include <vector>
+
+// Chunk edge in pixels
+const int WORLD_CHUNK_SIZE = 512;
+
+// Chunks within this many chunks of a tank are simulated
+const int WORLD_CHUNK_ACTIVE_RADIUS = 2;
+
+// Structure for the chunk grid (obstacle ids stored as slices of one array)
+struct WorldChunks {
+    int chunkSize;
+    int columns;
+    int rows;
+    int grassCount; // Ids below this are grass, the rest are rocks (same ids as the obstacle grid)
+    int margin; // How far an obstacle can reach outside its chunk (half its diagonal, rounded up)
+    std::vector<int> chunkStart; // First slot of each chunk in items (columns * rows + 1 entries)
+    std::vector<int> items; // Obstacle ids grouped by chunk
+    std::vector<uint8_t> active; // Simulation flag per chunk
+};
+
+// Function to split a world of worldWidth x worldHeight pixels into chunks and sort the obstacles into them
+void buildWorldChunks(WorldChunks* chunks, const GameObject* grassObjects, const GameObject* rockObjects,
+                      int grassCount, int rockCount, int worldWidth, int worldHeight,
+                      int chunkSize = WORLD_CHUNK_SIZE);
+
+// Function to get the chunk range covered by a rect, clamped to the world
+void getChunkRange(const WorldChunks* chunks, SDL_Rect rect, int* minX, int* minY, int* maxX, int* maxY);
+
+// Function to collect the ids of every obstacle that may be visible in
+// area, in id order (grass before rocks, as they are drawn)
+void collectChunkObstacles(const WorldChunks* chunks, SDL_Rect area, std::vector<int>* ids);
+
+// Function to mark the chunks within WORLD_CHUNK_ACTIVE_RADIUS of the focus rects as active (all others inactive)
+void updateActiveChunks(WorldChunks* chunks, const SDL_Rect* focus, int focusCount);
+
+// Function to check if the chunk holding a point is simulated (points outside the world are not)
+bool isPointInActiveChunk(const WorldChunks* chunks, int x, int y);